@@ -0,0 +1,84 @@
+/*!
+ * @file auth-emulator.h
+ * @brief In-process stand-in for the Firebase Auth emulator.
+ *
+ * Behaves like FirebaseAuthBackend against a local emulator: every fetch
+ * costs a configurable round-trip, tokens are unsigned JWTs ("alg": "none",
+ * as the emulator issues them) with a configurable lifetime, and failures
+ * can be injected. Counts the fetches that reached it.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include "auth-service.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+class AuthEmulatorBackend : public AuthBackend {
+public:
+    struct Options {
+        std::chrono::milliseconds latency{150};    ///< Simulated network round-trip.
+        std::chrono::seconds      lifetime{3600};  ///< Token validity.
+        bool                      fail = false;
+    };
+
+    explicit AuthEmulatorBackend(Options options)
+        : options_(options)
+    {
+    }
+
+    QByteArray id() const override { return "emulator:demo-playfame"; }
+
+    AuthTokenResult fetchToken(bool, const std::atomic<bool> &cancel) override
+    {
+        fetches_.fetch_add(1, std::memory_order_relaxed);
+
+        AuthTokenResult result;
+        const auto until = std::chrono::steady_clock::now() + options_.latency;
+        while (std::chrono::steady_clock::now() < until) {
+            if (cancel.load(std::memory_order_relaxed)) {
+                result.error = QStringLiteral("cancelled");
+                return result;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (options_.fail) {
+            result.error = QStringLiteral("emulator: injected failure");
+            return result;
+        }
+
+        const int64_t now = AuthService::nowMs() / 1000;
+        QJsonObject payload;
+        payload.insert(QStringLiteral("user_id"), QStringLiteral("emulator-user"));
+        payload.insert(QStringLiteral("iat"), static_cast<double>(now));
+        payload.insert(QStringLiteral("exp"), static_cast<double>(now + options_.lifetime.count()));
+
+        const auto encode = [](const QByteArray &raw) {
+            return raw.toBase64(QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals);
+        };
+        result.ok            = true;
+        result.token.uid     = "emulator-user";
+        result.token.idToken = encode(R"({"alg":"none","typ":"JWT"})") + "." +
+                               encode(QJsonDocument(payload).toJson(QJsonDocument::Compact)) + ".";
+        result.token.expiresAtMs = AuthService::jwtExpiryMs(result.token.idToken);
+        return result;
+    }
+
+    void signOut() override {}
+
+    uint64_t fetches() const { return fetches_.load(std::memory_order_relaxed); }
+
+private:
+    Options               options_;
+    std::atomic<uint64_t> fetches_{0};
+};
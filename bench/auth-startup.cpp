@@ -0,0 +1,187 @@
+/*!
+ * @file auth-startup.cpp
+ * @brief Cold/warm start latency and request coalescing of AuthService.
+ *
+ * Runs AuthService against the in-process auth emulator stand-in:
+ * - cold: no session cache, the first token needs a sign-in round-trip
+ * - warm: the cached session is fresh, the first token needs none
+ * - coalescing: many threads force a refresh at once
+ * - proactive: a short-lived token is refreshed before it expires
+ *
+ * Usage: auth-startup [--latency-ms N] [--repeat R] [--threads T] [--dir PATH]
+ * Prints one JSON object to stdout.
+ */
+
+#include "auth-emulator.h"
+#include "auth-service.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/* Waits for a number of callbacks that arrive on the auth worker. */
+class Latch {
+public:
+    explicit Latch(size_t count)
+        : count_(count)
+    {
+    }
+
+    void arrive(bool ok)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        failures_ += ok ? 0 : 1;
+        if (--count_ == 0)
+            done_.notify_all();
+    }
+
+    bool wait(std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return done_.wait_for(lock, timeout, [this] { return count_ == 0; }) && failures_ == 0;
+    }
+
+private:
+    std::mutex              mutex_;
+    std::condition_variable done_;
+    size_t                  count_;
+    size_t                  failures_ = 0;
+};
+
+double medianOf(std::vector<double> v)
+{
+    std::sort(v.begin(), v.end());
+    return v.empty() ? 0.0 : v[v.size() / 2];
+}
+
+struct StartResult {
+    double   startUs  = 0.0;   ///< As measured by the service.
+    double   firstUs  = 0.0;   ///< start() until the caller's callback ran.
+    bool     warm     = false;
+    uint64_t fetches  = 0;
+    bool     ok       = false;
+};
+
+StartResult startOnce(const QByteArray &cache, AuthEmulatorBackend::Options options)
+{
+    auto backend = std::make_unique<AuthEmulatorBackend>(options);
+    AuthEmulatorBackend *emulator = backend.get();
+    AuthService service(std::move(backend), cache);
+
+    Latch latch(1);
+    const auto t0 = Clock::now();
+    service.start();
+    service.requestToken(nullptr, [&latch](const AuthTokenResult &r) { latch.arrive(r.ok); });
+
+    StartResult out;
+    out.ok      = latch.wait(std::chrono::seconds(10));
+    out.firstUs = std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+    const AuthStats stats = service.stats();
+    out.startUs = static_cast<double>(stats.startUs);
+    out.warm    = stats.warmStart;
+    out.fetches = emulator->fetches();
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    AuthEmulatorBackend::Options options;
+    int repeat = 5;
+    unsigned threads = 64;
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "playfame-bench";
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--latency-ms"))
+            options.latency = std::chrono::milliseconds(std::atoi(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--repeat"))
+            repeat = std::max(1, std::atoi(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--threads"))
+            threads = static_cast<unsigned>(std::max(1, std::atoi(argv[i + 1])));
+        else if (!std::strcmp(argv[i], "--dir"))
+            dir = argv[i + 1];
+    }
+    std::filesystem::create_directories(dir);
+    const std::string cachePath = (dir / "auth-session.json").string();
+    const QByteArray cache = QByteArray::fromStdString(cachePath);
+
+    /* cold and warm start ------------------------------------------------ */
+    std::vector<double> coldUs, coldFirstUs, warmUs, warmFirstUs;
+    uint64_t coldFetches = 0, warmFetches = 0;
+    bool ok = true;
+    for (int r = 0; r < repeat; ++r) {
+        std::filesystem::remove(cachePath);
+        const StartResult cold = startOnce(cache, options);
+        const StartResult warm = startOnce(cache, options);     /* cache written by the cold run */
+        ok = ok && cold.ok && warm.ok && !cold.warm && warm.warm;
+        coldUs.push_back(cold.startUs);
+        coldFirstUs.push_back(cold.firstUs);
+        warmUs.push_back(warm.startUs);
+        warmFirstUs.push_back(warm.firstUs);
+        coldFetches += cold.fetches;
+        warmFetches += warm.fetches;
+    }
+
+    /* concurrent forced refreshes share one fetch ------------------------ */
+    uint64_t coalescedFetches = 0, coalesced = 0;
+    {
+        auto backend = std::make_unique<AuthEmulatorBackend>(options);
+        AuthEmulatorBackend *emulator = backend.get();
+        AuthService service(std::move(backend), QByteArray());
+        service.start();
+        Latch first(1);
+        service.requestToken(nullptr, [&first](const AuthTokenResult &r) { first.arrive(r.ok); });
+        ok = first.wait(std::chrono::seconds(10)) && ok;
+
+        const uint64_t before = emulator->fetches();
+        Latch all(threads);
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < threads; ++t)
+            pool.emplace_back([&] {
+                service.requestToken(nullptr, [&all](const AuthTokenResult &r) { all.arrive(r.ok); }, true);
+            });
+        for (auto &t : pool)
+            t.join();
+        ok = all.wait(std::chrono::seconds(10)) && ok;
+        coalescedFetches = emulator->fetches() - before;
+        coalesced        = service.stats().coalesced;
+    }
+
+    /* proactive refresh before expiry ------------------------------------- */
+    uint64_t proactive = 0;
+    {
+        AuthEmulatorBackend::Options shortLived = options;
+        shortLived.lifetime = std::chrono::seconds(3);
+        AuthService service(std::make_unique<AuthEmulatorBackend>(shortLived), QByteArray());
+        service.setRefreshMargin(std::chrono::seconds(2));   /* due one second after sign-in */
+        service.start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1500) + 2 * options.latency);
+        proactive = service.stats().proactiveRefreshes;
+        ok = ok && proactive >= 1 && service.currentToken().has_value();
+    }
+    std::filesystem::remove(cachePath);
+
+    std::printf("{\"latency_ms\": %lld, \"repeat\": %d, \"cold_start_us\": %.0f, \"cold_first_token_us\": %.0f, "
+                "\"warm_start_us\": %.0f, \"warm_first_token_us\": %.0f, \"cold_fetches\": %llu, "
+                "\"warm_fetches\": %llu, \"threads\": %u, \"coalesced_fetches\": %llu, \"coalesced_requests\": %llu, "
+                "\"proactive_refreshes\": %llu, \"ok\": %s}\n",
+                static_cast<long long>(options.latency.count()), repeat, medianOf(coldUs), medianOf(coldFirstUs),
+                medianOf(warmUs), medianOf(warmFirstUs), static_cast<unsigned long long>(coldFetches),
+                static_cast<unsigned long long>(warmFetches), threads,
+                static_cast<unsigned long long>(coalescedFetches), static_cast<unsigned long long>(coalesced),
+                static_cast<unsigned long long>(proactive), ok ? "true" : "false");
+    return ok ? 0 : 1;
+}
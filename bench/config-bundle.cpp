@@ -0,0 +1,470 @@
+/*!
+ * @file config-bundle.cpp
+ * @brief Bundle export/import: peak memory of streaming vs. the obs_data JSON path.
+ *
+ * Writes a config of --sections sections with --keys keys each plus an
+ * "assets" section holding an --assets long array of asset records (the
+ * cached lists that make real bundles large), and loads it. Then exports
+ * and imports it with obs_data_save_json_safe() /
+ * obs_data_create_from_json_file_safe() + applySections(), as a plugin
+ * would without ConfigBundle, and with ConfigBundle uncompressed, gzip and
+ * zstd (where compiled in), and imports it once more into an empty config,
+ * where nothing can be shared. Reports time and the peak resident memory
+ * each step adds on top of the loaded config (Linux: VmHWM, reset through
+ * /proc/self/clear_refs). Then checks that:
+ * - a round trip restores edited keys, drops added ones and notifies exactly those
+ * - doubles stay doubles, large integers stay exact, strings survive escaping
+ * - the section filter, progress reports and the skipped count are right
+ * - a cancelled export leaves no file, a cancelled or truncated import changes nothing
+ * - in journal mode, as the plugin runs, an import (removed keys included)
+ *   is still there after a restart
+ *
+ * Usage: config-bundle [--sections N] [--keys N] [--assets N] [--dir PATH]
+ * Prints one JSON object to stdout.
+ */
+
+#include "config-bundle.h"
+#include "obs-config-helper.h"
+#include "obs-standin.h"
+
+#include <QString>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::string sectionName(int s)
+{
+    return "section_" + std::to_string(s);
+}
+
+void writeConfig(const std::filesystem::path &file, int sections, int keys, int assets)
+{
+    std::ofstream out(file);
+    out << "{\"numbers\": {\"tenth\": 0.1, \"whole\": 3.0, \"huge\": 1e300, \"exact\": 9007199254740993, "
+           "\"lowest\": -9223372036854775807, \"negative\": -2.5e-8, \"flag\": true},\n"
+           "\"text\": {\"quoted\": \"say \\\"hi\\\" \\\\ back\\nslash\\ttab\\u0001\", \"utf8\": \"gr\\u00fc\\u00dfe \\u263a\"}";
+    for (int s = 0; s < sections; ++s) {
+        out << ",\n\"" << sectionName(s) << "\": {";
+        for (int k = 0; k < keys; ++k) {
+            out << (k ? ", " : "") << "\"key_" << k << "\": ";
+            switch (k % 4) {
+            case 0: out << "\"value " << s << '/' << k << " lorem ipsum dolor\""; break;
+            case 1: out << (s * 100000 + k); break;
+            case 2: out << (k * 0.25 + 0.125); break;
+            default: out << ((k & 8) ? "true" : "false");
+            }
+        }
+        out << '}';
+    }
+    out << ",\n\"assets\": {\"version\": 4, \"items\": [";
+    for (int a = 0; a < assets; ++a)
+        out << (a ? ",\n" : "") << "{\"id\": " << a << ", \"name\": \"asset " << a << "\", \"path\": \"C:/Users/streamer/"
+            << "Videos/PlayFame/clips/asset_" << a << ".webm\", \"size\": " << (a * 7919LL % 100000000)
+            << ", \"hash\": \"" << std::hex << (a * 2654435761ULL) << std::dec << "\", \"tags\": {\"game\": \"g"
+            << a % 97 << "\", \"pinned\": " << ((a % 5) ? "false" : "true") << "}}";
+    out << "]}}\n";
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Peak RSS                                                                 */
+/* ------------------------------------------------------------------------- */
+long statusKb(const char *field)
+{
+    std::ifstream in("/proc/self/status");
+    std::string   line;
+    const size_t  len = std::strlen(field);
+    while (std::getline(in, line))
+        if (line.compare(0, len, field) == 0 && line.size() > len && line[len] == ':')
+            return std::atol(line.c_str() + len + 1);
+    return -1;
+}
+
+/* the high-water mark drops back to the current RSS */
+bool resetPeak()
+{
+#if defined(__GLIBC__)
+    malloc_trim(0);
+#endif
+    std::ofstream out("/proc/self/clear_refs");
+    out << "5";
+    out.flush();
+    return out.good();
+}
+
+struct Phase {
+    bool     ran    = false;
+    double   ms     = 0;
+    long     peakKb = 0;   ///< Above the resident size before the step.
+    uint64_t fileBytes = 0;
+};
+
+Phase measure(const std::function<uint64_t()> &step)
+{
+    Phase phase;
+    resetPeak();
+    const long before = statusKb("VmRSS");
+    const auto t0     = Clock::now();
+    phase.fileBytes   = step();
+    phase.ms          = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    phase.peakKb      = std::max(0L, statusKb("VmHWM") - before);
+    phase.ran         = true;
+    return phase;
+}
+
+std::string phaseJson(const Phase &phase)
+{
+    if (!phase.ran)
+        return "null";
+    char text[160];
+    std::snprintf(text, sizeof(text), "{\"ms\": %.1f, \"peak_mb\": %.1f, \"file_mb\": %.2f}", phase.ms,
+                  static_cast<double>(phase.peakKb) / 1024.0, static_cast<double>(phase.fileBytes) / 1048576.0);
+    return text;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Comparison                                                               */
+/* ------------------------------------------------------------------------- */
+bool sameData(obs_data_t *a, obs_data_t *b);
+
+bool sameItem(obs_data_item_t *x, obs_data_item_t *y)
+{
+    if (obs_data_item_gettype(x) != obs_data_item_gettype(y))
+        return false;
+    switch (obs_data_item_gettype(x)) {
+    case OBS_DATA_STRING:
+        return std::strcmp(obs_data_item_get_string(x), obs_data_item_get_string(y)) == 0;
+    case OBS_DATA_NUMBER:
+        if (obs_data_item_numtype(x) != obs_data_item_numtype(y))
+            return false;
+        return obs_data_item_numtype(x) == OBS_DATA_NUM_DOUBLE
+                   ? obs_data_item_get_double(x) == obs_data_item_get_double(y)
+                   : obs_data_item_get_int(x) == obs_data_item_get_int(y);
+    case OBS_DATA_BOOLEAN:
+        return obs_data_item_get_bool(x) == obs_data_item_get_bool(y);
+    case OBS_DATA_OBJECT: {
+        obs_data_t *ox = obs_data_item_get_obj(x), *oy = obs_data_item_get_obj(y);
+        const bool  same = sameData(ox, oy);
+        obs_data_release(ox);
+        obs_data_release(oy);
+        return same;
+    }
+    case OBS_DATA_ARRAY: {
+        obs_data_array_t *ax = obs_data_item_get_array(x), *ay = obs_data_item_get_array(y);
+        bool same = obs_data_array_count(ax) == obs_data_array_count(ay);
+        for (size_t i = 0; same && i < obs_data_array_count(ax); ++i) {
+            obs_data_t *ex = obs_data_array_item(ax, i), *ey = obs_data_array_item(ay, i);
+            same = sameData(ex, ey);
+            obs_data_release(ex);
+            obs_data_release(ey);
+        }
+        obs_data_array_release(ax);
+        obs_data_array_release(ay);
+        return same;
+    }
+    default:
+        return true;
+    }
+}
+
+bool sameData(obs_data_t *a, obs_data_t *b)
+{
+    if (!a || !b)
+        return a == b;
+    size_t count = 0;
+    for (obs_data_item_t *x = obs_data_first(a); x; obs_data_item_next(&x)) {
+        ++count;
+        obs_data_item_t *y = obs_data_item_byname(b, obs_data_item_get_name(x));
+        const bool same = y && sameItem(x, y);
+        obs_data_item_release(&y);
+        if (!same) {
+            obs_data_item_release(&x);
+            return false;
+        }
+    }
+    for (obs_data_item_t *y = obs_data_first(b); y; obs_data_item_next(&y))
+        --count;
+    return count == 0;
+}
+
+obs_data_t *pinRoot(const OBSConfigHelper &cfg)
+{
+    ConfigReader reader = cfg.reader();
+    obs_data_t  *root   = reader.snapshot()->root;
+    obs_data_addref(root);
+    return root;
+}
+
+uint64_t version(const OBSConfigHelper &cfg)
+{
+    return cfg.reader().version();
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int sections = 40, keys = 2000, assets = 200000;
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "playfame-bench" / "bundle";
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--sections"))
+            sections = std::max(4, std::atoi(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--keys"))
+            keys = std::max(8, std::atoi(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--assets"))
+            assets = std::max(1, std::atoi(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--dir"))
+            dir = argv[i + 1];
+    }
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    ObsStandin::setConfigDir(dir.string().c_str());
+
+    const bool rssSupported = statusKb("VmHWM") >= 0 && resetPeak();
+    const QString domFile = QString::fromUtf8((dir / "dom.json").string().c_str());
+    const auto bundleFile = [&](const char *name) { return QString::fromUtf8((dir / name).string().c_str()); };
+
+    Phase domExport, domImport, domFresh, streamFresh, exports[3], imports[3];
+    static const BundleCompression kCodecs[3] = {BundleCompression::None, BundleCompression::Gzip,
+                                                  BundleCompression::Zstd};
+    static const char *const kFiles[3] = {"bundle.json", "bundle.json.gz", "bundle.json.zst"};
+    bool ok = true;
+    bool roundTrip = false, exactNotify = false, numbersKept = false, filtered = false, progressed = false;
+    bool cancelledExport = false, cancelledImport = false, truncatedRejected = false, skippedCounted = false;
+    bool survivesRestart = false;
+    uint64_t jsonBytes = 0, progressCalls = 0;
+    size_t changed = 0, removed = 0;
+
+    {
+        OBSConfigHelper cfg("playfame_config.json");
+        const std::filesystem::path file = cfg.path().toStdString();
+        std::filesystem::create_directories(file.parent_path());
+        writeConfig(file, sections, keys, assets);
+        cfg.load();
+        ok = ok && cfg.flush(std::chrono::seconds(30));
+
+        /* the path without ConfigBundle: one text buffer (and tree) for the whole file */
+        domExport = measure([&] {
+            obs_data_t *root = pinRoot(cfg);
+            const QByteArray path = domFile.toUtf8();
+            ok = obs_data_save_json_safe(root, path.constData(), ".tmp", ".bak") && ok;
+            obs_data_release(root);
+            return static_cast<uint64_t>(std::filesystem::file_size(path.constData()));
+        });
+        domImport = measure([&] {
+            const QByteArray path = domFile.toUtf8();
+            obs_data_t *data = obs_data_create_from_json_file_safe(path.constData(), ".bak");
+            ok = ok && data && cfg.applySections(data).changed == 0;
+            obs_data_release(data);
+            return static_cast<uint64_t>(std::filesystem::file_size(path.constData()));
+        });
+
+        for (int c = 0; c < 3; ++c) {
+            if (!ConfigBundle::supports(kCodecs[c]))
+                continue;
+            BundleOptions options;
+            options.compression = kCodecs[c];
+            exports[c] = measure([&] {
+                const BundleStats stats = ConfigBundle::exportTo(cfg, bundleFile(kFiles[c]), options);
+                ok = ok && stats.ok;
+                jsonBytes = stats.jsonBytes;
+                return stats.fileBytes;
+            });
+            imports[c] = measure([&] {
+                const BundleStats stats = ConfigBundle::importFrom(cfg, bundleFile(kFiles[c]), options);
+                ok = ok && stats.ok && stats.compression == kCodecs[c] && stats.applied.changed == 0 &&
+                     stats.applied.removed == 0;
+                return stats.fileBytes;
+            });
+        }
+
+        /* worst case: nothing to share, every value is new */
+        const auto fresh = [&](const char *name, const QString &from,
+                               const std::function<bool(OBSConfigHelper &)> &apply) {
+            return measure([&] {
+                OBSConfigHelper empty(name);
+                empty.load();
+                ok = apply(empty) && empty.flush(std::chrono::seconds(30)) && ok;
+                return static_cast<uint64_t>(std::filesystem::file_size(from.toUtf8().constData()));
+            });
+        };
+        domFresh = fresh("fresh_dom.json", domFile, [&](OBSConfigHelper &empty) {
+            const QByteArray path = domFile.toUtf8();
+            obs_data_t *data = obs_data_create_from_json_file_safe(path.constData(), ".bak");
+            const bool applied = data && empty.applySections(data).changed > 0;
+            obs_data_release(data);
+            empty.save();
+            return applied;
+        });
+        streamFresh = fresh("fresh_stream.json", bundleFile(kFiles[0]), [&](OBSConfigHelper &empty) {
+            return ConfigBundle::importFrom(empty, bundleFile(kFiles[0])).applied.changed > 0;
+        });
+
+        /* round trip: edit some keys and add one, import, all back as exported */
+        const int best = ConfigBundle::supports(BundleCompression::Zstd) ? 2 : 0;
+        obs_data_t *original = pinRoot(cfg);
+        std::mutex notifiedMutex;
+        std::set<std::string> notified, expected;
+        for (const char *section : {"section_1", "section_2"})
+            cfg.subscribeSection(QString::fromUtf8(section), nullptr, [&](const std::vector<ConfigChange> &batch) {
+                std::lock_guard<std::mutex> lock(notifiedMutex);
+                for (const ConfigChange &change : batch)
+                    notified.insert(change.key.toStdString());
+            });
+        for (int k = 0; k < 5; ++k) {
+            const std::string key = "key_" + std::to_string(k * 4);
+            cfg.set<const char *>(cfg.key("section_1", key.c_str()), "edited");
+            expected.insert(key);
+        }
+        cfg.set(cfg.key("section_2", "added"), 1);
+        expected.insert("added");
+        {
+            std::lock_guard<std::mutex> lock(notifiedMutex);
+            notified.clear();
+        }
+        BundleOptions progress;
+        progress.progressEveryBytes = 1 << 20;
+        uint64_t lastBytes = 0;
+        progressed = true;
+        progress.progress = [&](const BundleProgress &p) {
+            ++progressCalls;
+            progressed = progressed && p.jsonBytes >= lastBytes && p.fileTotal > 0;
+            lastBytes = p.jsonBytes;
+            return true;
+        };
+        const BundleStats back = ConfigBundle::importFrom(cfg, bundleFile(kFiles[best]), progress);
+        changed = back.applied.changed;
+        removed = back.applied.removed;
+        progressed = progressed && progressCalls > 1 && lastBytes == back.jsonBytes;
+        {
+            obs_data_t *now = pinRoot(cfg);
+            roundTrip = back.ok && changed == 5 && removed == 1 && sameData(original, now);
+            obs_data_t *numbers = obs_data_get_obj(now, "numbers");
+            obs_data_item_t *whole = obs_data_item_byname(numbers, "whole");
+            numbersKept = whole && obs_data_item_numtype(whole) == OBS_DATA_NUM_DOUBLE &&
+                          obs_data_get_int(numbers, "exact") == 9007199254740993LL &&
+                          obs_data_get_double(numbers, "tenth") == 0.1;
+            obs_data_item_release(&whole);
+            obs_data_release(numbers);
+            obs_data_release(now);
+        }
+        {
+            std::lock_guard<std::mutex> lock(notifiedMutex);
+            exactNotify = notified == expected;
+        }
+        obs_data_release(original);
+
+        /* only the named sections */
+        BundleOptions some;
+        some.sections = {QByteArray("numbers"), QByteArray("text")};
+        const BundleStats part = ConfigBundle::exportTo(cfg, bundleFile("part.json"), some);
+        const BundleStats partIn = ConfigBundle::importFrom(cfg, bundleFile(kFiles[0]), some);
+        filtered = part.ok && part.sections == 2 && partIn.ok && partIn.sections == 2;
+
+        /* cancelled export: no file, no temp file */
+        BundleOptions stop;
+        stop.progressEveryBytes = 1 << 20;
+        stop.progress = [](const BundleProgress &p) { return p.jsonBytes < (2u << 20); };
+        const BundleStats halted = ConfigBundle::exportTo(cfg, bundleFile("halted.json"), stop);
+        cancelledExport = !halted.ok && !std::filesystem::exists(dir / "halted.json") &&
+                          !std::filesystem::exists(dir / "halted.json.tmp");
+
+        /* cancelled and truncated imports publish nothing */
+        cfg.set(cfg.key("section_3", "key_0"), "local edit");
+        const uint64_t v = version(cfg);
+        cancelledImport = !ConfigBundle::importFrom(cfg, bundleFile(kFiles[best]), stop).ok && version(cfg) == v;
+        {
+            std::ifstream in(dir / kFiles[best], std::ios::binary);
+            std::string   text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            std::ofstream((dir / "truncated").string(), std::ios::binary).write(text.data(),
+                                                                                static_cast<std::streamsize>(text.size() * 3 / 4));
+        }
+        const BundleStats truncated = ConfigBundle::importFrom(cfg, bundleFile("truncated"));
+        truncatedRejected = !truncated.ok && !truncated.error.isEmpty() && version(cfg) == v;
+
+        /* values obs_data cannot hold */
+        std::ofstream(dir / "odd.json") << "{\"odd\": {\"gone\": null, \"list\": [1, {\"x\": 1}, [2, {\"y\": 2}]], "
+                                           "\"kept\": \"yes\"}, \"top\": 5, \"rows\": [{\"z\": 1}]}";
+        const BundleStats odd = ConfigBundle::importFrom(cfg, bundleFile("odd.json"));
+        obs_data_t *root = pinRoot(cfg);
+        obs_data_t *oddSection = obs_data_get_obj(root, "odd");
+        obs_data_array_t *list = obs_data_get_array(oddSection, "list");
+        skippedCounted = odd.ok && odd.skipped == 5 && odd.sections == 1 && list && obs_data_array_count(list) == 1 &&
+                         std::strcmp(obs_data_get_string(oddSection, "kept"), "yes") == 0;
+        obs_data_array_release(list);
+        obs_data_release(oddSection);
+        obs_data_release(root);
+
+        /* journal mode: the import replaces "numbers", dropping a local key, and must survive a restart */
+        {
+            obs_data_t *before = nullptr;
+            {
+                OBSConfigHelper journaled("journaled.json");
+                journaled.setJournalMode(true, 1 << 20);
+                journaled.load();
+                journaled.set(journaled.key("numbers", "local_only"), 1);
+                journaled.set(journaled.key("kept", "flag"), true);
+                journaled.save();
+                ok = ok && journaled.flush(std::chrono::seconds(30));
+                const BundleStats in = ConfigBundle::importFrom(journaled, bundleFile("part.json"));
+                journaled.save();
+                ok = ok && in.ok && in.applied.removed == 1 && journaled.flush(std::chrono::seconds(30));
+                before = pinRoot(journaled);
+            }
+            OBSConfigHelper restarted("journaled.json");
+            restarted.setJournalMode(true, 1 << 20);
+            restarted.load();
+            obs_data_t *after = pinRoot(restarted);
+            survivesRestart = sameData(before, after);
+            obs_data_release(after);
+            obs_data_release(before);
+        }
+
+        ok = ok && cfg.flush(std::chrono::seconds(30));
+    }
+    std::filesystem::remove_all(dir);
+
+    ok = ok && roundTrip && exactNotify && numbersKept && filtered && progressed && cancelledExport &&
+         cancelledImport && truncatedRejected && skippedCounted && survivesRestart;
+    if (rssSupported)
+        ok = ok && exports[0].peakKb < domExport.peakKb && imports[0].peakKb < domImport.peakKb;
+
+    std::printf("{\"sections\": %d, \"keys\": %d, \"assets\": %d, \"json_mb\": %.1f, \"rss_measured\": %s, "
+                "\"export\": {\"obs_data\": %s, \"stream\": %s, \"stream_gzip\": %s, \"stream_zstd\": %s}, "
+                "\"import\": {\"obs_data\": %s, \"stream\": %s, \"stream_gzip\": %s, \"stream_zstd\": %s}, "
+                "\"import_into_empty\": {\"obs_data\": %s, \"stream\": %s}, "
+                "\"round_trip\": {\"ok\": %s, \"changed\": %zu, \"removed\": %zu, \"exact_notify\": %s, "
+                "\"numbers_kept\": %s}, \"progress_calls\": %llu, \"progress_ok\": %s, \"section_filter\": %s, "
+                "\"cancelled_export_clean\": %s, \"cancelled_import_clean\": %s, \"truncated_rejected\": %s, "
+                "\"skipped_counted\": %s, \"import_survives_restart\": %s, \"ok\": %s}\n",
+                sections, keys, assets, static_cast<double>(jsonBytes) / 1048576.0, rssSupported ? "true" : "false",
+                phaseJson(domExport).c_str(), phaseJson(exports[0]).c_str(), phaseJson(exports[1]).c_str(),
+                phaseJson(exports[2]).c_str(), phaseJson(domImport).c_str(), phaseJson(imports[0]).c_str(),
+                phaseJson(imports[1]).c_str(), phaseJson(imports[2]).c_str(), phaseJson(domFresh).c_str(),
+                phaseJson(streamFresh).c_str(), roundTrip ? "true" : "false", changed,
+                removed, exactNotify ? "true" : "false", numbersKept ? "true" : "false",
+                static_cast<unsigned long long>(progressCalls), progressed ? "true" : "false",
+                filtered ? "true" : "false", cancelledExport ? "true" : "false", cancelledImport ? "true" : "false",
+                truncatedRejected ? "true" : "false", skippedCounted ? "true" : "false",
+                survivesRestart ? "true" : "false", ok ? "true" : "false");
+    return ok ? 0 : 1;
+}
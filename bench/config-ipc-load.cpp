@@ -0,0 +1,493 @@
+/*!
+ * @file config-ipc-load.cpp
+ * @brief Load generator for the config IPC endpoint: requests/sec and latency.
+ *
+ * Opens --connections connections and keeps --depth requests in flight on
+ * each for --seconds. A request is --batch ops on the "ipc_load" section:
+ * all gets, or, for --write-ratio percent of them, one set followed by
+ * gets that include the key just set, which must read back the new value.
+ * Reports requests and ops per second and the client-side latency of a
+ * request (written to answered) at p50, p99 and max.
+ *
+ * Without --path the endpoint is served in process, over a config on the
+ * obs-standin, and afterwards the tool checks that:
+ * - a request's gets see its own sets, and the version moves on
+ * - a set outside the schema range, or of the wrong type, rejects the whole
+ *   request: failed op reported, the other sets not applied
+ * - an unknown op or trailing bytes answer Malformed and the connection
+ *   keeps working; an oversized frame answers TooLarge and closes it
+ * - connections over the limit are closed at once
+ * - the server counted every request the clients sent
+ *
+ * With --path it drives a running OBS instead (PLAYFAME_IPC_PATH, or
+ * ipc.enabled); it writes only to the "ipc_load" section there.
+ *
+ * Usage: config-ipc-load [--path PATH] [--connections N] [--depth N] [--seconds N]
+ *                        [--batch N] [--write-ratio PERCENT] [--dir PATH]
+ * Prints one JSON object to stdout.
+ */
+
+#include "config-ipc.h"
+#include "obs-config-helper.h"
+#include "obs-standin.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using namespace ConfigIpc;
+
+constexpr const char *kSection = "ipc_load";
+
+struct OpSpec {
+    Op          op;
+    std::string section;
+    std::string key;
+    Value       value;
+};
+
+void encode(std::vector<uint8_t> &out, uint32_t id, const std::vector<OpSpec> &ops)
+{
+    Writer       w(out);
+    const size_t at = w.beginFrame();
+    w.u32(id);
+    w.u16(static_cast<uint16_t>(ops.size()));
+    for (const OpSpec &op : ops) {
+        w.u8(static_cast<uint8_t>(op.op));
+        w.str16(op.section);
+        w.str16(op.key);
+        if (op.op == Op::Set)
+            w.value(op.value);
+    }
+    w.endFrame(at);
+}
+
+struct Response {
+    uint32_t           id       = 0;
+    Status             status   = Status::Malformed;
+    uint16_t           failedOp = 0;
+    uint64_t           version  = 0;
+    std::vector<Value> values;   ///< Strings view into the client's frame buffer.
+};
+
+bool decode(const std::vector<uint8_t> &frame, Response &r)
+{
+    Reader in(frame.data(), frame.size());
+    r.id       = in.u32();
+    r.status   = static_cast<Status>(in.u8());
+    r.failedOp = in.u16();
+    r.version  = in.u64();
+    const uint16_t count = in.u16();
+    r.values.clear();
+    for (uint16_t i = 0; i < count && in.ok(); ++i)
+        r.values.push_back(in.value());
+    return in.ok() && in.atEnd();
+}
+
+/* blocking client: writes whole buffers, reads whole frames */
+class Client {
+public:
+    ~Client()
+    {
+        if (fd_ >= 0)
+            ::close(fd_);
+    }
+
+    bool open(const std::string &path)
+    {
+        fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, path.c_str(), sizeof addr.sun_path - 1);
+        return fd_ >= 0 && ::connect(fd_, reinterpret_cast<const sockaddr *>(&addr), sizeof addr) == 0;
+    }
+
+    bool send(const std::vector<uint8_t> &bytes)
+    {
+        size_t done = 0;
+        while (done < bytes.size()) {
+            const ssize_t n = ::send(fd_, bytes.data() + done, bytes.size() - done, MSG_NOSIGNAL);
+            if (n <= 0)
+                return false;
+            done += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    /// Next frame's payload; false on EOF or error.
+    bool next(std::vector<uint8_t> &frame)
+    {
+        for (;;) {
+            const size_t have = in_.size() - pos_;
+            if (have >= kHeaderBytes) {
+                const uint32_t size = frameLength(in_.data() + pos_);
+                if (have >= kHeaderBytes + size) {
+                    frame.assign(in_.begin() + static_cast<std::ptrdiff_t>(pos_ + kHeaderBytes),
+                                 in_.begin() + static_cast<std::ptrdiff_t>(pos_ + kHeaderBytes + size));
+                    pos_ += kHeaderBytes + size;
+                    return true;
+                }
+            }
+            if (pos_ == in_.size()) {
+                in_.clear();
+                pos_ = 0;
+            }
+            const size_t old = in_.size();
+            in_.resize(old + 64 * 1024);
+            const ssize_t n = ::recv(fd_, in_.data() + old, 64 * 1024, 0);
+            in_.resize(old + static_cast<size_t>(std::max<ssize_t>(n, 0)));
+            if (n <= 0)
+                return false;
+        }
+    }
+
+    /// True once every byte received so far has been consumed as frames.
+    bool drained() const { return pos_ == in_.size(); }
+
+private:
+    int                  fd_ = -1;
+    std::vector<uint8_t> in_;
+    size_t               pos_ = 0;
+};
+
+/* one round trip; false if the connection failed */
+bool call(Client &client, uint32_t id, const std::vector<OpSpec> &ops, std::vector<uint8_t> &frame, Response &r)
+{
+    std::vector<uint8_t> out;
+    encode(out, id, ops);
+    return client.send(out) && client.next(frame) && decode(frame, r) && r.id == id;
+}
+
+Value intValue(int64_t v)
+{
+    Value value;
+    value.tag = ValueTag::Int;
+    value.i   = v;
+    return value;
+}
+
+Value stringValue(std::string_view s)
+{
+    Value value;
+    value.tag = ValueTag::String;
+    value.s   = s;
+    return value;
+}
+
+struct ConnectionResult {
+    uint64_t              requests = 0;
+    uint64_t              ops      = 0;
+    uint64_t              errors   = 0;
+    std::vector<uint64_t> latencyNs;
+};
+
+void drive(const std::string &path, int conn, int depth, int batch, int writeRatio, Clock::time_point deadline,
+           ConnectionResult &result)
+{
+    Client client;
+    if (!client.open(path)) {
+        result.errors = 1;
+        return;
+    }
+
+    /* set key j of this connection, then get every key: the get of j reads it back */
+    std::vector<OpSpec> reads, writes;
+    for (int j = 0; j < batch; ++j)
+        reads.push_back({Op::Get, kSection, "c" + std::to_string(conn) + "_k" + std::to_string(j), Value()});
+    writes.push_back({Op::Set, kSection, std::string(), Value()});
+    writes.insert(writes.end(), reads.begin(), reads.end() - 1);
+
+    std::vector<Clock::time_point> sentAt(static_cast<size_t>(depth));
+    std::vector<int>               setKey(static_cast<size_t>(depth), -1);
+    std::vector<uint8_t>           out, frame;
+    Response                       r;
+    uint32_t                       nextId   = 0;
+    int                            inFlight = 0;
+    result.latencyNs.reserve(1 << 20);
+
+    const auto queue = [&] {
+        const uint32_t id   = nextId++;
+        const size_t   slot = id % static_cast<uint32_t>(depth);
+        if (static_cast<int>(id % 100) < writeRatio) {
+            const int j      = static_cast<int>(id % static_cast<uint32_t>(batch - 1));
+            writes[0].key    = reads[static_cast<size_t>(j)].key;
+            writes[0].value  = intValue(id);
+            setKey[slot]     = j;
+            encode(out, id, writes);
+        } else {
+            setKey[slot] = -1;
+            encode(out, id, reads);
+        }
+        sentAt[slot] = Clock::now();
+        ++inFlight;
+    };
+
+    for (int i = 0; i < depth; ++i)
+        queue();
+    while (inFlight > 0) {
+        if (!out.empty()) {
+            if (!client.send(out)) {
+                ++result.errors;
+                return;
+            }
+            out.clear();
+        }
+        /* answer everything that arrived in one read before writing again */
+        do {
+            if (!client.next(frame) || !decode(frame, r)) {
+                ++result.errors;
+                return;
+            }
+            const size_t slot = r.id % static_cast<uint32_t>(depth);
+            result.latencyNs.push_back(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - sentAt[slot]).count()));
+            ++result.requests;
+            result.ops += static_cast<uint64_t>(batch);
+            --inFlight;
+
+            bool good = r.status == Status::Ok && r.values.size() == static_cast<size_t>(setKey[slot] >= 0 ? batch - 1 : batch);
+            if (good && setKey[slot] >= 0) {
+                const Value &v = r.values[static_cast<size_t>(setKey[slot])];
+                good = v.tag == ValueTag::Int && v.i == static_cast<int64_t>(r.id);
+            }
+            result.errors += good ? 0 : 1;
+
+            if (Clock::now() < deadline)
+                queue();
+        } while (!client.drained());
+    }
+}
+
+uint64_t percentile(const std::vector<uint64_t> &sorted, double q)
+{
+    if (sorted.empty())
+        return 0;
+    return sorted[std::min(sorted.size() - 1, static_cast<size_t>(q * static_cast<double>(sorted.size())))];
+}
+
+const char *yes(bool b)
+{
+    return b ? "true" : "false";
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::string           path;
+    int                   connections = 4, depth = 16, seconds = 5, batch = 8, writeRatio = 10;
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "playfame-bench" / "ipc";
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--path"))
+            path = argv[i + 1];
+        else if (!std::strcmp(argv[i], "--connections"))
+            connections = std::clamp(std::atoi(argv[i + 1]), 1, 32);
+        else if (!std::strcmp(argv[i], "--depth"))
+            depth = std::clamp(std::atoi(argv[i + 1]), 1, 4096);
+        else if (!std::strcmp(argv[i], "--seconds"))
+            seconds = std::max(1, std::atoi(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--batch"))
+            batch = std::clamp(std::atoi(argv[i + 1]), 2, 1024);
+        else if (!std::strcmp(argv[i], "--write-ratio"))
+            writeRatio = std::clamp(std::atoi(argv[i + 1]), 0, 100);
+        else if (!std::strcmp(argv[i], "--dir"))
+            dir = argv[i + 1];
+    }
+    const bool external = !path.empty();
+
+    std::unique_ptr<OBSConfigHelper> cfg;
+    std::unique_ptr<ConfigIpcServer> server;
+    if (!external) {
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        ObsStandin::setConfigDir(dir.string().c_str());
+        cfg = std::make_unique<OBSConfigHelper>("playfame_config.json");
+        const std::filesystem::path file = cfg->path().toStdString();
+        std::filesystem::create_directories(file.parent_path());
+        std::ofstream(file) << "{\"ipc_load\": {}, \"general\": {}}";
+        cfg->load();
+
+        ConfigIpcOptions options;
+        options.path       = QByteArray((dir / "ipc.sock").string().c_str());
+        options.maxClients = static_cast<size_t>(connections) + 1;
+        server             = std::make_unique<ConfigIpcServer>(cfg.get(), options);
+        if (!server->start()) {
+            std::printf("{\"error\": \"cannot start the endpoint\", \"ok\": false}\n");
+            return 1;
+        }
+        path = server->path().constData();
+    }
+
+    /* --- load ---------------------------------------------------------- */
+    std::vector<ConnectionResult> results(static_cast<size_t>(connections));
+    std::vector<std::thread>      threads;
+    const Clock::time_point       started  = Clock::now();
+    const Clock::time_point       deadline = started + std::chrono::seconds(seconds);
+    for (int c = 0; c < connections; ++c)
+        threads.emplace_back(drive, path, c, depth, batch, writeRatio, deadline, std::ref(results[static_cast<size_t>(c)]));
+    for (std::thread &t : threads)
+        t.join();
+    const double elapsed = std::chrono::duration<double>(Clock::now() - started).count();
+
+    uint64_t              requests = 0, ops = 0, errors = 0;
+    std::vector<uint64_t> latency;
+    for (ConnectionResult &r : results) {
+        requests += r.requests;
+        ops += r.ops;
+        errors += r.errors;
+        latency.insert(latency.end(), r.latencyNs.begin(), r.latencyNs.end());
+    }
+    std::sort(latency.begin(), latency.end());
+
+    /* --- checks (in process) ------------------------------------------- */
+    bool readYourWrites = false, atomicReject = false, malformed = false, tooLarge = false, limited = false;
+    bool counted = false;
+    ConfigIpcStats stats;
+    if (!external) {
+        Client               client;
+        std::vector<uint8_t> frame;
+        Response             r;
+        uint64_t             sent = requests;
+        client.open(path);
+
+        /* gets see the request's own sets */
+        const uint64_t before = cfg->reader().version();
+        readYourWrites = call(client, 1, {{Op::Set, "bench", "a", intValue(41)},
+                                          {Op::Set, "bench", "s", stringValue("x\xc3\xa9")},
+                                          {Op::Get, "bench", "a", Value()},
+                                          {Op::Get, "bench", "s", Value()},
+                                          {Op::Get, "bench", "missing", Value()},
+                                          {Op::Get, "nowhere", "a", Value()}},
+                              frame, r) &&
+                         r.status == Status::Ok && r.version > before && r.values.size() == 4 &&
+                         r.values[0].tag == ValueTag::Int && r.values[0].i == 41 &&
+                         r.values[1].tag == ValueTag::String && r.values[1].s == "x\xc3\xa9" &&
+                         r.values[2].tag == ValueTag::Missing && r.values[3].tag == ValueTag::Missing &&
+                         cfg->get<long long>(cfg->key("bench", "a")) == 41;
+        sent += 1;
+
+        /* out of range, then wrong type: nothing applied either time */
+        const uint64_t held = cfg->reader().version();
+        atomicReject = call(client, 2, {{Op::Set, "bench", "a", intValue(7)},
+                                        {Op::Set, "ipc", "max_clients", intValue(100)},
+                                        {Op::Get, "bench", "a", Value()}},
+                            frame, r) &&
+                       r.status == Status::Rejected && r.failedOp == 1;
+        atomicReject = atomicReject &&
+                       call(client, 3, {{Op::Set, "bench", "a", intValue(8)}, {Op::Set, "ipc", "enabled", intValue(1)}},
+                            frame, r) &&
+                       r.status == Status::Rejected && r.failedOp == 1 &&
+                       cfg->get<long long>(cfg->key("bench", "a")) == 41 && cfg->reader().version() == held;
+        sent += 2;
+
+        /* unknown op, trailing bytes: answered, and the connection lives on */
+        std::vector<uint8_t> bad;
+        {
+            Writer       w(bad);
+            const size_t at = w.beginFrame();
+            w.u32(4);
+            w.u16(1);
+            w.u8(9);
+            w.str16("bench");
+            w.str16("a");
+            w.endFrame(at);
+        }
+        encode(bad, 5, {{Op::Get, "bench", "a", Value()}});
+        {
+            std::vector<uint8_t> trailing;
+            encode(trailing, 6, {{Op::Get, "bench", "a", Value()}});
+            trailing.push_back(0xAB);
+            trailing[0] += 1;   /* the length covers the extra byte */
+            bad.insert(bad.end(), trailing.begin(), trailing.end());
+        }
+        malformed = client.send(bad);
+        malformed = malformed && client.next(frame) && decode(frame, r) && r.id == 4 &&
+                    r.status == Status::Malformed && r.failedOp == 0;
+        malformed = malformed && client.next(frame) && decode(frame, r) && r.id == 5 && r.status == Status::Ok &&
+                    r.values.size() == 1 && r.values[0].i == 41;
+        malformed = malformed && client.next(frame) && decode(frame, r) && r.id == 6 &&
+                    r.status == Status::Malformed;
+        sent += 3;
+
+        /* oversized frame: TooLarge, then EOF */
+        {
+            Client big;
+            big.open(path);
+            std::vector<uint8_t> header(kHeaderBytes);
+            const uint32_t       n = kMaxFrameBytes + 1;
+            for (size_t k = 0; k < kHeaderBytes; ++k)
+                header[k] = static_cast<uint8_t>(n >> (8 * k));
+            tooLarge = big.send(header) && big.next(frame) && decode(frame, r) && r.status == Status::TooLarge &&
+                       !big.next(frame);
+        }
+
+        /* over the limit: exactly one of limit + 1 idle connections is closed */
+        {
+            const size_t                         limit = static_cast<size_t>(connections) + 1;
+            std::vector<std::unique_ptr<Client>> idle;
+            for (size_t i = 0; i + 1 < limit; ++i) {   /* `client` holds one slot */
+                idle.push_back(std::make_unique<Client>());
+                idle.back()->open(path);
+            }
+            idle.push_back(std::make_unique<Client>());
+            idle.back()->open(path);
+            size_t answered = 0, closed = 0;
+            for (size_t i = 0; i < idle.size(); ++i) {
+                if (call(*idle[i], 100 + static_cast<uint32_t>(i), {{Op::Get, "bench", "a", Value()}}, frame, r)) {
+                    ++answered;
+                    ++sent;
+                } else {
+                    ++closed;
+                }
+            }
+            limited = answered == limit - 1 && closed == 1;
+        }
+
+        stats   = server->stats();
+        counted = stats.requests == sent && stats.refused == 1 && stats.malformed == 3 && stats.rejected == 2;
+        server->stop();
+        cfg->flush(std::chrono::seconds(10));
+        server.reset();
+        cfg.reset();
+        std::filesystem::remove_all(dir);
+    }
+
+    const bool ok = errors == 0 && requests > 0 &&
+                    (external || (readYourWrites && atomicReject && malformed && tooLarge && limited && counted));
+
+    std::printf("{\"mode\": \"%s\", \"connections\": %d, \"depth\": %d, \"batch\": %d, \"write_ratio\": %d, "
+                "\"seconds\": %.2f, \"requests\": %llu, \"requests_per_sec\": %.0f, \"ops_per_sec\": %.0f, "
+                "\"latency_us\": {\"p50\": %.1f, \"p99\": %.1f, \"max\": %.1f}, \"errors\": %llu, "
+                "\"server\": {\"request_p50_us\": %llu, \"request_p99_us\": %llu, \"commits\": %llu, "
+                "\"bytes_in\": %llu, \"bytes_out\": %llu}, \"read_your_writes\": %s, \"atomic_reject\": %s, "
+                "\"malformed_answered\": %s, \"too_large_closed\": %s, \"client_limit\": %s, \"counted\": %s, "
+                "\"ok\": %s}\n",
+                external ? "external" : "in_process", connections, depth, batch, writeRatio, elapsed,
+                static_cast<unsigned long long>(requests), static_cast<double>(requests) / elapsed,
+                static_cast<double>(ops) / elapsed, static_cast<double>(percentile(latency, 0.50)) / 1000.0,
+                static_cast<double>(percentile(latency, 0.99)) / 1000.0,
+                latency.empty() ? 0.0 : static_cast<double>(latency.back()) / 1000.0,
+                static_cast<unsigned long long>(errors), static_cast<unsigned long long>(stats.requestP50Us),
+                static_cast<unsigned long long>(stats.requestP99Us), static_cast<unsigned long long>(stats.commits),
+                static_cast<unsigned long long>(stats.bytesIn), static_cast<unsigned long long>(stats.bytesOut),
+                yes(readYourWrites), yes(atomicReject), yes(malformed), yes(tooLarge), yes(limited), yes(counted),
+                yes(ok));
+    return ok ? 0 : 1;
+}
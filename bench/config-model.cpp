@@ -0,0 +1,328 @@
+/*!
+ * @file config-model.cpp
+ * @brief Settings editor cost against config size: open, scroll, search and edit.
+ *
+ * For each size (1k keys, ten times more, ... up to --max-keys) writes a
+ * config with --sections sections holding that many keys in total (strings,
+ * integers, doubles and booleans), loads it and replays what the settings
+ * dialog does, calling the model as a QTreeView would:
+ * - open:   ConfigModel construction, the first fetch of sections and of one
+ *           section's keys, and data() for one screen (--page rows)
+ * - eager:  reading every value up front, as a dialog with one widget per key
+ *           has to (a lower bound: no widgets are created here)
+ * - scroll: one fetchMore() batch plus data() for its rows
+ * - search: a ConfigSearch full scan, then refinements as the query grows
+ * Then checks that opening does not grow with the size, that search finds
+ * exactly the expected keys, that a burst of keystrokes yields one result,
+ * and that an edit is range-checked and committed through stage().
+ *
+ * Usage: config-model [--max-keys N] [--sections N] [--page N] [--dir PATH]
+ * Prints one JSON object to stdout.
+ */
+
+#include "config-model.h"
+#include "config-search.h"
+#include "config-transaction.h"
+#include "obs-config-helper.h"
+#include "obs-standin.h"
+
+#include <QString>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double usSince(Clock::time_point t0)
+{
+    return std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+}
+
+double median(std::vector<double> v)
+{
+    std::sort(v.begin(), v.end());
+    return v.empty() ? 0 : v[v.size() / 2];
+}
+
+/* key i lives in section i % sections; its type cycles string, int, double, bool */
+void writeConfig(const std::filesystem::path &file, size_t keys, int sections)
+{
+    std::ofstream out(file);
+    out << "{\"demo\": {\"text\": \"hello\", \"number\": 7, \"option\": 2}";
+    for (int s = 0; s < sections; ++s) {
+        out << ", \"overrides_" << s << "\": {";
+        bool first = true;
+        for (size_t i = static_cast<size_t>(s); i < keys; i += static_cast<size_t>(sections)) {
+            out << (first ? "" : ", ") << "\"key_" << i << "\": ";
+            first = false;
+            switch (i % 4) {
+            case 0: out << "\"value " << i << "\""; break;
+            case 1: out << i; break;
+            case 2: out << i << ".5"; break;
+            default: out << (i % 8 == 3 ? "true" : "false"); break;
+            }
+        }
+        out << "}";
+    }
+    out << "}";
+}
+
+/* what the search must find for a query that only key names can contain */
+size_t expectedMatches(size_t keys, const std::string &query)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < keys; ++i)
+        n += ("key_" + std::to_string(i)).find(query) != std::string::npos ? 1 : 0;
+    return n;
+}
+
+/* one screen of a tree view: both columns of each row */
+void readPage(ConfigModel &model, const QModelIndex &parent, int first, int rows)
+{
+    const int last = std::min(first + rows, model.rowCount(parent));
+    for (int r = first; r < last; ++r) {
+        (void)model.data(model.index(r, ConfigModel::KeyColumn, parent));
+        (void)model.data(model.index(r, ConfigModel::ValueColumn, parent));
+    }
+}
+
+struct SearchWaiter {
+    std::mutex                      mutex;
+    std::condition_variable         cv;
+    std::vector<ConfigSearchResult> results;
+
+    ConfigSearchResult next(size_t index)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return results.size() > index; });
+        return results[index];
+    }
+};
+
+struct SizeResult {
+    size_t keys = 0;
+    double loadMs = 0, openUs = 0, eagerUs = 0, scrollUs = 0;
+    double scanUs = 0, refineUs = 0, refine2Us = 0;
+    size_t matches = 0, refineMatches = 0, refine2Matches = 0, scanned = 0, refineScanned = 0;
+    bool   correct = false, incremental = false;
+};
+
+SizeResult runSize(const std::filesystem::path &dir, size_t keys, int sections, int page)
+{
+    SizeResult r;
+    r.keys = keys;
+    const char *file = "model.json";
+    writeConfig(dir / file, keys, sections);
+
+    OBSConfigHelper cfg(file);
+    auto t0 = Clock::now();
+    cfg.load();
+    r.loadMs = usSince(t0) / 1000.0;
+
+    /* open: what the dialog constructor and the first paint cost */
+    std::vector<double> opens;
+    for (int rep = 0; rep < 15; ++rep) {
+        t0 = Clock::now();
+        ConfigModel model(&cfg);
+        if (model.canFetchMore(QModelIndex()))
+            model.fetchMore(QModelIndex());
+        readPage(model, QModelIndex(), 0, page);
+        const QModelIndex first = model.index(1, ConfigModel::KeyColumn);   /* overrides_0 */
+        if (model.canFetchMore(first))
+            model.fetchMore(first);
+        readPage(model, first, 0, page);
+        opens.push_back(usSince(t0));
+    }
+    r.openUs = median(opens);
+
+    /* eager: every value read once, the floor of a widget-per-key dialog */
+    t0 = Clock::now();
+    {
+        std::vector<QVariant> values;
+        ConfigReader reader = cfg.reader();
+        obs_data_t *root = reader.snapshot()->root;
+        for (obs_data_item_t *s = obs_data_first(root); s; obs_data_item_next(&s)) {
+            obs_data_t *obj = obs_data_item_get_obj(s);
+            for (obs_data_item_t *k = obs_data_first(obj); k; obs_data_item_next(&k)) {
+                switch (obs_data_item_gettype(k)) {
+                case OBS_DATA_STRING: values.emplace_back(QString::fromUtf8(obs_data_item_get_string(k))); break;
+                case OBS_DATA_NUMBER: values.emplace_back(static_cast<qlonglong>(obs_data_item_get_int(k))); break;
+                default:              values.emplace_back(obs_data_item_get_bool(k)); break;
+                }
+            }
+            obs_data_release(obj);
+        }
+    }
+    r.eagerUs = usSince(t0);
+
+    /* scroll: every batch of one section */
+    {
+        ConfigModel model(&cfg);
+        model.fetchMore(QModelIndex());
+        const QModelIndex first = model.index(1, ConfigModel::KeyColumn);
+        std::vector<double> batches;
+        while (model.canFetchMore(first)) {
+            const int from = model.rowCount(first);
+            t0 = Clock::now();
+            model.fetchMore(first);
+            readPage(model, first, from, ConfigModel::kFetchBatch);
+            batches.push_back(usSince(t0));
+        }
+        r.scrollUs = median(batches);
+    }
+
+    /* search: a scan, then two refinements as the query grows */
+    SearchWaiter waiter;
+    {
+        ConfigSearch search(&cfg, nullptr, [&](const ConfigSearchResult &result) {
+            std::lock_guard<std::mutex> lock(waiter.mutex);
+            waiter.results.push_back(result);
+            waiter.cv.notify_all();
+        }, std::chrono::milliseconds(0));
+
+        search.search(QString("key_1"));
+        const ConfigSearchResult scan = waiter.next(0);
+        search.search(QString("KEY_12"));   /* case-insensitive */
+        const ConfigSearchResult refine = waiter.next(1);
+        search.search(QString("key_123"));
+        const ConfigSearchResult refine2 = waiter.next(2);
+
+        r.scanUs         = static_cast<double>(scan.durationUs);
+        r.refineUs       = static_cast<double>(refine.durationUs);
+        r.refine2Us      = static_cast<double>(refine2.durationUs);
+        r.matches        = scan.matches;
+        r.refineMatches  = refine.matches;
+        r.refine2Matches = refine2.matches;
+        r.scanned        = scan.scanned;
+        r.refineScanned  = refine.scanned;
+        r.incremental    = !scan.incremental && refine.incremental && refine2.incremental;
+        r.correct = scan.matches == expectedMatches(keys, "key_1") &&
+                    refine.matches == expectedMatches(keys, "key_12") &&
+                    refine2.matches == expectedMatches(keys, "key_123");
+
+        /* the filtered model shows exactly the matches */
+        ConfigModel model(&cfg);
+        model.setFilter(refine2);
+        size_t shown = 0;
+        for (int s = 0; s < model.rowCount(); ++s) {
+            const QModelIndex section = model.index(s, ConfigModel::KeyColumn);
+            while (model.canFetchMore(section))
+                model.fetchMore(section);
+            shown += static_cast<size_t>(model.rowCount(section));
+        }
+        r.correct = r.correct && shown == refine2.matches;
+    }
+    return r;
+}
+
+/* a burst of keystrokes inside the debounce window yields one scan */
+bool checkDebounce(OBSConfigHelper &cfg)
+{
+    SearchWaiter waiter;
+    ConfigSearch search(&cfg, nullptr, [&](const ConfigSearchResult &result) {
+        std::lock_guard<std::mutex> lock(waiter.mutex);
+        waiter.results.push_back(result);
+        waiter.cv.notify_all();
+    }, std::chrono::milliseconds(100));
+    for (const char *query : {"k", "ke", "key", "key_", "key_7"}) {
+        search.search(QString(query));
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    const ConfigSearchResult result = waiter.next(0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    std::lock_guard<std::mutex> lock(waiter.mutex);
+    return waiter.results.size() == 1 && result.query == QString("key_7");
+}
+
+/* range check on setData(), commit through stage() */
+bool checkEdit(OBSConfigHelper &cfg)
+{
+    ConfigModel model(&cfg);
+    model.fetchMore(QModelIndex());
+    const QModelIndex demo = model.index(0, ConfigModel::KeyColumn);
+    while (model.canFetchMore(demo))
+        model.fetchMore(demo);
+    QModelIndex number;
+    for (int r = 0; r < model.rowCount(demo); ++r)
+        if (model.data(model.index(r, ConfigModel::KeyColumn, demo)).toString() == QString("number"))
+            number = model.index(r, ConfigModel::ValueColumn, demo);
+    if (!number.isValid())
+        return false;
+
+    const bool rejected = !model.setData(number, QVariant(static_cast<qlonglong>(10000)));   /* max 9999 */
+    const bool accepted = model.setData(number, QVariant(static_cast<qlonglong>(42)));
+    const bool staged   = model.data(number, ConfigModel::StagedRole).toBool() &&
+                          cfg.get(ConfigSchema::kDemoNumber) == 7;
+    ConfigTransaction tx = cfg.begin();
+    model.stage(tx);
+    const bool committed = tx.commit(false);
+    model.discardEdits();
+    return rejected && accepted && staged && committed && cfg.get(ConfigSchema::kDemoNumber) == 42 &&
+           !model.hasStagedEdits();
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    size_t maxKeys = 1000000;
+    int    sections = 8, page = 40;
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "playfame-bench" / "model";
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--max-keys"))
+            maxKeys = std::max<size_t>(1000, std::strtoull(argv[i + 1], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--sections"))
+            sections = std::max(1, std::atoi(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--page"))
+            page = std::max(1, std::atoi(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--dir"))
+            dir = argv[i + 1];
+    }
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    ObsStandin::setConfigDir(dir.string().c_str());
+
+    std::vector<SizeResult> results;
+    for (size_t keys = 1000; keys <= maxKeys; keys *= 10)
+        results.push_back(runSize(dir, keys, sections, page));
+
+    OBSConfigHelper small("model.json");
+    writeConfig(dir / "model.json", 1000, sections);
+    small.load();
+    const bool debounced = checkDebounce(small);
+    const bool edited    = checkEdit(small);
+    std::filesystem::remove_all(dir);
+
+    /* opening may not grow with the config; allow noise, not a factor of the size */
+    bool ok = debounced && edited;
+    for (const SizeResult &r : results)
+        ok = ok && r.correct && r.incremental && r.openUs < results.front().openUs * 4 + 50;
+
+    std::printf("{\"sections\": %d, \"page\": %d, \"sizes\": [", sections, page);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const SizeResult &r = results[i];
+        std::printf("%s\n  {\"keys\": %zu, \"load_ms\": %.1f, \"open_us\": %.1f, \"eager_us\": %.1f, "
+                    "\"scroll_batch_us\": %.1f, \"search\": {\"scan_us\": %.0f, \"scanned\": %zu, \"matches\": %zu, "
+                    "\"refine_us\": %.0f, \"refine_scanned\": %zu, \"refine_matches\": %zu, \"refine2_us\": %.0f, "
+                    "\"refine2_matches\": %zu, \"incremental\": %s, \"correct\": %s}}",
+                    i ? "," : "", r.keys, r.loadMs, r.openUs, r.eagerUs, r.scrollUs, r.scanUs, r.scanned, r.matches,
+                    r.refineUs, r.refineScanned, r.refineMatches, r.refine2Us, r.refine2Matches,
+                    r.incremental ? "true" : "false", r.correct ? "true" : "false");
+    }
+    std::printf("],\n \"debounce_coalesced\": %s, \"edit_checked\": %s, \"ok\": %s}\n", debounced ? "true" : "false",
+                edited ? "true" : "false", ok ? "true" : "false");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,279 @@
+/*!
+ * @file config-reload.cpp
+ * @brief Cost of picking up an external edit: structural reload vs. full load().
+ *
+ * Writes a config of --sections sections with --keys keys each and loads
+ * it. Each of --rounds rounds then rewrites the file the way deployment
+ * tooling does (temp file + rename), changing --changes keys in one
+ * section and, every other round, removing one key, and fires a burst of
+ * five change events at a ConfigReloader, as a watcher would. Reports the
+ * reload's parse, diff and apply times next to a full load() of the same
+ * file, and checks that:
+ * - each burst costs exactly one reload
+ * - subscribers hear exactly the changed and removed keys
+ * - untouched sections are still the very same objects afterwards
+ * - the helper's own save is recognised and not reloaded
+ * - a corrupt file falls back to the .bak copy
+ *
+ * Usage: config-reload [--sections N] [--keys N] [--changes N] [--rounds N] [--debounce-ms N] [--dir PATH]
+ * Prints one JSON object to stdout.
+ */
+
+#include "config-reload.h"
+#include "obs-config-helper.h"
+#include "obs-standin.h"
+
+#include <QString>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double median(std::vector<double> v)
+{
+    if (v.empty())
+        return 0;
+    std::sort(v.begin(), v.end());
+    return v[v.size() / 2];
+}
+
+std::string sectionName(int s)
+{
+    return "section_" + std::to_string(s);
+}
+
+/* revision[s][k] < 0 means the key is absent */
+void writeConfig(const std::filesystem::path &file, const std::vector<std::vector<int>> &revision)
+{
+    const std::filesystem::path tmp = file.string() + ".deploy";
+    {
+        std::ofstream out(tmp);
+        out << "{\"demo\": {\"text\": \"deployed\", \"number\": 7}";
+        for (size_t s = 0; s < revision.size(); ++s) {
+            out << ", \"" << sectionName(static_cast<int>(s)) << "\": {";
+            bool first = true;
+            for (size_t k = 0; k < revision[s].size(); ++k) {
+                if (revision[s][k] < 0)
+                    continue;
+                out << (first ? "" : ", ") << "\"key_" << k << "\": \"value " << revision[s][k] << '/' << k
+                    << " lorem ipsum\"";
+                first = false;
+            }
+            out << '}';
+        }
+        out << '}';
+    }
+    std::filesystem::rename(tmp, file);
+}
+
+/* waits until the worker has dealt with the pending burst */
+bool settle(const ConfigReloader &reloader, uint64_t handledBefore)
+{
+    const auto deadline = Clock::now() + std::chrono::seconds(10);
+    while (Clock::now() < deadline) {
+        const ConfigReloaderStats s = reloader.stats();
+        if (s.reloads + s.ownWrites + s.unchanged > handledBefore)
+            return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+uint64_t handled(const ConfigReloader &reloader)
+{
+    const ConfigReloaderStats s = reloader.stats();
+    return s.reloads + s.ownWrites + s.unchanged;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int sections = 20, keys = 5000, changes = 10, rounds = 20, debounceMs = 50;
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "playfame-bench" / "reload";
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--sections"))
+            sections = std::max(2, std::atoi(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--keys"))
+            keys = std::max(2, std::atoi(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--changes"))
+            changes = std::max(1, std::atoi(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--rounds"))
+            rounds = std::max(2, std::atoi(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--debounce-ms"))
+            debounceMs = std::max(1, std::atoi(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--dir"))
+            dir = argv[i + 1];
+    }
+    changes = std::min(changes, keys - 1);
+    std::filesystem::remove_all(dir);
+    ObsStandin::setConfigDir(dir.string().c_str());
+
+    std::vector<std::vector<int>> revision(static_cast<size_t>(sections), std::vector<int>(static_cast<size_t>(keys), 0));
+    bool ok = true;
+    std::vector<double> parseMs, diffMs, applyMs, reloadMs, loadMs;
+    ConfigReloaderStats stats;
+    uint64_t rediffed = 0;
+    size_t fileBytes = 0;
+    bool coalesced = true, exactNotify = true, shared = true, ownWriteSkipped = false, backupUsed = false;
+
+    {
+        OBSConfigHelper cfg("playfame_config.json");
+        const std::filesystem::path file = cfg.path().toStdString();
+        std::filesystem::create_directories(file.parent_path());
+        writeConfig(file, revision);
+        fileBytes = static_cast<size_t>(std::filesystem::file_size(file));
+        cfg.load();
+
+        std::mutex                                     notifiedMutex;
+        std::set<std::pair<uint32_t, std::string>>     notified;
+        std::vector<uint32_t>                          index(static_cast<size_t>(sections));
+        for (int s = 0; s < sections; ++s) {
+            index[static_cast<size_t>(s)] = cfg.key(sectionName(s).c_str(), "key_0").section;
+            cfg.subscribeSection(QString::fromUtf8(sectionName(s).c_str()), nullptr,
+                                 [&](const std::vector<ConfigChange> &batch) {
+                                     std::lock_guard<std::mutex> lock(notifiedMutex);
+                                     for (const ConfigChange &c : batch)
+                                         notified.emplace(c.section, c.key.constData());
+                                 });
+        }
+
+        ConfigReloadOptions options;
+        options.debounce = std::chrono::milliseconds(debounceMs);
+        ConfigReloader reloader(&cfg, options);
+
+        for (int r = 1; r <= rounds; ++r) {
+            /* edit one section: change some keys, every other round drop one */
+            const int target = r % sections;
+            std::set<std::pair<uint32_t, std::string>> expected;
+            auto &keysOf = revision[static_cast<size_t>(target)];
+            for (int c = 0; c < changes; ++c) {
+                const int k = (r * 7919 + c * 104729) % keys;
+                keysOf[static_cast<size_t>(k)] = r;
+                expected.emplace(index[static_cast<size_t>(target)], "key_" + std::to_string(k));
+            }
+            if (r % 2 == 0) {
+                for (int k = keys - 1; k >= 0; --k) {
+                    if (keysOf[static_cast<size_t>(k)] == 0) {
+                        keysOf[static_cast<size_t>(k)] = -1;
+                        expected.emplace(index[static_cast<size_t>(target)], "key_" + std::to_string(k));
+                        break;
+                    }
+                }
+            }
+
+            std::vector<obs_data_t *> before;
+            {
+                ConfigReader reader = cfg.reader();
+                for (uint32_t i : index) {
+                    before.push_back(reader.snapshot()->section(i));
+                    obs_data_addref(before.back());   /* keeps the address from being reused */
+                }
+            }
+            {
+                std::lock_guard<std::mutex> lock(notifiedMutex);
+                notified.clear();
+            }
+
+            /* mtime has millisecond resolution; keep rounds apart */
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            writeConfig(file, revision);
+
+            const uint64_t reloadsBefore = reloader.stats().reloads;
+            const uint64_t handledBefore = handled(reloader);
+            for (int e = 0; e < 5; ++e) {
+                reloader.fileChanged();
+                std::this_thread::sleep_for(std::chrono::milliseconds(debounceMs / 5));
+            }
+            ok = ok && settle(reloader, handledBefore);
+
+            stats = reloader.stats();
+            coalesced = coalesced && stats.reloads == reloadsBefore + 1;
+            rediffed += stats.last.rediffed ? 1 : 0;
+            parseMs.push_back(static_cast<double>(stats.last.parseUs) / 1000.0);
+            diffMs.push_back(static_cast<double>(stats.last.diffUs) / 1000.0);
+            applyMs.push_back(static_cast<double>(stats.last.applyUs) / 1000.0);
+            reloadMs.push_back(static_cast<double>(stats.last.parseUs + stats.last.diffUs + stats.last.applyUs) /
+                               1000.0);
+            {
+                std::lock_guard<std::mutex> lock(notifiedMutex);
+                exactNotify = exactNotify && notified == expected;
+            }
+            {
+                ConfigReader reader = cfg.reader();
+                for (int s = 0; s < sections; ++s) {
+                    obs_data_t *now = reader.snapshot()->section(index[static_cast<size_t>(s)]);
+                    if (s == target)
+                        shared = shared && now != before[static_cast<size_t>(s)];
+                    else
+                        shared = shared && now == before[static_cast<size_t>(s)];
+                }
+            }
+            for (obs_data_t *obj : before)
+                obs_data_release(obj);
+
+            /* what the Load button used to cost: a full re-parse and republish */
+            std::filesystem::remove(file.string() + ".bin");
+            const auto l0 = Clock::now();
+            cfg.load();
+            loadMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - l0).count());
+        }
+
+        /* own save: the watcher fires, the stamp matches, nothing is reloaded */
+        cfg.set(cfg.key("demo", "number"), 8);
+        cfg.save();
+        ok = ok && cfg.flush(std::chrono::seconds(5));
+        const uint64_t ownBefore = reloader.stats().ownWrites;
+        const uint64_t handledBefore = handled(reloader);
+        reloader.fileChanged();
+        ok = ok && settle(reloader, handledBefore);
+        ownWriteSkipped = reloader.stats().ownWrites == ownBefore + 1;
+
+        /* half-written file: the .bak from the save above is used instead */
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        {
+            std::ofstream out(file, std::ios::trunc);
+            out << "{\"demo\": {\"text\": \"trunc";
+        }
+        const uint64_t reloadsBefore = reloader.stats().reloads;
+        reloader.fileChanged();
+        ok = ok && settle(reloader, handled(reloader));
+        stats = reloader.stats();
+        backupUsed = stats.reloads == reloadsBefore + 1 && stats.last.ok && stats.last.fromBackup &&
+                     cfg.get(cfg.key("demo", "number"), 0) == 7;   /* the .bak predates the save of 8 */
+    }
+    std::filesystem::remove_all(dir);
+
+    ok = ok && coalesced && exactNotify && shared && ownWriteSkipped && backupUsed &&
+         median(reloadMs) < median(loadMs);
+
+    std::printf("{\"sections\": %d, \"keys\": %d, \"file_bytes\": %zu, \"changes\": %d, \"rounds\": %d, "
+                "\"debounce_ms\": %d, \"reload\": {\"parse_ms\": %.2f, \"diff_ms\": %.2f, \"apply_ms\": %.3f, "
+                "\"total_ms\": %.2f, \"rediffed\": %llu}, \"full_load_ms\": %.2f, \"events\": %llu, "
+                "\"reloads\": %llu, \"own_writes\": %llu, \"unchanged\": %llu, \"from_backup\": %llu, "
+                "\"coalesced\": %s, \"exact_notify\": %s, \"untouched_shared\": %s, \"own_write_skipped\": %s, "
+                "\"backup_used\": %s, \"ok\": %s}\n",
+                sections, keys, fileBytes, changes, rounds, debounceMs, median(parseMs), median(diffMs),
+                median(applyMs), median(reloadMs), static_cast<unsigned long long>(rediffed), median(loadMs),
+                static_cast<unsigned long long>(stats.events), static_cast<unsigned long long>(stats.reloads),
+                static_cast<unsigned long long>(stats.ownWrites), static_cast<unsigned long long>(stats.unchanged),
+                static_cast<unsigned long long>(stats.fromBackup), coalesced ? "true" : "false",
+                exactNotify ? "true" : "false", shared ? "true" : "false", ownWriteSkipped ? "true" : "false",
+                backupUsed ? "true" : "false", ok ? "true" : "false");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,205 @@
+/*!
+ * @file config-scopes.cpp
+ * @brief Profile switching cost with and without the ConfigScopes cache.
+ *
+ * Writes --profiles JSON stores (--keys keys each), then replays --switches
+ * profile changes the way an operator does them: mostly back to the
+ * previous profile, sometimes to one of a few favourites, rarely anywhere.
+ * Between switches the operator pauses for --think-ms.
+ * - uncached: every switch constructs and loads a fresh OBSConfigHelper,
+ *   as a single global store reloaded per profile would
+ * - cached: ConfigScopes::activate() with its LRU and prefetch; a miss is
+ *   loaded on the scopes worker, timed until waitForCurrent() has it;
+ *   frontend_* is the activate() call alone, what the frontend thread pays
+ * - evicted: a two-store cache switching back to a store it just evicted,
+ *   right after writing to it; the write must still be there
+ * Reports activation latency percentiles, hit and prefetch-hit ratios.
+ *
+ * Usage: config-scopes [--profiles N] [--keys N] [--switches N] [--think-ms N] [--dir PATH]
+ * Prints one JSON object to stdout.
+ */
+
+#include "config-scopes.h"
+#include "obs-config-helper.h"
+#include "obs-standin.h"
+
+#include <QString>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Percentiles {
+    double p50 = 0, p99 = 0, max = 0;
+};
+
+Percentiles percentiles(std::vector<double> &us)
+{
+    Percentiles p;
+    if (us.empty())
+        return p;
+    std::sort(us.begin(), us.end());
+    p.p50 = us[us.size() / 2];
+    p.p99 = us[std::min(us.size() - 1, us.size() * 99 / 100)];
+    p.max = us.back();
+    return p;
+}
+
+QString profileName(int i)
+{
+    return QString::fromUtf8(("Show " + std::to_string(i)).c_str());
+}
+
+void writeStore(const std::filesystem::path &configDir, int profile, int keys)
+{
+    const std::filesystem::path file =
+        configDir / ConfigScopes::fileName(ConfigScopeKind::Profile, profileName(profile)).toStdString();
+    std::filesystem::create_directories(file.parent_path());
+    std::ofstream out(file);
+    out << "{\"demo\": {\"text\": \"profile " << profile << "\", \"number\": " << profile << "}, \"overlay\": {";
+    for (int k = 0; k < keys; ++k)
+        out << (k ? ", " : "") << "\"key_" << k << "\": \"value " << profile << '/' << k << " lorem ipsum\"";
+    out << "}}";
+}
+
+/* back to the previous profile 60%, one of 4 favourites 30%, anything 10% */
+std::vector<int> operatorSwitches(int profiles, int switches)
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> pick(0, 1);
+    std::vector<int> order;
+    int current = 0, previous = 1;
+    for (int i = 0; i < switches; ++i) {
+        const double r = pick(rng);
+        int next;
+        if (r < 0.6)
+            next = previous;
+        else if (r < 0.9)
+            next = static_cast<int>(rng() % 4);
+        else
+            next = static_cast<int>(rng() % static_cast<unsigned>(profiles));
+        if (next == current)
+            next = (current + 1) % profiles;
+        previous = current;
+        current  = next;
+        order.push_back(next);
+    }
+    return order;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int profiles = 40, keys = 400, switches = 400, thinkMs = 20;
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "playfame-bench" / "scopes";
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--profiles"))
+            profiles = std::max(5, std::atoi(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--keys"))
+            keys = std::max(1, std::atoi(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--switches"))
+            switches = std::max(10, std::atoi(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--think-ms"))
+            thinkMs = std::max(0, std::atoi(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--dir"))
+            dir = argv[i + 1];
+    }
+    std::filesystem::remove_all(dir);
+    ObsStandin::setConfigDir(dir.string().c_str());
+    for (int p = 0; p < profiles; ++p)
+        writeStore(dir, p, keys);
+    const auto storeBytes = std::filesystem::file_size(
+        dir / ConfigScopes::fileName(ConfigScopeKind::Profile, profileName(0)).toStdString());
+
+    const std::vector<int> order = operatorSwitches(profiles, switches);
+    const auto think = std::chrono::milliseconds(thinkMs);
+    bool ok = true;
+
+    /* uncached: one store, reloaded per switch --------------------------------- */
+    std::vector<double> uncached;
+    for (int p : order) {
+        const auto t0 = Clock::now();
+        auto store = std::make_unique<OBSConfigHelper>(
+            ConfigScopes::fileName(ConfigScopeKind::Profile, profileName(p)).constData());
+        store->setJournalMode(true);
+        store->load();
+        uncached.push_back(std::chrono::duration<double, std::micro>(Clock::now() - t0).count());
+        ok = ok && store->get(ConfigSchema::kDemoNumber) == p;
+        std::this_thread::sleep_for(think);
+    }
+
+    /* cached: ConfigScopes ---------------------------------------------------- */
+    std::vector<double> cached, hitUs, missUs, frontendUs;
+    ConfigScopes::Stats stats;
+    {
+        ConfigScopes scopes;
+        for (int p : order) {
+            const ConfigScopes::Stats before = scopes.stats();
+            const auto t0 = Clock::now();
+            std::shared_ptr<OBSConfigHelper> store = scopes.activate(ConfigScopeKind::Profile, profileName(p));
+            frontendUs.push_back(std::chrono::duration<double, std::micro>(Clock::now() - t0).count());
+            if (!store)
+                store = scopes.waitForCurrent(ConfigScopeKind::Profile, std::chrono::seconds(5));
+            const double us = std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+            cached.push_back(us);
+            (scopes.stats().misses > before.misses ? missUs : hitUs).push_back(us);
+            ok = ok && store && store->get(ConfigSchema::kDemoNumber) == p;
+            std::this_thread::sleep_for(think);
+        }
+        stats = scopes.stats();
+    }
+
+    /* evicted: switching back before the worker saved the store ------------------ */
+    bool evictedWritesKept = true;
+    {
+        ConfigScopeOptions tight;
+        tight.maxStores = 2;
+        ConfigScopes scopes(tight);
+        auto use = [&](int p) {
+            std::shared_ptr<OBSConfigHelper> store = scopes.activate(ConfigScopeKind::Profile, profileName(p));
+            return store ? store : scopes.waitForCurrent(ConfigScopeKind::Profile, std::chrono::seconds(5));
+        };
+        for (int round = 0; round < 200 && evictedWritesKept; ++round) {
+            use(0)->set(ConfigSchema::kDemoNumber, round);
+            use(1);
+            use(2);                 /* evicts profile 0 */
+            std::shared_ptr<OBSConfigHelper> back = use(0);
+            evictedWritesKept = back && back->get(ConfigSchema::kDemoNumber) == round;
+        }
+    }
+    std::filesystem::remove_all(dir);
+
+    const Percentiles u = percentiles(uncached), c = percentiles(cached), h = percentiles(hitUs),
+                      m = percentiles(missUs), f = percentiles(frontendUs);
+    const double hitRatio = static_cast<double>(stats.hits) / static_cast<double>(stats.hits + stats.misses);
+    ok = ok && stats.hits > stats.misses && c.p50 < u.p50 && evictedWritesKept;
+
+    std::printf("{\"profiles\": %d, \"keys\": %d, \"store_bytes\": %llu, \"switches\": %d, \"think_ms\": %d, "
+                "\"uncached\": {\"p50_us\": %.1f, \"p99_us\": %.1f, \"max_us\": %.1f}, "
+                "\"cached\": {\"p50_us\": %.1f, \"p99_us\": %.1f, \"max_us\": %.1f, "
+                "\"hit_p50_us\": %.1f, \"miss_p50_us\": %.1f, \"frontend_p99_us\": %.1f, "
+                "\"frontend_max_us\": %.1f, \"hits\": %llu, \"misses\": %llu, "
+                "\"hit_ratio\": %.3f, \"prefetches\": %llu, \"prefetch_hits\": %llu, \"evictions\": %llu, "
+                "\"stores\": %zu, \"est_bytes\": %zu}, \"evicted_writes_kept\": %s, \"ok\": %s}\n",
+                profiles, keys, static_cast<unsigned long long>(storeBytes), switches, thinkMs, u.p50, u.p99, u.max,
+                c.p50, c.p99, c.max, h.p50, m.p50, f.p99, f.max, static_cast<unsigned long long>(stats.hits),
+                static_cast<unsigned long long>(stats.misses), hitRatio,
+                static_cast<unsigned long long>(stats.prefetches), static_cast<unsigned long long>(stats.prefetchHits),
+                static_cast<unsigned long long>(stats.evictions), stats.stores, stats.bytes,
+                evictedWritesKept ? "true" : "false", ok ? "true" : "false");
+    return ok ? 0 : 1;
+}
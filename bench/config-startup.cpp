@@ -0,0 +1,158 @@
+/*!
+ * @file config-startup.cpp
+ * @brief Startup-time benchmark: JSON parse vs. binary sidecar.
+ *
+ * For each key count, generates a config tree (sections of 1000 mixed-type
+ * keys), writes it as JSON and as a binary sidecar, then times how long each
+ * path takes to produce a ready obs_data_t, as OBSConfigHelper::load() does.
+ * Also checks that the rebuilt tree keeps the key order of the JSON, and
+ * that an edit keeping the JSON's size and mtime invalidates the sidecar.
+ *
+ * Usage: config-startup [--keys N[,N...]] [--repeat R] [--dir PATH]
+ * Prints one JSON object per key count to stdout.
+ */
+
+#include "config-binary-cache.h"
+
+#include <obs-module.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+obs_data_t *makeTree(size_t keys)
+{
+    obs_data_t *root    = obs_data_create();
+    obs_data_t *section = nullptr;
+    char name[32];
+
+    for (size_t i = 0; i < keys; ++i) {
+        if (i % 1000 == 0) {
+            obs_data_release(section);
+            section = obs_data_create();
+            std::snprintf(name, sizeof(name), "section_%zu", i / 1000);
+            obs_data_set_obj(root, name, section);
+        }
+        std::snprintf(name, sizeof(name), "key_%zu", i);
+        switch (i % 4) {
+        case 0: obs_data_set_int(section, name, static_cast<long long>(i) * 7919); break;
+        case 1: obs_data_set_double(section, name, static_cast<double>(i) * 0.25); break;
+        case 2: obs_data_set_bool(section, name, (i & 8) != 0); break;
+        default: obs_data_set_string(section, name, "overlay-layout-entry-with-some-payload"); break;
+        }
+    }
+    obs_data_release(section);
+    return root;
+}
+
+double medianUs(std::vector<double> v)
+{
+    std::sort(v.begin(), v.end());
+    return v.empty() ? 0.0 : v[v.size() / 2];
+}
+
+/* Same-size edit with the old mtime restored: only the content hash can tell. */
+bool sameStampEditRejected(const std::string &json, const std::string &cache)
+{
+    const auto mtime = std::filesystem::last_write_time(json);
+    std::string text;
+    {
+        std::ifstream in(json, std::ios::binary);
+        text.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    const size_t at = text.find("section_0");
+    if (at == std::string::npos)
+        return false;
+    text[at + 8] = 'X';
+    {
+        std::ofstream out(json, std::ios::binary | std::ios::trunc);
+        out << text;
+    }
+    std::filesystem::last_write_time(json, mtime);
+
+    obs_data_t *data = ConfigBinaryCache::load(cache.c_str(), json.c_str());
+    obs_data_release(data);
+    return data == nullptr;
+}
+
+template<typename Fn> double timeUs(Fn fn)
+{
+    auto start = Clock::now();
+    fn();
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::vector<size_t> counts = {1000, 100000, 1000000};
+    int repeat = 5;
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "playfame-bench";
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--keys")) {
+            counts.clear();
+            for (char *tok = std::strtok(argv[i + 1], ","); tok; tok = std::strtok(nullptr, ","))
+                counts.push_back(static_cast<size_t>(std::atoll(tok)));
+        } else if (!std::strcmp(argv[i], "--repeat")) {
+            repeat = std::max(1, std::atoi(argv[i + 1]));
+        } else if (!std::strcmp(argv[i], "--dir")) {
+            dir = argv[i + 1];
+        }
+    }
+    std::filesystem::create_directories(dir);
+
+    std::printf("[\n");
+    for (size_t c = 0; c < counts.size(); ++c) {
+        const size_t keys = counts[c];
+        const std::string json  = (dir / ("startup_" + std::to_string(keys) + ".json")).string();
+        const std::string cache = json + ".bin";
+
+        obs_data_t *tree = makeTree(keys);
+        obs_data_save_json_safe(tree, json.c_str(), ".tmp", ".bak");
+        const double storeUs = timeUs([&] { ConfigBinaryCache::store(cache.c_str(), json.c_str(), tree); });
+
+        obs_data_t *cached = ConfigBinaryCache::load(cache.c_str(), json.c_str());
+        const bool orderKept = cached && !std::strcmp(obs_data_get_json(cached), obs_data_get_json(tree));
+        obs_data_release(cached);
+        obs_data_release(tree);
+
+        std::vector<double> jsonUs, binaryUs;
+        for (int r = 0; r < repeat; ++r) {
+            jsonUs.push_back(timeUs([&] {
+                obs_data_release(obs_data_create_from_json_file_safe(json.c_str(), ".bak"));
+            }));
+            binaryUs.push_back(timeUs([&] {
+                obs_data_t *data = ConfigBinaryCache::load(cache.c_str(), json.c_str());
+                if (!data)
+                    std::fprintf(stderr, "binary cache rejected for %zu keys\n", keys);
+                obs_data_release(data);
+            }));
+        }
+
+        const double j = medianUs(jsonUs), b = medianUs(binaryUs);
+        const bool editRejected = sameStampEditRejected(json, cache);
+        std::printf("  {\"keys\": %zu, \"json_bytes\": %llu, \"cache_bytes\": %llu, \"json_load_us\": %.0f, "
+                    "\"binary_load_us\": %.0f, \"speedup\": %.2f, \"binary_store_us\": %.0f, "
+                    "\"order_kept\": %s, \"same_stamp_edit_rejected\": %s}%s\n",
+                    keys, static_cast<unsigned long long>(std::filesystem::file_size(json)),
+                    static_cast<unsigned long long>(std::filesystem::file_size(cache)), j, b, b > 0 ? j / b : 0.0,
+                    storeUs, orderKept ? "true" : "false", editRejected ? "true" : "false",
+                    c + 1 < counts.size() ? "," : "");
+        std::fflush(stdout);
+    }
+    std::printf("]\n");
+    return 0;
+}
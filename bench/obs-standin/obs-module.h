@@ -0,0 +1,107 @@
+/*!
+ * @file obs-module.h
+ * @brief In-process stand-in for the parts of libobs the plugin core uses.
+ *
+ * Only for the headless benchmarks in bench/. Declares the obs_data_* tree,
+ * obs_module_config_path() and logging with libobs' signatures so the
+ * plugin sources compile unchanged; obs-standin.cpp implements them.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include "util/base.h"
+#include "util/bmem.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct obs_data obs_data_t;
+typedef struct obs_data_item obs_data_item_t;
+typedef struct obs_data_array obs_data_array_t;
+
+enum obs_data_type {
+	OBS_DATA_NULL,
+	OBS_DATA_STRING,
+	OBS_DATA_NUMBER,
+	OBS_DATA_BOOLEAN,
+	OBS_DATA_OBJECT,
+	OBS_DATA_ARRAY,
+};
+
+enum obs_data_number_type {
+	OBS_DATA_NUM_INVALID,
+	OBS_DATA_NUM_INT,
+	OBS_DATA_NUM_DOUBLE,
+};
+
+/* ---- data ------------------------------------------------------------- */
+obs_data_t *obs_data_create(void);
+obs_data_t *obs_data_create_from_json(const char *json_string);
+obs_data_t *obs_data_create_from_json_file(const char *json_file);
+obs_data_t *obs_data_create_from_json_file_safe(const char *json_file, const char *backup_ext);
+void obs_data_addref(obs_data_t *data);
+void obs_data_release(obs_data_t *data);
+
+const char *obs_data_get_json(obs_data_t *data);
+bool obs_data_save_json(obs_data_t *data, const char *file);
+bool obs_data_save_json_safe(obs_data_t *data, const char *file, const char *temp_ext, const char *backup_ext);
+
+void obs_data_erase(obs_data_t *data, const char *name);
+
+void obs_data_set_string(obs_data_t *data, const char *name, const char *val);
+void obs_data_set_int(obs_data_t *data, const char *name, long long val);
+void obs_data_set_double(obs_data_t *data, const char *name, double val);
+void obs_data_set_bool(obs_data_t *data, const char *name, bool val);
+void obs_data_set_obj(obs_data_t *data, const char *name, obs_data_t *obj);
+void obs_data_set_array(obs_data_t *data, const char *name, obs_data_array_t *array);
+
+const char *obs_data_get_string(obs_data_t *data, const char *name);
+long long obs_data_get_int(obs_data_t *data, const char *name);
+double obs_data_get_double(obs_data_t *data, const char *name);
+bool obs_data_get_bool(obs_data_t *data, const char *name);
+obs_data_t *obs_data_get_obj(obs_data_t *data, const char *name);
+obs_data_array_t *obs_data_get_array(obs_data_t *data, const char *name);
+bool obs_data_has_user_value(obs_data_t *data, const char *name);
+
+/* ---- arrays ----------------------------------------------------------- */
+obs_data_array_t *obs_data_array_create(void);
+void obs_data_array_addref(obs_data_array_t *array);
+void obs_data_array_release(obs_data_array_t *array);
+size_t obs_data_array_count(obs_data_array_t *array);
+obs_data_t *obs_data_array_item(obs_data_array_t *array, size_t idx);
+size_t obs_data_array_push_back(obs_data_array_t *array, obs_data_t *obj);
+
+/* ---- item iteration --------------------------------------------------- */
+obs_data_item_t *obs_data_first(obs_data_t *data);
+obs_data_item_t *obs_data_item_byname(obs_data_t *data, const char *name);
+bool obs_data_item_next(obs_data_item_t **item);
+void obs_data_item_release(obs_data_item_t **item);
+
+enum obs_data_type obs_data_item_gettype(obs_data_item_t *item);
+enum obs_data_number_type obs_data_item_numtype(obs_data_item_t *item);
+const char *obs_data_item_get_name(obs_data_item_t *item);
+bool obs_data_item_has_user_value(obs_data_item_t *item);
+
+const char *obs_data_item_get_string(obs_data_item_t *item);
+long long obs_data_item_get_int(obs_data_item_t *item);
+double obs_data_item_get_double(obs_data_item_t *item);
+bool obs_data_item_get_bool(obs_data_item_t *item);
+obs_data_t *obs_data_item_get_obj(obs_data_item_t *item);
+obs_data_array_t *obs_data_item_get_array(obs_data_item_t *item);
+
+/* ---- module ----------------------------------------------------------- */
+/** Returns "<config dir>/<file>"; free with bfree(). See obs-standin.h. */
+char *obs_module_config_path(const char *file);
+
+#ifdef __cplusplus
+}
+#endif
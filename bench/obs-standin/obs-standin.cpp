@@ -0,0 +1,990 @@
+/*!
+ * @file obs-standin.cpp
+ * @brief Implements the libobs stand-in used by the headless benchmarks.
+ *
+ * Follows libobs semantics where the plugin depends on them: reference
+ * counted data and arrays, getters that add a reference for objects and
+ * arrays, items kept in insertion order with a name index, NULL from the
+ * JSON loaders on parse errors, and temp/backup files in
+ * obs_data_save_json_safe(). It is not a general-purpose libobs
+ * replacement; numbers are only comparable between runs of the benchmarks.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "obs-module.h"
+#include "obs-standin.h"
+#include "util/platform.h"
+
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+struct obs_data_item {
+    std::atomic<long>         ref{1};       ///< One held by the parent list.
+    obs_data_item            *prev = nullptr;
+    obs_data_item            *next = nullptr;
+    std::string               name;
+    obs_data_type             type    = OBS_DATA_NULL;
+    obs_data_number_type      numtype = OBS_DATA_NUM_INVALID;
+    std::string               str;
+    long long                 i   = 0;
+    double                    d   = 0.0;
+    bool                      b   = false;
+    obs_data_t               *obj = nullptr;
+    obs_data_array_t         *array = nullptr;
+};
+
+struct obs_data {
+    std::atomic<long>                                 ref{1};
+    obs_data_item                                    *first = nullptr;
+    obs_data_item                                    *last  = nullptr;
+    std::unordered_map<std::string_view, obs_data_item *> index;  ///< Views into item names.
+    std::string                                       json;       ///< Backs obs_data_get_json().
+};
+
+struct obs_data_array {
+    std::atomic<long>         ref{1};
+    std::vector<obs_data_t *> items;
+};
+
+namespace {
+
+std::mutex            g_configDirMutex;
+std::string           g_configDir;
+std::atomic<uint64_t> g_logLines{0};
+std::atomic<bool>     g_logEcho{false};
+
+/* ------------------------------------------------------------------------- */
+/*  Items                                                                    */
+/* ------------------------------------------------------------------------- */
+void clearValue(obs_data_item *item)
+{
+    obs_data_release(item->obj);
+    obs_data_array_release(item->array);
+    item->obj   = nullptr;
+    item->array = nullptr;
+    item->str.clear();
+}
+
+void releaseItem(obs_data_item *item)
+{
+    if (item && item->ref.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        clearValue(item);
+        delete item;
+    }
+}
+
+obs_data_item *findItem(obs_data_t *data, const char *name)
+{
+    if (!data || !name)
+        return nullptr;
+    auto it = data->index.find(std::string_view(name));
+    return it == data->index.end() ? nullptr : it->second;
+}
+
+obs_data_item *itemForSet(obs_data_t *data, const char *name, obs_data_type type)
+{
+    if (!data || !name)
+        return nullptr;
+    obs_data_item *item = findItem(data, name);
+    if (!item) {
+        item       = new obs_data_item;
+        item->name = name;
+        item->prev = data->last;
+        if (data->last)
+            data->last->next = item;
+        else
+            data->first = item;
+        data->last = item;
+        data->index.emplace(std::string_view(item->name), item);
+    } else {
+        clearValue(item);
+    }
+    item->type    = type;
+    item->numtype = OBS_DATA_NUM_INVALID;
+    return item;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  JSON writer                                                              */
+/* ------------------------------------------------------------------------- */
+void writeString(std::string &out, std::string_view s)
+{
+    out.push_back('"');
+    for (unsigned char c : s) {
+        switch (c) {
+        case '"':  out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (c < 0x20) {
+                char esc[8];
+                std::snprintf(esc, sizeof(esc), "\\u%04x", c);
+                out += esc;
+            } else {
+                out.push_back(static_cast<char>(c));
+            }
+        }
+    }
+    out.push_back('"');
+}
+
+void writeDouble(std::string &out, double v)
+{
+    if (!std::isfinite(v))
+        v = 0.0;
+    char buf[32];
+    const auto res = std::to_chars(buf, buf + sizeof(buf), v);
+    std::string_view text(buf, static_cast<size_t>(res.ptr - buf));
+    out += text;
+    if (text.find_first_of(".eE") == std::string_view::npos)
+        out += ".0";                /* keep it a real number when read back */
+}
+
+void newline(std::string &out, int indent, int depth)
+{
+    if (indent > 0) {
+        out.push_back('\n');
+        out.append(static_cast<size_t>(indent * depth), ' ');
+    }
+}
+
+void writeObject(std::string &out, obs_data_t *data, int indent, int depth);
+
+void writeArray(std::string &out, obs_data_array_t *array, int indent, int depth)
+{
+    out.push_back('[');
+    for (size_t i = 0; i < array->items.size(); ++i) {
+        if (i)
+            out.push_back(',');
+        newline(out, indent, depth + 1);
+        writeObject(out, array->items[i], indent, depth + 1);
+    }
+    if (!array->items.empty())
+        newline(out, indent, depth);
+    out.push_back(']');
+}
+
+void writeObject(std::string &out, obs_data_t *data, int indent, int depth)
+{
+    out.push_back('{');
+    bool first = true;
+    for (obs_data_item *item = data->first; item; item = item->next) {
+        if ((item->type == OBS_DATA_OBJECT && !item->obj) || (item->type == OBS_DATA_ARRAY && !item->array) ||
+            item->type == OBS_DATA_NULL)
+            continue;
+        if (!first)
+            out.push_back(',');
+        first = false;
+        newline(out, indent, depth + 1);
+        writeString(out, item->name);
+        out += indent > 0 ? ": " : ":";
+
+        switch (item->type) {
+        case OBS_DATA_STRING:  writeString(out, item->str); break;
+        case OBS_DATA_BOOLEAN: out += item->b ? "true" : "false"; break;
+        case OBS_DATA_OBJECT:  writeObject(out, item->obj, indent, depth + 1); break;
+        case OBS_DATA_ARRAY:   writeArray(out, item->array, indent, depth + 1); break;
+        case OBS_DATA_NUMBER:
+            if (item->numtype == OBS_DATA_NUM_DOUBLE)
+                writeDouble(out, item->d);
+            else
+                out += std::to_string(item->i);
+            break;
+        default: break;
+        }
+    }
+    if (!first)
+        newline(out, indent, depth);
+    out.push_back('}');
+}
+
+/* ------------------------------------------------------------------------- */
+/*  JSON parser                                                              */
+/* ------------------------------------------------------------------------- */
+class JsonParser {
+public:
+    explicit JsonParser(std::string_view text)
+        : s_(text)
+    {
+    }
+
+    obs_data_t *parseDocument()
+    {
+        skipSpace();
+        obs_data_t *data = peek() == '{' ? parseObject() : nullptr;
+        skipSpace();
+        if (data && pos_ != s_.size()) {
+            obs_data_release(data);
+            return nullptr;
+        }
+        return data;
+    }
+
+private:
+    char peek() const { return pos_ < s_.size() ? s_[pos_] : '\0'; }
+
+    bool consume(char c)
+    {
+        skipSpace();
+        if (peek() != c)
+            return false;
+        ++pos_;
+        return true;
+    }
+
+    void skipSpace()
+    {
+        while (pos_ < s_.size() && (s_[pos_] == ' ' || s_[pos_] == '\n' || s_[pos_] == '\r' || s_[pos_] == '\t'))
+            ++pos_;
+    }
+
+    bool literal(std::string_view word)
+    {
+        if (s_.substr(pos_, word.size()) != word)
+            return false;
+        pos_ += word.size();
+        return true;
+    }
+
+    static void appendUtf8(std::string &out, uint32_t cp)
+    {
+        if (cp < 0x80) {
+            out.push_back(static_cast<char>(cp));
+        } else if (cp < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+    }
+
+    bool hex4(uint32_t &out)
+    {
+        if (pos_ + 4 > s_.size())
+            return false;
+        const auto res = std::from_chars(s_.data() + pos_, s_.data() + pos_ + 4, out, 16);
+        if (res.ptr != s_.data() + pos_ + 4)
+            return false;
+        pos_ += 4;
+        return true;
+    }
+
+    bool parseString(std::string &out)
+    {
+        if (!consume('"'))
+            return false;
+        out.clear();
+        while (pos_ < s_.size()) {
+            const char c = s_[pos_++];
+            if (c == '"')
+                return true;
+            if (c != '\\') {
+                out.push_back(c);
+                continue;
+            }
+            if (pos_ >= s_.size())
+                return false;
+            switch (s_[pos_++]) {
+            case '"':  out.push_back('"'); break;
+            case '\\': out.push_back('\\'); break;
+            case '/':  out.push_back('/'); break;
+            case 'b':  out.push_back('\b'); break;
+            case 'f':  out.push_back('\f'); break;
+            case 'n':  out.push_back('\n'); break;
+            case 'r':  out.push_back('\r'); break;
+            case 't':  out.push_back('\t'); break;
+            case 'u': {
+                uint32_t cp = 0;
+                if (!hex4(cp))
+                    return false;
+                if (cp >= 0xD800 && cp < 0xDC00 && literal("\\u")) {
+                    uint32_t low = 0;
+                    if (!hex4(low) || low < 0xDC00 || low > 0xDFFF)
+                        return false;
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                }
+                appendUtf8(out, cp);
+                break;
+            }
+            default: return false;
+            }
+        }
+        return false;
+    }
+
+    /* only objects are kept in arrays, as obs_data arrays hold obs_data */
+    obs_data_array_t *parseArray()
+    {
+        if (!consume('['))
+            return nullptr;
+        obs_data_array_t *array = obs_data_array_create();
+        if (consume(']'))
+            return array;
+        do {
+            skipSpace();
+            if (peek() == '{') {
+                obs_data_t *obj = parseObject();
+                if (!obj)
+                    break;
+                array->items.push_back(obj);
+            } else if (!skipValue()) {
+                break;
+            }
+            if (consume(']'))
+                return array;
+        } while (consume(','));
+        obs_data_array_release(array);
+        return nullptr;
+    }
+
+    bool skipValue()
+    {
+        skipSpace();
+        std::string ignored;
+        switch (peek()) {
+        case '"': return parseString(ignored);
+        case '[': {
+            obs_data_array_t *a = parseArray();
+            obs_data_array_release(a);
+            return a != nullptr;
+        }
+        case '{': {
+            obs_data_t *o = parseObject();
+            obs_data_release(o);
+            return o != nullptr;
+        }
+        default: {
+            const size_t start = pos_;
+            while (pos_ < s_.size() && !std::strchr(",]} \n\r\t", s_[pos_]))
+                ++pos_;
+            return pos_ > start;
+        }
+        }
+    }
+
+    bool parseMember(obs_data_t *data)
+    {
+        std::string name;
+        if (!parseString(name) || !consume(':'))
+            return false;
+        skipSpace();
+
+        switch (peek()) {
+        case '"': {
+            std::string value;
+            if (!parseString(value))
+                return false;
+            obs_data_set_string(data, name.c_str(), value.c_str());
+            return true;
+        }
+        case '{': {
+            obs_data_t *obj = parseObject();
+            if (!obj)
+                return false;
+            obs_data_set_obj(data, name.c_str(), obj);
+            obs_data_release(obj);
+            return true;
+        }
+        case '[': {
+            obs_data_array_t *array = parseArray();
+            if (!array)
+                return false;
+            obs_data_set_array(data, name.c_str(), array);
+            obs_data_array_release(array);
+            return true;
+        }
+        case 't': if (!literal("true"))  return false; obs_data_set_bool(data, name.c_str(), true);  return true;
+        case 'f': if (!literal("false")) return false; obs_data_set_bool(data, name.c_str(), false); return true;
+        case 'n': return literal("null");
+        default:  return parseNumber(data, name.c_str());
+        }
+    }
+
+    bool parseNumber(obs_data_t *data, const char *name)
+    {
+        const size_t start = pos_;
+        while (pos_ < s_.size() && std::strchr("+-0123456789.eE", s_[pos_]))
+            ++pos_;
+        const char *first = s_.data() + start;
+        const char *last  = s_.data() + pos_;
+        if (first == last)
+            return false;
+
+        if (std::string_view(first, static_cast<size_t>(last - first)).find_first_of(".eE") ==
+            std::string_view::npos) {
+            long long v = 0;
+            const auto res = std::from_chars(first, last, v);
+            if (res.ptr == last && res.ec == std::errc()) {
+                obs_data_set_int(data, name, v);
+                return true;
+            }
+        }
+        double v = 0.0;
+        const auto res = std::from_chars(first, last, v);
+        if (res.ptr != last)
+            return false;
+        obs_data_set_double(data, name, v);
+        return true;
+    }
+
+    obs_data_t *parseObject()
+    {
+        if (!consume('{'))
+            return nullptr;
+        obs_data_t *data = obs_data_create();
+        if (consume('}'))
+            return data;
+        do {
+            if (!parseMember(data))
+                break;
+            if (consume('}'))
+                return data;
+        } while (consume(','));
+        obs_data_release(data);
+        return nullptr;
+    }
+
+    std::string_view s_;
+    size_t           pos_ = 0;
+};
+
+bool readFile(const char *path, std::string &out)
+{
+    std::FILE *f = path ? std::fopen(path, "rb") : nullptr;
+    if (!f)
+        return false;
+    char   buf[65536];
+    size_t n;
+    out.clear();
+    while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0)
+        out.append(buf, n);
+    const bool ok = !std::ferror(f);
+    std::fclose(f);
+    return ok;
+}
+
+bool writeFile(const char *path, const std::string &text)
+{
+    std::FILE *f = std::fopen(path, "wb");
+    if (!f)
+        return false;
+    const bool ok = std::fwrite(text.data(), 1, text.size(), f) == text.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+} // namespace
+
+extern "C" {
+
+/* ------------------------------------------------------------------------- */
+/*  Memory and logging                                                       */
+/* ------------------------------------------------------------------------- */
+void *bmalloc(size_t size)
+{
+    return std::malloc(size ? size : 1);
+}
+
+void *bzalloc(size_t size)
+{
+    return std::calloc(1, size ? size : 1);
+}
+
+void bfree(void *ptr)
+{
+    std::free(ptr);
+}
+
+char *bstrdup(const char *str)
+{
+    if (!str)
+        return nullptr;
+    const size_t len = std::strlen(str) + 1;
+    auto *copy = static_cast<char *>(bmalloc(len));
+    std::memcpy(copy, str, len);
+    return copy;
+}
+
+/* formats like libobs' default handler, so the sink cost is realistic */
+void blogva(int log_level, const char *format, va_list args)
+{
+    thread_local char line[4096];
+    std::vsnprintf(line, sizeof(line), format, args);
+    g_logLines.fetch_add(1, std::memory_order_relaxed);
+    if (g_logEcho.load(std::memory_order_relaxed))
+        std::fprintf(stderr, "[%d] %s\n", log_level, line);
+}
+
+void blog(int log_level, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    blogva(log_level, format, args);
+    va_end(args);
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Platform                                                                 */
+/* ------------------------------------------------------------------------- */
+FILE *os_fopen(const char *path, const char *mode)
+{
+    return path ? std::fopen(path, mode) : nullptr;
+}
+
+int os_mkdirs(const char *path)
+{
+    std::error_code ec;
+    if (std::filesystem::is_directory(path, ec))
+        return MKDIR_EXISTS;
+    return std::filesystem::create_directories(path, ec) ? MKDIR_SUCCESS : MKDIR_ERROR;
+}
+
+bool os_file_exists(const char *path)
+{
+    std::error_code ec;
+    return path && std::filesystem::exists(path, ec);
+}
+
+int os_rename(const char *old_path, const char *new_path)
+{
+    return std::rename(old_path, new_path) == 0 ? 0 : -1;
+}
+
+int os_unlink(const char *path)
+{
+    return std::remove(path) == 0 ? 0 : -1;
+}
+
+int64_t os_get_file_size(const char *path)
+{
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    return ec ? -1 : static_cast<int64_t>(size);
+}
+
+struct os_dir {
+    std::filesystem::directory_iterator it;
+    os_dirent                           current;
+};
+
+os_dir_t *os_opendir(const char *path)
+{
+    std::error_code ec;
+    std::filesystem::directory_iterator it(path, ec);
+    return ec ? nullptr : new os_dir{it, {}};
+}
+
+struct os_dirent *os_readdir(os_dir_t *dir)
+{
+    if (!dir || dir->it == std::filesystem::directory_iterator())
+        return nullptr;
+    const std::string name = dir->it->path().filename().string();
+    std::snprintf(dir->current.d_name, sizeof(dir->current.d_name), "%s", name.c_str());
+    std::error_code ec;
+    dir->current.directory = dir->it->is_directory(ec);
+    dir->it.increment(ec);
+    if (ec)
+        dir->it = std::filesystem::directory_iterator();
+    return &dir->current;
+}
+
+void os_closedir(os_dir_t *dir)
+{
+    delete dir;
+}
+
+uint64_t os_gettime_ns(void)
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+char *obs_module_config_path(const char *file)
+{
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(g_configDirMutex);
+        if (g_configDir.empty()) {
+            const char *env = std::getenv("PLAYFAME_BENCH_DIR");
+            g_configDir = env && *env ? std::string(env)
+                                      : (std::filesystem::temp_directory_path() / "playfame-bench" / "config").string();
+        }
+        path = g_configDir;
+    }
+    if (file && *file)
+        path += "/" + std::string(file);
+    return bstrdup(path.c_str());
+}
+
+/* ------------------------------------------------------------------------- */
+/*  obs_data                                                                 */
+/* ------------------------------------------------------------------------- */
+obs_data_t *obs_data_create(void)
+{
+    return new obs_data;
+}
+
+obs_data_t *obs_data_create_from_json(const char *json_string)
+{
+    if (!json_string)
+        return nullptr;
+    obs_data_t *data = JsonParser(json_string).parseDocument();
+    if (!data)
+        blog(LOG_ERROR, "obs-data.c: [obs_data_create_from_json] Failed reading json string");
+    return data;
+}
+
+obs_data_t *obs_data_create_from_json_file(const char *json_file)
+{
+    std::string text;
+    return readFile(json_file, text) ? obs_data_create_from_json(text.c_str()) : nullptr;
+}
+
+obs_data_t *obs_data_create_from_json_file_safe(const char *json_file, const char *backup_ext)
+{
+    obs_data_t *data = obs_data_create_from_json_file(json_file);
+    if (!data && backup_ext && *backup_ext && json_file) {
+        const std::string backup = std::string(json_file) + backup_ext;
+        data = obs_data_create_from_json_file(backup.c_str());
+        if (data)
+            blog(LOG_WARNING, "obs-data.c: loaded backup file '%s'", backup.c_str());
+    }
+    return data;
+}
+
+void obs_data_addref(obs_data_t *data)
+{
+    if (data)
+        data->ref.fetch_add(1, std::memory_order_relaxed);
+}
+
+void obs_data_release(obs_data_t *data)
+{
+    if (!data || data->ref.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+    for (obs_data_item *item = data->first; item;) {
+        obs_data_item *next = item->next;
+        item->prev = item->next = nullptr;
+        releaseItem(item);
+        item = next;
+    }
+    delete data;
+}
+
+const char *obs_data_get_json(obs_data_t *data)
+{
+    if (!data)
+        return nullptr;
+    data->json.clear();
+    writeObject(data->json, data, 0, 0);
+    return data->json.c_str();
+}
+
+bool obs_data_save_json(obs_data_t *data, const char *file)
+{
+    if (!data || !file)
+        return false;
+    std::string text;
+    writeObject(text, data, 4, 0);
+    return writeFile(file, text);
+}
+
+bool obs_data_save_json_safe(obs_data_t *data, const char *file, const char *temp_ext, const char *backup_ext)
+{
+    if (!data || !file || !temp_ext)
+        return false;
+    const std::string temp = std::string(file) + temp_ext;
+    if (!obs_data_save_json(data, temp.c_str()))
+        return false;
+    if (backup_ext && *backup_ext && os_file_exists(file)) {
+        const std::string backup = std::string(file) + backup_ext;
+        os_unlink(backup.c_str());
+        os_rename(file, backup.c_str());
+    }
+    return os_rename(temp.c_str(), file) == 0;
+}
+
+void obs_data_erase(obs_data_t *data, const char *name)
+{
+    obs_data_item *item = findItem(data, name);
+    if (!item)
+        return;
+    data->index.erase(std::string_view(item->name));
+    (item->prev ? item->prev->next : data->first) = item->next;
+    (item->next ? item->next->prev : data->last)  = item->prev;
+    item->prev = item->next = nullptr;
+    releaseItem(item);
+}
+
+void obs_data_set_string(obs_data_t *data, const char *name, const char *val)
+{
+    if (obs_data_item *item = itemForSet(data, name, OBS_DATA_STRING))
+        item->str = val ? val : "";
+}
+
+void obs_data_set_int(obs_data_t *data, const char *name, long long val)
+{
+    if (obs_data_item *item = itemForSet(data, name, OBS_DATA_NUMBER)) {
+        item->numtype = OBS_DATA_NUM_INT;
+        item->i       = val;
+    }
+}
+
+void obs_data_set_double(obs_data_t *data, const char *name, double val)
+{
+    if (obs_data_item *item = itemForSet(data, name, OBS_DATA_NUMBER)) {
+        item->numtype = OBS_DATA_NUM_DOUBLE;
+        item->d       = val;
+    }
+}
+
+void obs_data_set_bool(obs_data_t *data, const char *name, bool val)
+{
+    if (obs_data_item *item = itemForSet(data, name, OBS_DATA_BOOLEAN))
+        item->b = val;
+}
+
+void obs_data_set_obj(obs_data_t *data, const char *name, obs_data_t *obj)
+{
+    obs_data_addref(obj);           /* before clearing, in case obj is the old value */
+    if (obs_data_item *item = itemForSet(data, name, OBS_DATA_OBJECT))
+        item->obj = obj;
+    else
+        obs_data_release(obj);
+}
+
+void obs_data_set_array(obs_data_t *data, const char *name, obs_data_array_t *array)
+{
+    obs_data_array_addref(array);
+    if (obs_data_item *item = itemForSet(data, name, OBS_DATA_ARRAY))
+        item->array = array;
+    else
+        obs_data_array_release(array);
+}
+
+const char *obs_data_get_string(obs_data_t *data, const char *name)
+{
+    return obs_data_item_get_string(findItem(data, name));
+}
+
+long long obs_data_get_int(obs_data_t *data, const char *name)
+{
+    return obs_data_item_get_int(findItem(data, name));
+}
+
+double obs_data_get_double(obs_data_t *data, const char *name)
+{
+    return obs_data_item_get_double(findItem(data, name));
+}
+
+bool obs_data_get_bool(obs_data_t *data, const char *name)
+{
+    return obs_data_item_get_bool(findItem(data, name));
+}
+
+obs_data_t *obs_data_get_obj(obs_data_t *data, const char *name)
+{
+    return obs_data_item_get_obj(findItem(data, name));
+}
+
+obs_data_array_t *obs_data_get_array(obs_data_t *data, const char *name)
+{
+    return obs_data_item_get_array(findItem(data, name));
+}
+
+bool obs_data_has_user_value(obs_data_t *data, const char *name)
+{
+    return findItem(data, name) != nullptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  obs_data_array                                                           */
+/* ------------------------------------------------------------------------- */
+obs_data_array_t *obs_data_array_create(void)
+{
+    return new obs_data_array;
+}
+
+void obs_data_array_addref(obs_data_array_t *array)
+{
+    if (array)
+        array->ref.fetch_add(1, std::memory_order_relaxed);
+}
+
+void obs_data_array_release(obs_data_array_t *array)
+{
+    if (!array || array->ref.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+    for (obs_data_t *item : array->items)
+        obs_data_release(item);
+    delete array;
+}
+
+size_t obs_data_array_count(obs_data_array_t *array)
+{
+    return array ? array->items.size() : 0;
+}
+
+obs_data_t *obs_data_array_item(obs_data_array_t *array, size_t idx)
+{
+    if (!array || idx >= array->items.size())
+        return nullptr;
+    obs_data_addref(array->items[idx]);
+    return array->items[idx];
+}
+
+size_t obs_data_array_push_back(obs_data_array_t *array, obs_data_t *obj)
+{
+    if (!array || !obj)
+        return 0;
+    obs_data_addref(obj);
+    array->items.push_back(obj);
+    return array->items.size() - 1;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Items                                                                    */
+/* ------------------------------------------------------------------------- */
+obs_data_item_t *obs_data_first(obs_data_t *data)
+{
+    obs_data_item *item = data ? data->first : nullptr;
+    if (item)
+        item->ref.fetch_add(1, std::memory_order_relaxed);
+    return item;
+}
+
+obs_data_item_t *obs_data_item_byname(obs_data_t *data, const char *name)
+{
+    obs_data_item *item = findItem(data, name);
+    if (item)
+        item->ref.fetch_add(1, std::memory_order_relaxed);
+    return item;
+}
+
+bool obs_data_item_next(obs_data_item_t **item)
+{
+    if (!item || !*item)
+        return false;
+    obs_data_item *next = (*item)->next;
+    if (next)
+        next->ref.fetch_add(1, std::memory_order_relaxed);
+    releaseItem(*item);
+    *item = next;
+    return next != nullptr;
+}
+
+void obs_data_item_release(obs_data_item_t **item)
+{
+    if (item) {
+        releaseItem(*item);
+        *item = nullptr;
+    }
+}
+
+enum obs_data_type obs_data_item_gettype(obs_data_item_t *item)
+{
+    return item ? item->type : OBS_DATA_NULL;
+}
+
+enum obs_data_number_type obs_data_item_numtype(obs_data_item_t *item)
+{
+    return item && item->type == OBS_DATA_NUMBER ? item->numtype : OBS_DATA_NUM_INVALID;
+}
+
+const char *obs_data_item_get_name(obs_data_item_t *item)
+{
+    return item ? item->name.c_str() : nullptr;
+}
+
+bool obs_data_item_has_user_value(obs_data_item_t *item)
+{
+    return item != nullptr;
+}
+
+const char *obs_data_item_get_string(obs_data_item_t *item)
+{
+    return item && item->type == OBS_DATA_STRING ? item->str.c_str() : "";
+}
+
+long long obs_data_item_get_int(obs_data_item_t *item)
+{
+    if (!item || item->type != OBS_DATA_NUMBER)
+        return 0;
+    return item->numtype == OBS_DATA_NUM_DOUBLE ? static_cast<long long>(item->d) : item->i;
+}
+
+double obs_data_item_get_double(obs_data_item_t *item)
+{
+    if (!item || item->type != OBS_DATA_NUMBER)
+        return 0.0;
+    return item->numtype == OBS_DATA_NUM_INT ? static_cast<double>(item->i) : item->d;
+}
+
+bool obs_data_item_get_bool(obs_data_item_t *item)
+{
+    return item && item->type == OBS_DATA_BOOLEAN && item->b;
+}
+
+obs_data_t *obs_data_item_get_obj(obs_data_item_t *item)
+{
+    if (!item || item->type != OBS_DATA_OBJECT)
+        return nullptr;
+    obs_data_addref(item->obj);
+    return item->obj;
+}
+
+obs_data_array_t *obs_data_item_get_array(obs_data_item_t *item)
+{
+    if (!item || item->type != OBS_DATA_ARRAY)
+        return nullptr;
+    obs_data_array_addref(item->array);
+    return item->array;
+}
+
+} // extern "C"
+
+/* ------------------------------------------------------------------------- */
+/*  Stand-in controls                                                        */
+/* ------------------------------------------------------------------------- */
+namespace ObsStandin {
+
+void setConfigDir(const char *dir)
+{
+    std::lock_guard<std::mutex> lock(g_configDirMutex);
+    g_configDir = dir ? dir : "";
+}
+
+uint64_t logLines()
+{
+    return g_logLines.load(std::memory_order_relaxed);
+}
+
+void setLogEcho(bool echo)
+{
+    g_logEcho.store(echo, std::memory_order_relaxed);
+}
+
+} // namespace ObsStandin
@@ -0,0 +1,24 @@
+/*!
+ * @file obs-standin.h
+ * @brief Controls for the libobs stand-in that have no libobs equivalent.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace ObsStandin {
+
+/// Directory obs_module_config_path() resolves against. Created on demand.
+void setConfigDir(const char *dir);
+
+/// Lines that reached blogva(). Output goes to stderr only if @p echo is set.
+uint64_t logLines();
+void setLogEcho(bool echo);
+
+} // namespace ObsStandin
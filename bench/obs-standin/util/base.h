@@ -0,0 +1,31 @@
+/*!
+ * @file util/base.h
+ * @brief Logging part of the libobs stand-in used by the benchmarks.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include <stdarg.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+	LOG_ERROR = 100,
+	LOG_WARNING = 200,
+	LOG_INFO = 300,
+	LOG_DEBUG = 400,
+};
+
+void blogva(int log_level, const char *format, va_list args);
+void blog(int log_level, const char *format, ...);
+
+#ifdef __cplusplus
+}
+#endif
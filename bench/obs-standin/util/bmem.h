@@ -0,0 +1,26 @@
+/*!
+ * @file util/bmem.h
+ * @brief Allocation part of the libobs stand-in used by the benchmarks.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void *bmalloc(size_t size);
+void *bzalloc(size_t size);
+void bfree(void *ptr);
+char *bstrdup(const char *str);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,45 @@
+/*!
+ * @file util/platform.h
+ * @brief File-system part of the libobs stand-in used by the benchmarks.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MKDIR_EXISTS 1
+#define MKDIR_SUCCESS 0
+#define MKDIR_ERROR -1
+
+FILE *os_fopen(const char *path, const char *mode);
+int os_mkdirs(const char *path);
+bool os_file_exists(const char *path);
+int os_rename(const char *old_path, const char *new_path);
+int os_unlink(const char *path);
+uint64_t os_gettime_ns(void);
+int64_t os_get_file_size(const char *path);
+
+struct os_dirent {
+	char d_name[256];
+	bool directory;
+};
+typedef struct os_dir os_dir_t;
+
+os_dir_t *os_opendir(const char *path);
+struct os_dirent *os_readdir(os_dir_t *dir);
+void os_closedir(os_dir_t *dir);
+
+#ifdef __cplusplus
+}
+#endif
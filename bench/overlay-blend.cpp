@@ -0,0 +1,144 @@
+/*!
+ * @file overlay-blend.cpp
+ * @brief Throughput of the overlay blend kernels at 1080p and 4K.
+ *
+ * Blends a full premultiplied BGRA frame over another with every kernel the
+ * machine supports, for two source patterns:
+ * - overlay: mostly transparent with opaque glyph runs and soft edges,
+ *   like the PlayFame overlay
+ * - mixed: random alpha everywhere (no fast paths apply)
+ * Each kernel's output is checked against the scalar kernel byte for byte.
+ *
+ * Usage: overlay-blend [--repeat R] [--min-ms MS]
+ * Prints one JSON document to stdout; exit code 1 if a kernel disagrees.
+ */
+
+#include "overlay-blend.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using namespace OverlayBlend;
+
+struct Resolution {
+    const char *name;
+    uint32_t    width;
+    uint32_t    height;
+};
+
+/* premultiplied pixel with alpha @p a and random colour */
+void putPixel(uint8_t *p, uint32_t a, std::mt19937 &rng)
+{
+    for (int c = 0; c < 3; ++c)
+        p[c] = static_cast<uint8_t>((rng() % 256) * a / 255);
+    p[3] = static_cast<uint8_t>(a);
+}
+
+std::vector<uint8_t> makeSource(uint32_t width, uint32_t height, bool overlayLike, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> px(size_t(width) * height * 4, 0);
+    for (size_t i = 0; i < size_t(width) * height;) {
+        if (!overlayLike) {
+            putPixel(&px[i * 4], rng() % 256, rng);
+            ++i;
+            continue;
+        }
+        /* runs: ~75% transparent, ~15% opaque, ~10% anti-aliased edge */
+        const uint32_t kind = rng() % 100;
+        const size_t   run  = std::min<size_t>(8 + rng() % 120, size_t(width) * height - i);
+        for (size_t j = 0; j < run; ++j, ++i) {
+            if (kind < 75)
+                continue;
+            putPixel(&px[i * 4], kind < 90 ? 255 : 1 + rng() % 254, rng);
+        }
+    }
+    return px;
+}
+
+double medianOf(std::vector<double> v)
+{
+    std::sort(v.begin(), v.end());
+    return v.empty() ? 0.0 : v[v.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int    repeat = 5;
+    double minMs  = 200.0;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--repeat"))
+            repeat = std::max(1, std::atoi(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--min-ms"))
+            minMs = std::max(1.0, std::atof(argv[i + 1]));
+    }
+
+    const Resolution resolutions[] = {{"1080p", 1920, 1080}, {"4k", 3840, 2160}};
+    const Kernel     kernels[]     = {Kernel::Scalar, Kernel::SSE2, Kernel::AVX2, Kernel::NEON};
+
+    bool ok    = true;
+    bool first = true;
+    std::printf("{\n  \"suite\": \"overlay-blend\",\n  \"best_kernel\": \"%s\",\n  \"repeat\": %d,\n"
+                "  \"results\": [",
+                kernelName(bestKernel()), repeat);
+
+    for (const Resolution &res : resolutions) {
+        const size_t pixels = size_t(res.width) * res.height;
+        const size_t stride = size_t(res.width) * 4;
+        const std::vector<uint8_t> background = makeSource(res.width, res.height, false, 7);
+
+        for (bool overlayLike : {true, false}) {
+            const std::vector<uint8_t> src = makeSource(res.width, res.height, overlayLike, 11);
+
+            std::vector<uint8_t> reference = background;
+            blendRect(rowFunction(Kernel::Scalar), reference.data(), stride, src.data(), stride, res.width,
+                      res.height);
+
+            for (Kernel kernel : kernels) {
+                const RowFn fn = rowFunction(kernel);
+                if (!fn)
+                    continue;
+
+                std::vector<uint8_t> dst = background;
+                blendRect(fn, dst.data(), stride, src.data(), stride, res.width, res.height);
+                const bool matches = dst == reference;
+                ok = ok && matches;
+
+                /* time whole frames; the destination is reset outside the clock */
+                std::vector<double> msPerFrame;
+                for (int r = 0; r < repeat; ++r) {
+                    double total  = 0.0;
+                    int    frames = 0;
+                    while (total < minMs) {
+                        std::memcpy(dst.data(), background.data(), dst.size());
+                        const auto t0 = Clock::now();
+                        blendRect(fn, dst.data(), stride, src.data(), stride, res.width, res.height);
+                        total += std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+                        ++frames;
+                    }
+                    msPerFrame.push_back(total / frames);
+                }
+
+                const double ms = medianOf(msPerFrame);
+                std::printf("%s\n    {\"kernel\": \"%s\", \"resolution\": \"%s\", \"pattern\": \"%s\", "
+                            "\"ms_per_frame\": %.3f, \"gpix_per_s\": %.3f, \"matches_scalar\": %s}",
+                            first ? "" : ",", kernelName(kernel), res.name, overlayLike ? "overlay" : "mixed", ms,
+                            static_cast<double>(pixels) / (ms * 1e6), matches ? "true" : "false");
+                first = false;
+            }
+        }
+    }
+
+    std::printf("\n  ],\n  \"ok\": %s\n}\n", ok ? "true" : "false");
+    return ok ? 0 : 1;
+}
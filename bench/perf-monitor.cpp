@@ -0,0 +1,227 @@
+/*!
+ * @file perf-monitor.cpp
+ * @brief Performance monitor: what the sampler costs, and its history and alerts.
+ *
+ * Cost part: a stand-in render thread advances OBS-like frame counters at
+ * 60 fps while PerfMonitor samples them every --interval-ms for --seconds
+ * through a probe doing what the libobs probe does (a dozen counter reads,
+ * a weak-reference lock and a process CPU time query). Reports the wall
+ * time per tick and the sampler thread's CPU time, which must stay under
+ * the default budget of 0.1% of one core.
+ *
+ * Then, with a scripted probe at 5 ms ticks, checks that:
+ * - the history holds the newest kHistory samples, oldest first
+ * - rates come from counter deltas, and a counter that starts over (an
+ *   output restart) reads as a restart, not a huge delta
+ * - an alert is raised only after the limit was crossed for the hold time,
+ *   and cleared likewise: a short dip or a single spike changes nothing
+ * - disabling pauses sampling and clears the alerts; failed probes count
+ *
+ * Usage: perf-monitor [--interval-ms N] [--seconds N]
+ * Prints one JSON object to stdout.
+ */
+
+#include "perf-monitor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/* what libobs keeps for the probe to read */
+struct FakeObs {
+    std::atomic<uint64_t> rendered{0};
+    std::atomic<uint64_t> lagged{0};
+    std::atomic<uint64_t> encoded{0};
+    std::atomic<uint64_t> skipped{0};
+    std::atomic<uint64_t> streamFrames{0};
+    std::atomic<uint64_t> streamDropped{0};
+    std::atomic<uint64_t> renderNs{4'000'000};
+    std::mutex            weakLock;
+    Clock::time_point     started = Clock::now();
+};
+
+bool readLikeObs(FakeObs &obs, PerfCounters &c)
+{
+    c.renderedFrames  = obs.rendered.load(std::memory_order_relaxed);
+    c.laggedFrames    = obs.lagged.load(std::memory_order_relaxed);
+    c.encodedFrames   = obs.encoded.load(std::memory_order_relaxed);
+    c.skippedFrames   = obs.skipped.load(std::memory_order_relaxed);
+    c.renderTimeNs    = obs.renderNs.load(std::memory_order_relaxed);
+    c.frameIntervalNs = 16'666'667;
+    c.fps             = 60.0;
+
+    /* os_cpu_usage_info_query() is a times() call and some arithmetic */
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    const double cpuUs  = static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1e6 +
+                          static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+    const double wallUs = std::chrono::duration<double, std::micro>(Clock::now() - obs.started).count();
+    c.cpuPercent        = wallUs > 0.0 ? cpuUs * 100.0 / wallUs : 0.0;
+
+    std::lock_guard<std::mutex> lock(obs.weakLock);
+    c.streaming     = true;
+    c.outputFrames  = obs.streamFrames.load(std::memory_order_relaxed);
+    c.droppedFrames = obs.streamDropped.load(std::memory_order_relaxed);
+    return true;
+}
+
+/* scripted counters: one step per probe call */
+struct Script {
+    std::atomic<int> calls{0};
+    std::atomic<int> failFrom{1 << 30};
+    float            load[256] = {};   ///< Render load per call, in %.
+};
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int intervalMs = 250;
+    int seconds    = 5;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--interval-ms"))
+            intervalMs = std::max(1, std::atoi(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--seconds"))
+            seconds = std::max(1, std::atoi(argv[i + 1]));
+    }
+
+    /* --- cost ---------------------------------------------------------- */
+    FakeObs           obs;
+    std::atomic<bool> rendering{true};
+    std::thread render([&] {
+        auto next = Clock::now();
+        while (rendering.load()) {
+            obs.rendered.fetch_add(1, std::memory_order_relaxed);
+            obs.encoded.fetch_add(1, std::memory_order_relaxed);
+            obs.streamFrames.fetch_add(1, std::memory_order_relaxed);
+            next += std::chrono::microseconds(16'667);
+            std::this_thread::sleep_until(next);
+        }
+    });
+
+    PerfMonitorOptions costOptions;
+    costOptions.interval = std::chrono::milliseconds(intervalMs);
+    PerfMonitor costMonitor([&](PerfCounters &c) { return readLikeObs(obs, c); });
+    costMonitor.start(costOptions);
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    costMonitor.stop();
+    rendering.store(false);
+    render.join();
+    const PerfMonitorStats cost = costMonitor.stats();
+
+    std::vector<PerfSample> costHistory(PerfMonitor::kHistory);
+    const size_t costCount = costMonitor.history(costHistory.data(), costHistory.size());
+    const bool   withinBudget = cost.cpuPercent <= costOptions.budgetPercent && cost.samples > 0;
+
+    /* --- scripted: ring, rates, alerts --------------------------------- */
+    Script script;
+    for (int i = 0; i < 256; ++i) {
+        /* 50% with the limit (100%) crossed from 20..39 and 42..59, a dip at 40..41, a spike at 100 */
+        const bool high = (i >= 20 && i < 40) || (i >= 42 && i < 60) || i == 100;
+        script.load[i]  = high ? 120.0f : 50.0f;
+    }
+
+    std::mutex             alertsLock;
+    std::vector<PerfAlert> alerts;
+    const auto scripted = [&](PerfCounters &c) {
+        const int n = script.calls.fetch_add(1);
+        if (n >= script.failFrom.load())
+            return false;
+        const int step = std::min(n, 255);
+        c.renderedFrames  = 60ull * static_cast<uint64_t>(n);
+        c.laggedFrames    = 3ull * static_cast<uint64_t>(n);                       /* 5% missed */
+        c.encodedFrames   = 60ull * static_cast<uint64_t>(n);
+        c.skippedFrames   = 0;
+        c.outputFrames    = 60ull * static_cast<uint64_t>(n % 50);                 /* restarts every 50 */
+        c.droppedFrames   = 6ull * static_cast<uint64_t>(n % 50);                  /* 10% dropped */
+        c.frameIntervalNs = 10'000'000;
+        c.renderTimeNs    = static_cast<uint64_t>(script.load[step] * 100'000.0f);
+        c.fps             = static_cast<double>(n);                               /* tags the sample */
+        c.streaming       = true;
+        return true;
+    };
+    PerfMonitor monitor(scripted, [&](const PerfAlert &alert) {
+        std::lock_guard<std::mutex> lock(alertsLock);
+        alerts.push_back(alert);
+    });
+
+    PerfMonitorOptions options;
+    options.interval = std::chrono::milliseconds(5);
+    options.hold     = std::chrono::milliseconds(40);
+    options.limit[static_cast<size_t>(PerfMetric::RenderLoad)] = 100.0f;
+    monitor.start(options);
+    while (script.calls.load() < 300)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    std::vector<PerfSample> history(PerfMonitor::kHistory + 8);
+    const size_t count  = monitor.history(history.data(), history.size());
+    bool         ordered = count == PerfMonitor::kHistory;
+    for (size_t i = 1; i < count; ++i)
+        ordered = ordered && history[i].fps == history[i - 1].fps + 1.0f && history[i].timeNs > history[i - 1].timeNs;
+
+    bool ratesOk = count > 0;
+    for (size_t i = 0; i < count; ++i) {
+        const PerfSample &s = history[i];
+        ratesOk = ratesOk && s.missed == 3 && s[PerfMetric::Missed] == 5.0f;
+        /* a restart reads as its new count: 0 frames, 0 dropped */
+        if (static_cast<int>(s.fps) % 50 != 0)
+            ratesOk = ratesOk && s.dropped == 6 && s[PerfMetric::Dropped] == 10.0f;
+        else
+            ratesOk = ratesOk && s.dropped == 0;
+    }
+
+    std::vector<PerfAlert> seen;
+    {
+        std::lock_guard<std::mutex> lock(alertsLock);
+        seen = alerts;
+    }
+    const bool alertsOk = seen.size() == 2 && seen[0].raised && !seen[1].raised &&
+                          seen[0].metric == PerfMetric::RenderLoad && seen[0].limit == 100.0f &&
+                          monitor.activeAlerts() == 0 && monitor.stats().alertsRaised == 1;
+
+    /* pause: nothing is written while disabled */
+    options.enabled = false;
+    monitor.setOptions(options);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    const uint64_t pausedAt = monitor.written();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    const bool paused = monitor.written() == pausedAt;
+
+    options.enabled = true;
+    script.failFrom.store(0);
+    monitor.setOptions(options);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    monitor.stop();
+    const PerfMonitorStats scriptedStats = monitor.stats();
+    const bool failuresCounted = scriptedStats.probeFailures > 0 && monitor.written() == pausedAt;
+
+    const bool ok = withinBudget && costCount == std::min<size_t>(cost.samples, PerfMonitor::kHistory) && ordered &&
+                    ratesOk && alertsOk && paused && failuresCounted;
+
+    std::printf("{\"interval_ms\": %d, \"seconds\": %d, \"samples\": %llu, \"late_ticks\": %llu, "
+                "\"tick_us\": {\"p50\": %llu, \"p99\": %llu, \"max\": %llu}, \"sampler_cpu_us\": %llu, "
+                "\"sampler_cpu_percent\": %.4f, \"budget_percent\": %.2f, \"budget_us_per_tick\": %llu, "
+                "\"over_budget_ticks\": %llu, \"history_ordered\": %s, \"rates_ok\": %s, \"alerts\": %zu, "
+                "\"alerts_ok\": %s, \"paused\": %s, \"probe_failures\": %llu, \"ok\": %s}\n",
+                intervalMs, seconds, static_cast<unsigned long long>(cost.samples),
+                static_cast<unsigned long long>(cost.lateTicks), static_cast<unsigned long long>(cost.tickP50Us),
+                static_cast<unsigned long long>(cost.tickP99Us), static_cast<unsigned long long>(cost.tickMaxUs),
+                static_cast<unsigned long long>(cost.cpuUs), cost.cpuPercent, costOptions.budgetPercent,
+                static_cast<unsigned long long>(cost.budgetUs), static_cast<unsigned long long>(cost.overBudget),
+                ordered ? "true" : "false", ratesOk ? "true" : "false", seen.size(), alertsOk ? "true" : "false",
+                paused ? "true" : "false", static_cast<unsigned long long>(scriptedStats.probeFailures),
+                ok ? "true" : "false");
+    return ok ? 0 : 1;
+}
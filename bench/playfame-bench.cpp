@@ -0,0 +1,569 @@
+/*!
+ * @file playfame-bench.cpp
+ * @brief Microbenchmarks for the plugin core, run against the libobs stand-in.
+ *
+ * Covers the paths the plugin exercises most:
+ * - config.get / config.set: handle-based access by section size
+ * - config.save / config.load: durable save and cold (JSON) / warm (sidecar)
+ *   load by file size
+ * - config.validate: the range checks behind setValue()
+ * - config.journal_crash: what load() recovers from a damaged journal (a
+ *   check, not a timing: each case reports 1 when the outcome is right)
+ * - obs_log: synchronous, queued and rate-limited calls
+ *
+ * Each measurement runs in batches until it has taken at least --min-ms,
+ * then reports the median of --repeat such runs. Absolute numbers depend on
+ * the stand-in's obs_data; compare them between commits on the same machine.
+ *
+ * Usage: playfame-bench [--keys N[,N...]] [--file-keys N[,N...]] [--repeat R]
+ *                       [--min-ms MS] [--dir PATH] [--label TEXT] [--only PREFIX]
+ * Prints a single JSON document to stdout.
+ */
+
+#include "config-transaction.h"
+#include "obs-config-helper.h"
+#include "obs-standin.h"
+#include "plugin-log.h"
+#include "plugin-support.h"
+
+#include <QString>
+#include <QVariant>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::vector<size_t>   keys      = {100, 1000, 10000};
+    std::vector<size_t>   fileKeys  = {1000, 10000, 100000};
+    int                   repeat    = 5;
+    double                minMs     = 200.0;
+    std::filesystem::path dir       = std::filesystem::temp_directory_path() / "playfame-bench";
+    std::string           label;
+    std::string           only;
+};
+
+Options g_opt;
+bool    g_firstResult = true;
+
+std::vector<size_t> parseList(char *arg)
+{
+    std::vector<size_t> out;
+    for (char *tok = std::strtok(arg, ","); tok; tok = std::strtok(nullptr, ","))
+        out.push_back(static_cast<size_t>(std::atoll(tok)));
+    return out;
+}
+
+bool selected(const char *name)
+{
+    return g_opt.only.empty() || std::strncmp(name, g_opt.only.c_str(), g_opt.only.size()) == 0;
+}
+
+double median(std::vector<double> v)
+{
+    std::sort(v.begin(), v.end());
+    return v.empty() ? 0.0 : v[v.size() / 2];
+}
+
+double elapsedNs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+/* Calls fn(i) in growing batches until --min-ms has passed; returns ns per call. */
+double nsPerOp(const std::function<void(size_t)> &fn)
+{
+    size_t batch = 1;
+    size_t index = 0;
+    double totalNs = 0.0;
+    size_t ops = 0;
+    while (totalNs < g_opt.minMs * 1e6) {
+        const auto start = Clock::now();
+        for (size_t i = 0; i < batch; ++i)
+            fn(index++);
+        totalNs += elapsedNs(start);
+        ops += batch;
+        batch = std::min<size_t>(batch * 2, 1 << 20);
+    }
+    return totalNs / static_cast<double>(ops);
+}
+
+double medianNsPerOp(const std::function<void(size_t)> &fn)
+{
+    std::vector<double> runs;
+    for (int r = 0; r < g_opt.repeat; ++r)
+        runs.push_back(nsPerOp(fn));
+    return median(runs);
+}
+
+/* One entry of the "results" array; params and metrics are flat number maps. */
+void report(const char *name, std::initializer_list<std::pair<const char *, double>> params,
+          std::initializer_list<std::pair<const char *, double>> metrics)
+{
+    std::printf("%s\n    {\"name\": \"%s\", \"params\": {", g_firstResult ? "" : ",", name);
+    bool first = true;
+    for (const auto &[k, v] : params) {
+        std::printf("%s\"%s\": %.0f", first ? "" : ", ", k, v);
+        first = false;
+    }
+    std::printf("}, \"metrics\": {");
+    first = true;
+    for (const auto &[k, v] : metrics) {
+        std::printf("%s\"%s\": %.3f", first ? "" : ", ", k, v);
+        first = false;
+    }
+    std::printf("}}");
+    std::fflush(stdout);
+    g_firstResult = false;
+}
+
+std::string keyName(size_t i)
+{
+    return "key_" + std::to_string(i);
+}
+
+void removeConfigFiles(const char *file)
+{
+    char *raw = obs_module_config_path(file);
+    const std::string path = raw ? raw : "";
+    bfree(raw);
+    for (const char *suffix : {"", ".bak", ".tmp", ".bin", ".journal"}) {
+        std::error_code ec;
+        std::filesystem::remove(path + suffix, ec);
+    }
+}
+
+std::string configPath(const char *file, const char *suffix = "")
+{
+    char *raw = obs_module_config_path(file);
+    const std::string path = std::string(raw ? raw : "") + suffix;
+    bfree(raw);
+    return path;
+}
+
+uint64_t fileSize(const char *file, const char *suffix = "")
+{
+    char *raw = obs_module_config_path(file);
+    const std::string path = std::string(raw ? raw : "") + suffix;
+    bfree(raw);
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    return ec ? 0 : static_cast<uint64_t>(size);
+}
+
+/* ------------------------------------------------------------------------- */
+/*  get / set                                                                */
+/* ------------------------------------------------------------------------- */
+void benchGetSet(size_t keys)
+{
+    const std::string file = "getset-" + std::to_string(keys) + ".json";
+    removeConfigFiles(file.c_str());
+    OBSConfigHelper cfg(file.c_str());
+
+    std::vector<ConfigKey> handles;
+    handles.reserve(keys);
+    {
+        ConfigTransaction tx = cfg.begin();
+        for (size_t i = 0; i < keys; ++i) {
+            handles.push_back(cfg.key("Bench", keyName(i).c_str()));
+            tx.set<long long>(handles.back(), static_cast<long long>(i));
+        }
+        tx.commit(false);
+    }
+
+    /* random order so the index is not walked sequentially */
+    std::vector<size_t> order(keys);
+    for (size_t i = 0; i < keys; ++i)
+        order[i] = i;
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+    const auto pick = [&](size_t i) -> const ConfigKey & { return handles[order[i % keys]]; };
+
+    long long sink = 0;
+    if (selected("config.get")) {
+        const double getNs = medianNsPerOp([&](size_t i) { sink += cfg.get<long long>(pick(i)); });
+        const double readerNs = medianNsPerOp([&](size_t i) {
+            ConfigReader reader = cfg.reader();
+            for (size_t k = 0; k < 16; ++k)
+                sink += reader.get<long long>(pick(i * 16 + k));
+        }) / 16.0;
+        report("config.get", {{"keys", double(keys)}},
+             {{"ns_per_op", getNs}, {"ns_per_op_shared_reader", readerNs}, {"mops", 1e3 / getNs}});
+    }
+
+    if (selected("config.set")) {
+        const double setNs = medianNsPerOp([&](size_t i) { cfg.set<long long>(pick(i), static_cast<long long>(i)); });
+        report("config.set", {{"keys", double(keys)}}, {{"ns_per_op", setNs}, {"ops_per_s", 1e9 / setNs}});
+    }
+
+    if (sink == 42)
+        std::fprintf(stderr, " ");  /* keeps the reads observable */
+}
+
+/* ------------------------------------------------------------------------- */
+/*  load / save                                                              */
+/* ------------------------------------------------------------------------- */
+void benchLoadSave(size_t keys)
+{
+    const std::string file = "io-" + std::to_string(keys) + ".json";
+    removeConfigFiles(file.c_str());
+
+    {
+        OBSConfigHelper cfg(file.c_str());
+        ConfigTransaction tx = cfg.begin();
+        for (size_t i = 0; i < keys; ++i) {
+            const ConfigKey key = cfg.key(("Section" + std::to_string(i / 1000)).c_str(), keyName(i).c_str());
+            switch (i % 4) {
+            case 0: tx.set<long long>(key, static_cast<long long>(i) * 7919); break;
+            case 1: tx.set<double>(key, static_cast<double>(i) * 0.25); break;
+            case 2: tx.set<bool>(key, (i & 8) != 0); break;
+            default: tx.set<const char *>(key, "overlay-layout-entry-with-some-payload"); break;
+            }
+        }
+        tx.commit(false);
+
+        if (selected("config.save")) {
+            std::vector<double> callUs, durableUs;
+            for (int r = 0; r < g_opt.repeat; ++r) {
+                const auto start = Clock::now();
+                cfg.save();
+                callUs.push_back(elapsedNs(start) / 1e3);
+                cfg.flush(std::chrono::seconds(60));
+                durableUs.push_back(elapsedNs(start) / 1e3);
+            }
+            report("config.save", {{"keys", double(keys)}, {"json_bytes", double(fileSize(file.c_str()))}},
+                 {{"call_us", median(callUs)}, {"durable_us", median(durableUs)}});
+        } else {
+            cfg.save();
+        }
+    }                                   /* destructor writes anything pending */
+
+    if (!selected("config.load"))
+        return;
+
+    OBSConfigHelper cfg(file.c_str());
+    char *raw = obs_module_config_path(file.c_str());
+    const std::string cache = std::string(raw ? raw : "") + ".bin";
+    bfree(raw);
+
+    std::vector<double> coldUs, warmUs;
+    for (int r = 0; r < g_opt.repeat; ++r) {
+        std::error_code ec;
+        std::filesystem::remove(cache, ec);
+        auto start = Clock::now();
+        cfg.load();
+        coldUs.push_back(elapsedNs(start) / 1e3);
+        cfg.flush(std::chrono::seconds(60));    /* sidecar rebuild stays out of the timings */
+
+        start = Clock::now();
+        cfg.load();
+        warmUs.push_back(elapsedNs(start) / 1e3);
+        if (!cfg.loadStats().fromCache)
+            std::fprintf(stderr, "config.load: sidecar not used for %zu keys\n", keys);
+    }
+    report("config.load",
+         {{"keys", double(keys)}, {"json_bytes", double(fileSize(file.c_str()))},
+          {"cache_bytes", double(fileSize(file.c_str(), ".bin"))}},
+         {{"json_us", median(coldUs)}, {"cache_us", median(warmUs)}});
+}
+
+/* ------------------------------------------------------------------------- */
+/*  validate                                                                 */
+/* ------------------------------------------------------------------------- */
+void benchValidate()
+{
+    if (!selected("config.validate"))
+        return;
+
+    removeConfigFiles("validate.json");
+    OBSConfigHelper cfg("validate.json");
+
+    /* out-of-range values are rejected by validate() before anything is written */
+    struct Case {
+        const char     *name;
+        QVariant        value, min, max;
+        QMetaType::Type type;
+    };
+    const Case cases[] = {
+        {"int", QVariant(500), QVariant(0), QVariant(100), QMetaType::Int},
+        {"double", QVariant(2.5), QVariant(0.0), QVariant(1.0), QMetaType::Double},
+        {"string", QVariant(QString("zzz")), QVariant(QString("a")), QVariant(QString("m")), QMetaType::QString},
+    };
+
+    const QString section = QStringLiteral("Bench");
+    const QString key     = QStringLiteral("value");
+    for (const Case &c : cases) {
+        int accepted = 0;
+        const double ns = medianNsPerOp([&](size_t) {
+            accepted += cfg.setValue(section, key, c.value, c.type, c.min, c.max);
+        });
+        if (accepted)
+            std::fprintf(stderr, "config.validate: %s case was accepted\n", c.name);
+        std::printf("%s\n    {\"name\": \"config.validate\", \"params\": {\"type\": \"%s\"}, "
+                    "\"metrics\": {\"ns_per_op\": %.3f}}",
+                    g_firstResult ? "" : ",", c.name, ns);
+        g_firstResult = false;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/*  journal crash safety                                                     */
+/* ------------------------------------------------------------------------- */
+constexpr int kCrashKeys    = 10;
+constexpr int kCrashRecords = 5;    /* keys 0..4 are journalled over the JSON */
+
+/* JSON with every key at 1, then one synced journal record per key 0..4
+ * setting it to 2. Records reach the disk at save(), so each set is saved. */
+void prepareJournal(const char *file)
+{
+    removeConfigFiles(file);
+    {
+        OBSConfigHelper cfg(file);
+        for (int i = 0; i < kCrashKeys; ++i)
+            cfg.set<long long>(cfg.key("Crash", keyName(i).c_str()), 1);
+        cfg.save();
+        cfg.flush(std::chrono::seconds(60));
+    }
+    OBSConfigHelper cfg(file);
+    cfg.setJournalMode(true, 1 << 20);
+    cfg.load();
+    for (int i = 0; i < kCrashRecords; ++i) {
+        cfg.set<long long>(cfg.key("Crash", keyName(i).c_str()), 2);
+        cfg.save();
+        cfg.flush(std::chrono::seconds(60));
+    }
+}
+
+/* Loads file in journal mode; true if key i holds expected(i) for every key. */
+bool loadsAs(const char *file, const std::function<long long(int)> &expected)
+{
+    OBSConfigHelper cfg(file);
+    cfg.setJournalMode(true, 1 << 20);
+    cfg.load();
+    bool ok = true;
+    for (int i = 0; i < kCrashKeys; ++i)
+        ok &= cfg.get<long long>(cfg.key("Crash", keyName(i).c_str()), -1) == expected(i);
+    return ok;
+}
+
+void rewriteFile(const std::string &path, const std::function<void(std::string &)> &edit)
+{
+    std::string data;
+    if (FILE *f = std::fopen(path.c_str(), "rb")) {
+        char buf[4096];
+        for (size_t n; (n = std::fread(buf, 1, sizeof(buf), f)) > 0;)
+            data.append(buf, n);
+        std::fclose(f);
+    }
+    edit(data);
+    if (FILE *f = std::fopen(path.c_str(), "wb")) {
+        std::fwrite(data.data(), 1, data.size(), f);
+        std::fclose(f);
+    }
+}
+
+void benchJournalCrash()
+{
+    if (!selected("config.journal_crash"))
+        return;
+
+    const char *file = "journal-crash.json";
+    const std::string journal = configPath(file, ".journal");
+
+    /* torn tail: the last append was cut short; every record before it survives,
+     * and the file is cut back so the next append is reachable */
+    prepareJournal(file);
+    rewriteFile(journal, [](std::string &d) { d.resize(d.size() - 3); });
+    bool torn = loadsAs(file, [](int i) { return i < kCrashRecords - 1 ? 2 : 1; });
+    {
+        OBSConfigHelper cfg(file);
+        cfg.setJournalMode(true, 1 << 20);
+        cfg.load();
+        cfg.set<long long>(cfg.key("Crash", keyName(kCrashKeys - 1).c_str()), 3);
+        cfg.save();
+        cfg.flush(std::chrono::seconds(60));
+    }
+    torn &= loadsAs(file, [](int i) { return i < kCrashRecords - 1 ? 2 : i == kCrashKeys - 1 ? 3 : 1; });
+
+    /* CRC mismatch in the middle: replay stops before the damaged record */
+    prepareJournal(file);
+    const uint64_t recordBytes = (fileSize(file, ".journal") - 16) / kCrashRecords;
+    rewriteFile(journal, [&](std::string &d) { d[16 + 3 * recordBytes - 1] ^= 0x5a; });
+    const bool crc = loadsAs(file, [](int i) { return i < 2 ? 2 : 1; });
+
+    /* base mismatch: a tool rewrote the JSON without knowing the journal, which
+     * is ignored; saves after that must land where the next load finds them */
+    prepareJournal(file);
+    std::filesystem::rename(journal, journal + ".held");
+    {
+        OBSConfigHelper tool(file);
+        for (int i = 0; i < kCrashKeys; ++i)
+            tool.set<long long>(tool.key("Crash", keyName(i).c_str()), i == kCrashKeys - 1 ? 7 : 1);
+        tool.save();
+        tool.flush(std::chrono::seconds(60));
+    }
+    std::filesystem::rename(journal + ".held", journal);
+    bool base = loadsAs(file, [](int i) { return i == kCrashKeys - 1 ? 7 : 1; });
+    {
+        OBSConfigHelper cfg(file);
+        cfg.setJournalMode(true, 1 << 20);
+        cfg.load();
+        cfg.set<long long>(cfg.key("Crash", keyName(0).c_str()), 4);
+        cfg.save();
+        cfg.flush(std::chrono::seconds(60));
+    }
+    base &= loadsAs(file, [](int i) { return i == 0 ? 4 : i == kCrashKeys - 1 ? 7 : 1; });
+
+    /* compaction that wrote the JSON but died before the journal rename: the
+     * old journal no longer matches and the JSON already holds its records */
+    prepareJournal(file);
+    const std::string held = journal + ".held";
+    std::filesystem::copy_file(journal, held, std::filesystem::copy_options::overwrite_existing);
+    {
+        OBSConfigHelper cfg(file);
+        cfg.setJournalMode(true, 1);    /* every save compacts */
+        cfg.load();
+        cfg.set<long long>(cfg.key("Crash", keyName(kCrashRecords).c_str()), 3);
+        cfg.save();
+        cfg.flush(std::chrono::seconds(60));
+    }
+    std::filesystem::rename(held, journal);
+    const bool compaction = loadsAs(file, [](int i) { return i < kCrashRecords ? 2 : i == kCrashRecords ? 3 : 1; });
+
+    if (!(torn && crc && base && compaction))
+        std::fprintf(stderr, "config.journal_crash: torn %d, crc %d, base %d, compaction %d\n", torn, crc, base,
+                     compaction);
+    report("config.journal_crash", {{"records", double(kCrashRecords)}},
+         {{"torn_tail_ok", double(torn)}, {"crc_mismatch_ok", double(crc)}, {"base_mismatch_ok", double(base)},
+          {"failed_compaction_ok", double(compaction)}});
+    removeConfigFiles(file);
+}
+
+/* ------------------------------------------------------------------------- */
+/*  obs_log                                                                  */
+/* ------------------------------------------------------------------------- */
+constexpr size_t kLogSites = 256;
+
+/* Distinct call sites, so the per-site rate limit does not hide the queued path. */
+template<size_t N> const char *logFormat()
+{
+    static const char format[] = "[bench] site message %d value=%s";
+    return format;
+}
+
+template<size_t... N> std::vector<const char *> logFormats(std::index_sequence<N...>)
+{
+    return {logFormat<N>()...};
+}
+
+void waitForDrain()
+{
+    for (int i = 0; i < 1000; ++i) {
+        plugin_log_stats stats{};
+        plugin_log_get_stats(&stats);
+        if (stats.written >= stats.queued)
+            return;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void benchLog()
+{
+    if (!selected("obs_log"))
+        return;
+
+    /* 1) before plugin_log_start(): formatted on the caller, as plain blog() */
+    const double syncNs = medianNsPerOp([](size_t i) {
+        obs_log(LOG_INFO, "[bench] sync message %d value=%s", static_cast<int>(i), "text");
+    });
+
+    plugin_log_start();
+
+    /* 2) queued: a burst per site, timed in slices the drain can keep up with */
+    const std::vector<const char *> formats = logFormats(std::make_index_sequence<kLogSites>());
+    constexpr size_t kSlice = 128;          /* below the 256-slot ring */
+    std::vector<double> queuedRuns;
+    plugin_log_stats before{}, after{};
+    for (int r = 0; r < g_opt.repeat; ++r) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1100));   /* fresh rate-limit window */
+        plugin_log_get_stats(&before);
+        double ns = 0.0;
+        size_t calls = 0;
+        for (size_t burst = 0; burst < 16; ++burst) {
+            for (size_t site = 0; site < kLogSites; site += kSlice) {
+                const auto start = Clock::now();
+                for (size_t k = 0; k < kSlice; ++k)
+                    obs_log(LOG_INFO, formats[site + k], static_cast<int>(k), "text");
+                ns += elapsedNs(start);
+                calls += kSlice;
+                waitForDrain();
+            }
+        }
+        plugin_log_get_stats(&after);
+        if (after.suppressed != before.suppressed || after.dropped != before.dropped)
+            std::fprintf(stderr, "obs_log: queued run was rate limited or dropped\n");
+        queuedRuns.push_back(ns / static_cast<double>(calls));
+    }
+
+    /* 3) one hot site past its budget: the rate limiter's early exit */
+    const double limitedNs = medianNsPerOp([](size_t i) {
+        obs_log(LOG_INFO, "[bench] hot message %d value=%s", static_cast<int>(i), "text");
+    });
+
+    plugin_log_stop();
+
+    report("obs_log", {},
+         {{"sync_ns", syncNs}, {"queued_ns", median(queuedRuns)}, {"rate_limited_ns", limitedNs},
+          {"blog_lines", double(ObsStandin::logLines())}});
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--keys"))
+            g_opt.keys = parseList(argv[i + 1]);
+        else if (!std::strcmp(argv[i], "--file-keys"))
+            g_opt.fileKeys = parseList(argv[i + 1]);
+        else if (!std::strcmp(argv[i], "--repeat"))
+            g_opt.repeat = std::max(1, std::atoi(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--min-ms"))
+            g_opt.minMs = std::max(1.0, std::atof(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--dir"))
+            g_opt.dir = argv[i + 1];
+        else if (!std::strcmp(argv[i], "--label"))
+            g_opt.label = argv[i + 1];
+        else if (!std::strcmp(argv[i], "--only"))
+            g_opt.only = argv[i + 1];
+    }
+    std::filesystem::create_directories(g_opt.dir);
+    ObsStandin::setConfigDir(g_opt.dir.string().c_str());
+
+    std::printf("{\n  \"suite\": \"%s\",\n  \"label\": \"%s\",\n  \"repeat\": %d,\n  \"min_ms\": %.0f,\n"
+                "  \"results\": [",
+                PLUGIN_NAME, g_opt.label.c_str(), g_opt.repeat, g_opt.minMs);
+
+    for (size_t keys : g_opt.keys)
+        benchGetSet(keys);
+    for (size_t keys : g_opt.fileKeys)
+        benchLoadSave(keys);
+    benchValidate();
+    benchJournalCrash();
+    benchLog();
+
+    std::printf("\n  ]\n}\n");
+    return 0;
+}
@@ -0,0 +1,225 @@
+/*!
+ * @file plugin-executor.cpp
+ * @brief Plugin executor: interactive latency under background load, stealing, cancellation.
+ *
+ * Keeps --background-ms long Background tasks (a disk write stand-in) queued
+ * --backlog deep while posting --interactive short Interactive tasks, once
+ * with the two lanes and once with everything on one lane, as a pool
+ * without priorities would run it. Reports how long Interactive tasks
+ * waited in each case. Then checks that:
+ * - a burst posted from one worker is spread by stealing
+ * - cancelled and group-cancelled tasks never run, delayed ones included
+ * - postAfter() fires no earlier than asked, and reports how late it is
+ * - a continuation without a context gets the work's result
+ * - shutdown() runs what is still queued and later posts fail
+ *
+ * Usage: plugin-executor [--workers N] [--interactive N] [--backlog N] [--background-ms N]
+ * Prints one JSON object to stdout.
+ */
+
+#include "plugin-executor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double percentile(std::vector<double> v, double q)
+{
+    if (v.empty())
+        return 0;
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, static_cast<size_t>(q * static_cast<double>(v.size())))];
+}
+
+/* blocks like a write would, without burning a core */
+void io(int ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+struct LatencyRun {
+    double p50Ms = 0, p99Ms = 0, maxMs = 0;
+};
+
+/* interactive tasks posted every millisecond while background work stays queued */
+LatencyRun interactiveUnderLoad(size_t workers, TaskLane interactiveLane, int interactive, int backlog,
+                                int backgroundMs)
+{
+    ExecutorOptions options;
+    options.workers = workers;
+    PluginExecutor executor;
+    executor.start(options);
+
+    std::atomic<bool> stop{false};
+    std::atomic<int>  queued{0};
+    std::thread feeder([&] {
+        while (!stop.load()) {
+            while (queued.load() < backlog) {
+                queued.fetch_add(1);
+                executor.post(TaskLane::Background, [&] {
+                    io(backgroundMs);
+                    queued.fetch_sub(1);
+                });
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(backgroundMs * 2));   /* saturate first */
+
+    std::mutex          mutex;
+    std::vector<double> waits;
+    std::atomic<int>    done{0};
+    for (int i = 0; i < interactive; ++i) {
+        const Clock::time_point posted = Clock::now();
+        executor.post(interactiveLane, [&, posted] {
+            const double ms = std::chrono::duration<double, std::milli>(Clock::now() - posted).count();
+            std::lock_guard<std::mutex> lock(mutex);
+            waits.push_back(ms);
+            done.fetch_add(1);
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    while (done.load() < interactive)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    stop.store(true);
+    feeder.join();
+    executor.shutdown();
+
+    LatencyRun run;
+    run.p50Ms = percentile(waits, 0.50);
+    run.p99Ms = percentile(waits, 0.99);
+    run.maxMs = percentile(waits, 1.0);
+    return run;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    size_t workers = 4;
+    int    interactive = 300, backlog = 32, backgroundMs = 20;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--workers"))
+            workers = static_cast<size_t>(std::max(2, std::atoi(argv[i + 1])));
+        else if (!std::strcmp(argv[i], "--interactive"))
+            interactive = std::max(10, std::atoi(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--backlog"))
+            backlog = std::max(1, std::atoi(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--background-ms"))
+            backgroundMs = std::max(1, std::atoi(argv[i + 1]));
+    }
+
+    const LatencyRun lanes  = interactiveUnderLoad(workers, TaskLane::Interactive, interactive, backlog, backgroundMs);
+    const LatencyRun single = interactiveUnderLoad(workers, TaskLane::Background, interactive, backlog, backgroundMs);
+
+    ExecutorOptions options;
+    options.workers = workers;
+    PluginExecutor executor;
+    executor.start(options);
+
+    /* fan-out from one worker: its own deque fills, the others steal */
+    constexpr int kFanOut = 20000;
+    std::atomic<int> fanned{0};
+    {
+        TaskGroup group(TaskLane::Interactive, executor);
+        group.post([&] {
+            for (int i = 0; i < kFanOut; ++i) {
+                executor.post(TaskLane::Interactive, [&] {
+                    volatile int spin = 0;
+                    for (int k = 0; k < 2000; ++k)
+                        spin = spin + k;
+                    fanned.fetch_add(1);
+                });
+            }
+        });
+        group.wait();
+    }
+    while (fanned.load() < kFanOut)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    const uint64_t stolen = executor.stats().lanes[static_cast<size_t>(TaskLane::Interactive)].stolen;
+
+    /* cancellation: by token, by group, delayed and ready */
+    std::atomic<int> ranCancelled{0};
+    const uint64_t cancelledBefore = executor.stats().lanes[static_cast<size_t>(TaskLane::Background)].cancelled;
+    {
+        CancelToken token = CancelToken::create();
+        for (int i = 0; i < 100; ++i)
+            executor.postAfter(std::chrono::milliseconds(30), TaskLane::Background, [&] { ranCancelled.fetch_add(1); },
+                               token);
+        token.cancel();
+        TaskGroup group(TaskLane::Background, executor);
+        for (int i = 0; i < 100; ++i)
+            group.postAfter(std::chrono::seconds(10), [&] { ranCancelled.fetch_add(1); });
+        group.cancel();
+        group.wait();             /* returns at once: the purge dropped them */
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    const uint64_t cancelled =
+        executor.stats().lanes[static_cast<size_t>(TaskLane::Background)].cancelled - cancelledBefore;
+
+    /* timer accuracy */
+    std::vector<double> lateMs;
+    bool early = false;
+    for (int i = 0; i < 50; ++i) {
+        const int delay = 1 + i % 10;
+        std::atomic<bool> fired{false};
+        const Clock::time_point posted = Clock::now();
+        executor.postAfter(std::chrono::milliseconds(delay), TaskLane::Interactive, [&] {
+            const double ms = std::chrono::duration<double, std::milli>(Clock::now() - posted).count();
+            early = early || ms < delay;
+            lateMs.push_back(ms - delay);
+            fired.store(true);
+        });
+        while (!fired.load())
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    /* continuation without a context: done() gets the result on the worker */
+    std::atomic<int> result{0};
+    executor.post(TaskLane::Interactive, [] { return 42; }, nullptr, [&](int value) { result.store(value); });
+    while (result.load() == 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    /* shutdown runs the queue, delayed tasks included; then posting fails */
+    std::atomic<int> drained{0};
+    for (int i = 0; i < 50; ++i)
+        executor.post(TaskLane::Background, [&] {
+            io(1);
+            drained.fetch_add(1);
+        });
+    executor.postAfter(std::chrono::seconds(30), TaskLane::Background, [&] { drained.fetch_add(1); });
+    const ExecutorStats before = executor.stats();
+    const auto s0 = Clock::now();
+    const bool joined = executor.shutdown();
+    const double shutdownMs = std::chrono::duration<double, std::milli>(Clock::now() - s0).count();
+    const bool rejected = !executor.post(TaskLane::Interactive, [] {});
+
+    const bool ok = lanes.p99Ms < backgroundMs && stolen > 0 && ranCancelled.load() == 0 && cancelled == 200 &&
+                    !early && result.load() == 42 && joined && drained.load() == 51 && rejected;
+
+    const ExecutorLaneStats &bg = before.lanes[static_cast<size_t>(TaskLane::Background)];
+    std::printf("{\"workers\": %zu, \"background_ms\": %d, \"backlog\": %d, \"interactive\": %d, "
+                "\"interactive_wait_ms\": {\"lanes\": {\"p50\": %.3f, \"p99\": %.3f, \"max\": %.3f}, "
+                "\"one_lane\": {\"p50\": %.3f, \"p99\": %.3f, \"max\": %.3f}}, \"fan_out\": %d, \"stolen\": %llu, "
+                "\"cancelled\": %llu, \"cancelled_ran\": %d, \"timer_late_ms\": {\"p50\": %.3f, \"p99\": %.3f}, "
+                "\"background_max_depth\": %zu, \"shutdown_ms\": %.2f, \"drained\": %d, \"post_rejected\": %s, "
+                "\"ok\": %s}\n",
+                workers, backgroundMs, backlog, interactive, lanes.p50Ms, lanes.p99Ms, lanes.maxMs, single.p50Ms,
+                single.p99Ms, single.maxMs, kFanOut, static_cast<unsigned long long>(stolen),
+                static_cast<unsigned long long>(cancelled), ranCancelled.load(), percentile(lateMs, 0.5),
+                percentile(lateMs, 0.99), bg.maxDepth, shutdownMs, drained.load(), rejected ? "true" : "false",
+                ok ? "true" : "false");
+    return ok ? 0 : 1;
+}
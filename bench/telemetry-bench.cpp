@@ -0,0 +1,267 @@
+/*!
+ * @file telemetry-bench.cpp
+ * @brief Enqueue latency, throughput and offline spooling of TelemetryPipeline.
+ *
+ * Runs the pipeline against the in-process collector stand-in:
+ * - enqueue: 1 and 4 threads enqueue as fast as they can; per-call latency
+ *   percentiles, and how many events a ring overflow dropped
+ * - throughput: one thread keeps the ring full; events per second delivered
+ *   to the collector and encoded bytes per event
+ * - offline: the collector is down for a whole session, batches go to a
+ *   bounded spool (oldest evicted); the next session uploads what is left.
+ *   Checks delivered == enqueued + drop reports - evicted, with no malformed
+ *   or duplicate batches.
+ *
+ * Usage: telemetry-bench [--events N] [--latency-us N] [--spool-kb N] [--dir PATH]
+ * Prints one JSON object to stdout.
+ */
+
+#include "obs-standin.h"
+#include "telemetry-collector.h"
+#include "telemetry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Percentiles {
+    double p50 = 0, p99 = 0, p999 = 0, max = 0;
+};
+
+Percentiles percentiles(std::vector<uint32_t> &ns)
+{
+    Percentiles p;
+    if (ns.empty())
+        return p;
+    std::sort(ns.begin(), ns.end());
+    const auto at = [&](double q) { return static_cast<double>(ns[std::min(ns.size() - 1, size_t(q * ns.size()))]); };
+    p.p50  = at(0.50);
+    p.p99  = at(0.99);
+    p.p999 = at(0.999);
+    p.max  = static_cast<double>(ns.back());
+    return p;
+}
+
+/* a scene-switch-like event; detail varies so batches are not trivially compressible */
+TelemetryEvent sampleEvent(uint64_t i)
+{
+    char detail[32];
+    std::snprintf(detail, sizeof(detail), "Scene %llu", static_cast<unsigned long long>(i % 37));
+    return TelemetryEvent::make(8 /* OBS_FRONTEND_EVENT_SCENE_CHANGED */, static_cast<int32_t>(i), detail);
+}
+
+bool waitFor(const std::function<bool()> &done, std::chrono::milliseconds timeout)
+{
+    const auto until = Clock::now() + timeout;
+    while (!done()) {
+        if (Clock::now() > until)
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    return true;
+}
+
+TelemetryOptions benchOptions(const std::string &spoolDir)
+{
+    TelemetryOptions options;
+    options.spoolDir      = QByteArray::fromStdString(spoolDir);
+    options.maxBatchDelay = std::chrono::milliseconds(50);
+    options.retryMin      = std::chrono::milliseconds(5);
+    options.retryMax      = std::chrono::milliseconds(50);
+    options.pollInterval  = std::chrono::milliseconds(1);
+    return options;
+}
+
+struct EnqueueResult {
+    Percentiles latency;
+    uint64_t    accepted = 0;
+    uint64_t    dropped  = 0;
+    double      mEventsPerSec = 0;   ///< Enqueue calls per second, all threads.
+};
+
+EnqueueResult runEnqueue(unsigned threads, uint64_t perThread, std::chrono::microseconds latency,
+                         const std::string &dir)
+{
+    auto collector = std::make_unique<TelemetryCollector>(latency);
+    TelemetryPipeline pipeline(std::move(collector), benchOptions(dir));
+    pipeline.start();
+
+    std::vector<std::vector<uint32_t>> samples(threads);
+    std::vector<std::thread>           pool;
+    const auto t0 = Clock::now();
+    for (unsigned t = 0; t < threads; ++t)
+        pool.emplace_back([&, t] {
+            std::vector<uint32_t> &ns = samples[t];
+            ns.reserve(perThread);
+            for (uint64_t i = 0; i < perThread; ++i) {
+                const TelemetryEvent e = sampleEvent(i);
+                const auto a = Clock::now();
+                pipeline.enqueue(e);
+                ns.push_back(static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                       Clock::now() - a).count()));
+            }
+        });
+    for (auto &t : pool)
+        t.join();
+    const double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    std::vector<uint32_t> all;
+    for (auto &s : samples)
+        all.insert(all.end(), s.begin(), s.end());
+
+    pipeline.stop();
+    const TelemetryStats stats = pipeline.stats();
+
+    EnqueueResult r;
+    r.latency       = percentiles(all);
+    r.accepted      = stats.enqueued;
+    r.dropped       = stats.droppedQueueFull;
+    r.mEventsPerSec = static_cast<double>(threads * perThread) / seconds / 1e6;
+    std::filesystem::remove_all(dir);
+    return r;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    uint64_t events  = 1000000;
+    int64_t  latencyUs = 2000;
+    size_t   spoolKb = 64;
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "playfame-bench" / "telemetry";
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "--events"))
+            events = std::max<uint64_t>(1000, std::strtoull(argv[i + 1], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--latency-us"))
+            latencyUs = std::max<int64_t>(0, std::atoll(argv[i + 1]));
+        else if (!std::strcmp(argv[i], "--spool-kb"))
+            spoolKb = std::max<size_t>(4, std::strtoull(argv[i + 1], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--dir"))
+            dir = argv[i + 1];
+    }
+    const auto latency = std::chrono::microseconds(latencyUs);
+    ObsStandin::setConfigDir(dir.string().c_str());
+    std::filesystem::remove_all(dir);
+
+    bool ok = true;
+
+    /* enqueue latency, unpaced --------------------------------------------- */
+    const EnqueueResult one  = runEnqueue(1, events / 10, latency, (dir / "enqueue-1").string());
+    const EnqueueResult four = runEnqueue(4, events / 40, latency, (dir / "enqueue-4").string());
+
+    /* sustained throughput: the producer waits for ring space ---------------- */
+    double   deliveredPerSec = 0, bytesPerEvent = 0;
+    uint64_t throughputBatches = 0, throughputSpooled = 0;
+    {
+        auto collector = std::make_unique<TelemetryCollector>(latency);
+        TelemetryCollector *sink = collector.get();
+        /* large batches so the collector round-trip is not the limit */
+        TelemetryOptions options = benchOptions((dir / "throughput").string());
+        options.maxBatchEvents   = 4096;
+        options.maxBatchBytes    = 256 * 1024;
+        options.maxSpoolBytes    = size_t(1) << 40;   /* measure capacity, not eviction */
+        TelemetryPipeline pipeline(std::move(collector), options);
+        pipeline.start();
+        ok = waitFor([&] { return sink->counters().events >= 1; }, std::chrono::seconds(5)) && ok;   /* session start */
+
+        const auto t0 = Clock::now();
+        for (uint64_t i = 0; i < events; ++i) {
+            const TelemetryEvent e = sampleEvent(i);
+            while (!pipeline.enqueue(e))
+                std::this_thread::yield();
+        }
+        /* a full ring counts as a drop and is reported in-band; those reports are not ours */
+        const auto ours = [&] {
+            const TelemetryCollector::Counters c = sink->counters();
+            return c.events - c.dropReports;
+        };
+        ok = waitFor([&] { return ours() >= events + 1; }, std::chrono::seconds(120)) && ok;
+        const double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+
+        const TelemetryCollector::Counters c = sink->counters();
+        deliveredPerSec   = static_cast<double>(ours() - 1) / seconds;
+        throughputSpooled = pipeline.stats().spooledBatches;
+        bytesPerEvent     = static_cast<double>(c.bytes) / static_cast<double>(c.events);
+        throughputBatches = c.batches;
+        ok = ok && c.malformed == 0 && c.duplicates == 0;
+        pipeline.stop();
+    }
+
+    /* offline session, then recovery ----------------------------------------- */
+    const std::string spoolDir = (dir / "spool").string();
+    const uint64_t    offlineEvents = std::min<uint64_t>(events / 20, 50000);
+    TelemetryStats    offline, recovery;
+    TelemetryCollector::Counters delivered;
+    {
+        TelemetryOptions options = benchOptions(spoolDir);
+        options.maxSpoolBytes    = spoolKb * 1024;
+
+        auto collector = std::make_unique<TelemetryCollector>(latency);
+        TelemetryCollector *sink = collector.get();
+        sink->setOnline(false);
+        {
+            TelemetryPipeline pipeline(std::move(collector), options);
+            pipeline.start();
+            for (uint64_t i = 0; i < offlineEvents; ++i) {
+                const TelemetryEvent e = sampleEvent(i);
+                while (!pipeline.enqueue(e))
+                    std::this_thread::yield();
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            pipeline.stop();
+            offline = pipeline.stats();
+        }
+
+        auto online = std::make_unique<TelemetryCollector>(latency);
+        sink = online.get();
+        TelemetryPipeline pipeline(std::move(online), options);
+        pipeline.start();
+        /* + this session's start; the producer spins on a full ring, so drop reports are generated too */
+        const uint64_t expected = offline.enqueued + offline.generated - offline.droppedSpool + 1;
+        ok = waitFor([&] { return sink->counters().events >= expected; }, std::chrono::seconds(30)) && ok;
+        pipeline.stop();
+        recovery  = pipeline.stats();
+        delivered = sink->counters();
+        ok = ok && delivered.events == expected + recovery.generated && delivered.malformed == 0 &&
+             delivered.duplicates == 0 && recovery.spoolBytes == 0;
+    }
+    std::filesystem::remove_all(dir);
+
+    std::printf("{\"events\": %llu, \"collector_latency_us\": %lld, "
+                "\"enqueue_1t\": {\"p50_ns\": %.0f, \"p99_ns\": %.0f, \"p999_ns\": %.0f, \"max_ns\": %.0f, "
+                "\"calls_per_s_m\": %.1f, \"accepted\": %llu, \"dropped_ring_full\": %llu}, "
+                "\"enqueue_4t\": {\"p50_ns\": %.0f, \"p99_ns\": %.0f, \"p999_ns\": %.0f, \"max_ns\": %.0f, "
+                "\"calls_per_s_m\": %.1f, \"accepted\": %llu, \"dropped_ring_full\": %llu}, "
+                "\"throughput\": {\"delivered_events_per_s\": %.0f, \"bytes_per_event\": %.2f, \"batches\": %llu, "
+                "\"spooled_batches\": %llu}, "
+                "\"offline\": {\"events\": %llu, \"spool_kb\": %zu, \"spooled_batches\": %llu, "
+                "\"evicted_events\": %llu, \"upload_retries\": %llu, \"recovered_batches\": %llu, "
+                "\"delivered_events\": %llu}, \"ok\": %s}\n",
+                static_cast<unsigned long long>(events), static_cast<long long>(latencyUs), one.latency.p50,
+                one.latency.p99, one.latency.p999, one.latency.max, one.mEventsPerSec,
+                static_cast<unsigned long long>(one.accepted), static_cast<unsigned long long>(one.dropped),
+                four.latency.p50, four.latency.p99, four.latency.p999, four.latency.max, four.mEventsPerSec,
+                static_cast<unsigned long long>(four.accepted), static_cast<unsigned long long>(four.dropped),
+                deliveredPerSec, bytesPerEvent, static_cast<unsigned long long>(throughputBatches),
+                static_cast<unsigned long long>(throughputSpooled),
+                static_cast<unsigned long long>(offlineEvents), spoolKb,
+                static_cast<unsigned long long>(offline.spooledBatches),
+                static_cast<unsigned long long>(offline.droppedSpool),
+                static_cast<unsigned long long>(offline.uploadFailures),
+                static_cast<unsigned long long>(recovery.recoveredBatches),
+                static_cast<unsigned long long>(delivered.events), ok ? "true" : "false");
+    return ok ? 0 : 1;
+}
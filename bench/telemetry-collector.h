@@ -0,0 +1,97 @@
+/*!
+ * @file telemetry-collector.h
+ * @brief In-process stand-in for the telemetry backend.
+ *
+ * Behaves like TelemetryHttpUploader against a local collector: every
+ * upload costs a configurable round-trip, the collector can be switched
+ * offline (uploads are answered with Retry), and every accepted batch is
+ * decoded, so malformed or duplicate batches show up in the counters.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include "telemetry.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class TelemetryCollector : public TelemetryUploader {
+public:
+    struct Counters {
+        uint64_t batches     = 0;
+        uint64_t events      = 0;
+        uint64_t bytes       = 0;
+        uint64_t malformed   = 0;
+        uint64_t duplicates  = 0;
+        uint64_t refused     = 0;   ///< Uploads answered with Retry while offline.
+        uint64_t dropReports = 0;   ///< kTelemetryDropped events among the received ones.
+    };
+
+    explicit TelemetryCollector(std::chrono::microseconds latency)
+        : latency_(latency)
+    {
+    }
+
+    void setOnline(bool online) { online_.store(online); }
+
+    TelemetryUploadResult upload(const QByteArray &batch, uint32_t, const std::atomic<bool> &cancel) override
+    {
+        TelemetryUploadResult result;
+        const auto until = std::chrono::steady_clock::now() + latency_;
+        while (std::chrono::steady_clock::now() < until) {
+            if (cancel.load(std::memory_order_relaxed)) {
+                result.error = QStringLiteral("cancelled");
+                return result;
+            }
+            std::this_thread::sleep_for(std::min<std::chrono::microseconds>(latency_, std::chrono::milliseconds(1)));
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!online_.load()) {
+            ++counters_.refused;
+            result.error = QStringLiteral("collector offline");
+            return result;
+        }
+
+        std::vector<TelemetryEvent> events;
+        uint64_t session = 0, sequence = 0;
+        if (!TelemetryCodec::decode(batch, events, &session, &sequence)) {
+            ++counters_.malformed;
+            result.status = TelemetryUploadResult::Rejected;
+            result.error  = QStringLiteral("malformed batch");
+            return result;
+        }
+        if (!seen_.insert({session, sequence}).second)
+            ++counters_.duplicates;
+        ++counters_.batches;
+        counters_.events += events.size();
+        for (const TelemetryEvent &e : events)
+            counters_.dropReports += e.type == kTelemetryDropped ? 1 : 0;
+        counters_.bytes  += static_cast<uint64_t>(batch.size());
+        result.status = TelemetryUploadResult::Sent;
+        return result;
+    }
+
+    Counters counters() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return counters_;
+    }
+
+private:
+    const std::chrono::microseconds        latency_;
+    std::atomic<bool>                      online_{true};
+    mutable std::mutex                     mutex_;
+    Counters                               counters_;
+    std::set<std::pair<uint64_t, uint64_t>> seen_;
+};
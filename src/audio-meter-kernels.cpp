@@ -0,0 +1,339 @@
+/*!
+ * @file audio-meter-kernels.cpp
+ * @brief Implements the meter kernels with SSE2 (x86-64), NEON (AArch64)
+ *        and scalar code paths.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "audio-meter-kernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define PF_AUDIO_SSE2 1
+#include <emmintrin.h>
+#else
+#define PF_AUDIO_SSE2 0
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define PF_AUDIO_NEON 1
+#include <arm_neon.h>
+#else
+#define PF_AUDIO_NEON 0
+#endif
+
+namespace AudioKernels {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+/* float partial sums are folded into a double this often */
+constexpr size_t kSumChunk = 4096;
+
+/* Filter memory this small only decays further; zero it before it turns
+ * denormal and slows the audio thread down during silence. */
+constexpr double kFlushBelow = 1e-30;
+
+inline double flushTiny(double v)
+{
+    return std::fabs(v) < kFlushBelow ? 0.0 : v;
+}
+
+inline void flushState(KState &st)
+{
+    st.s1 = flushTiny(st.s1);
+    st.s2 = flushTiny(st.s2);
+    st.h1 = flushTiny(st.h1);
+    st.h2 = flushTiny(st.h2);
+}
+
+} // namespace
+
+/* ------------------------------------------------------------------------- */
+/*  Coefficients                                                             */
+/* ------------------------------------------------------------------------- */
+/* BS.1770-4 filters re-derived for any rate (constants as in libebur128) */
+KWeighting KWeighting::forSampleRate(double rate)
+{
+    KWeighting k{};
+
+    {
+        const double f0 = 1681.974450955533;
+        const double g  = 3.999843853973347;
+        const double q  = 0.7071752369554196;
+        const double K  = std::tan(kPi * f0 / rate);
+        const double vh = std::pow(10.0, g / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + K / q + K * K;
+        k.shelf = {(vh + vb * K / q + K * K) / a0, 2.0 * (K * K - vh) / a0, (vh - vb * K / q + K * K) / a0,
+                   2.0 * (K * K - 1.0) / a0, (1.0 - K / q + K * K) / a0};
+    }
+    {
+        const double f0 = 38.13547087602444;
+        const double q  = 0.5003270373238773;
+        const double K  = std::tan(kPi * f0 / rate);
+        const double a0 = 1.0 + K / q + K * K;
+        k.highPass = {1.0, -2.0, 1.0, 2.0 * (K * K - 1.0) / a0, (1.0 - K / q + K * K) / a0};
+    }
+    return k;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Scalar reference                                                         */
+/* ------------------------------------------------------------------------- */
+namespace Scalar {
+
+float peak(const float *x, size_t n)
+{
+    float m = 0.0f;
+    for (size_t i = 0; i < n; ++i)
+        m = std::max(m, std::fabs(x[i]));
+    return m;
+}
+
+double sumSquares(const float *x, size_t n)
+{
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i)
+        sum += static_cast<double>(x[i]) * x[i];
+    return sum;
+}
+
+void kWeightedSumSquares(const float *const *planes, size_t channels, size_t frames, const KWeighting &k,
+                         KState *states, double *out)
+{
+    const Biquad &s = k.shelf;
+    const Biquad &h = k.highPass;
+    for (size_t c = 0; c < channels; ++c) {
+        KState st  = states[c];
+        double acc = 0.0;
+        for (size_t i = 0; i < frames; ++i) {
+            const double x = planes[c][i];
+            const double y = s.b0 * x + st.s1;
+            st.s1 = s.b1 * x - s.a1 * y + st.s2;
+            st.s2 = s.b2 * x - s.a2 * y;
+            const double z = h.b0 * y + st.h1;
+            st.h1 = h.b1 * y - h.a1 * z + st.h2;
+            st.h2 = h.b2 * y - h.a2 * z;
+            acc += z * z;
+        }
+        flushState(st);
+        states[c] = st;
+        out[c]    = acc;
+    }
+}
+
+} // namespace Scalar
+
+/* ------------------------------------------------------------------------- */
+/*  SSE2                                                                     */
+/* ------------------------------------------------------------------------- */
+#if PF_AUDIO_SSE2
+float peak(const float *x, size_t n)
+{
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    __m128 m0 = _mm_setzero_ps();
+    __m128 m1 = _mm_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        m0 = _mm_max_ps(m0, _mm_and_ps(_mm_loadu_ps(x + i), absMask));
+        m1 = _mm_max_ps(m1, _mm_and_ps(_mm_loadu_ps(x + i + 4), absMask));
+    }
+    m0 = _mm_max_ps(m0, m1);
+    m0 = _mm_max_ps(m0, _mm_movehl_ps(m0, m0));
+    m0 = _mm_max_ss(m0, _mm_shuffle_ps(m0, m0, 1));
+    return std::max(_mm_cvtss_f32(m0), Scalar::peak(x + i, n - i));
+}
+
+double sumSquares(const float *x, size_t n)
+{
+    double sum = 0.0;
+    size_t i   = 0;
+    while (i + 8 <= n) {
+        const size_t end = std::min(n, i + kSumChunk);
+        __m128 a0 = _mm_setzero_ps();
+        __m128 a1 = _mm_setzero_ps();
+        for (; i + 8 <= end; i += 8) {
+            const __m128 v0 = _mm_loadu_ps(x + i);
+            const __m128 v1 = _mm_loadu_ps(x + i + 4);
+            a0 = _mm_add_ps(a0, _mm_mul_ps(v0, v0));
+            a1 = _mm_add_ps(a1, _mm_mul_ps(v1, v1));
+        }
+        a0 = _mm_add_ps(a0, a1);
+        const __m128d lo = _mm_cvtps_pd(a0);
+        const __m128d hi = _mm_cvtps_pd(_mm_movehl_ps(a0, a0));
+        const __m128d s  = _mm_add_pd(lo, hi);
+        sum += _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+    }
+    return sum + Scalar::sumSquares(x + i, n - i);
+}
+
+void kWeightedSumSquares(const float *const *planes, size_t channels, size_t frames, const KWeighting &k,
+                         KState *states, double *out)
+{
+    const Biquad &s = k.shelf;
+    const Biquad &h = k.highPass;
+    const __m128d sb0 = _mm_set1_pd(s.b0), sb1 = _mm_set1_pd(s.b1), sb2 = _mm_set1_pd(s.b2);
+    const __m128d sa1 = _mm_set1_pd(s.a1), sa2 = _mm_set1_pd(s.a2);
+    const __m128d hb0 = _mm_set1_pd(h.b0), hb1 = _mm_set1_pd(h.b1), hb2 = _mm_set1_pd(h.b2);
+    const __m128d ha1 = _mm_set1_pd(h.a1), ha2 = _mm_set1_pd(h.a2);
+
+    size_t c = 0;
+    for (; c + 2 <= channels; c += 2) {
+        /* lane 0 = channel c, lane 1 = channel c + 1 */
+        KState &l0 = states[c];
+        KState &l1 = states[c + 1];
+        __m128d s1 = _mm_set_pd(l1.s1, l0.s1), s2 = _mm_set_pd(l1.s2, l0.s2);
+        __m128d h1 = _mm_set_pd(l1.h1, l0.h1), h2 = _mm_set_pd(l1.h2, l0.h2);
+        __m128d acc = _mm_setzero_pd();
+        const float *p0 = planes[c];
+        const float *p1 = planes[c + 1];
+
+        for (size_t i = 0; i < frames; ++i) {
+            const __m128d x = _mm_set_pd(p1[i], p0[i]);
+            const __m128d y = _mm_add_pd(_mm_mul_pd(sb0, x), s1);
+            s1 = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(sb1, x), _mm_mul_pd(sa1, y)), s2);
+            s2 = _mm_sub_pd(_mm_mul_pd(sb2, x), _mm_mul_pd(sa2, y));
+            const __m128d z = _mm_add_pd(_mm_mul_pd(hb0, y), h1);
+            h1 = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(hb1, y), _mm_mul_pd(ha1, z)), h2);
+            h2 = _mm_sub_pd(_mm_mul_pd(hb2, y), _mm_mul_pd(ha2, z));
+            acc = _mm_add_pd(acc, _mm_mul_pd(z, z));
+        }
+
+        double v[2];
+        _mm_storeu_pd(v, s1); l0.s1 = v[0]; l1.s1 = v[1];
+        _mm_storeu_pd(v, s2); l0.s2 = v[0]; l1.s2 = v[1];
+        _mm_storeu_pd(v, h1); l0.h1 = v[0]; l1.h1 = v[1];
+        _mm_storeu_pd(v, h2); l0.h2 = v[0]; l1.h2 = v[1];
+        flushState(l0);
+        flushState(l1);
+        _mm_storeu_pd(out + c, acc);
+    }
+    Scalar::kWeightedSumSquares(planes + c, channels - c, frames, k, states + c, out + c);
+}
+
+const char *simdName()
+{
+    return "sse2";
+}
+
+/* ------------------------------------------------------------------------- */
+/*  NEON                                                                     */
+/* ------------------------------------------------------------------------- */
+#elif PF_AUDIO_NEON
+float peak(const float *x, size_t n)
+{
+    float32x4_t m0 = vdupq_n_f32(0.0f);
+    float32x4_t m1 = vdupq_n_f32(0.0f);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        m0 = vmaxq_f32(m0, vabsq_f32(vld1q_f32(x + i)));
+        m1 = vmaxq_f32(m1, vabsq_f32(vld1q_f32(x + i + 4)));
+    }
+    return std::max(vmaxvq_f32(vmaxq_f32(m0, m1)), Scalar::peak(x + i, n - i));
+}
+
+double sumSquares(const float *x, size_t n)
+{
+    double sum = 0.0;
+    size_t i   = 0;
+    while (i + 8 <= n) {
+        const size_t end = std::min(n, i + kSumChunk);
+        float32x4_t a0 = vdupq_n_f32(0.0f);
+        float32x4_t a1 = vdupq_n_f32(0.0f);
+        for (; i + 8 <= end; i += 8) {
+            const float32x4_t v0 = vld1q_f32(x + i);
+            const float32x4_t v1 = vld1q_f32(x + i + 4);
+            a0 = vmlaq_f32(a0, v0, v0);
+            a1 = vmlaq_f32(a1, v1, v1);
+        }
+        const float32x4_t a = vaddq_f32(a0, a1);
+        sum += vaddvq_f64(vaddq_f64(vcvt_f64_f32(vget_low_f32(a)), vcvt_high_f64_f32(a)));
+    }
+    return sum + Scalar::sumSquares(x + i, n - i);
+}
+
+void kWeightedSumSquares(const float *const *planes, size_t channels, size_t frames, const KWeighting &k,
+                         KState *states, double *out)
+{
+    const Biquad &s = k.shelf;
+    const Biquad &h = k.highPass;
+
+    size_t c = 0;
+    for (; c + 2 <= channels; c += 2) {
+        KState &l0 = states[c];
+        KState &l1 = states[c + 1];
+        const double init[8] = {l0.s1, l1.s1, l0.s2, l1.s2, l0.h1, l1.h1, l0.h2, l1.h2};
+        float64x2_t s1 = vld1q_f64(init), s2 = vld1q_f64(init + 2);
+        float64x2_t h1 = vld1q_f64(init + 4), h2 = vld1q_f64(init + 6);
+        float64x2_t acc = vdupq_n_f64(0.0);
+        const float *p0 = planes[c];
+        const float *p1 = planes[c + 1];
+
+        for (size_t i = 0; i < frames; ++i) {
+            const double      pair[2] = {p0[i], p1[i]};
+            const float64x2_t x = vld1q_f64(pair);
+            const float64x2_t y = vaddq_f64(vmulq_n_f64(x, s.b0), s1);
+            s1 = vaddq_f64(vsubq_f64(vmulq_n_f64(x, s.b1), vmulq_n_f64(y, s.a1)), s2);
+            s2 = vsubq_f64(vmulq_n_f64(x, s.b2), vmulq_n_f64(y, s.a2));
+            const float64x2_t z = vaddq_f64(vmulq_n_f64(y, h.b0), h1);
+            h1 = vaddq_f64(vsubq_f64(vmulq_n_f64(y, h.b1), vmulq_n_f64(z, h.a1)), h2);
+            h2 = vsubq_f64(vmulq_n_f64(y, h.b2), vmulq_n_f64(z, h.a2));
+            acc = vfmaq_f64(acc, z, z);
+        }
+
+        double v[8];
+        vst1q_f64(v, s1);
+        vst1q_f64(v + 2, s2);
+        vst1q_f64(v + 4, h1);
+        vst1q_f64(v + 6, h2);
+        l0 = {v[0], v[2], v[4], v[6]};
+        l1 = {v[1], v[3], v[5], v[7]};
+        flushState(l0);
+        flushState(l1);
+        vst1q_f64(out + c, acc);
+    }
+    Scalar::kWeightedSumSquares(planes + c, channels - c, frames, k, states + c, out + c);
+}
+
+const char *simdName()
+{
+    return "neon";
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Other targets                                                            */
+/* ------------------------------------------------------------------------- */
+#else
+float peak(const float *x, size_t n)
+{
+    return Scalar::peak(x, n);
+}
+
+double sumSquares(const float *x, size_t n)
+{
+    return Scalar::sumSquares(x, n);
+}
+
+void kWeightedSumSquares(const float *const *planes, size_t channels, size_t frames, const KWeighting &k,
+                         KState *states, double *out)
+{
+    Scalar::kWeightedSumSquares(planes, channels, frames, k, states, out);
+}
+
+const char *simdName()
+{
+    return "scalar";
+}
+#endif
+
+} // namespace AudioKernels
@@ -0,0 +1,72 @@
+/*!
+ * @file audio-meter-kernels.h
+ * @brief Block kernels behind the audio meter: peak, sum of squares and
+ *        ITU-R BS.1770 K-weighting.
+ *
+ * Each call processes one whole block of planar float samples. Peak and
+ * sum of squares are vectorized over samples; K-weighting is a recursive
+ * filter and is vectorized across channels instead (two channels per
+ * double-precision SIMD register), with filter state carried from block to
+ * block. The Scalar namespace holds the reference versions.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace AudioKernels {
+
+/// Normalized biquad: y = b0 x + b1 x[-1] + b2 x[-2] - a1 y[-1] - a2 y[-2].
+struct Biquad {
+    double b0, b1, b2, a1, a2;
+};
+
+/**
+ * @brief The two BS.1770 stages: a high shelf (head effects) and the RLB high-pass.
+ */
+struct KWeighting {
+    Biquad shelf;
+    Biquad highPass;
+
+    static KWeighting forSampleRate(double sampleRate);
+};
+
+/// Filter memory of one channel (transposed direct form II, both stages).
+struct KState {
+    double s1 = 0.0, s2 = 0.0;    ///< Shelf.
+    double h1 = 0.0, h2 = 0.0;    ///< High-pass.
+};
+
+/// Largest absolute sample value.
+float peak(const float *samples, size_t count);
+
+/// Sum of squared samples.
+double sumSquares(const float *samples, size_t count);
+
+/**
+ * @brief K-weights each channel and sums the squared output.
+ * @param planes   @p channels pointers to @p frames samples each.
+ * @param states   Per-channel filter memory, updated in place.
+ * @param out      Receives one sum per channel.
+ */
+void kWeightedSumSquares(const float *const *planes, size_t channels, size_t frames, const KWeighting &k,
+                         KState *states, double *out);
+
+/// Instruction set the kernels were built for ("sse2", "neon" or "scalar").
+const char *simdName();
+
+namespace Scalar {
+
+float  peak(const float *samples, size_t count);
+double sumSquares(const float *samples, size_t count);
+void   kWeightedSumSquares(const float *const *planes, size_t channels, size_t frames, const KWeighting &k,
+                           KState *states, double *out);
+
+} // namespace Scalar
+
+} // namespace AudioKernels
@@ -0,0 +1,363 @@
+/*!
+ * @file audio-meter-widget.cpp
+ * @brief Implements AudioMeterWidget: OBS capture glue, display timer and painting.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "audio-meter-widget.h"
+#include "plugin-support.h"
+#include "plugin-trace.h"
+
+#include <obs-module.h>
+
+#include <QAction>
+#include <QFontMetrics>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QMenu>
+#include <QPainter>
+#include <QScreen>
+#include <QStringList>
+#include <QTimer>
+#include <QToolButton>
+#include <QVBoxLayout>
+
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+constexpr float kFallDbPerSecond = 20.0f;   /* peak marker fall-off */
+constexpr int   kBarHeight       = 6;
+constexpr int   kBarGap          = 2;
+constexpr int   kRowGap          = 8;
+constexpr int   kMaintainTicks   = 60;      /* re-attach / prune roughly once a second */
+
+/**
+ * @brief Plain paint surface; the owner does the drawing.
+ */
+class MeterBars : public QWidget {
+public:
+    using PaintFn = std::function<void(QPainter &, const QRect &)>;
+
+    MeterBars(PaintFn paint, QWidget *parent) : QWidget(parent), paint_(std::move(paint))
+    {
+        setAttribute(Qt::WA_OpaquePaintEvent, false);
+    }
+
+protected:
+    void paintEvent(QPaintEvent *) override
+    {
+        QPainter p(this);
+        paint_(p, rect());
+    }
+
+private:
+    PaintFn paint_;
+};
+
+QStringList configuredSources(OBSConfigHelper *cfg)
+{
+    return cfg->get(ConfigSchema::kMeterSources).split(';', Qt::SkipEmptyParts);
+}
+
+/* -96 dB .. 0 dB mapped onto 0 .. 1 */
+double levelFraction(float db)
+{
+    return std::clamp((db - AudioMeter::kFloorDb) / -AudioMeter::kFloorDb, 0.0f, 1.0f);
+}
+
+} // namespace
+
+/* ------------------------------------------------------------------------- */
+/*  Construction                                                             */
+/* ------------------------------------------------------------------------- */
+AudioMeterWidget::AudioMeterWidget(OBSConfigHelper *cfg, QWidget *parent)
+    : QWidget(parent)
+    , cfg_(cfg)
+{
+    auto *layout = new QVBoxLayout;
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    auto *header = new QHBoxLayout;
+    auto *title  = new QLabel(tr("Audio"), this);
+    sourcesBtn_  = new QToolButton(this);
+    sourcesBtn_->setText(tr("Sources"));
+    sourcesBtn_->setPopupMode(QToolButton::InstantPopup);
+    auto *menu = new QMenu(sourcesBtn_);
+    sourcesBtn_->setMenu(menu);
+    connect(menu, &QMenu::aboutToShow, this, &AudioMeterWidget::populateSourceMenu);
+    header->addWidget(title);
+    header->addStretch();
+    header->addWidget(sourcesBtn_);
+    layout->addLayout(header);
+
+    bars_ = new MeterBars([this](QPainter &p, const QRect &area) { paintBars(p, area); }, this);
+    layout->addWidget(bars_);
+
+    overrunLabel_ = new QLabel(this);
+    overrunLabel_->setVisible(false);
+    layout->addWidget(overrunLabel_);
+
+    setLayout(layout);
+
+    timer_ = new QTimer(this);
+    timer_->setTimerType(Qt::PreciseTimer);
+    connect(timer_, &QTimer::timeout, this, &AudioMeterWidget::tick);
+
+    subscription_ = cfg_->subscribeSection(ConfigSchema::Meter, this, [this](const std::vector<ConfigChange> &) {
+        rebuildTaps();
+        if (timer_->isActive())
+            timer_->start(refreshIntervalMs());
+    });
+    rebuildTaps();
+}
+
+AudioMeterWidget::~AudioMeterWidget()
+{
+    if (subscription_)
+        cfg_->unsubscribe(subscription_);
+    for (Tap &tap : taps_)
+        detach(tap);
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Capture (audio thread)                                                   */
+/* ------------------------------------------------------------------------- */
+void AudioMeterWidget::onAudio(void *param, obs_source_t *, const struct audio_data *audio, bool muted)
+{
+    PF_TRACE_SCOPE("meter.capture");
+    auto *meter = static_cast<AudioMeter *>(param);
+    meter->process(reinterpret_cast<const float *const *>(audio->data), audio->frames, muted);
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Taps                                                                     */
+/* ------------------------------------------------------------------------- */
+void AudioMeterWidget::rebuildTaps()
+{
+    const QStringList names = configuredSources(cfg_);
+
+    /* keep taps that are still listed so their windows survive */
+    std::vector<Tap> next;
+    next.reserve(names.size());
+    for (const QString &name : names) {
+        auto it = std::find_if(taps_.begin(), taps_.end(), [&](const Tap &t) { return t.name == name; });
+        if (it != taps_.end()) {
+            next.push_back(std::move(*it));
+            taps_.erase(it);
+            continue;
+        }
+        Tap tap;
+        tap.name = name;
+        attach(tap);
+        next.push_back(std::move(tap));
+    }
+    for (Tap &tap : taps_)
+        detach(tap);
+    taps_ = std::move(next);
+
+    bars_->setMinimumHeight(barsHeight());
+    bars_->update();
+}
+
+bool AudioMeterWidget::attach(Tap &tap)
+{
+    if (tap.source)
+        return true;
+
+    obs_source_t *source = obs_get_source_by_name(tap.name.toUtf8().constData());
+    if (!source)
+        return false;
+    if (!(obs_source_get_output_flags(source) & OBS_SOURCE_AUDIO)) {
+        obs_log(LOG_WARNING, "[Meter] Source '%s' has no audio", tap.name.toUtf8().constData());
+        obs_source_release(source);
+        return false;
+    }
+
+    /* channel layout and rate are global to the OBS audio output */
+    audio_t *audio = obs_get_audio();
+    if (!tap.meter)
+        tap.meter = std::make_unique<AudioMeter>(static_cast<uint32_t>(audio_output_get_channels(audio)),
+                                                 audio_output_get_sample_rate(audio));
+    tap.meter->setEnabled(timer_->isActive());
+    tap.source = source;
+    obs_source_add_audio_capture_callback(source, &AudioMeterWidget::onAudio, tap.meter.get());
+    return true;
+}
+
+void AudioMeterWidget::detach(Tap &tap)
+{
+    if (!tap.source)
+        return;
+    /* returns only once no callback is running, so the meter may go afterwards */
+    obs_source_remove_audio_capture_callback(tap.source, &AudioMeterWidget::onAudio, tap.meter.get());
+    obs_source_release(tap.source);
+    tap.source = nullptr;
+}
+
+void AudioMeterWidget::setSourceEnabled(const QString &name, bool enabled)
+{
+    QStringList names = configuredSources(cfg_);
+    names.removeAll(name);
+    if (enabled)
+        names.append(name);
+    cfg_->set(ConfigSchema::kMeterSources, names.join(';'));
+}
+
+void AudioMeterWidget::populateSourceMenu()
+{
+    QMenu *menu = sourcesBtn_->menu();
+    menu->clear();
+
+    QStringList audioSources;
+    obs_enum_sources(
+        [](void *param, obs_source_t *source) {
+            if (obs_source_get_output_flags(source) & OBS_SOURCE_AUDIO)
+                static_cast<QStringList *>(param)->append(QString::fromUtf8(obs_source_get_name(source)));
+            return true;
+        },
+        &audioSources);
+    audioSources.sort(Qt::CaseInsensitive);
+
+    const QStringList enabled = configuredSources(cfg_);
+    for (const QString &name : audioSources) {
+        QAction *action = menu->addAction(name);
+        action->setCheckable(true);
+        action->setChecked(enabled.contains(name));
+        connect(action, &QAction::toggled, this, [this, name](bool on) { setSourceEnabled(name, on); });
+    }
+    if (audioSources.isEmpty())
+        menu->addAction(tr("No audio sources"))->setEnabled(false);
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Display                                                                  */
+/* ------------------------------------------------------------------------- */
+int AudioMeterWidget::refreshIntervalMs() const
+{
+    /* nothing is gained by draining faster than the screen can show */
+    double hz = screen() ? screen()->refreshRate() : 60.0;
+    hz        = std::min<double>(hz > 0.0 ? hz : 60.0, cfg_->get(ConfigSchema::kMeterMaxFps));
+    return std::max(1, static_cast<int>(1000.0 / hz));
+}
+
+void AudioMeterWidget::showEvent(QShowEvent *event)
+{
+    for (Tap &tap : taps_)
+        if (tap.meter)
+            tap.meter->setEnabled(true);
+    timer_->start(refreshIntervalMs());
+    QWidget::showEvent(event);
+}
+
+void AudioMeterWidget::hideEvent(QHideEvent *event)
+{
+    timer_->stop();
+    for (Tap &tap : taps_)
+        if (tap.meter)
+            tap.meter->setEnabled(false);
+    QWidget::hideEvent(event);
+}
+
+void AudioMeterWidget::tick()
+{
+    PF_TRACE_SCOPE("meter.tick");
+
+    if (++ticks_ >= kMaintainTicks) {
+        ticks_ = 0;
+        for (Tap &tap : taps_) {
+            if (tap.source && obs_source_removed(tap.source))
+                detach(tap);
+            if (!tap.source)
+                attach(tap);
+        }
+    }
+
+    const float fall  = kFallDbPerSecond * static_cast<float>(timer_->interval()) / 1000.0f;
+    uint64_t overruns = 0;
+    for (Tap &tap : taps_) {
+        if (!tap.meter)
+            continue;
+        const AudioMeterReading &r = tap.meter->update();
+        overruns += tap.meter->counters().overruns;
+        if (!r.fresh)
+            continue;
+
+        /* peaks jump up and fall back slowly so short transients stay visible */
+        AudioMeterReading shown = r;
+        for (uint32_t c = 0; c < r.channels; ++c) {
+            const float held = c < tap.shown.channels ? tap.shown.peakDb[c] - fall : AudioMeter::kFloorDb;
+            shown.peakDb[c]  = std::max(r.peakDb[c], held);
+        }
+        tap.shown = shown;
+    }
+
+    if (overruns != overruns_) {
+        overruns_ = overruns;
+        overrunLabel_->setText(tr("Dropped meter blocks: %1").arg(overruns_));
+        overrunLabel_->setVisible(true);
+        PF_TRACE_COUNTER("meter.overruns", static_cast<int64_t>(overruns_));
+    }
+    bars_->update();
+}
+
+int AudioMeterWidget::barsHeight() const
+{
+    const int line = QFontMetrics(font()).height();
+    int h          = 0;
+    for (const Tap &tap : taps_) {
+        const int channels = tap.meter ? static_cast<int>(tap.meter->channels()) : 0;
+        h += line + channels * (kBarHeight + kBarGap) + kRowGap;
+    }
+    return h;
+}
+
+void AudioMeterWidget::paintBars(QPainter &p, const QRect &area) const
+{
+    const QFontMetrics fm(font());
+    const int          line = fm.height();
+    int                y    = area.top();
+
+    if (taps_.empty()) {
+        p.setPen(palette().color(QPalette::Disabled, QPalette::Text));
+        p.drawText(area, Qt::AlignCenter, tr("No sources metered"));
+        return;
+    }
+
+    for (const Tap &tap : taps_) {
+        const AudioMeterReading &r = tap.shown;
+
+        p.setPen(palette().color(tap.source ? QPalette::Active : QPalette::Disabled, QPalette::Text));
+        const QString loudness = tap.source ? QStringLiteral("%1 LUFS").arg(r.momentaryLufs, 0, 'f', 1)
+                                            : tr("unavailable");
+        const QRect   textRow(area.left(), y, area.width(), line);
+        p.drawText(textRow, Qt::AlignLeft | Qt::AlignVCenter, tap.name);
+        p.drawText(textRow, Qt::AlignRight | Qt::AlignVCenter, loudness);
+        y += line;
+
+        const int channels = tap.meter ? static_cast<int>(tap.meter->channels()) : 0;
+        for (int c = 0; c < channels; ++c) {
+            const QRect track(area.left(), y, area.width(), kBarHeight);
+            p.fillRect(track, QColor(40, 40, 40));
+
+            if (c < static_cast<int>(r.channels)) {
+                const QColor fill = r.muted ? QColor(110, 110, 110)
+                                    : r.peakDb[c] > -9.0f ? QColor(214, 60, 50)
+                                    : r.peakDb[c] > -20.0f ? QColor(222, 190, 60)
+                                                           : QColor(70, 190, 90);
+                const int rmsW = static_cast<int>(levelFraction(r.rmsDb[c]) * track.width());
+                p.fillRect(QRect(track.left(), track.top(), rmsW, track.height()), fill);
+
+                const int peakX = track.left() + static_cast<int>(levelFraction(r.peakDb[c]) * (track.width() - 2));
+                p.fillRect(QRect(peakX, track.top(), 2, track.height()), fill.lighter(140));
+            }
+            y += kBarHeight + kBarGap;
+        }
+        y += kRowGap;
+    }
+}
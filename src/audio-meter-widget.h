@@ -0,0 +1,83 @@
+/*!
+ * @file audio-meter-widget.h
+ * @brief Dock widget showing peak, RMS and momentary loudness of the audio
+ *        sources listed in the "meter" config section.
+ *
+ * Each source gets an AudioMeter fed by an OBS audio capture callback. The
+ * widget drains the meters on a timer running at the screen's refresh rate
+ * (capped by meter.max_fps), so the display is decimated to what can be
+ * seen, and stops the meters while it is hidden.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include "audio-meter.h"
+#include "obs-config-helper.h"
+
+#include <obs.h>
+
+#include <QString>
+#include <QWidget>
+
+#include <memory>
+#include <vector>
+
+class QHideEvent;
+class QLabel;
+class QPainter;
+class QRect;
+class QShowEvent;
+class QTimer;
+class QToolButton;
+
+/**
+ * @class AudioMeterWidget
+ * @brief Meter rows for the configured sources plus a source picker.
+ */
+class AudioMeterWidget : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit AudioMeterWidget(OBSConfigHelper *cfg, QWidget *parent = nullptr);
+    ~AudioMeterWidget() override;
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    /// One metered source.
+    struct Tap {
+        QString                     name;
+        obs_source_t               *source = nullptr;   ///< Strong reference while attached.
+        std::unique_ptr<AudioMeter> meter;
+        AudioMeterReading           shown;              ///< With peak fall-off applied.
+    };
+
+    static void onAudio(void *param, obs_source_t *source, const struct audio_data *audio, bool muted);
+
+    void rebuildTaps();
+    bool attach(Tap &tap);
+    void detach(Tap &tap);
+    void tick();
+    void populateSourceMenu();
+    void setSourceEnabled(const QString &name, bool enabled);
+    int  refreshIntervalMs() const;
+    int  barsHeight() const;
+    void paintBars(QPainter &p, const QRect &area) const;
+
+    OBSConfigHelper  *cfg_;
+    std::vector<Tap>  taps_;
+    QWidget          *bars_         = nullptr;   ///< Paints the meters via paintBars().
+    QTimer           *timer_        = nullptr;
+    QToolButton      *sourcesBtn_   = nullptr;
+    QLabel           *overrunLabel_ = nullptr;
+    uint64_t          subscription_ = 0;
+    int               ticks_        = 0;
+    uint64_t          overruns_     = 0;
+};
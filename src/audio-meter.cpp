@@ -0,0 +1,167 @@
+/*!
+ * @file audio-meter.cpp
+ * @brief Implements the audio-thread producer and the UI-side windows of AudioMeter.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "audio-meter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr double kRmsWindowSeconds      = 0.3;
+constexpr double kMomentaryWindowSeconds = 0.4;   /* BS.1770 momentary loudness */
+
+float amplitudeDb(double amplitude)
+{
+    if (amplitude <= 0.0)
+        return AudioMeter::kFloorDb;
+    return std::max(AudioMeter::kFloorDb, static_cast<float>(20.0 * std::log10(amplitude)));
+}
+
+float powerDb(double meanSquare)
+{
+    if (meanSquare <= 0.0)
+        return AudioMeter::kFloorDb;
+    return std::max(AudioMeter::kFloorDb, static_cast<float>(10.0 * std::log10(meanSquare)));
+}
+
+} // namespace
+
+AudioMeter::AudioMeter(uint32_t channels, uint32_t sampleRate)
+    : channels_(std::min<uint32_t>(channels, AudioMeterBlock::kMaxChannels))
+    , sampleRate_(sampleRate ? sampleRate : 48000)
+    , kWeighting_(AudioKernels::KWeighting::forSampleRate(sampleRate_))
+{
+    reading_.channels = channels_;
+    std::fill(std::begin(reading_.peakDb), std::end(reading_.peakDb), kFloorDb);
+    std::fill(std::begin(reading_.rmsDb), std::end(reading_.rmsDb), kFloorDb);
+    reading_.momentaryLufs = kFloorLufs;
+}
+
+double AudioMeter::channelWeight(uint32_t channels, uint32_t index)
+{
+    /* libobs layouts: 2.1 = FL FR LFE, 4.0 = FL FR FC RC, 4.1 = FL FR FC LFE RC,
+     * 5.1 = FL FR FC LFE RL RR, 7.1 = FL FR FC LFE RL RR SL SR */
+    const bool lfe = (channels == 3 && index == 2) || (channels >= 5 && index == 3);
+    if (lfe)
+        return 0.0;
+    const bool surround = (channels == 4 && index == 3) || (channels >= 5 && index >= 4);
+    return surround ? 1.41 : 1.0;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Producer (audio thread)                                                  */
+/* ------------------------------------------------------------------------- */
+void AudioMeter::process(const float *const *planes, uint32_t frames, bool muted)
+{
+    callbacks_.fetch_add(1, std::memory_order_relaxed);
+
+    if (!enabled_.load(std::memory_order_relaxed)) {
+        wasEnabled_ = false;
+        skipped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (!wasEnabled_) {
+        /* filter memory from before the pause would leak into the first blocks */
+        std::fill(std::begin(states_), std::end(states_), AudioKernels::KState());
+        wasEnabled_ = true;
+    }
+
+    AudioMeterBlock block;
+    block.frames   = frames;
+    block.channels = channels_;
+    block.muted    = muted;
+    if (!muted && frames) {
+        for (uint32_t c = 0; c < channels_; ++c) {
+            block.peak[c]       = AudioKernels::peak(planes[c], frames);
+            block.sumSquares[c] = AudioKernels::sumSquares(planes[c], frames);
+        }
+        AudioKernels::kWeightedSumSquares(planes, channels_, frames, kWeighting_, states_, block.kSumSquares);
+    }
+
+    if (!ring_.push(block))
+        overruns_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AudioMeter::setEnabled(bool enabled)
+{
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+AudioMeterCounters AudioMeter::counters() const
+{
+    return {callbacks_.load(std::memory_order_relaxed), overruns_.load(std::memory_order_relaxed),
+            skipped_.load(std::memory_order_relaxed)};
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Consumer (UI thread)                                                     */
+/* ------------------------------------------------------------------------- */
+void AudioMeter::addToHistory(const AudioMeterBlock &block)
+{
+    WindowEntry &e = history_[historyHead_];
+    e.frames = block.frames;
+    std::copy(std::begin(block.sumSquares), std::end(block.sumSquares), std::begin(e.sumSquares));
+    std::copy(std::begin(block.kSumSquares), std::end(block.kSumSquares), std::begin(e.kSumSquares));
+    historyHead_  = (historyHead_ + 1) % kHistory;
+    historyCount_ = std::min(historyCount_ + 1, kHistory);
+}
+
+const AudioMeterReading &AudioMeter::update()
+{
+    float peak[AudioMeterBlock::kMaxChannels] = {};
+    bool  fresh = false;
+
+    AudioMeterBlock block;
+    while (ring_.pop(block)) {
+        fresh          = true;
+        reading_.muted = block.muted;
+        for (uint32_t c = 0; c < channels_; ++c)
+            peak[c] = std::max(peak[c], block.peak[c]);
+        addToHistory(block);
+    }
+    reading_.fresh = fresh;
+    if (!fresh)
+        return reading_;
+
+    /* sliding windows, newest block first */
+    const double rmsFrames       = kRmsWindowSeconds * sampleRate_;
+    const double momentaryFrames = kMomentaryWindowSeconds * sampleRate_;
+    double   rmsSum[AudioMeterBlock::kMaxChannels] = {};
+    double   kSum[AudioMeterBlock::kMaxChannels]   = {};
+    uint64_t rmsCount = 0, kCount = 0;
+
+    for (size_t n = 0; n < historyCount_; ++n) {
+        const WindowEntry &e = history_[(historyHead_ + kHistory - 1 - n) % kHistory];
+        const bool inRms       = rmsCount < rmsFrames;
+        const bool inMomentary = kCount < momentaryFrames;
+        if (!inRms && !inMomentary)
+            break;
+        for (uint32_t c = 0; c < channels_; ++c) {
+            if (inRms)
+                rmsSum[c] += e.sumSquares[c];
+            if (inMomentary)
+                kSum[c] += e.kSumSquares[c];
+        }
+        rmsCount += inRms ? e.frames : 0;
+        kCount   += inMomentary ? e.frames : 0;
+    }
+
+    double loudness = 0.0;
+    for (uint32_t c = 0; c < channels_; ++c) {
+        reading_.peakDb[c] = amplitudeDb(peak[c]);
+        reading_.rmsDb[c]  = rmsCount ? powerDb(rmsSum[c] / static_cast<double>(rmsCount)) : kFloorDb;
+        if (kCount)
+            loudness += channelWeight(channels_, c) * kSum[c] / static_cast<double>(kCount);
+    }
+    reading_.momentaryLufs =
+        loudness > 0.0 ? std::max(kFloorLufs, static_cast<float>(-0.691 + 10.0 * std::log10(loudness))) : kFloorLufs;
+    return reading_;
+}
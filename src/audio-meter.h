@@ -0,0 +1,134 @@
+/*!
+ * @file audio-meter.h
+ * @brief Peak/RMS/loudness meter split between OBS's audio thread and the UI.
+ *
+ * The audio thread calls process() once per captured block. It runs the
+ * block kernels (audio-meter-kernels.h) and pushes a small per-block
+ * summary into a wait-free SPSC ring; if the ring is full the summary is
+ * dropped and counted as an overrun, so the audio thread never waits. The
+ * UI drains the ring at display rate with update() and turns the summaries
+ * into readings over sliding windows.
+ *
+ * No OBS or Qt dependency: the capture glue lives in audio-meter-widget.cpp.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include "audio-meter-kernels.h"
+#include "spsc-ring.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Summary of one captured block; what crosses the ring.
+ */
+struct AudioMeterBlock {
+    static constexpr size_t kMaxChannels = 8;   ///< MAX_AUDIO_CHANNELS in libobs.
+
+    uint32_t frames   = 0;
+    uint32_t channels = 0;
+    bool     muted    = false;
+    float    peak[kMaxChannels]        = {};
+    double   sumSquares[kMaxChannels]  = {};
+    double   kSumSquares[kMaxChannels] = {};   ///< After K-weighting.
+};
+
+/**
+ * @brief What the UI shows; levels are clamped to kFloorDb / kFloorLufs.
+ */
+struct AudioMeterReading {
+    uint32_t channels = 0;
+    float    peakDb[AudioMeterBlock::kMaxChannels] = {};   ///< Highest sample since the last reading, dBFS.
+    float    rmsDb[AudioMeterBlock::kMaxChannels]  = {};   ///< Over the last 300 ms, dBFS.
+    float    momentaryLufs = 0.0f;                         ///< BS.1770 momentary loudness (400 ms).
+    bool     muted         = false;
+    bool     fresh         = false;                        ///< New blocks arrived since the last reading.
+};
+
+/**
+ * @brief Producer-side counters, readable from any thread.
+ */
+struct AudioMeterCounters {
+    uint64_t callbacks = 0;   ///< process() calls.
+    uint64_t overruns  = 0;   ///< Blocks dropped because the ring was full.
+    uint64_t skipped   = 0;   ///< Calls ignored while the meter was disabled.
+};
+
+/**
+ * @class AudioMeter
+ * @brief One metered source: process() on the audio thread, update() on the UI thread.
+ */
+class AudioMeter {
+public:
+    static constexpr float kFloorDb   = -96.0f;
+    static constexpr float kFloorLufs = -70.0f;   ///< BS.1770 absolute gate.
+
+    AudioMeter(uint32_t channels, uint32_t sampleRate);
+
+    AudioMeter(const AudioMeter &) = delete;
+    AudioMeter &operator=(const AudioMeter &) = delete;
+
+    /**
+     * @brief Audio thread: meters one block of planar float samples.
+     *
+     * Wait-free and allocation-free; extra channels beyond the meter's
+     * channel count are ignored.
+     */
+    void process(const float *const *planes, uint32_t frames, bool muted);
+
+    /// Consumer: drains all queued blocks and returns the current reading.
+    const AudioMeterReading &update();
+
+    /// While disabled, process() returns at once (e.g. while the dock is hidden).
+    void setEnabled(bool enabled);
+
+    AudioMeterCounters counters() const;
+
+    uint32_t channels() const { return channels_; }
+    uint32_t sampleRate() const { return sampleRate_; }
+
+    /// BS.1770 channel weight for channel @p index of a libobs speaker layout.
+    static double channelWeight(uint32_t channels, uint32_t index);
+
+private:
+    /// Ring capacity in blocks; about 1.3 s of OBS's 1024-frame blocks at 48 kHz.
+    static constexpr size_t kRingBlocks = 64;
+    /// Window history; enough for 400 ms of 128-frame blocks at 96 kHz.
+    static constexpr size_t kHistory = 512;
+
+    struct WindowEntry {
+        uint32_t frames;
+        double   sumSquares[AudioMeterBlock::kMaxChannels];
+        double   kSumSquares[AudioMeterBlock::kMaxChannels];
+    };
+
+    void addToHistory(const AudioMeterBlock &block);
+
+    const uint32_t                   channels_;
+    const uint32_t                   sampleRate_;
+    const AudioKernels::KWeighting   kWeighting_;
+
+    SpscRing<AudioMeterBlock, kRingBlocks> ring_;
+
+    /* producer only */
+    AudioKernels::KState states_[AudioMeterBlock::kMaxChannels];
+    bool                 wasEnabled_ = true;
+
+    /* consumer only */
+    WindowEntry       history_[kHistory];
+    size_t            historyHead_  = 0;     ///< Next slot to write.
+    size_t            historyCount_ = 0;
+    AudioMeterReading reading_;
+
+    std::atomic<bool>     enabled_{true};
+    std::atomic<uint64_t> callbacks_{0};
+    std::atomic<uint64_t> overruns_{0};
+    std::atomic<uint64_t> skipped_{0};
+};
@@ -0,0 +1,135 @@
+/*!
+ * @file auth-firebase.cpp
+ * @brief Implements FirebaseAuthBackend.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "auth-firebase.h"
+
+#include <firebase/app.h>
+#include <firebase/auth.h>
+#include <firebase/future.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+namespace {
+
+constexpr auto kRequestTimeout = std::chrono::seconds(20);
+constexpr auto kPollInterval   = std::chrono::milliseconds(10);
+
+/* The SDK completes futures on its own threads; the auth worker just waits. */
+template<typename T>
+bool waitFor(const firebase::Future<T> &future, const std::atomic<bool> &cancel, QString &error)
+{
+    const auto deadline = std::chrono::steady_clock::now() + kRequestTimeout;
+    while (future.status() == firebase::kFutureStatusPending) {
+        if (cancel.load(std::memory_order_relaxed)) {
+            error = QStringLiteral("cancelled");
+            return false;
+        }
+        if (std::chrono::steady_clock::now() > deadline) {
+            error = QStringLiteral("timed out");
+            return false;
+        }
+        std::this_thread::sleep_for(kPollInterval);
+    }
+    if (future.status() != firebase::kFutureStatusComplete || future.error() != 0) {
+        error = QString::fromUtf8(future.error_message() ? future.error_message() : "request failed");
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+FirebaseAuthBackend::FirebaseAuthBackend(FirebaseAuthOptions options)
+    : options_(std::move(options))
+{
+}
+
+FirebaseAuthBackend::~FirebaseAuthBackend()
+{
+    delete auth_;                   /* before the app it belongs to */
+    delete app_;
+}
+
+QByteArray FirebaseAuthBackend::id() const
+{
+    return "firebase:" + options_.projectId + ":" + options_.appId +
+           (options_.emulatorHost.isEmpty() ? QByteArray() : "@" + options_.emulatorHost);
+}
+
+bool FirebaseAuthBackend::ensureAuth(QString &error)
+{
+    if (auth_)
+        return true;
+
+    if (!app_) {
+        firebase::AppOptions appOptions;
+        appOptions.set_api_key(options_.apiKey.constData());
+        appOptions.set_app_id(options_.appId.constData());
+        appOptions.set_project_id(options_.projectId.constData());
+        app_ = firebase::App::Create(appOptions, "playfame");
+        if (!app_) {
+            error = QStringLiteral("firebase::App::Create failed");
+            return false;
+        }
+    }
+
+    firebase::InitResult init = firebase::kInitResultSuccess;
+    auth_ = firebase::auth::Auth::GetAuth(app_, &init);
+    if (!auth_ || init != firebase::kInitResultSuccess) {
+        auth_ = nullptr;
+        error = QStringLiteral("firebase::auth::Auth::GetAuth failed");
+        return false;
+    }
+
+    if (!options_.emulatorHost.isEmpty()) {
+        const int colon = options_.emulatorHost.lastIndexOf(':');
+        const std::string host = options_.emulatorHost.left(colon < 0 ? options_.emulatorHost.size() : colon).toStdString();
+        const uint32_t port = colon < 0 ? 9099u : options_.emulatorHost.mid(colon + 1).toUInt();
+        auth_->UseEmulator(host, port);
+    }
+    return true;
+}
+
+AuthTokenResult FirebaseAuthBackend::fetchToken(bool forceRefresh, const std::atomic<bool> &cancel)
+{
+    AuthTokenResult result;
+    if (!ensureAuth(result.error))
+        return result;
+
+    /* the SDK restores a persisted user; sign in only when there is none */
+    firebase::auth::User user = auth_->current_user();
+    if (!user.is_valid()) {
+        if (!waitFor(auth_->SignInAnonymously(), cancel, result.error))
+            return result;
+        user = auth_->current_user();
+        if (!user.is_valid()) {
+            result.error = QStringLiteral("sign-in returned no user");
+            return result;
+        }
+    }
+
+    firebase::Future<std::string> token = user.GetToken(forceRefresh);
+    if (!waitFor(token, cancel, result.error))
+        return result;
+
+    result.ok                = true;
+    result.token.uid         = QByteArray::fromStdString(user.uid());
+    result.token.idToken     = QByteArray::fromStdString(*token.result());
+    result.token.expiresAtMs = AuthService::jwtExpiryMs(result.token.idToken);
+    return result;
+}
+
+void FirebaseAuthBackend::signOut()
+{
+    if (auth_)
+        auth_->SignOut();
+}
@@ -0,0 +1,57 @@
+/*!
+ * @file auth-firebase.h
+ * @brief AuthBackend on top of the Firebase C++ SDK.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include "auth-service.h"
+
+#include <QByteArray>
+
+namespace firebase {
+class App;
+namespace auth {
+class Auth;
+}
+} // namespace firebase
+
+/**
+ * @brief Project settings for FirebaseAuthBackend.
+ */
+struct FirebaseAuthOptions {
+    QByteArray apiKey;
+    QByteArray appId;
+    QByteArray projectId;
+    QByteArray emulatorHost;    ///< "host:port" of a local Auth emulator; empty for production.
+};
+
+/**
+ * @class FirebaseAuthBackend
+ * @brief Anonymous sign-in and ID tokens through firebase::auth.
+ *
+ * The SDK is initialised lazily on the first fetch, i.e. on the auth
+ * worker, so firebase::App::Create() never runs during module load. The
+ * SDK persists the signed-in user itself; fetchToken() reuses it.
+ */
+class FirebaseAuthBackend : public AuthBackend {
+public:
+    explicit FirebaseAuthBackend(FirebaseAuthOptions options);
+    ~FirebaseAuthBackend() override;
+
+    QByteArray id() const override;
+    AuthTokenResult fetchToken(bool forceRefresh, const std::atomic<bool> &cancel) override;
+    void signOut() override;
+
+private:
+    bool ensureAuth(QString &error);
+
+    FirebaseAuthOptions   options_;
+    firebase::App        *app_  = nullptr;
+    firebase::auth::Auth *auth_ = nullptr;
+};
@@ -0,0 +1,344 @@
+/*!
+ * @file auth-service.cpp
+ * @brief Implements the auth worker, request coalescing and the session cache.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "auth-service.h"
+#include "plugin-support.h"
+#include "plugin-trace.h"
+
+#include <obs-module.h>
+
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QList>
+#include <QMetaObject>
+#include <QSaveFile>
+
+#include <algorithm>
+
+namespace {
+
+constexpr int64_t kRetryDelayMs       = 30 * 1000;       /* after a failed refresh */
+constexpr int64_t kDefaultLifetimeMs  = 55 * 60 * 1000;  /* if a token carries no "exp" */
+
+uint64_t elapsedUs(std::chrono::steady_clock::time_point since)
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                     std::chrono::steady_clock::now() - since).count());
+}
+
+} // namespace
+
+AuthService::AuthService(std::unique_ptr<AuthBackend> backend, QByteArray cachePath)
+    : backend_(std::move(backend))
+    , cachePath_(std::move(cachePath))
+    , backendId_(backend_ ? backend_->id() : QByteArray())
+{
+    thread_ = std::thread(&AuthService::run, this);
+}
+
+AuthService::~AuthService()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cancel_.store(true);            /* a fetch in progress gives up */
+    wake_.notify_all();
+
+    if (thread_.joinable())
+        thread_.join();
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Public API                                                               */
+/* ------------------------------------------------------------------------- */
+void AuthService::start()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (startRequested_ || startPending_)
+            return;
+        startRequested_ = true;
+        startPending_   = true;
+        startTime_      = std::chrono::steady_clock::now();
+    }
+    wake_.notify_one();
+}
+
+void AuthService::requestToken(QObject *context, TokenFn fn, bool forceRefresh)
+{
+    Waiter waiter{context, context != nullptr, std::move(fn)};
+    AuthTokenResult direct;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (forceRefresh || !token_ || !fresh(*token_, nowMs())) {
+            waiters_.push_back(std::move(waiter));
+            if (inFlight_ || fetchRequested_)
+                ++stats_.coalesced;         /* rides on the fetch already under way */
+            else
+                fetchRequested_ = true;
+            if (forceRefresh && !inFlight_)
+                forceRequested_ = true;
+            wake_.notify_one();
+            return;
+        }
+        ++stats_.servedFresh;
+        direct = {true, *token_, QString()};
+    }
+
+    std::vector<Waiter> one;
+    one.push_back(std::move(waiter));
+    deliver(std::move(one), direct);
+}
+
+void AuthService::signOut()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        signOutRequested_ = true;
+    }
+    wake_.notify_one();
+}
+
+std::optional<AuthToken> AuthService::currentToken() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return token_;
+}
+
+AuthStats AuthService::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void AuthService::setRefreshMargin(std::chrono::seconds margin)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        margin_ = std::max<std::chrono::milliseconds>(margin, std::chrono::milliseconds(0));
+    }
+    wake_.notify_one();
+}
+
+int64_t AuthService::jwtExpiryMs(const QByteArray &jwt)
+{
+    const QList<QByteArray> parts = jwt.split('.');
+    if (parts.size() < 2)
+        return 0;
+
+    const QByteArray payload =
+        QByteArray::fromBase64(parts[1], QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals);
+    const double exp = QJsonDocument::fromJson(payload).object().value(QStringLiteral("exp")).toDouble();
+    return exp > 0 ? static_cast<int64_t>(exp * 1000.0) : 0;
+}
+
+int64_t AuthService::nowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+bool AuthService::fresh(const AuthToken &token, int64_t now) const
+{
+    return token.expiresAtMs - margin_.count() > now;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Worker thread                                                            */
+/* ------------------------------------------------------------------------- */
+void AuthService::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    for (;;) {
+        /* sleep until asked, or until the token is due for a proactive refresh */
+        while (!stopping_ && !startRequested_ && !fetchRequested_ && !signOutRequested_) {
+            if (!token_) {
+                wake_.wait(lock);
+                continue;
+            }
+            const int64_t due  = std::max(token_->expiresAtMs - margin_.count(), retryAtMs_);
+            const int64_t wait = due - nowMs();
+            if (wait <= 0)
+                break;
+            wake_.wait_for(lock, std::chrono::milliseconds(wait));
+        }
+        if (stopping_)
+            break;
+
+        if (signOutRequested_) {
+            signOutRequested_ = false;
+            token_.reset();
+            retryAtMs_ = 0;
+            lock.unlock();
+            backend_->signOut();
+            removeCache();
+            lock.lock();
+            continue;
+        }
+
+        if (startRequested_) {
+            startRequested_ = false;
+            lock.unlock();
+            AuthToken cached;
+            const bool haveCache = loadCache(cached);
+            lock.lock();
+
+            if (haveCache && fresh(cached, nowMs())) {
+                /* warm start: usable without a round-trip; refreshed before expiry */
+                token_               = cached;
+                startPending_        = false;
+                stats_.warmStart     = true;
+                stats_.startUs       = elapsedUs(startTime_);
+                const uint64_t us    = stats_.startUs;
+                fetchRequested_      = forceRequested_;
+                std::vector<Waiter> waiters;
+                if (!forceRequested_)
+                    waiters.swap(waiters_);
+                lock.unlock();
+                obs_log(LOG_INFO, "[AuthService] Session restored from cache (warm start) in %.1f ms",
+                        static_cast<double>(us) / 1000.0);
+                deliver(std::move(waiters), {true, cached, QString()});
+                lock.lock();
+                continue;
+            }
+            fetchRequested_ = true;         /* cold start: sign in now */
+        }
+
+        /* fetch: requested by callers, or proactive when nothing asked for it */
+        const bool proactive = !fetchRequested_;
+        const bool force     = forceRequested_ || proactive;
+        fetchRequested_ = false;
+        forceRequested_ = false;
+        inFlight_       = true;
+        ++stats_.backendCalls;
+        if (proactive)
+            ++stats_.proactiveRefreshes;
+        lock.unlock();
+
+        AuthTokenResult result;
+        {
+            PF_TRACE_SCOPE("auth.fetch_token");
+            result = backend_->fetchToken(force, cancel_);
+        }
+        if (result.ok) {
+            result.token.fromCache = false;
+            if (result.token.expiresAtMs <= 0)
+                result.token.expiresAtMs = nowMs() + kDefaultLifetimeMs;
+            storeCache(result.token);
+        }
+
+        lock.lock();
+        inFlight_ = false;
+        bool     reportStart = false;
+        uint64_t startUs     = 0;
+        if (result.ok) {
+            token_     = result.token;
+            retryAtMs_ = 0;
+            if (startPending_) {
+                startPending_    = false;
+                stats_.warmStart = false;
+                stats_.startUs   = elapsedUs(startTime_);
+                reportStart      = true;
+                startUs          = stats_.startUs;
+            }
+        } else {
+            ++stats_.failures;
+            retryAtMs_ = nowMs() + kRetryDelayMs;
+        }
+        std::vector<Waiter> waiters;
+        waiters.swap(waiters_);
+        lock.unlock();
+
+        if (reportStart)
+            obs_log(LOG_INFO, "[AuthService] Signed in (cold start) in %.1f ms", static_cast<double>(startUs) / 1000.0);
+        if (!result.ok && !cancel_.load())
+            obs_log(LOG_WARNING, "[AuthService] Token request failed: %s", result.error.toUtf8().constData());
+        deliver(std::move(waiters), result);
+
+        lock.lock();
+    }
+
+    /* nobody will answer these any more */
+    std::vector<Waiter> waiters;
+    waiters.swap(waiters_);
+    lock.unlock();
+    deliver(std::move(waiters), {false, AuthToken(), QStringLiteral("Auth service stopped")});
+}
+
+void AuthService::deliver(std::vector<Waiter> waiters, const AuthTokenResult &result)
+{
+    for (Waiter &w : waiters) {
+        if (!w.fn)
+            continue;
+        if (!w.queued) {
+            w.fn(result);
+            continue;
+        }
+        QObject *context = w.context.data();
+        if (!context)
+            continue;               /* receiver is gone */
+        QMetaObject::invokeMethod(context, [fn = std::move(w.fn), result]() { fn(result); },
+                                  Qt::QueuedConnection);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Session cache                                                            */
+/* ------------------------------------------------------------------------- */
+bool AuthService::loadCache(AuthToken &out) const
+{
+    if (cachePath_.isEmpty())
+        return false;
+
+    QFile file(QString::fromUtf8(cachePath_));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    const QJsonObject obj = QJsonDocument::fromJson(file.readAll()).object();
+    if (obj.value(QStringLiteral("backend")).toString().toUtf8() != backendId_)
+        return false;               /* another project or app */
+
+    out.uid         = obj.value(QStringLiteral("uid")).toString().toUtf8();
+    out.idToken     = obj.value(QStringLiteral("id_token")).toString().toUtf8();
+    out.expiresAtMs = static_cast<int64_t>(obj.value(QStringLiteral("expires_at_ms")).toDouble());
+    out.fromCache   = true;
+    return !out.idToken.isEmpty() && out.expiresAtMs > 0;
+}
+
+void AuthService::storeCache(const AuthToken &token) const
+{
+    if (cachePath_.isEmpty())
+        return;
+
+    QJsonObject obj;
+    obj.insert(QStringLiteral("backend"), QString::fromUtf8(backendId_));
+    obj.insert(QStringLiteral("uid"), QString::fromUtf8(token.uid));
+    obj.insert(QStringLiteral("id_token"), QString::fromUtf8(token.idToken));
+    obj.insert(QStringLiteral("expires_at_ms"), static_cast<double>(token.expiresAtMs));
+
+    QSaveFile file(QString::fromUtf8(cachePath_));
+    if (!file.open(QIODevice::WriteOnly)) {
+        obs_log(LOG_WARNING, "[AuthService] Could not write session cache");
+        return;
+    }
+    file.setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner);  /* holds a credential */
+    file.write(QJsonDocument(obj).toJson(QJsonDocument::Compact));
+    if (!file.commit())
+        obs_log(LOG_WARNING, "[AuthService] Could not write session cache");
+}
+
+void AuthService::removeCache() const
+{
+    if (!cachePath_.isEmpty())
+        QFile::remove(QString::fromUtf8(cachePath_));
+}
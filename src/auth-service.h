@@ -0,0 +1,176 @@
+/*!
+ * @file auth-service.h
+ * @brief Non-blocking sign-in and ID-token management on a dedicated worker.
+ *
+ * All backend work (SDK initialisation, sign-in, token refresh, cache I/O)
+ * runs on the service's own thread, so neither OBS startup nor the UI thread
+ * ever waits for the network:
+ * - requestToken() answers from the current token when it is still fresh
+ *   and otherwise queues the caller; concurrent requests share one refresh.
+ * - Tokens are refreshed in the background a margin before they expire.
+ * - The last token is persisted; a warm start with a fresh cached token is
+ *   ready without a round-trip, and the refresh happens later in background.
+ * - Callbacks given a QObject context run on that object's thread.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief A signed-in user's ID token.
+ */
+struct AuthToken {
+    QByteArray uid;
+    QByteArray idToken;
+    int64_t    expiresAtMs = 0;     ///< Wall-clock expiry (ms since the Unix epoch).
+    bool       fromCache   = false; ///< Restored from the session cache, not fetched.
+};
+
+/**
+ * @brief Outcome of a token request.
+ */
+struct AuthTokenResult {
+    bool      ok = false;
+    AuthToken token;
+    QString   error;
+};
+
+/**
+ * @brief Counters describing the auth pipeline.
+ */
+struct AuthStats {
+    uint64_t startUs            = 0;     ///< start() until the first usable token.
+    bool     warmStart          = false; ///< First token came from the session cache.
+    uint64_t backendCalls       = 0;     ///< Token fetches that reached the backend.
+    uint64_t coalesced          = 0;     ///< Requests answered by a fetch already under way.
+    uint64_t servedFresh        = 0;     ///< Requests answered from the current token.
+    uint64_t proactiveRefreshes = 0;     ///< Background refreshes before expiry.
+    uint64_t failures           = 0;     ///< Backend fetches that failed.
+};
+
+/**
+ * @class AuthBackend
+ * @brief Identity provider behind AuthService.
+ *
+ * Methods are called on the auth worker only and may block. Long waits
+ * should poll @p cancel and give up once it is set.
+ */
+class AuthBackend {
+public:
+    virtual ~AuthBackend() = default;
+
+    /// Identifies the project/app; cached sessions of another backend are ignored.
+    virtual QByteArray id() const = 0;
+
+    /// Signs in if needed and returns an ID token, refreshed when @p forceRefresh is set.
+    virtual AuthTokenResult fetchToken(bool forceRefresh, const std::atomic<bool> &cancel) = 0;
+
+    virtual void signOut() = 0;
+};
+
+/**
+ * @class AuthService
+ * @brief Owns the auth worker, the current token and the session cache.
+ */
+class AuthService {
+public:
+    using TokenFn = std::function<void(const AuthTokenResult &result)>;
+
+    /**
+     * @param backend   Identity provider; used on the worker thread only.
+     * @param cachePath Session cache file (UTF-8); empty disables the cache.
+     */
+    AuthService(std::unique_ptr<AuthBackend> backend, QByteArray cachePath);
+
+    /// Cancels any fetch in progress and joins the worker.
+    ~AuthService();
+
+    AuthService(const AuthService &) = delete;
+    AuthService &operator=(const AuthService &) = delete;
+
+    /// Restores the cached session or signs in, in the background. Returns immediately.
+    void start();
+
+    /**
+     * @brief Delivers a valid ID token to @p fn.
+     *
+     * Served from the current token unless it is within the refresh margin
+     * of expiry or @p forceRefresh is set. Without a @p context, @p fn runs
+     * on the auth worker (or the calling thread when served directly).
+     */
+    void requestToken(QObject *context, TokenFn fn, bool forceRefresh = false);
+
+    /// Forgets the user and deletes the session cache.
+    void signOut();
+
+    /// Token currently held, if any; never blocks on the worker.
+    std::optional<AuthToken> currentToken() const;
+
+    AuthStats stats() const;
+
+    /// How long before expiry tokens are refreshed (default 5 minutes).
+    void setRefreshMargin(std::chrono::seconds margin);
+
+    /// Reads the "exp" claim of a JWT; 0 if it cannot be decoded.
+    static int64_t jwtExpiryMs(const QByteArray &jwt);
+
+    static int64_t nowMs();
+
+private:
+    struct Waiter {
+        QPointer<QObject> context;
+        bool              queued = false;
+        TokenFn           fn;
+    };
+
+    void run();
+    bool fresh(const AuthToken &token, int64_t now) const;
+    static void deliver(std::vector<Waiter> waiters, const AuthTokenResult &result);
+
+    bool loadCache(AuthToken &out) const;
+    void storeCache(const AuthToken &token) const;
+    void removeCache() const;
+
+    std::unique_ptr<AuthBackend> backend_;
+    const QByteArray             cachePath_;
+    const QByteArray             backendId_;
+
+    mutable std::mutex          mutex_;
+    std::condition_variable     wake_;
+    bool                        stopping_         = false;
+    bool                        startRequested_   = false;
+    bool                        fetchRequested_   = false;
+    bool                        forceRequested_   = false;
+    bool                        signOutRequested_ = false;
+    bool                        inFlight_         = false;
+    bool                        startPending_     = false; ///< start() called, no token yet.
+    int64_t                     retryAtMs_        = 0;     ///< Backoff after a failed refresh.
+    std::chrono::milliseconds   margin_{std::chrono::minutes(5)};
+    std::optional<AuthToken>    token_;
+    std::vector<Waiter>         waiters_;
+    AuthStats                   stats_;
+    std::chrono::steady_clock::time_point startTime_;
+
+    std::atomic<bool>           cancel_{false};
+    std::thread                 thread_;            ///< Declared last: started after everything else.
+};
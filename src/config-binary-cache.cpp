@@ -0,0 +1,441 @@
+/*!
+ * @file config-binary-cache.cpp
+ * @brief Implements the binary config sidecar.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "config-binary-cache.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QString>
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+static constexpr char kMagic[4] = {'P', 'F', 'C', 'B'};
+
+/* ------------------------------------------------------------------------- */
+/*  View                                                                     */
+/* ------------------------------------------------------------------------- */
+uint64_t ConfigBinaryView::checksum(const uint8_t *data, size_t size)
+{
+    /* word-at-a-time multiply/xorshift; detects truncation and bit rot */
+    uint64_t h = 0x243F6A8885A308D3ull ^ size;
+    size_t   i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t w;
+        std::memcpy(&w, data + i, 8);
+        h = (h ^ w) * 0x9E3779B97F4A7C15ull;
+        h ^= h >> 32;
+    }
+    for (; i < size; ++i) {
+        h = (h ^ data[i]) * 0x100000001B3ull;
+    }
+    return h ^ (h >> 29);
+}
+
+bool ConfigBinaryView::open(const uint8_t *data, size_t size)
+{
+    header_  = nullptr;
+    entries_ = nullptr;
+    index_   = nullptr;
+    strings_ = nullptr;
+
+    if constexpr (std::endian::native != std::endian::little)
+        return false;               /* images are little-endian only */
+
+    if (!data || size < sizeof(ConfigBinaryHeader))
+        return false;
+
+    auto *h = reinterpret_cast<const ConfigBinaryHeader *>(data);
+    if (std::memcmp(h->magic, kMagic, sizeof(kMagic)) != 0 || h->version != kVersion)
+        return false;
+
+    const uint64_t entriesEnd = h->entriesOffset + uint64_t(h->entryCount) * sizeof(ConfigBinaryEntry);
+    const uint64_t indexEnd   = entriesEnd + uint64_t(h->entryCount) * sizeof(uint32_t);
+    if (h->entriesOffset != sizeof(ConfigBinaryHeader) || indexEnd > size || h->stringsOffset != indexEnd ||
+        h->stringsOffset + h->stringsSize != size)
+        return false;
+
+    if (checksum(data + sizeof(ConfigBinaryHeader), size - sizeof(ConfigBinaryHeader)) != h->checksum)
+        return false;
+
+    header_  = h;
+    entries_ = reinterpret_cast<const ConfigBinaryEntry *>(data + h->entriesOffset);
+    index_   = reinterpret_cast<const uint32_t *>(data + entriesEnd);
+    strings_ = reinterpret_cast<const char *>(data + h->stringsOffset);
+
+    /* every reference must stay inside the entries and the string table */
+    for (uint32_t i = 0; i < h->entryCount; ++i) {
+        const ConfigBinaryEntry &e = entries_[i];
+        bool ok = index_[i] < h->entryCount && uint64_t(e.pathOffset) + e.pathLength <= h->stringsSize;
+        if (e.type == ConfigBinaryEntry::String)
+            ok = ok && (e.value & 0xFFFFFFFFull) + (e.value >> 32) <= h->stringsSize;
+        if (!ok) {
+            header_ = nullptr;
+            return false;
+        }
+    }
+    return true;
+}
+
+ConfigFileStamp ConfigBinaryView::stamp() const
+{
+    ConfigFileStamp s;
+    if (header_) {
+        s.size    = header_->jsonSize;
+        s.mtimeMs = header_->jsonMtimeMs;
+    }
+    return s;
+}
+
+std::string_view ConfigBinaryView::path(const ConfigBinaryEntry &e) const
+{
+    return {strings_ + e.pathOffset, e.pathLength};
+}
+
+std::string_view ConfigBinaryView::string(const ConfigBinaryEntry &e) const
+{
+    return {strings_ + (e.value & 0xFFFFFFFFull), static_cast<size_t>(e.value >> 32)};
+}
+
+const ConfigBinaryEntry *ConfigBinaryView::find(std::string_view p) const
+{
+    const uint32_t *first = index_;
+    const uint32_t *last  = index_ + count();
+    auto it = std::lower_bound(first, last, p,
+                               [this](uint32_t e, std::string_view key) { return path(entries_[e]) < key; });
+    return (it != last && path(entries_[*it]) == p) ? &entries_[*it] : nullptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Writing                                                                  */
+/* ------------------------------------------------------------------------- */
+namespace {
+
+struct FlatEntry {
+    std::string path;
+    uint8_t     type;
+    uint64_t    value = 0;
+    std::string text;
+};
+
+std::string joinPath(const std::string &prefix, std::string_view name)
+{
+    std::string p;
+    p.reserve(prefix.size() + 1 + name.size());
+    if (!prefix.empty()) {
+        p += prefix;
+        p += ConfigBinaryView::kSeparator;
+    }
+    p += name;
+    return p;
+}
+
+bool flatten(obs_data_t *obj, const std::string &prefix, std::vector<FlatEntry> &out)
+{
+    for (obs_data_item_t *item = obs_data_first(obj); item; obs_data_item_next(&item)) {
+        if (!obs_data_item_has_user_value(item))
+            continue;
+
+        std::string_view name = obs_data_item_get_name(item);
+        if (name.find(ConfigBinaryView::kSeparator) != std::string_view::npos) {
+            obs_data_item_release(&item);
+            return false;           /* cannot be represented; stay on JSON */
+        }
+
+        FlatEntry e;
+        e.path = joinPath(prefix, name);
+
+        switch (obs_data_item_gettype(item)) {
+        case OBS_DATA_STRING:
+            e.type = ConfigBinaryEntry::String;
+            e.text = obs_data_item_get_string(item);
+            out.push_back(std::move(e));
+            break;
+        case OBS_DATA_NUMBER:
+            if (obs_data_item_numtype(item) == OBS_DATA_NUM_DOUBLE) {
+                e.type = ConfigBinaryEntry::Double;
+                e.value = std::bit_cast<uint64_t>(obs_data_item_get_double(item));
+            } else {
+                e.type = ConfigBinaryEntry::Int;
+                e.value = static_cast<uint64_t>(obs_data_item_get_int(item));
+            }
+            out.push_back(std::move(e));
+            break;
+        case OBS_DATA_BOOLEAN:
+            e.type  = ConfigBinaryEntry::Bool;
+            e.value = obs_data_item_get_bool(item) ? 1 : 0;
+            out.push_back(std::move(e));
+            break;
+        case OBS_DATA_OBJECT: {
+            e.type = ConfigBinaryEntry::Object;
+            const std::string path = e.path;
+            out.push_back(std::move(e));
+
+            obs_data_t *child = obs_data_item_get_obj(item);
+            bool ok = flatten(child, path, out);
+            obs_data_release(child);
+            if (!ok) {
+                obs_data_item_release(&item);
+                return false;
+            }
+            break;
+        }
+        case OBS_DATA_ARRAY: {
+            obs_data_array_t *arr = obs_data_item_get_array(item);
+            const size_t count = obs_data_array_count(arr);
+            e.type  = ConfigBinaryEntry::Array;
+            e.value = count;
+            const std::string path = e.path;
+            out.push_back(std::move(e));
+
+            bool ok = true;
+            char index[16];
+            for (size_t i = 0; ok && i < count; ++i) {
+                std::snprintf(index, sizeof(index), "#%010zu", i);
+                FlatEntry element;
+                element.path = joinPath(path, index);
+                element.type = ConfigBinaryEntry::Object;
+                const std::string elementPath = element.path;
+                out.push_back(std::move(element));
+
+                obs_data_t *child = obs_data_array_item(arr, i);
+                ok = flatten(child, elementPath, out);
+                obs_data_release(child);
+            }
+            obs_data_array_release(arr);
+            if (!ok) {
+                obs_data_item_release(&item);
+                return false;
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+ConfigFileStamp ConfigBinaryCache::stampOf(const char *path)
+{
+    ConfigFileStamp s;
+    QFileInfo info(QString::fromUtf8(path));
+    if (info.exists() && info.isFile()) {
+        s.size    = info.size();
+        s.mtimeMs = info.lastModified().toMSecsSinceEpoch();
+    }
+    return s;
+}
+
+bool ConfigBinaryCache::hashOf(const char *path, uint64_t &hash)
+{
+    QFile file(QString::fromUtf8(path));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    const qint64 size = file.size();
+    if (size == 0) {
+        hash = ConfigBinaryView::checksum(nullptr, 0);
+        return true;
+    }
+    uchar *mapped = file.map(0, size);
+    if (!mapped)
+        return false;
+    hash = ConfigBinaryView::checksum(mapped, static_cast<size_t>(size));
+    file.unmap(mapped);
+    return true;
+}
+
+bool ConfigBinaryCache::store(const char *cachePath, const char *jsonPath, obs_data_t *root)
+{
+    const ConfigFileStamp stamp = stampOf(jsonPath);
+    uint64_t jsonHash = 0;
+    if (!root || !stamp.isValid() || !hashOf(jsonPath, jsonHash) || !(stampOf(jsonPath) == stamp))
+        return false;               /* the hash must belong to the stamp */
+
+    std::vector<FlatEntry> flat;
+    if (!flatten(root, std::string(), flat))
+        return false;
+
+    /* entries stay in document order; lookups go through a sorted index */
+    std::vector<uint32_t> index(flat.size());
+    for (size_t i = 0; i < index.size(); ++i)
+        index[i] = static_cast<uint32_t>(i);
+    std::sort(index.begin(), index.end(), [&](uint32_t a, uint32_t b) { return flat[a].path < flat[b].path; });
+
+    /* string table: all paths, then all string values */
+    uint64_t stringsSize = 0;
+    for (const FlatEntry &e : flat)
+        stringsSize += e.path.size() + e.text.size();
+    if (stringsSize > UINT32_MAX || flat.size() > UINT32_MAX)
+        return false;
+
+    const size_t entriesBytes = flat.size() * sizeof(ConfigBinaryEntry);
+    const size_t indexBytes   = index.size() * sizeof(uint32_t);
+    std::vector<uint8_t> image(sizeof(ConfigBinaryHeader) + entriesBytes + indexBytes + stringsSize);
+
+    auto *entries = reinterpret_cast<ConfigBinaryEntry *>(image.data() + sizeof(ConfigBinaryHeader));
+    std::memcpy(image.data() + sizeof(ConfigBinaryHeader) + entriesBytes, index.data(), indexBytes);
+    char *strings = reinterpret_cast<char *>(image.data() + sizeof(ConfigBinaryHeader) + entriesBytes + indexBytes);
+    uint32_t cursor = 0;
+
+    for (size_t i = 0; i < flat.size(); ++i) {
+        const FlatEntry &f = flat[i];
+        ConfigBinaryEntry &e = entries[i];
+        std::memset(&e, 0, sizeof(e));
+        e.type       = f.type;
+        e.value      = f.value;
+        e.pathOffset = cursor;
+        e.pathLength = static_cast<uint32_t>(f.path.size());
+        std::memcpy(strings + cursor, f.path.data(), f.path.size());
+        cursor += e.pathLength;
+
+        if (f.type == ConfigBinaryEntry::String) {
+            e.value = uint64_t(cursor) | (uint64_t(f.text.size()) << 32);
+            std::memcpy(strings + cursor, f.text.data(), f.text.size());
+            cursor += static_cast<uint32_t>(f.text.size());
+        }
+    }
+
+    ConfigBinaryHeader header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version       = ConfigBinaryView::kVersion;
+    header.entryCount    = static_cast<uint32_t>(flat.size());
+    header.jsonSize      = stamp.size;
+    header.jsonMtimeMs   = stamp.mtimeMs;
+    header.jsonHash      = jsonHash;
+    header.entriesOffset = sizeof(ConfigBinaryHeader);
+    header.stringsOffset = sizeof(ConfigBinaryHeader) + entriesBytes + indexBytes;
+    header.stringsSize   = stringsSize;
+    header.checksum      = ConfigBinaryView::checksum(image.data() + sizeof(header), image.size() - sizeof(header));
+    std::memcpy(image.data(), &header, sizeof(header));
+
+    QSaveFile file(QString::fromUtf8(cachePath));
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    if (file.write(reinterpret_cast<const char *>(image.data()), static_cast<qint64>(image.size())) !=
+        static_cast<qint64>(image.size())) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Loading                                                                  */
+/* ------------------------------------------------------------------------- */
+static obs_data_t *rebuild(const ConfigBinaryView &view)
+{
+    obs_data_t *root = obs_data_create();
+
+    /* containers are borrowed: their parents hold the references */
+    std::unordered_map<std::string_view, obs_data_t *>       objects;
+    std::unordered_map<std::string_view, obs_data_array_t *> arrays;
+    objects.reserve(64);
+    objects.emplace(std::string_view(), root);
+
+    std::string name;
+    for (uint32_t i = 0; i < view.count(); ++i) {
+        const ConfigBinaryEntry &e = view.entry(i);
+        const std::string_view path = view.path(e);
+        const size_t sep = path.rfind(ConfigBinaryView::kSeparator);
+        const std::string_view parent = sep == std::string_view::npos ? std::string_view() : path.substr(0, sep);
+        name.assign(sep == std::string_view::npos ? path : path.substr(sep + 1));
+
+        if (auto arr = arrays.find(parent); arr != arrays.end()) {
+            if (e.type != ConfigBinaryEntry::Object)
+                goto corrupt;
+            obs_data_t *element = obs_data_create();
+            obs_data_array_push_back(arr->second, element);
+            obs_data_release(element);
+            objects.emplace(path, element);
+            continue;
+        }
+
+        auto owner = objects.find(parent);
+        if (owner == objects.end())
+            goto corrupt;
+        obs_data_t *obj = owner->second;
+
+        switch (e.type) {
+        case ConfigBinaryEntry::Int:
+            obs_data_set_int(obj, name.c_str(), static_cast<long long>(e.value));
+            break;
+        case ConfigBinaryEntry::Double:
+            obs_data_set_double(obj, name.c_str(), std::bit_cast<double>(e.value));
+            break;
+        case ConfigBinaryEntry::Bool:
+            obs_data_set_bool(obj, name.c_str(), e.value != 0);
+            break;
+        case ConfigBinaryEntry::String: {
+            const std::string value(view.string(e));
+            obs_data_set_string(obj, name.c_str(), value.c_str());
+            break;
+        }
+        case ConfigBinaryEntry::Object: {
+            obs_data_t *child = obs_data_create();
+            obs_data_set_obj(obj, name.c_str(), child);
+            obs_data_release(child);
+            objects.emplace(path, child);
+            break;
+        }
+        case ConfigBinaryEntry::Array: {
+            obs_data_array_t *arr = obs_data_array_create();
+            obs_data_set_array(obj, name.c_str(), arr);
+            obs_data_array_release(arr);
+            arrays.emplace(path, arr);
+            break;
+        }
+        default:
+            goto corrupt;
+        }
+    }
+    return root;
+
+corrupt:
+    obs_data_release(root);
+    return nullptr;
+}
+
+obs_data_t *ConfigBinaryCache::load(const char *cachePath, const char *jsonPath, uint64_t *hashOut)
+{
+    const ConfigFileStamp jsonStamp = stampOf(jsonPath);
+    if (!jsonStamp.isValid())
+        return nullptr;
+
+    QFile file(QString::fromUtf8(cachePath));
+    if (!file.open(QIODevice::ReadOnly) || file.size() < qint64(sizeof(ConfigBinaryHeader)))
+        return nullptr;
+
+    const qint64 size = file.size();
+    uchar *mapped = file.map(0, size);
+    if (!mapped)
+        return nullptr;
+
+    obs_data_t *root = nullptr;
+    ConfigBinaryView view;
+    uint64_t jsonHash = 0;
+    if (view.open(mapped, static_cast<size_t>(size)) && view.stamp() == jsonStamp &&
+        hashOf(jsonPath, jsonHash) && jsonHash == view.jsonHash())
+        root = rebuild(view);
+    if (root && hashOut)
+        *hashOut = jsonHash;
+
+    file.unmap(mapped);
+    return root;
+}
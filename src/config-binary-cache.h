@@ -0,0 +1,135 @@
+/*!
+ * @file config-binary-cache.h
+ * @brief Memory-mappable binary sidecar of the JSON config for fast warm starts.
+ *
+ * The JSON file stays the canonical, human-editable copy. Next to it we keep
+ * "<config>.bin", a flattened, checksummed image of the same tree with a
+ * sorted key index. It records the size, mtime and a content hash of the
+ * JSON it was built from and is only used while the JSON still matches all
+ * three: the stamp rejects most stale images without reading the JSON, the
+ * hash catches an edit that kept both size and mtime.
+ *
+ * Layout (little-endian):
+ *   Header   72 bytes, see ConfigBinaryHeader
+ *   Entries  entryCount x 24 bytes, in document order (parents first)
+ *   Index    entryCount x 4 bytes, entry numbers sorted by path (bytewise)
+ *   Strings  paths and string values, referenced by offset/length
+ *
+ * Entries keep the key order of the JSON, so a tree rebuilt from the image
+ * saves back to the same file.
+ *
+ * A path joins object keys with '\x1F'; array elements are named
+ * "#0000000000" (zero-padded so bytewise order equals index order).
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include <obs-module.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/// Stamp of the JSON file a cache was generated from.
+struct ConfigFileStamp {
+    int64_t size    = -1;
+    int64_t mtimeMs = 0;
+
+    bool isValid() const { return size >= 0; }
+    bool operator==(const ConfigFileStamp &o) const { return size == o.size && mtimeMs == o.mtimeMs; }
+};
+
+struct ConfigBinaryHeader {
+    char     magic[4];        ///< "PFCB"
+    uint32_t version;         ///< ConfigBinaryView::kVersion
+    uint32_t entryCount;
+    uint32_t reserved;
+    int64_t  jsonSize;
+    int64_t  jsonMtimeMs;
+    uint64_t jsonHash;        ///< ConfigBinaryView::checksum() of the JSON bytes.
+    uint64_t entriesOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+    uint64_t checksum;        ///< Over every byte after the header.
+};
+static_assert(sizeof(ConfigBinaryHeader) == 72, "ConfigBinaryHeader must stay 72 bytes");
+
+struct ConfigBinaryEntry {
+    enum Type : uint8_t { Object = 1, Array = 2, Int = 3, Double = 4, Bool = 5, String = 6 };
+
+    uint32_t pathOffset;
+    uint32_t pathLength;
+    uint8_t  type;
+    uint8_t  pad[7];
+    uint64_t value;           ///< int64/double bits, bool, array count, or string (offset | length << 32).
+};
+static_assert(sizeof(ConfigBinaryEntry) == 24, "ConfigBinaryEntry must stay 24 bytes");
+
+/**
+ * @class ConfigBinaryView
+ * @brief Read-only, zero-copy view over a mapped cache image.
+ */
+class ConfigBinaryView {
+public:
+    static constexpr uint32_t kVersion   = 2;
+    static constexpr char     kSeparator = '\x1F';
+
+    /// Validates header, bounds and checksum. Returns false for any mismatch.
+    bool open(const uint8_t *data, size_t size);
+
+    uint32_t count() const { return header_ ? header_->entryCount : 0; }
+    ConfigFileStamp stamp() const;
+    uint64_t jsonHash() const { return header_ ? header_->jsonHash : 0; }
+
+    const ConfigBinaryEntry &entry(uint32_t index) const { return entries_[index]; }
+    std::string_view path(const ConfigBinaryEntry &e) const;
+    std::string_view string(const ConfigBinaryEntry &e) const;
+
+    /// Binary search over the path index. Returns nullptr if absent.
+    const ConfigBinaryEntry *find(std::string_view path) const;
+
+    static uint64_t checksum(const uint8_t *data, size_t size);
+
+private:
+    const ConfigBinaryHeader *header_  = nullptr;
+    const ConfigBinaryEntry  *entries_ = nullptr;
+    const uint32_t           *index_   = nullptr;
+    const char               *strings_ = nullptr;
+};
+
+/**
+ * @brief Reading and writing of the binary sidecar.
+ */
+namespace ConfigBinaryCache {
+
+/// Current stamp of a file, or an invalid stamp if it does not exist.
+ConfigFileStamp stampOf(const char *path);
+
+/// ConfigBinaryView::checksum() of a file's bytes; false if it cannot be read.
+bool hashOf(const char *path, uint64_t &hash);
+
+/**
+ * @brief Writes @p root to @p cachePath, stamped with the JSON's current state.
+ *
+ * Written through a temporary file and renamed, so readers never see a
+ * partial image. Safe to call from a worker thread on an immutable tree.
+ */
+bool store(const char *cachePath, const char *jsonPath, obs_data_t *root);
+
+/**
+ * @brief Maps @p cachePath and rebuilds the tree if it matches @p jsonPath.
+ *
+ * Hashes the JSON bytes when the stamp matches; that read costs a small
+ * fraction of parsing them.
+ * @param jsonHash Receives the hash of the JSON bytes when a tree is returned.
+ * @return A new obs_data_t (caller releases), or nullptr if the cache is
+ *         missing, stale, corrupt or from another format version.
+ */
+obs_data_t *load(const char *cachePath, const char *jsonPath, uint64_t *jsonHash = nullptr);
+
+} // namespace ConfigBinaryCache
@@ -0,0 +1,1074 @@
+/*!
+ * @file config-bundle.cpp
+ * @brief Implements streaming bundle export (incremental writer) and import (SAX).
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "config-bundle.h"
+#include "plugin-support.h"
+#include "plugin-trace.h"
+
+#include <obs-module.h>
+#include <util/platform.h>
+
+#include <nlohmann/json.hpp>
+
+#ifndef PLAYFAME_HAVE_ZLIB
+#define PLAYFAME_HAVE_ZLIB 0
+#endif
+#ifndef PLAYFAME_HAVE_ZSTD
+#define PLAYFAME_HAVE_ZSTD 0
+#endif
+
+#if PLAYFAME_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#if PLAYFAME_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using json  = nlohmann::json;
+
+constexpr unsigned char kGzipMagic[2] = {0x1f, 0x8b};
+constexpr unsigned char kZstdMagic[4] = {0x28, 0xb5, 0x2f, 0xfd};
+
+const char *compressionName(BundleCompression compression)
+{
+    switch (compression) {
+    case BundleCompression::Gzip:
+        return "gzip";
+    case BundleCompression::Zstd:
+        return "zstd";
+    default:
+        return "none";
+    }
+}
+
+uint64_t elapsedUs(Clock::time_point start)
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+}
+
+/* The published root is never modified; holding it does not hold up reclamation. */
+obs_data_t *pinRoot(const OBSConfigHelper &cfg)
+{
+    ConfigReader reader = cfg.reader();
+    obs_data_t  *root   = reader.snapshot()->root;
+    obs_data_addref(root);
+    return root;
+}
+
+bool wanted(const std::vector<QByteArray> &sections, const char *name)
+{
+    return sections.empty() || std::find(sections.begin(), sections.end(), QByteArray(name)) != sections.end();
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Output: JSON text -> fixed buffer -> codec -> file                       */
+/* ------------------------------------------------------------------------- */
+class BundleSink {
+public:
+    BundleSink(const BundleOptions &options, BundleProgress &progress)
+        : options_(options)
+        , progress_(progress)
+        , limit_(std::max<size_t>(options.bufferBytes, 4096))
+    {
+        text_.reserve(limit_ + 256);
+    }
+
+    ~BundleSink()
+    {
+        close();
+#if PLAYFAME_HAVE_ZLIB
+        if (gzipOpen_)
+            deflateEnd(&gzip_);
+#endif
+#if PLAYFAME_HAVE_ZSTD
+        ZSTD_freeCCtx(zstd_);
+#endif
+    }
+
+    bool open(const QByteArray &path, QString &error)
+    {
+        switch (options_.compression) {
+        case BundleCompression::None:
+            break;
+        case BundleCompression::Gzip:
+#if PLAYFAME_HAVE_ZLIB
+            std::memset(&gzip_, 0, sizeof(gzip_));
+            /* 15 + 16: gzip wrapper, so the file opens with any gunzip */
+            if (deflateInit2(&gzip_, options_.level > 0 ? options_.level : Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                             15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+                error = QStringLiteral("gzip initialisation failed");
+                return false;
+            }
+            gzipOpen_ = true;
+            break;
+#else
+            error = QStringLiteral("gzip support is not compiled in");
+            return false;
+#endif
+        case BundleCompression::Zstd:
+#if PLAYFAME_HAVE_ZSTD
+            zstd_ = ZSTD_createCCtx();
+            if (!zstd_ || ZSTD_isError(ZSTD_CCtx_setParameter(zstd_, ZSTD_c_compressionLevel,
+                                                              options_.level > 0 ? options_.level
+                                                                                 : ZSTD_CLEVEL_DEFAULT))) {
+                error = QStringLiteral("zstd initialisation failed");
+                return false;
+            }
+            break;
+#else
+            error = QStringLiteral("zstd support is not compiled in");
+            return false;
+#endif
+        }
+        if (options_.compression != BundleCompression::None)
+            out_.resize(limit_);
+
+        file_ = os_fopen(path.constData(), "wb");
+        if (!file_) {
+            error = QStringLiteral("cannot create %1").arg(QString::fromUtf8(path));
+            return false;
+        }
+        return true;
+    }
+
+    std::string &text() { return text_; }
+
+    /* call between values; writes out once the buffer is full */
+    bool spill()
+    {
+        return text_.size() < limit_ || writeOut(false);
+    }
+
+    bool finish()
+    {
+        if (!writeOut(true) || std::fflush(file_) != 0)
+            return fail(QStringLiteral("write failed"));
+        return true;
+    }
+
+    bool close()
+    {
+        if (!file_)
+            return true;
+        const bool ok = std::fclose(file_) == 0;
+        file_ = nullptr;
+        return ok;
+    }
+
+    bool cancelled() const { return cancelled_; }
+    const QString &error() const { return error_; }
+
+private:
+    bool fail(const QString &error)
+    {
+        if (error_.isEmpty())
+            error_ = error;
+        return false;
+    }
+
+    bool put(const char *data, size_t size)
+    {
+        if (size && std::fwrite(data, 1, size, file_) != size)
+            return fail(QStringLiteral("write failed"));
+        progress_.fileBytes += size;
+        return true;
+    }
+
+    bool writeOut([[maybe_unused]] bool end)
+    {
+        progress_.jsonBytes += text_.size();
+        bool ok = true;
+
+        switch (options_.compression) {
+        case BundleCompression::None:
+            ok = put(text_.data(), text_.size());
+            break;
+        case BundleCompression::Gzip: {
+#if PLAYFAME_HAVE_ZLIB
+            gzip_.next_in  = reinterpret_cast<Bytef *>(text_.data());
+            gzip_.avail_in = static_cast<uInt>(text_.size());
+            int ret;
+            do {
+                gzip_.next_out  = reinterpret_cast<Bytef *>(out_.data());
+                gzip_.avail_out = static_cast<uInt>(out_.size());
+                ret = deflate(&gzip_, end ? Z_FINISH : Z_NO_FLUSH);
+                if (ret == Z_STREAM_ERROR)
+                    return fail(QStringLiteral("gzip failed"));
+                ok = put(out_.data(), out_.size() - gzip_.avail_out);
+            } while (ok && (gzip_.avail_out == 0 || (end && ret != Z_STREAM_END)));
+#endif
+            break;
+        }
+        case BundleCompression::Zstd: {
+#if PLAYFAME_HAVE_ZSTD
+            ZSTD_inBuffer in = {text_.data(), text_.size(), 0};
+            for (;;) {
+                ZSTD_outBuffer out = {out_.data(), out_.size(), 0};
+                const size_t left = ZSTD_compressStream2(zstd_, &out, &in, end ? ZSTD_e_end : ZSTD_e_continue);
+                if (ZSTD_isError(left))
+                    return fail(QStringLiteral("zstd failed: %1").arg(ZSTD_getErrorName(left)));
+                ok = put(out_.data(), out.pos);
+                if (!ok || (end ? left == 0 : in.pos == in.size))
+                    break;
+            }
+#endif
+            break;
+        }
+        }
+        text_.clear();
+
+        if (ok && options_.progress && progress_.jsonBytes >= nextProgress_) {
+            nextProgress_ = progress_.jsonBytes + std::max<uint64_t>(options_.progressEveryBytes, 1);
+            if (!options_.progress(progress_)) {
+                cancelled_ = true;
+                return fail(QStringLiteral("cancelled"));
+            }
+        }
+        return ok;
+    }
+
+    const BundleOptions &options_;
+    BundleProgress      &progress_;
+    const size_t         limit_;
+    std::string          text_;
+    std::string          out_;
+    std::FILE           *file_         = nullptr;
+    uint64_t             nextProgress_ = 0;
+    bool                 cancelled_    = false;
+    QString              error_;
+#if PLAYFAME_HAVE_ZLIB
+    z_stream gzip_;
+    bool     gzipOpen_ = false;
+#endif
+#if PLAYFAME_HAVE_ZSTD
+    ZSTD_CCtx *zstd_ = nullptr;
+#endif
+};
+
+/* ------------------------------------------------------------------------- */
+/*  JSON writer over obs_data                                                */
+/* ------------------------------------------------------------------------- */
+void writeString(std::string &out, std::string_view s)
+{
+    static constexpr char kHex[] = "0123456789abcdef";
+    out.push_back('"');
+    size_t run = 0;
+    for (size_t i = 0; i < s.size(); ++i) {
+        const auto c = static_cast<unsigned char>(s[i]);
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+        out.append(s.data() + run, i - run);
+        run = i + 1;
+        switch (c) {
+        case '"':  out.append("\\\""); break;
+        case '\\': out.append("\\\\"); break;
+        case '\n': out.append("\\n"); break;
+        case '\r': out.append("\\r"); break;
+        case '\t': out.append("\\t"); break;
+        default: {
+            const char esc[] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 15]};
+            out.append(esc, sizeof(esc));
+        }
+        }
+    }
+    out.append(s.data() + run, s.size() - run);
+    out.push_back('"');
+}
+
+void writeNumber(std::string &out, obs_data_item_t *item)
+{
+    char text[32];
+    if (obs_data_item_numtype(item) != OBS_DATA_NUM_DOUBLE) {
+        const auto end = std::to_chars(text, text + sizeof(text), obs_data_item_get_int(item)).ptr;
+        out.append(text, static_cast<size_t>(end - text));
+        return;
+    }
+    const double value = obs_data_item_get_double(item);
+    if (!std::isfinite(value)) {
+        out.append("null");         /* JSON has no NaN or infinity */
+        return;
+    }
+    const auto end = std::to_chars(text, text + sizeof(text), value).ptr;
+    out.append(text, static_cast<size_t>(end - text));
+    /* keep it a double on the way back in */
+    if (std::find_if(text, end, [](char c) { return c == '.' || c == 'e' || c == 'E'; }) == end)
+        out.append(".0");
+}
+
+class BundleWriter {
+public:
+    BundleWriter(BundleSink &sink, BundleProgress &progress)
+        : sink_(sink)
+        , out_(sink.text())
+        , progress_(progress)
+    {
+    }
+
+    bool object(obs_data_t *data)
+    {
+        out_.push_back('{');
+        bool first = true;
+        for (obs_data_item_t *item = obs_data_first(data); item; obs_data_item_next(&item)) {
+            if (!obs_data_item_has_user_value(item))
+                continue;
+            if (!first)
+                out_.push_back(',');
+            first = false;
+            writeString(out_, obs_data_item_get_name(item));
+            out_.push_back(':');
+            if (!value(item) || !sink_.spill()) {
+                obs_data_item_release(&item);
+                return false;
+            }
+        }
+        out_.push_back('}');
+        return true;
+    }
+
+private:
+    bool value(obs_data_item_t *item)
+    {
+        ++progress_.keys;
+        switch (obs_data_item_gettype(item)) {
+        case OBS_DATA_STRING: {
+            const char *s = obs_data_item_get_string(item);
+            writeString(out_, s ? s : "");
+            return true;
+        }
+        case OBS_DATA_NUMBER:
+            writeNumber(out_, item);
+            return true;
+        case OBS_DATA_BOOLEAN:
+            out_.append(obs_data_item_get_bool(item) ? "true" : "false");
+            return true;
+        case OBS_DATA_OBJECT: {
+            obs_data_t *obj = obs_data_item_get_obj(item);
+            const bool  ok  = obj ? object(obj) : (out_.append("{}"), true);
+            obs_data_release(obj);
+            return ok;
+        }
+        case OBS_DATA_ARRAY: {
+            obs_data_array_t *array = obs_data_item_get_array(item);
+            const bool        ok    = this->array(array);
+            obs_data_array_release(array);
+            return ok;
+        }
+        default:
+            out_.append("null");
+            return true;
+        }
+    }
+
+    bool array(obs_data_array_t *array)
+    {
+        out_.push_back('[');
+        const size_t count = array ? obs_data_array_count(array) : 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (i)
+                out_.push_back(',');
+            obs_data_t *element = obs_data_array_item(array, i);
+            const bool  ok      = object(element) && sink_.spill();
+            obs_data_release(element);
+            if (!ok)
+                return false;
+        }
+        out_.push_back(']');
+        return true;
+    }
+
+    BundleSink     &sink_;
+    std::string    &out_;
+    BundleProgress &progress_;
+};
+
+/* ------------------------------------------------------------------------- */
+/*  Input: file -> codec -> fixed buffer, as a streambuf for the SAX parser  */
+/* ------------------------------------------------------------------------- */
+class BundleSource : public std::streambuf {
+public:
+    BundleSource(const BundleOptions &options, BundleProgress &progress)
+        : options_(options)
+        , progress_(progress)
+        , size_(std::max<size_t>(options.bufferBytes, 4096))
+    {
+    }
+
+    ~BundleSource() override
+    {
+        if (file_)
+            std::fclose(file_);
+#if PLAYFAME_HAVE_ZLIB
+        if (gzipOpen_)
+            inflateEnd(&gzip_);
+#endif
+#if PLAYFAME_HAVE_ZSTD
+        ZSTD_freeDCtx(zstd_);
+#endif
+    }
+
+    bool open(const QByteArray &path, BundleCompression &compression, QString &error)
+    {
+        file_ = os_fopen(path.constData(), "rb");
+        if (!file_) {
+            error = QStringLiteral("cannot open %1").arg(QString::fromUtf8(path));
+            return false;
+        }
+        progress_.fileTotal = static_cast<uint64_t>(std::max<int64_t>(0, os_get_file_size(path.constData())));
+        in_.resize(size_);
+        out_.resize(size_);
+        readMore();
+
+        const auto *head = reinterpret_cast<const unsigned char *>(in_.data());
+        if (inEnd_ >= 2 && std::memcmp(head, kGzipMagic, 2) == 0)
+            codec_ = BundleCompression::Gzip;
+        else if (inEnd_ >= 4 && std::memcmp(head, kZstdMagic, 4) == 0)
+            codec_ = BundleCompression::Zstd;
+        compression = codec_;
+
+        switch (codec_) {
+        case BundleCompression::None:
+            return true;
+        case BundleCompression::Gzip:
+#if PLAYFAME_HAVE_ZLIB
+            std::memset(&gzip_, 0, sizeof(gzip_));
+            if (inflateInit2(&gzip_, 15 + 32) != Z_OK) {
+                error = QStringLiteral("gzip initialisation failed");
+                return false;
+            }
+            gzipOpen_ = true;
+            return true;
+#else
+            error = QStringLiteral("the bundle is gzip-compressed; gzip support is not compiled in");
+            return false;
+#endif
+        case BundleCompression::Zstd:
+#if PLAYFAME_HAVE_ZSTD
+            zstd_ = ZSTD_createDCtx();
+            if (!zstd_) {
+                error = QStringLiteral("zstd initialisation failed");
+                return false;
+            }
+            return true;
+#else
+            error = QStringLiteral("the bundle is zstd-compressed; zstd support is not compiled in");
+            return false;
+#endif
+        }
+        return false;
+    }
+
+    bool cancelled() const { return cancelled_; }
+    const QString &error() const { return error_; }
+
+protected:
+    int_type underflow() override
+    {
+        if (gptr() < egptr())
+            return traits_type::to_int_type(*gptr());
+        if (!error_.isEmpty())
+            return traits_type::eof();
+
+        const size_t n = fill();
+        if (n == 0)
+            return traits_type::eof();
+        setg(out_.data(), out_.data(), out_.data() + n);
+        progress_.jsonBytes += n;
+
+        if (options_.progress && progress_.jsonBytes >= nextProgress_) {
+            nextProgress_ = progress_.jsonBytes + std::max<uint64_t>(options_.progressEveryBytes, 1);
+            if (!options_.progress(progress_)) {
+                cancelled_ = true;
+                error_     = QStringLiteral("cancelled");
+                setg(out_.data(), out_.data(), out_.data());
+                return traits_type::eof();   /* the parser reports a truncated document */
+            }
+        }
+        return traits_type::to_int_type(*gptr());
+    }
+
+private:
+    /* refills in_ once it is used up; false at the end of the file */
+    bool readMore()
+    {
+        if (inPos_ < inEnd_)
+            return true;
+        if (eof_)
+            return false;
+        inPos_ = 0;
+        inEnd_ = std::fread(in_.data(), 1, in_.size(), file_);
+        progress_.fileBytes += inEnd_;
+        if (inEnd_ < in_.size()) {
+            eof_ = true;
+            if (std::ferror(file_))
+                error_ = QStringLiteral("read failed");
+        }
+        return inEnd_ > 0;
+    }
+
+    size_t fill()
+    {
+        switch (codec_) {
+        case BundleCompression::None: {
+            if (!readMore())
+                return 0;
+            const size_t n = inEnd_ - inPos_;
+            std::memcpy(out_.data(), in_.data() + inPos_, n);
+            inPos_ = inEnd_;
+            return n;
+        }
+        case BundleCompression::Gzip:
+#if PLAYFAME_HAVE_ZLIB
+            for (;;) {
+                if (!readMore()) {
+                    if (!streamEnd_)
+                        error_ = QStringLiteral("the bundle is truncated");
+                    return 0;
+                }
+                if (streamEnd_) {
+                    inflateReset(&gzip_);   /* another gzip member follows */
+                    streamEnd_ = false;
+                }
+                gzip_.next_in   = reinterpret_cast<Bytef *>(in_.data() + inPos_);
+                gzip_.avail_in  = static_cast<uInt>(inEnd_ - inPos_);
+                gzip_.next_out  = reinterpret_cast<Bytef *>(out_.data());
+                gzip_.avail_out = static_cast<uInt>(out_.size());
+                const int ret = inflate(&gzip_, Z_NO_FLUSH);
+                inPos_ = inEnd_ - gzip_.avail_in;
+                if (ret == Z_STREAM_END)
+                    streamEnd_ = true;
+                else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+                    error_ = QStringLiteral("gzip data is corrupt");
+                    return 0;
+                }
+                const size_t n = out_.size() - gzip_.avail_out;
+                if (n > 0)
+                    return n;
+            }
+#else
+            return 0;
+#endif
+        case BundleCompression::Zstd:
+#if PLAYFAME_HAVE_ZSTD
+            for (;;) {
+                if (!readMore()) {
+                    if (!streamEnd_)
+                        error_ = QStringLiteral("the bundle is truncated");
+                    return 0;
+                }
+                ZSTD_inBuffer  in  = {in_.data() + inPos_, inEnd_ - inPos_, 0};
+                ZSTD_outBuffer out = {out_.data(), out_.size(), 0};
+                const size_t   ret = ZSTD_decompressStream(zstd_, &out, &in);
+                inPos_ += in.pos;
+                if (ZSTD_isError(ret)) {
+                    error_ = QStringLiteral("zstd data is corrupt: %1").arg(ZSTD_getErrorName(ret));
+                    return 0;
+                }
+                streamEnd_ = ret == 0;     /* a frame ended; more may follow */
+                if (out.pos > 0)
+                    return out.pos;
+            }
+#else
+            return 0;
+#endif
+        }
+        return 0;
+    }
+
+    const BundleOptions &options_;
+    BundleProgress      &progress_;
+    const size_t         size_;
+    std::FILE           *file_ = nullptr;
+    std::string          in_;
+    std::string          out_;
+    size_t               inPos_ = 0, inEnd_ = 0;
+    bool                 eof_       = false;
+    bool                 streamEnd_ = false;
+    bool                 cancelled_ = false;
+    uint64_t             nextProgress_ = 0;
+    QString              error_;
+    BundleCompression    codec_ = BundleCompression::None;
+#if PLAYFAME_HAVE_ZLIB
+    z_stream gzip_;
+    bool     gzipOpen_ = false;
+#endif
+#if PLAYFAME_HAVE_ZSTD
+    ZSTD_DCtx *zstd_ = nullptr;
+#endif
+};
+
+/* ------------------------------------------------------------------------- */
+/*  SAX handler: builds each section straight into obs_data                  */
+/* ------------------------------------------------------------------------- */
+/* The item holding a user value under name, or null. */
+obs_data_item_t *userItem(obs_data_t *obj, const char *name)
+{
+    obs_data_item_t *item = obj ? obs_data_item_byname(obj, name) : nullptr;
+    if (item && !obs_data_item_has_user_value(item))
+        obs_data_item_release(&item);
+    return item;
+}
+
+size_t userCount(obs_data_t *obj)
+{
+    size_t count = 0;
+    for (obs_data_item_t *item = obs_data_first(obj); item; obs_data_item_next(&item))
+        count += obs_data_item_has_user_value(item) ? 1 : 0;
+    return count;
+}
+
+/*
+ * Every object and array is matched against the same place in the live
+ * config while it is parsed. One that turns out equal is dropped as soon as
+ * it closes and the live one is shared in its place, so memory holds what
+ * the bundle changes plus the object being parsed, and applySections()
+ * skips shared data by identity. Keys are matched in step, as diffKeys()
+ * does, and looked up by name only when the order differs.
+ */
+class SectionBuilder : public nlohmann::json_sax<json> {
+public:
+    SectionBuilder(const BundleOptions &options, BundleProgress &progress, obs_data_t *live)
+        : options_(options)
+        , progress_(progress)
+        , live_(live)
+        , sections_(obs_data_create())
+    {
+    }
+
+    ~SectionBuilder() override
+    {
+        for (Frame &frame : stack_)
+            frame.release();
+        obs_data_release(sections_);
+    }
+
+    obs_data_t *sections() const { return sections_; }
+    uint64_t skipped() const { return skipped_; }
+    const QString &error() const { return error_; }
+
+    bool null() override { return scalar(nullptr, nullptr); }
+
+    bool boolean(bool val) override
+    {
+        return scalar([&](Frame &up) { obs_data_set_bool(up.obj, up.key.c_str(), val); },
+                      [&](obs_data_item_t *was) {
+                          return obs_data_item_gettype(was) == OBS_DATA_BOOLEAN && obs_data_item_get_bool(was) == val;
+                      });
+    }
+
+    bool number_integer(number_integer_t val) override
+    {
+        return scalar([&](Frame &up) { obs_data_set_int(up.obj, up.key.c_str(), val); },
+                      [&](obs_data_item_t *was) {
+                          return obs_data_item_gettype(was) == OBS_DATA_NUMBER &&
+                                 obs_data_item_numtype(was) == OBS_DATA_NUM_INT && obs_data_item_get_int(was) == val;
+                      });
+    }
+
+    bool number_unsigned(number_unsigned_t val) override
+    {
+        if (val > static_cast<number_unsigned_t>(std::numeric_limits<int64_t>::max()))
+            return number_float(static_cast<double>(val), {});
+        return number_integer(static_cast<number_integer_t>(val));
+    }
+
+    bool number_float(number_float_t val, const string_t &) override
+    {
+        return scalar([&](Frame &up) { obs_data_set_double(up.obj, up.key.c_str(), val); },
+                      [&](obs_data_item_t *was) {
+                          return obs_data_item_gettype(was) == OBS_DATA_NUMBER &&
+                                 obs_data_item_numtype(was) == OBS_DATA_NUM_DOUBLE &&
+                                 obs_data_item_get_double(was) == val;
+                      });
+    }
+
+    bool string(string_t &val) override
+    {
+        return scalar([&](Frame &up) { obs_data_set_string(up.obj, up.key.c_str(), val.c_str()); },
+                      [&](obs_data_item_t *was) {
+                          return obs_data_item_gettype(was) == OBS_DATA_STRING &&
+                                 std::strcmp(obs_data_item_get_string(was), val.c_str()) == 0;
+                      });
+    }
+
+    bool binary(binary_t &) override { return scalar(nullptr, nullptr); }
+
+    bool key(string_t &val) override
+    {
+        if (skip_)
+            return true;
+        Frame &up = parent();
+        up.key.swap(val);
+        if (!up.live)
+            return true;
+
+        /* done with the previous key */
+        if (up.inStep)
+            obs_data_item_next(&up.peer);
+        obs_data_item_release(&up.match);
+        while (up.peer && !obs_data_item_has_user_value(up.peer))
+            obs_data_item_next(&up.peer);
+
+        up.inStep = up.peer && std::strcmp(obs_data_item_get_name(up.peer), up.key.c_str()) == 0;
+        if (!up.inStep)
+            up.match = userItem(up.live, up.key.c_str());
+        return true;
+    }
+
+    bool start_object(std::size_t) override
+    {
+        if (skip_) {
+            ++skip_;
+            return true;
+        }
+        if (stack_.empty()) {
+            stack_.emplace_back();          /* the root: its keys are section names */
+            return true;
+        }
+        Frame &up = parent();
+        Frame  frame;
+        if (isRoot(up)) {
+            if (!wanted(options_.sections, up.key.c_str())) {
+                skip_ = 1;
+                return true;
+            }
+            obs_data_item_t *was = userItem(live_, up.key.c_str());
+            if (was && obs_data_item_gettype(was) == OBS_DATA_OBJECT)
+                frame.live = obs_data_item_get_obj(was);
+            obs_data_item_release(&was);
+        } else if (up.array) {
+            if (up.liveArray && up.index < obs_data_array_count(up.liveArray))
+                frame.live = obs_data_array_item(up.liveArray, up.index);
+            ++up.index;
+        } else if (obs_data_item_t *was = up.current(); was && obs_data_item_gettype(was) == OBS_DATA_OBJECT) {
+            frame.live = obs_data_item_get_obj(was);
+        }
+        frame.obj  = obs_data_create();
+        frame.peer = frame.live ? obs_data_first(frame.live) : nullptr;
+        stack_.push_back(std::move(frame));
+        return true;
+    }
+
+    bool end_object() override
+    {
+        if (skip_) {
+            --skip_;
+            return true;
+        }
+        Frame done = std::move(stack_.back());
+        stack_.pop_back();
+        if (stack_.empty())
+            return true;                    /* end of the root */
+
+        const bool  same  = done.live && done.same == done.count && done.count == userCount(done.live);
+        obs_data_t *value = same ? done.live : done.obj;
+        Frame      &up    = parent();
+        if (up.array) {
+            obs_data_array_push_back(up.array, value);
+        } else {
+            obs_data_set_obj(isRoot(up) ? sections_ : up.obj, up.key.c_str(), value);
+            if (isRoot(up))
+                ++progress_.sections;
+        }
+        up.child(same);
+        ++progress_.keys;
+        done.release();
+        return true;
+    }
+
+    bool start_array(std::size_t) override
+    {
+        if (skip_) {
+            ++skip_;
+            return true;
+        }
+        if (stack_.empty()) {
+            error_ = QStringLiteral("the bundle is not a JSON object");
+            return false;
+        }
+        Frame &up = parent();
+        if (isRoot(up) || up.array) {
+            /* a top-level array is not a section; obs_data arrays hold only objects */
+            ++skipped_;
+            skip_ = 1;
+            return true;
+        }
+        Frame frame;
+        frame.array = obs_data_array_create();
+        if (obs_data_item_t *was = up.current(); was && obs_data_item_gettype(was) == OBS_DATA_ARRAY)
+            frame.liveArray = obs_data_item_get_array(was);
+        stack_.push_back(std::move(frame));
+        return true;
+    }
+
+    bool end_array() override
+    {
+        if (skip_) {
+            --skip_;
+            return true;
+        }
+        Frame done = std::move(stack_.back());
+        stack_.pop_back();
+        const bool same = done.liveArray && done.same == done.count &&
+                          done.count == obs_data_array_count(done.liveArray);
+        Frame &up = parent();
+        obs_data_set_array(up.obj, up.key.c_str(), same ? done.liveArray : done.array);
+        up.child(same);
+        ++progress_.keys;
+        done.release();
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string &, const nlohmann::detail::exception &ex) override
+    {
+        /* the message carries the line and column */
+        if (error_.isEmpty())
+            error_ = QStringLiteral("invalid JSON: %1").arg(QString::fromUtf8(ex.what()));
+        return false;
+    }
+
+private:
+    struct Frame {
+        obs_data_t       *obj       = nullptr;   ///< Both null: the root.
+        obs_data_array_t *array     = nullptr;
+        obs_data_t       *live      = nullptr;   ///< The live counterpart, if any.
+        obs_data_array_t *liveArray = nullptr;
+        obs_data_item_t  *peer      = nullptr;   ///< Live item in step with the keys.
+        obs_data_item_t  *match     = nullptr;   ///< Live item of the current key, found out of step.
+        bool              inStep    = false;
+        size_t            index     = 0;         ///< Array: objects so far.
+        size_t            count     = 0;         ///< Values stored.
+        size_t            same      = 0;         ///< ... equal to the live ones.
+        std::string       key;
+
+        obs_data_item_t *current() const { return inStep ? peer : match; }
+
+        void child(bool equal)
+        {
+            ++count;
+            same += equal ? 1 : 0;
+        }
+
+        void release()
+        {
+            obs_data_release(obj);
+            obs_data_array_release(array);
+            obs_data_release(live);
+            obs_data_array_release(liveArray);
+            obs_data_item_release(&peer);
+            obs_data_item_release(&match);
+        }
+    };
+
+    Frame &parent() { return stack_.back(); }
+    static bool isRoot(const Frame &frame) { return !frame.obj && !frame.array; }
+
+    /* set stores the value in the parent object; equal compares it with the live item */
+    template<typename Set, typename Equal>
+    bool scalar(Set set, Equal equal)
+    {
+        if (skip_)
+            return true;
+        if (stack_.empty()) {
+            error_ = QStringLiteral("the bundle is not a JSON object");
+            return false;
+        }
+        Frame &up = parent();
+        if constexpr (!std::is_null_pointer_v<Set>) {
+            if (!isRoot(up) && !up.array) {
+                set(up);
+                obs_data_item_t *was = up.current();
+                up.child(was && equal(was));
+                ++progress_.keys;
+                return true;
+            }
+        }
+        ++skipped_;                         /* nulls, top-level scalars, scalars in arrays */
+        return true;
+    }
+
+    const BundleOptions &options_;
+    BundleProgress      &progress_;
+    obs_data_t          *live_;          ///< Pinned live root.
+    obs_data_t          *sections_;
+    std::vector<Frame>   stack_;
+    size_t               skip_    = 0;   ///< Depth inside a value that is not kept.
+    uint64_t             skipped_ = 0;
+    QString              error_;
+};
+
+} // namespace
+
+/* ------------------------------------------------------------------------- */
+/*  ConfigBundle                                                             */
+/* ------------------------------------------------------------------------- */
+bool ConfigBundle::supports(BundleCompression compression)
+{
+    switch (compression) {
+    case BundleCompression::Gzip:
+        return PLAYFAME_HAVE_ZLIB;
+    case BundleCompression::Zstd:
+        return PLAYFAME_HAVE_ZSTD;
+    default:
+        return true;
+    }
+}
+
+BundleStats ConfigBundle::exportTo(const OBSConfigHelper &cfg, const QString &path, const BundleOptions &options)
+{
+    PF_TRACE_SCOPE("config.bundle_export");
+    const auto start = Clock::now();
+    BundleStats    stats;
+    BundleProgress progress;
+    stats.compression = options.compression;
+
+    obs_data_t *root = pinRoot(cfg);
+    for (obs_data_item_t *item = obs_data_first(root); item; obs_data_item_next(&item)) {
+        if (obs_data_item_has_user_value(item) && obs_data_item_gettype(item) == OBS_DATA_OBJECT &&
+            wanted(options.sections, obs_data_item_get_name(item)))
+            ++progress.sectionsTotal;
+    }
+
+    const QByteArray target = path.toUtf8();
+    const QByteArray tmp    = target + ".tmp";
+    bool ok;
+    {
+        BundleSink sink(options, progress);
+        ok = sink.open(tmp, stats.error);
+        if (ok) {
+            BundleWriter writer(sink, progress);
+            std::string &out = sink.text();
+            out.push_back('{');
+            bool first = true;
+            for (obs_data_item_t *item = obs_data_first(root); ok && item; obs_data_item_next(&item)) {
+                if (!obs_data_item_has_user_value(item) || obs_data_item_gettype(item) != OBS_DATA_OBJECT)
+                    continue;
+                const char *name = obs_data_item_get_name(item);
+                if (!wanted(options.sections, name))
+                    continue;
+                out.append(first ? "\n" : ",\n");
+                first = false;
+                writeString(out, name);
+                out.push_back(':');
+                obs_data_t *section = obs_data_item_get_obj(item);
+                ok = writer.object(section) && sink.spill();
+                obs_data_release(section);
+                if (ok)
+                    ++progress.sections;
+                else
+                    obs_data_item_release(&item);
+            }
+            out.append("\n}\n");
+            ok = ok && sink.finish();
+            ok = sink.close() && ok;
+            if (!ok && stats.error.isEmpty())
+                stats.error = sink.error().isEmpty() ? QStringLiteral("write failed") : sink.error();
+        }
+    }
+    obs_data_release(root);
+
+    if (ok && os_rename(tmp.constData(), target.constData()) != 0) {
+        ok          = false;
+        stats.error = QStringLiteral("cannot replace %1").arg(path);
+    }
+    if (!ok)
+        os_unlink(tmp.constData());
+
+    stats.ok         = ok;
+    stats.fileBytes  = progress.fileBytes;
+    stats.jsonBytes  = progress.jsonBytes;
+    stats.sections   = progress.sections;
+    stats.keys       = progress.keys;
+    stats.durationUs = elapsedUs(start);
+    if (ok)
+        obs_log(LOG_INFO, "[ConfigBundle] Exported %zu section(s), %llu values: %llu bytes (%s, %llu uncompressed) in %.1f ms",
+                stats.sections, static_cast<unsigned long long>(stats.keys),
+                static_cast<unsigned long long>(stats.fileBytes), compressionName(stats.compression),
+                static_cast<unsigned long long>(stats.jsonBytes), static_cast<double>(stats.durationUs) / 1000.0);
+    else
+        obs_log(LOG_WARNING, "[ConfigBundle] Export to %s failed: %s", target.constData(),
+                stats.error.toUtf8().constData());
+    return stats;
+}
+
+BundleStats ConfigBundle::importFrom(OBSConfigHelper &cfg, const QString &path, const BundleOptions &options)
+{
+    PF_TRACE_SCOPE("config.bundle_import");
+    const auto start = Clock::now();
+    BundleStats    stats;
+    BundleProgress progress;
+
+    const QByteArray source = path.toUtf8();
+    obs_data_t      *live   = pinRoot(cfg);
+    {
+        BundleSource   input(options, progress);
+        SectionBuilder builder(options, progress, live);
+
+        bool ok = input.open(source, stats.compression, stats.error);
+        if (ok) {
+            std::istream stream(&input);
+            ok = json::sax_parse(stream, &builder);
+            /* the stream's own failure explains a parse error better */
+            if (!input.error().isEmpty())
+                stats.error = input.error();
+            else if (!ok)
+                stats.error = builder.error().isEmpty() ? QStringLiteral("invalid JSON") : builder.error();
+            ok = ok && input.error().isEmpty();
+        }
+        stats.skipped = builder.skipped();
+
+        if (ok && options.progress && !options.progress(progress)) {
+            ok          = false;
+            stats.error = QStringLiteral("cancelled");
+        }
+        if (ok) {
+            /* one snapshot; nothing is applied from a bundle that did not parse to the end */
+            stats.applied = cfg.applySections(builder.sections());
+            ok            = stats.applied.ok;
+        }
+        stats.ok = ok;
+    }
+    obs_data_release(live);
+    if (stats.ok && stats.applied.changed + stats.applied.removed > 0)
+        cfg.save();
+
+    stats.fileBytes  = progress.fileBytes;
+    stats.jsonBytes  = progress.jsonBytes;
+    stats.sections   = progress.sections;
+    stats.keys       = progress.keys;
+    stats.durationUs = elapsedUs(start);
+    if (stats.ok)
+        obs_log(LOG_INFO,
+                "[ConfigBundle] Imported %zu section(s), %llu values from %llu bytes (%s): %zu changed, %zu removed, "
+                "%llu skipped, in %.1f ms",
+                stats.sections, static_cast<unsigned long long>(stats.keys),
+                static_cast<unsigned long long>(stats.fileBytes), compressionName(stats.compression),
+                stats.applied.changed, stats.applied.removed, static_cast<unsigned long long>(stats.skipped),
+                static_cast<double>(stats.durationUs) / 1000.0);
+    else
+        obs_log(LOG_WARNING, "[ConfigBundle] Import of %s failed: %s; nothing applied", source.constData(),
+                stats.error.toUtf8().constData());
+    return stats;
+}
@@ -0,0 +1,99 @@
+/*!
+ * @file config-bundle.h
+ * @brief Streaming export and import of config bundles, optionally compressed.
+ *
+ * A bundle is the config as JSON, one top-level object per section, the
+ * same shape as playfame_config.json, optionally wrapped in gzip or zstd.
+ * Bundles move settings between machines and can reach hundreds of MB
+ * (cached asset lists), so neither direction holds the whole file:
+ *
+ * - exportTo() walks a pinned snapshot and writes JSON text into a fixed
+ *   buffer that is compressed and written out whenever it fills.
+ * - importFrom() decompresses into a fixed buffer and feeds it to the
+ *   nlohmann SAX parser, which builds each section straight into obs_data.
+ *   Every object or array that closes equal to its live counterpart is
+ *   dropped and the live one shared instead. The sections are applied in
+ *   one snapshot with OBSConfigHelper::applySections(), so a truncated
+ *   bundle changes nothing and only keys that differ are published and
+ *   notified.
+ *
+ * Beyond the live config, memory is therefore what the bundle changes,
+ * the object being parsed and two buffers, never the file text or a
+ * second document tree. Both directions report progress and can be
+ * cancelled from the callback. They block; run them as Background tasks
+ * on the plugin executor.
+ *
+ * Like obs_data, arrays keep only their object elements; scalars in
+ * arrays and nulls are counted as skipped.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include "obs-config-helper.h"
+
+#include <QByteArray>
+#include <QString>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+enum class BundleCompression { None, Gzip, Zstd };
+
+struct BundleProgress {
+    uint64_t fileBytes     = 0;   ///< Read from or written to disk so far.
+    uint64_t fileTotal     = 0;   ///< Import: size of the bundle; export: 0 (unknown).
+    uint64_t jsonBytes     = 0;   ///< Uncompressed JSON so far.
+    size_t   sections      = 0;   ///< Completed.
+    size_t   sectionsTotal = 0;   ///< Export only.
+    uint64_t keys          = 0;
+};
+
+/// Return false to cancel; the bundle file or the live config stay as they were.
+using BundleProgressFn = std::function<bool(const BundleProgress &progress)>;
+
+struct BundleOptions {
+    BundleCompression       compression = BundleCompression::None;   ///< Export only; import detects it.
+    int                     level       = 0;          ///< 0: the codec's default.
+    size_t                  bufferBytes = 256 * 1024; ///< Per buffer; memory use does not grow past it.
+    std::vector<QByteArray> sections;                 ///< Only these; empty for all.
+    BundleProgressFn        progress;
+    uint64_t                progressEveryBytes = 4 * 1024 * 1024;
+};
+
+struct BundleStats {
+    bool              ok = false;
+    QString           error;
+    BundleCompression compression = BundleCompression::None;
+    uint64_t          fileBytes   = 0;
+    uint64_t          jsonBytes   = 0;
+    size_t            sections    = 0;
+    uint64_t          keys        = 0;   ///< Values written or read, nested ones included.
+    uint64_t          skipped     = 0;   ///< Import: values obs_data cannot hold.
+    uint64_t          durationUs  = 0;
+    ConfigReloadStats applied;           ///< Import: what applySections() changed.
+};
+
+/**
+ * @class ConfigBundle
+ * @brief Streaming bundle I/O; see the file comment.
+ */
+class ConfigBundle {
+public:
+    /// Writes the current snapshot to @p path (through "<path>.tmp" and a rename).
+    static BundleStats exportTo(const OBSConfigHelper &cfg, const QString &path,
+                                const BundleOptions &options = BundleOptions());
+
+    /// Reads @p path and applies its sections to @p cfg, then saves. The compression is detected.
+    static BundleStats importFrom(OBSConfigHelper &cfg, const QString &path,
+                                  const BundleOptions &options = BundleOptions());
+
+    /// Whether this build can write (and read) @p compression.
+    static bool supports(BundleCompression compression);
+};
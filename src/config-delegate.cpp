@@ -0,0 +1,108 @@
+/*!
+ * @file config-delegate.cpp
+ * @brief Implements the per-type value editors of the settings tree.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "config-delegate.h"
+#include "config-model.h"
+
+#include <QComboBox>
+#include <QDoubleSpinBox>
+#include <QLineEdit>
+#include <QSpinBox>
+
+#include <climits>
+#include <cmath>
+
+QValidator::State Utf8LengthValidator::validate(QString &input, int & /*pos*/) const
+{
+    return input.toUtf8().size() <= maxBytes_ ? Acceptable : Invalid;
+}
+
+QWidget *ConfigValueDelegate::createEditor(QWidget *parent, const QStyleOptionViewItem &option,
+                                           const QModelIndex &index) const
+{
+    const QVariant min = index.data(ConfigModel::MinimumRole);
+    const QVariant max = index.data(ConfigModel::MaximumRole);
+
+    switch (index.data(ConfigModel::ValueTypeRole).toInt()) {
+    case ConfigModel::Boolean: {
+        auto *combo = new QComboBox(parent);
+        combo->addItem(QStringLiteral("false"), false);
+        combo->addItem(QStringLiteral("true"), true);
+        return combo;
+    }
+    case ConfigModel::Integer: {
+        /* QSpinBox is int-only; wider values outside the schema get a plain line edit */
+        const qlonglong current = index.data(Qt::EditRole).toLongLong();
+        if (!min.isValid() && (current < INT_MIN || current > INT_MAX))
+            return new QLineEdit(parent);
+        auto *spin = new QSpinBox(parent);
+        spin->setRange(min.isValid() ? static_cast<int>(min.toDouble()) : INT_MIN,
+                       max.isValid() ? static_cast<int>(max.toDouble()) : INT_MAX);
+        return spin;
+    }
+    case ConfigModel::Real: {
+        auto *spin = new QDoubleSpinBox(parent);
+        spin->setDecimals(6);
+        spin->setRange(min.isValid() ? min.toDouble() : -HUGE_VAL, max.isValid() ? max.toDouble() : HUGE_VAL);
+        return spin;
+    }
+    case ConfigModel::Text: {
+        auto *edit = new QLineEdit(parent);
+        const QVariant maxBytes = index.data(ConfigModel::MaxBytesRole);
+        if (maxBytes.isValid())
+            edit->setValidator(new Utf8LengthValidator(maxBytes.toLongLong(), edit));
+        return edit;
+    }
+    default:
+        return QStyledItemDelegate::createEditor(parent, option, index);
+    }
+}
+
+void ConfigValueDelegate::setEditorData(QWidget *editor, const QModelIndex &index) const
+{
+    const QVariant value = index.data(Qt::EditRole);
+    if (auto *combo = qobject_cast<QComboBox *>(editor))
+        combo->setCurrentIndex(value.toBool() ? 1 : 0);
+    else if (auto *spin = qobject_cast<QSpinBox *>(editor))
+        spin->setValue(static_cast<int>(value.toLongLong()));
+    else if (auto *dspin = qobject_cast<QDoubleSpinBox *>(editor))
+        dspin->setValue(value.toDouble());
+    else if (auto *edit = qobject_cast<QLineEdit *>(editor))
+        edit->setText(value.toString());
+    else
+        QStyledItemDelegate::setEditorData(editor, index);
+}
+
+void ConfigValueDelegate::setModelData(QWidget *editor, QAbstractItemModel *model, const QModelIndex &index) const
+{
+    if (auto *combo = qobject_cast<QComboBox *>(editor))
+        model->setData(index, combo->currentData());
+    else if (auto *spin = qobject_cast<QSpinBox *>(editor))
+        model->setData(index, static_cast<qlonglong>(spin->value()));
+    else if (auto *dspin = qobject_cast<QDoubleSpinBox *>(editor))
+        model->setData(index, dspin->value());
+    else if (auto *edit = qobject_cast<QLineEdit *>(editor))
+        model->setData(index, edit->text());
+    else
+        QStyledItemDelegate::setModelData(editor, model, index);
+}
+
+void ConfigValueDelegate::updateEditorGeometry(QWidget *editor, const QStyleOptionViewItem &option,
+                                               const QModelIndex &) const
+{
+    editor->setGeometry(option.rect);
+}
+
+void ConfigValueDelegate::initStyleOption(QStyleOptionViewItem *option, const QModelIndex &index) const
+{
+    QStyledItemDelegate::initStyleOption(option, index);
+    if (index.siblingAtColumn(ConfigModel::ValueColumn).data(ConfigModel::StagedRole).toBool())
+        option->font.setBold(true);
+}
@@ -0,0 +1,55 @@
+/*!
+ * @file config-delegate.h
+ * @brief Editors for ConfigModel values, created only for the cell being edited.
+ *
+ * Rows are painted by the delegate without any widget; an editor exists
+ * only while a cell is edited and matches the stored type: a line edit for
+ * text, spin boxes for numbers (bounded by the schema when the key is a
+ * schema field) and a combo box for booleans. Staged rows are shown bold.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include <QStyledItemDelegate>
+#include <QValidator>
+
+/**
+ * @brief Accepts text up to a length in UTF-8 bytes, the unit of ConfigTextField::maxBytes.
+ *
+ * QLineEdit::setMaxLength() counts UTF-16 code units, which lets through
+ * non-ASCII text that the schema then rejects on commit.
+ */
+class Utf8LengthValidator : public QValidator {
+public:
+    explicit Utf8LengthValidator(qsizetype maxBytes, QObject *parent = nullptr)
+        : QValidator(parent), maxBytes_(maxBytes)
+    {
+    }
+
+    State validate(QString &input, int &pos) const override;
+
+private:
+    qsizetype maxBytes_;
+};
+
+class ConfigValueDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+
+public:
+    using QStyledItemDelegate::QStyledItemDelegate;
+
+    QWidget *createEditor(QWidget *parent, const QStyleOptionViewItem &option,
+                          const QModelIndex &index) const override;
+    void     setEditorData(QWidget *editor, const QModelIndex &index) const override;
+    void     setModelData(QWidget *editor, QAbstractItemModel *model, const QModelIndex &index) const override;
+    void     updateEditorGeometry(QWidget *editor, const QStyleOptionViewItem &option,
+                                  const QModelIndex &index) const override;
+
+protected:
+    void initStyleOption(QStyleOptionViewItem *option, const QModelIndex &index) const override;
+};
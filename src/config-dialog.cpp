@@ -1,11 +1,16 @@
 // ─────────── config-dialog.cpp ───────────
 #include "config-dialog.h"
+#include "config-delegate.h"
+#include "config-model.h"
+#include "config-search.h"
+#include "config-transaction.h"
+#include <QTreeView>
 #include <QVBoxLayout>
 #include <QDialogButtonBox>
 #include <QMessageBox>
 #include "toast-helper.h"
 
-static constexpr const char *kSec = "demo";
+using namespace ConfigSchema;
 
 ConfigDialog::ConfigDialog(OBSConfigHelper *cfg, QWidget *parent)
     : QDialog(parent)
@@ -13,27 +18,47 @@ ConfigDialog::ConfigDialog(OBSConfigHelper *cfg, QWidget *parent)
 {
     setWindowTitle("PlayFame – Config");
     setModal(true);
-    resize(300, 180);
+    resize(520, 520);
 
     auto *lay = new QVBoxLayout(this);
 
+    /* widget limits come from the schema, the same place validation does */
     txt_ = new QLineEdit(this);
     txt_->setPlaceholderText("Your text…");
+    txt_->setValidator(new Utf8LengthValidator(static_cast<qsizetype>(kDemoText.maxBytes), txt_));
     num_ = new QSpinBox(this);
-    num_->setRange(0, 9999);
+    num_->setRange(kDemoNumber.min, kDemoNumber.max);
 
     opt_ = new QComboBox(this);
-    for (int i = 1; i <= 5; ++i)
+    for (int i = kDemoOption.min; i <= kDemoOption.max; ++i)
         opt_->addItem(QString("Option %1").arg(i), i);
 
+    /* every key of the config; rows are fetched as the tree scrolls, so
+       opening costs the same for any config size */
+    filter_ = new QLineEdit(this);
+    filter_->setPlaceholderText(tr("Search all settings…"));
+    filter_->setClearButtonEnabled(true);
+    model_ = new ConfigModel(cfg_, this);
+    tree_  = new QTreeView(this);
+    tree_->setUniformRowHeights(true);   /* no per-row size queries for rows off screen */
+    tree_->setItemDelegateForColumn(ConfigModel::ValueColumn, new ConfigValueDelegate(tree_));
+    tree_->setModel(model_);
+
+    search_ = std::make_unique<ConfigSearch>(cfg_, this, [this](const ConfigSearchResult &result) {
+        model_->setFilter(result);
+        tree_->expandToDepth(0);
+    });
+
     lay->addWidget(txt_);
     lay->addWidget(num_);
     lay->addWidget(opt_);
+    lay->addWidget(filter_);
+    lay->addWidget(tree_, 1);
 
     auto *btnBox = new QDialogButtonBox(
         QDialogButtonBox::Save | QDialogButtonBox::Cancel, this);
-    auto *loadBtn = new QPushButton("Load", this);
-    btnBox->addButton(loadBtn, QDialogButtonBox::ActionRole);
+    loadBtn_ = new QPushButton("Load", this);
+    btnBox->addButton(loadBtn_, QDialogButtonBox::ActionRole);
 
     lay->addWidget(btnBox);
     setLayout(lay);
@@ -42,38 +67,98 @@ ConfigDialog::ConfigDialog(OBSConfigHelper *cfg, QWidget *parent)
             &QPushButton::clicked, this, &QDialog::reject);
     connect(btnBox->button(QDialogButtonBox::Save),
             &QPushButton::clicked, this, &ConfigDialog::onSave);
-    connect(loadBtn, &QPushButton::clicked, this, &ConfigDialog::onLoad);
+    connect(loadBtn_, &QPushButton::clicked, this, &ConfigDialog::onLoad);
+    connect(filter_, &QLineEdit::textChanged, this, &ConfigDialog::onFilterChanged);
 
     loadFromCfg();
+
+    /* afterwards only fields whose values changed are refreshed */
+    subscription_ = cfg_->subscribeSection(Demo, this, [this](const std::vector<ConfigChange> &changes) {
+        applyChanges(changes);
+    });
+}
+
+ConfigDialog::~ConfigDialog()
+{
+    reloads_.cancel();
+    reloads_.wait();                /* a reload in flight still posts to this object */
+    search_.reset();                /* waits for a running scan before this object stops taking events */
+    cfg_->unsubscribe(subscription_);
 }
 
 void ConfigDialog::loadFromCfg()
 {
-    txt_->setText(cfg_->getValue(kSec, "text", "hello").toString());
-    num_->setValue(cfg_->getValue(kSec, "number", 0).toInt());
-    int idx = cfg_->getValue(kSec, "option", 1).toInt() - 1;
-    opt_->setCurrentIndex(std::clamp(idx, 0, 4));
+    /* defaults and clamping come from the schema */
+    txt_->setText(cfg_->get(kDemoText));
+    num_->setValue(cfg_->get(kDemoNumber));
+    opt_->setCurrentIndex(cfg_->get(kDemoOption) - kDemoOption.min);
 }
 
-void ConfigDialog::saveToCfg()
+void ConfigDialog::applyChanges(const std::vector<ConfigChange> &changes)
 {
-    cfg_->setValue(kSec, "text",   txt_->text(),   QMetaType::QString);
-    cfg_->setValue(kSec, "number", num_->value(),  QMetaType::Int, 0, 9999);
-    cfg_->setValue(kSec, "option", opt_->currentData().toInt(),
-                   QMetaType::Int, 1, 5);
-    cfg_->save();
+    for (const ConfigChange &change : changes) {
+        if (change.key == kDemoText.key)
+            txt_->setText(cfg_->get(kDemoText));
+        else if (change.key == kDemoNumber.key)
+            num_->setValue(cfg_->get(kDemoNumber));
+        else if (change.key == kDemoOption.key)
+            opt_->setCurrentIndex(cfg_->get(kDemoOption) - kDemoOption.min);
+    }
+}
+
+bool ConfigDialog::saveToCfg()
+{
+    /* all three keys land together (or not at all), followed by one save */
+    ConfigTransaction tx = cfg_->begin();
+    tx.set(kDemoText,   txt_->text());
+    tx.set(kDemoNumber, num_->value());
+    tx.set(kDemoOption, opt_->currentData().toInt());
+    model_->stage(tx);              /* after the fields: an edit in the tree wins */
+    if (!tx.commit())
+        return false;
+    model_->discardEdits();
+    return true;
 }
 
 void ConfigDialog::onLoad()
 {
-    cfg_->load();
-    loadFromCfg();
-    showToast(this, tr("Config loaded"));    
+    /* parsing a large file takes long enough to freeze the dialog */
+    loadBtn_->setEnabled(false);
+    const bool posted = reloads_.post([this, token = reloads_.token()]() {
+        const ConfigReloadStats stats = cfg_->reload();
+        if (token.cancelled())
+            return;
+        PluginExecutor::global().postToUi(this, [this, stats]() {
+            loadBtn_->setEnabled(true);
+            if (!stats.ok) {
+                showToast(this, tr("Config not loaded: file is unreadable"), true);
+                return;
+            }
+            /* only what differs from the file is applied to the config, so fields the
+               file did not change would keep their unsaved edits: reset the form */
+            loadFromCfg();
+            showToast(this, stats.fromBackup
+                                ? tr("Config loaded from backup (%1 changed)").arg(stats.changed + stats.removed)
+                                : tr("Config loaded (%1 changed)").arg(stats.changed + stats.removed));
+        });
+    });
+    if (!posted)
+        loadBtn_->setEnabled(true);    /* shutting down */
 }
 
 void ConfigDialog::onSave()
 {
-    saveToCfg();
+    if (!saveToCfg()) {
+        showToast(this, tr("Config not saved: invalid value"), true);
+        return;
+    }
     showToast(this, tr("Config saved"));    
     accept();
 }
+
+void ConfigDialog::onFilterChanged(const QString &text)
+{
+    search_->search(text);          /* debounced; an empty query just cancels */
+    if (text.isEmpty())
+        model_->clearFilter();
+}
@@ -5,21 +5,37 @@
 #include <QComboBox>
 #include <QPushButton>
 #include "obs-config-helper.h"
+#include "plugin-executor.h"
+#include <memory>
+
+class ConfigModel;
+class ConfigSearch;
+class QTreeView;
 
 class ConfigDialog : public QDialog {
     Q_OBJECT
 public:
     ConfigDialog(OBSConfigHelper *cfg, QWidget *parent = nullptr);
+    ~ConfigDialog() override;
 
 private:
     OBSConfigHelper *cfg_;
     QLineEdit  *txt_;
     QSpinBox   *num_;
     QComboBox  *opt_;
+    QLineEdit  *filter_;
+    QTreeView  *tree_;
+    QPushButton *loadBtn_;
+    ConfigModel *model_;
+    std::unique_ptr<ConfigSearch> search_;
+    uint64_t    subscription_ = 0;
+    TaskGroup   reloads_{TaskLane::Interactive};   ///< Load runs here, off the UI thread.
     void loadFromCfg();
-    void saveToCfg();
+    void applyChanges(const std::vector<ConfigChange> &changes);
+    bool saveToCfg();
 
 private slots:
     void onLoad();
     void onSave();
+    void onFilterChanged(const QString &text);
 };
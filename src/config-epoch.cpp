@@ -0,0 +1,173 @@
+/*!
+ * @file config-epoch.cpp
+ * @brief Implements epoch-based reclamation for config snapshots.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "config-epoch.h"
+
+#include <algorithm>
+#include <limits>
+
+/* ------------------------------------------------------------------------- */
+/*  Per-thread reader state                                                  */
+/* ------------------------------------------------------------------------- */
+/* A thread rarely reads from more than one domain; a tiny array is enough. */
+struct EpochThreadReaders {
+    struct Entry {
+        EpochDomain *domain = nullptr;
+        void        *slot   = nullptr;
+        uint32_t     depth  = 0;
+    };
+
+    static constexpr size_t kMaxDomains = 4;
+    Entry entries[kMaxDomains];
+
+    ~EpochThreadReaders();
+};
+
+static thread_local EpochThreadReaders t_readers;
+
+EpochDomain &EpochDomain::global()
+{
+    static EpochDomain domain;
+    return domain;
+}
+
+EpochDomain::~EpochDomain()
+{
+    std::lock_guard<std::mutex> lock(retiredMutex_);
+    for (const Retired &r : retired_)
+        r.deleter(r.ptr);
+    retired_.clear();
+}
+
+EpochDomain::Slot *EpochDomain::claimSlot()
+{
+    for (Slot &slot : slots_) {
+        bool expected = false;
+        if (!slot.used.load(std::memory_order_relaxed) &&
+            slot.used.compare_exchange_strong(expected, true, std::memory_order_acquire))
+            return &slot;
+    }
+    return nullptr;                 /* all slots taken: fall back to overflow pins */
+}
+
+void EpochDomain::releaseSlot(Slot *slot)
+{
+    slot->epoch.store(0, std::memory_order_release);
+    slot->used.store(false, std::memory_order_release);
+}
+
+EpochThreadReaders::~EpochThreadReaders()
+{
+    for (Entry &e : entries) {
+        if (e.domain && e.slot)
+            e.domain->releaseSlot(static_cast<EpochDomain::Slot *>(e.slot));
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Read side                                                                */
+/* ------------------------------------------------------------------------- */
+void EpochDomain::pin()
+{
+    EpochThreadReaders::Entry *entry = nullptr;
+    for (EpochThreadReaders::Entry &e : t_readers.entries) {
+        if (e.domain == this) {
+            entry = &e;
+            break;
+        }
+        if (!e.domain && !entry)
+            entry = &e;
+    }
+
+    if (entry && !entry->domain) {  /* first read from this domain on this thread */
+        entry->domain = this;
+        entry->slot   = claimSlot();
+    }
+
+    if (entry && entry->depth++ > 0)
+        return;                     /* nested guard: already pinned */
+
+    Slot *slot = entry ? static_cast<Slot *>(entry->slot) : nullptr;
+    if (slot) {
+        /* seq_cst: the store must be visible before the caller loads a pointer */
+        slot->epoch.store(epoch_.load(std::memory_order_relaxed), std::memory_order_seq_cst);
+    } else {
+        overflowPins_.fetch_add(1, std::memory_order_seq_cst);
+    }
+}
+
+void EpochDomain::unpin()
+{
+    EpochThreadReaders::Entry *entry = nullptr;
+    for (EpochThreadReaders::Entry &e : t_readers.entries) {
+        if (e.domain == this) {
+            entry = &e;
+            break;
+        }
+    }
+
+    if (entry && --entry->depth > 0)
+        return;
+
+    Slot *slot = entry ? static_cast<Slot *>(entry->slot) : nullptr;
+    if (slot)
+        slot->epoch.store(0, std::memory_order_release);
+    else
+        overflowPins_.fetch_sub(1, std::memory_order_release);
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Write side                                                               */
+/* ------------------------------------------------------------------------- */
+void EpochDomain::retire(void *ptr, Deleter deleter)
+{
+    if (!ptr)
+        return;
+
+    /* the caller has already unpublished ptr, so readers pinning from now on
+     * cannot reach it; only those pinned at or before this epoch can */
+    const uint64_t retiredAt = epoch_.fetch_add(1, std::memory_order_seq_cst);
+    {
+        std::lock_guard<std::mutex> lock(retiredMutex_);
+        retired_.push_back({ptr, deleter, retiredAt});
+    }
+    reclaim();
+}
+
+void EpochDomain::reclaim()
+{
+    if (overflowPins_.load(std::memory_order_seq_cst) > 0)
+        return;
+
+    uint64_t oldest = std::numeric_limits<uint64_t>::max();
+    for (const Slot &slot : slots_) {
+        const uint64_t e = slot.epoch.load(std::memory_order_seq_cst);
+        if (e)
+            oldest = std::min(oldest, e);
+    }
+
+    std::vector<Retired> ready;
+    {
+        std::lock_guard<std::mutex> lock(retiredMutex_);
+        auto split = std::partition(retired_.begin(), retired_.end(),
+                                    [oldest](const Retired &r) { return r.epoch >= oldest; });
+        ready.assign(split, retired_.end());
+        retired_.erase(split, retired_.end());
+    }
+
+    for (const Retired &r : ready)  /* deleters run outside the lock */
+        r.deleter(r.ptr);
+}
+
+size_t EpochDomain::pendingCount() const
+{
+    std::lock_guard<std::mutex> lock(retiredMutex_);
+    return retired_.size();
+}
@@ -0,0 +1,121 @@
+/*!
+ * @file config-epoch.h
+ * @brief Epoch-based reclamation for lock-free, read-mostly snapshots.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+ * @class EpochDomain
+ * @brief Defers freeing of retired objects until no reader can still see them.
+ *
+ * Readers pin the current epoch with an EpochGuard, then load a published
+ * pointer. Pinning is one store into a per-thread slot: no lock, no CAS, no
+ * allocation, so it is safe on OBS's video render and audio threads.
+ *
+ * Writers swap the published pointer, then retire() the previous object. It
+ * is freed once every pinned reader has moved past the epoch it was retired
+ * in. Writers serialise among themselves; retire() takes a mutex.
+ */
+class EpochDomain {
+public:
+    /// Maximum threads that can hold a dedicated reader slot at once.
+    static constexpr size_t kMaxReaders = 256;
+
+    using Deleter = void (*)(void *);
+
+    /// Process-wide domain shared by all config stores.
+    static EpochDomain &global();
+
+    EpochDomain() = default;
+    ~EpochDomain();
+
+    EpochDomain(const EpochDomain &) = delete;
+    EpochDomain &operator=(const EpochDomain &) = delete;
+
+    /**
+     * @brief Hands an unpublished object over for deferred deletion.
+     * @param ptr Object that new readers can no longer reach.
+     * @param deleter Called with @p ptr once it is safe to free.
+     */
+    void retire(void *ptr, Deleter deleter);
+
+    /// Frees every retired object that no pinned reader can still see.
+    void reclaim();
+
+    /// Number of retired objects waiting for readers to move on.
+    size_t pendingCount() const;
+
+private:
+    friend class EpochGuard;
+    friend struct EpochThreadReaders;
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{0};  ///< 0 = not inside a read section.
+        std::atomic<bool>     used{false};
+    };
+
+    struct Retired {
+        void    *ptr;
+        Deleter  deleter;
+        uint64_t epoch;
+    };
+
+    Slot *claimSlot();
+    void  releaseSlot(Slot *slot);
+    void  pin();
+    void  unpin();
+
+    std::atomic<uint64_t> epoch_{1};
+    std::atomic<uint32_t> overflowPins_{0}; ///< Readers without a slot; blocks reclamation.
+    Slot                  slots_[kMaxReaders];
+
+    mutable std::mutex   retiredMutex_;
+    std::vector<Retired> retired_;
+};
+
+/**
+ * @class EpochGuard
+ * @brief RAII read-side critical section for an EpochDomain.
+ *
+ * Pointers loaded while a guard is alive remain valid until it is destroyed.
+ * Guards nest and must be destroyed on the thread that created them.
+ */
+class EpochGuard {
+public:
+    explicit EpochGuard(EpochDomain &domain = EpochDomain::global())
+        : domain_(&domain)
+    {
+        domain_->pin();
+    }
+
+    ~EpochGuard()
+    {
+        if (domain_)
+            domain_->unpin();
+    }
+
+    EpochGuard(EpochGuard &&other) noexcept
+        : domain_(other.domain_)
+    {
+        other.domain_ = nullptr;
+    }
+
+    EpochGuard(const EpochGuard &) = delete;
+    EpochGuard &operator=(const EpochGuard &) = delete;
+    EpochGuard &operator=(EpochGuard &&) = delete;
+
+private:
+    EpochDomain *domain_;
+};
@@ -0,0 +1,240 @@
+/*!
+ * @file config-ipc-protocol.h
+ * @brief Wire format of the local config control endpoint (see config-ipc.h).
+ *
+ * Every message is a frame: a little-endian u32 payload length followed by
+ * the payload. Clients may pipeline any number of requests; responses come
+ * back in request order and echo the request id.
+ *
+ * Request payload:
+ *
+ *     u32 id
+ *     u16 op count
+ *     op count x { u8 Op, str16 section, str16 key, [Set: value] }
+ *
+ * Response payload:
+ *
+ *     u32 id
+ *     u8  Status
+ *     u16 failed op index, or kNoOp
+ *     u64 config version the gets were read from (after the sets)
+ *     u16 value count, then one value per Get op, in order (Ok only)
+ *
+ * str16 is a u16 byte count and UTF-8 bytes; a value is a u8 ValueTag and
+ * then u8 (Bool), i64 (Int), f64 (Double) or a u32 byte count and UTF-8
+ * bytes (String). All integers are little-endian.
+ *
+ * All sets of a request are applied in one transaction before its gets are
+ * read, from one snapshot, so the gets see the request's own writes. A set
+ * that fails validation rejects the whole request and applies nothing.
+ *
+ * No OBS or Qt dependency, so clients can include it as is.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+namespace ConfigIpc {
+
+inline constexpr size_t   kHeaderBytes   = 4;
+inline constexpr uint32_t kMaxFrameBytes = 1u << 20;   ///< Larger frames are answered with TooLarge and the connection closed.
+inline constexpr uint16_t kMaxOps        = 4096;
+inline constexpr uint16_t kNoOp          = 0xFFFF;
+
+enum class Op : uint8_t { Get = 1, Set = 2 };
+
+/// Same numbering as the config journal's value tags.
+enum class ValueTag : uint8_t {
+    Missing = 0,   ///< Get: no such key.
+    Bool    = 1,
+    Int     = 2,
+    Double  = 3,
+    String  = 4,
+    Other   = 5,   ///< Get: an object or array; not readable here.
+};
+
+enum class Status : uint8_t {
+    Ok        = 0,
+    Malformed = 1,   ///< The payload does not parse; failed op is where it stopped.
+    Rejected  = 2,   ///< A set failed validation (type or schema range); nothing was applied.
+    TooLarge  = 3,   ///< Frame over the limit; the connection is closed after this response.
+};
+
+/**
+ * @brief A decoded value; String views into the frame it came from.
+ */
+struct Value {
+    ValueTag         tag = ValueTag::Missing;
+    bool             b   = false;
+    int64_t          i   = 0;
+    double           d   = 0.0;
+    std::string_view s;
+};
+
+/**
+ * @brief Appends little-endian fields to a byte vector.
+ */
+class Writer {
+public:
+    explicit Writer(std::vector<uint8_t> &out) : out_(out) {}
+
+    void u8(uint8_t v) { out_.push_back(v); }
+    void u16(uint16_t v) { le(v, 2); }
+    void u32(uint32_t v) { le(v, 4); }
+    void u64(uint64_t v) { le(v, 8); }
+    void i64(int64_t v) { le(static_cast<uint64_t>(v), 8); }
+
+    void f64(double v)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof bits);
+        le(bits, 8);
+    }
+
+    void str16(std::string_view s)
+    {
+        u16(static_cast<uint16_t>(s.size()));
+        bytes(s);
+    }
+
+    void str32(std::string_view s)
+    {
+        u32(static_cast<uint32_t>(s.size()));
+        bytes(s);
+    }
+
+    void value(const Value &v)
+    {
+        u8(static_cast<uint8_t>(v.tag));
+        switch (v.tag) {
+        case ValueTag::Bool:   u8(v.b ? 1 : 0); break;
+        case ValueTag::Int:    i64(v.i); break;
+        case ValueTag::Double: f64(v.d); break;
+        case ValueTag::String: str32(v.s); break;
+        default:               break;
+        }
+    }
+
+    /// Reserves the length prefix; pass the result to endFrame().
+    size_t beginFrame()
+    {
+        const size_t at = out_.size();
+        u32(0);
+        return at;
+    }
+
+    void endFrame(size_t at)
+    {
+        const uint32_t n = static_cast<uint32_t>(out_.size() - at - kHeaderBytes);
+        for (size_t k = 0; k < 4; ++k)
+            out_[at + k] = static_cast<uint8_t>(n >> (8 * k));
+    }
+
+private:
+    void le(uint64_t v, size_t n)
+    {
+        for (size_t k = 0; k < n; ++k)
+            out_.push_back(static_cast<uint8_t>(v >> (8 * k)));
+    }
+
+    void bytes(std::string_view s) { out_.insert(out_.end(), s.begin(), s.end()); }
+
+    std::vector<uint8_t> &out_;
+};
+
+/**
+ * @brief Reads little-endian fields; any overrun clears ok() and yields zeros.
+ */
+class Reader {
+public:
+    Reader(const uint8_t *data, size_t size) : p_(data), end_(data + size) {}
+
+    bool ok() const { return ok_; }
+    bool atEnd() const { return p_ == end_; }
+
+    uint8_t  u8() { return static_cast<uint8_t>(le(1)); }
+    uint16_t u16() { return static_cast<uint16_t>(le(2)); }
+    uint32_t u32() { return static_cast<uint32_t>(le(4)); }
+    uint64_t u64() { return le(8); }
+    int64_t  i64() { return static_cast<int64_t>(le(8)); }
+
+    double f64()
+    {
+        const uint64_t bits = le(8);
+        double         v;
+        std::memcpy(&v, &bits, sizeof v);
+        return v;
+    }
+
+    std::string_view str16() { return bytes(u16()); }
+    std::string_view str32() { return bytes(u32()); }
+
+    Value value()
+    {
+        Value v;
+        v.tag = static_cast<ValueTag>(u8());
+        switch (v.tag) {
+        case ValueTag::Missing:
+        case ValueTag::Other:  break;
+        case ValueTag::Bool:   v.b = u8() != 0; break;
+        case ValueTag::Int:    v.i = i64(); break;
+        case ValueTag::Double: v.d = f64(); break;
+        case ValueTag::String: v.s = str32(); break;
+        default:               ok_ = false; break;
+        }
+        return v;
+    }
+
+private:
+    bool take(size_t n)
+    {
+        if (!ok_ || static_cast<size_t>(end_ - p_) < n) {
+            ok_ = false;
+            return false;
+        }
+        return true;
+    }
+
+    uint64_t le(size_t n)
+    {
+        if (!take(n))
+            return 0;
+        uint64_t v = 0;
+        for (size_t k = 0; k < n; ++k)
+            v |= static_cast<uint64_t>(p_[k]) << (8 * k);
+        p_ += n;
+        return v;
+    }
+
+    std::string_view bytes(size_t n)
+    {
+        if (!take(n))
+            return {};
+        std::string_view s(reinterpret_cast<const char *>(p_), n);
+        p_ += n;
+        return s;
+    }
+
+    const uint8_t *p_;
+    const uint8_t *end_;
+    bool           ok_ = true;
+};
+
+/// Payload length of the frame at @p header (kHeaderBytes readable).
+inline uint32_t frameLength(const uint8_t *header)
+{
+    return static_cast<uint32_t>(header[0]) | static_cast<uint32_t>(header[1]) << 8 |
+           static_cast<uint32_t>(header[2]) << 16 | static_cast<uint32_t>(header[3]) << 24;
+}
+
+} // namespace ConfigIpc
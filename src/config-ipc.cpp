@@ -0,0 +1,855 @@
+/*!
+ * @file config-ipc.cpp
+ * @brief Implements ConfigIpcServer: the request handler and both transports.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "config-ipc.h"
+#include "config-schema.h"
+#include "config-transaction.h"
+
+#include <obs-module.h>
+#include <plugin-support.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+
+#include <QString>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace ConfigIpc;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr size_t kReadChunk = 64 * 1024;
+
+/* stop reading from a client that does not read its responses */
+constexpr size_t kOutHighWater = 4 * 1024 * 1024;
+
+QByteArray bytesOf(std::string_view s)
+{
+    return QByteArray::fromRawData(s.data(), static_cast<qsizetype>(s.size()));
+}
+
+bool validName(std::string_view s)
+{
+    return !s.empty() && s.find('\0') == std::string_view::npos;
+}
+
+} // namespace
+
+/* ------------------------------------------------------------------------- */
+/*  Platform state                                                           */
+/* ------------------------------------------------------------------------- */
+struct ConfigIpcServer::Endpoint {
+#ifdef _WIN32
+    HANDLE       stopEvent = nullptr;
+    HANDLE       first     = INVALID_HANDLE_VALUE;   ///< Created by start(), adopted by run().
+    std::wstring name;
+#else
+    int  listenFd = -1;
+    int  wake[2]  = {-1, -1};   ///< Self-pipe: stop() writes, the poll loop wakes.
+    bool created  = false;      ///< We bound the socket path and remove it on stop.
+#endif
+};
+
+struct ConfigIpcServer::Connection {
+    std::vector<uint8_t> in;
+    size_t               inPos   = 0;
+    std::vector<uint8_t> out;
+    size_t               outPos  = 0;
+    bool                 closing = false;   ///< Flush out, then close.
+
+#ifdef _WIN32
+    enum class State { Connecting, Reading, Writing };
+
+    HANDLE               pipe  = INVALID_HANDLE_VALUE;
+    HANDLE               event = nullptr;
+    OVERLAPPED           ov{};
+    State                state = State::Connecting;
+    bool                 early = false;   ///< Connected before ConnectNamedPipe(): no I/O to complete.
+    std::vector<uint8_t> chunk;
+#else
+    int fd = -1;
+#endif
+
+    size_t pending() const { return out.size() - outPos; }
+};
+
+/* ------------------------------------------------------------------------- */
+/*  Lifetime                                                                 */
+/* ------------------------------------------------------------------------- */
+ConfigIpcServer::ConfigIpcServer(OBSConfigHelper *cfg, ConfigIpcOptions options)
+    : cfg_(cfg)
+    , options_(std::move(options))
+{
+    options_.maxClients    = std::clamp<size_t>(options_.maxClients, 1, 63);   /* one wait slot is the stop event */
+    options_.maxFrameBytes = std::max<uint32_t>(options_.maxFrameBytes, 64);
+    if (options_.path.isEmpty())
+        options_.path = defaultPath();
+
+    /* schema sections are interned first, in order */
+    for (uint32_t i = 0; i < ConfigSchema::SectionCount; ++i)
+        sections_.insert(QByteArray(ConfigSchema::kSections[i]), i);
+}
+
+ConfigIpcServer::~ConfigIpcServer()
+{
+    stop();
+}
+
+ConfigIpcStats ConfigIpcServer::stats() const
+{
+    ConfigIpcStats s;
+    s.connections  = connections_.load(std::memory_order_relaxed);
+    s.refused      = refused_.load(std::memory_order_relaxed);
+    s.requests     = requestsServed_.load(std::memory_order_relaxed);
+    s.gets         = gets_.load(std::memory_order_relaxed);
+    s.sets         = sets_.load(std::memory_order_relaxed);
+    s.commits      = commits_.load(std::memory_order_relaxed);
+    s.rejected     = rejected_.load(std::memory_order_relaxed);
+    s.malformed    = malformed_.load(std::memory_order_relaxed);
+    s.bytesIn      = bytesIn_.load(std::memory_order_relaxed);
+    s.bytesOut     = bytesOut_.load(std::memory_order_relaxed);
+    s.requestP50Us = requestNs_.percentile(0.50) / 1000;
+    s.requestP99Us = requestNs_.percentile(0.99) / 1000;
+    return s;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Requests                                                                 */
+/* ------------------------------------------------------------------------- */
+bool ConfigIpcServer::serve(Connection &conn)
+{
+    while (conn.in.size() - conn.inPos >= kHeaderBytes) {
+        const uint8_t *frame = conn.in.data() + conn.inPos;
+        const uint32_t size  = frameLength(frame);
+        if (size > options_.maxFrameBytes) {
+            /* the stream cannot be resynchronised: answer, then close */
+            malformed_.fetch_add(1, std::memory_order_relaxed);
+            respond(conn.out, 0, Status::TooLarge, kNoOp);
+            conn.in.clear();
+            conn.inPos = 0;
+            return false;
+        }
+        if (conn.in.size() - conn.inPos < kHeaderBytes + size)
+            break;
+        handle(frame + kHeaderBytes, size, conn.out);
+        conn.inPos += kHeaderBytes + size;
+    }
+
+    /* keep the partial frame at the front */
+    if (conn.inPos == conn.in.size()) {
+        conn.in.clear();
+        conn.inPos = 0;
+    } else if (conn.inPos > conn.in.size() / 2) {
+        conn.in.erase(conn.in.begin(), conn.in.begin() + static_cast<std::ptrdiff_t>(conn.inPos));
+        conn.inPos = 0;
+    }
+    return true;
+}
+
+void ConfigIpcServer::handle(const uint8_t *payload, size_t size, std::vector<uint8_t> &out)
+{
+    PF_TRACE_SCOPE("ipc.request");
+    const Clock::time_point start = Clock::now();
+    requestsServed_.fetch_add(1, std::memory_order_relaxed);
+    const auto finish = [&] {
+        requestNs_.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count()));
+    };
+
+    Reader         in(payload, size);
+    const uint32_t id    = in.u32();
+    const uint16_t count = in.u16();
+    bool           ok    = in.ok() && count <= kMaxOps;
+
+    requests_.clear();
+    for (uint16_t i = 0; ok && i < count; ++i) {
+        Request r;
+        r.op      = static_cast<Op>(in.u8());
+        r.section = in.str16();
+        r.key     = in.str16();
+        if (r.op == Op::Set)
+            r.value = in.value();
+        else if (r.op != Op::Get)
+            ok = false;
+        ok = ok && in.ok();
+        if (ok)
+            requests_.push_back(r);
+    }
+    if (!ok || !in.atEnd()) {
+        malformed_.fetch_add(1, std::memory_order_relaxed);
+        respond(out, id, Status::Malformed, static_cast<uint16_t>(requests_.size()));
+        finish();
+        return;
+    }
+
+    /* every set in one transaction: all of them or none */
+    std::optional<ConfigTransaction> tx;
+    uint16_t                         gets = 0;
+    for (size_t i = 0; i < requests_.size(); ++i) {
+        const Request &r = requests_[i];
+        if (r.op == Op::Get) {
+            ++gets;
+            continue;
+        }
+        if (!tx)
+            tx.emplace(cfg_->begin());
+        if (!stage(*tx, r)) {
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            respond(out, id, Status::Rejected, static_cast<uint16_t>(i));
+            finish();
+            return;
+        }
+    }
+    if (tx) {
+        sets_.fetch_add(tx->size(), std::memory_order_relaxed);
+        if (!tx->commit()) {
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            respond(out, id, Status::Rejected, kNoOp);
+            finish();
+            return;
+        }
+        commits_.fetch_add(1, std::memory_order_relaxed);
+    }
+    gets_.fetch_add(gets, std::memory_order_relaxed);
+
+    /* one snapshot for every get, taken after the commit */
+    const ConfigReader reader = cfg_->reader();
+    Writer             w(out);
+    const size_t       at = w.beginFrame();
+    w.u32(id);
+    w.u8(static_cast<uint8_t>(Status::Ok));
+    w.u16(kNoOp);
+    w.u64(reader.version());
+    w.u16(gets);
+    for (const Request &r : requests_) {
+        if (r.op == Op::Get)
+            readValue(reader, r, w);
+    }
+    w.endFrame(at);
+    finish();
+}
+
+void ConfigIpcServer::respond(std::vector<uint8_t> &out, uint32_t id, Status status, uint16_t failedOp)
+{
+    Writer       w(out);
+    const size_t at = w.beginFrame();
+    w.u32(id);
+    w.u8(static_cast<uint8_t>(status));
+    w.u16(failedOp);
+    w.u64(0);
+    w.u16(0);
+    w.endFrame(at);
+}
+
+bool ConfigIpcServer::stage(ConfigTransaction &tx, const Request &request)
+{
+    if (!validName(request.section) || !validName(request.key))
+        return false;
+
+    const Value     &v = request.value;
+    const ConfigKey  key{sectionId(request.section), QByteArray(request.key.data(),
+                                                                static_cast<qsizetype>(request.key.size()))};
+    const ConfigFieldInfo *field = ConfigSchema::findField(request.section, request.key);
+
+    /* schema fields: the field's type only, within its limits */
+    if (field) {
+        switch (field->type) {
+        case ConfigFieldType::Bool:
+            if (v.tag != ValueTag::Bool)
+                return false;
+            tx.set<bool>(key, v.b);
+            return true;
+        case ConfigFieldType::Integer:
+            if (v.tag != ValueTag::Int || static_cast<double>(v.i) < field->min ||
+                static_cast<double>(v.i) > field->max)
+                return false;
+            tx.set<long long>(key, v.i);
+            return true;
+        case ConfigFieldType::Real: {
+            const double d = v.tag == ValueTag::Double ? v.d
+                             : v.tag == ValueTag::Int  ? static_cast<double>(v.i)
+                                                       : std::nan("");
+            if (!(d >= field->min && d <= field->max))
+                return false;
+            tx.set<double>(key, d);
+            return true;
+        }
+        case ConfigFieldType::Text:
+            if (v.tag != ValueTag::String || v.s.size() > field->maxBytes)
+                return false;
+            tx.set(key, QByteArray(v.s.data(), static_cast<qsizetype>(v.s.size())));
+            return true;
+        }
+        return false;
+    }
+
+    /* anything else: any scalar the config file can hold */
+    switch (v.tag) {
+    case ValueTag::Bool:
+        tx.set<bool>(key, v.b);
+        return true;
+    case ValueTag::Int:
+        tx.set<long long>(key, v.i);
+        return true;
+    case ValueTag::Double:
+        if (!std::isfinite(v.d))   /* not representable in JSON */
+            return false;
+        tx.set<double>(key, v.d);
+        return true;
+    case ValueTag::String:
+        tx.set(key, QByteArray(v.s.data(), static_cast<qsizetype>(v.s.size())));
+        return true;
+    default:
+        return false;
+    }
+}
+
+uint32_t ConfigIpcServer::sectionId(std::string_view section)
+{
+    const auto it = sections_.constFind(bytesOf(section));
+    if (it != sections_.constEnd())
+        return *it;
+
+    /* interning a new name republishes once; later requests hit the cache */
+    const QByteArray name(section.data(), static_cast<qsizetype>(section.size()));
+    const uint32_t   id = cfg_->key(name.constData(), "").section;
+    sections_.insert(name, id);
+    return id;
+}
+
+void ConfigIpcServer::readValue(const ConfigReader &reader, const Request &request, Writer &w)
+{
+    obs_data_t *section = nullptr;
+    obs_data_t *owned   = nullptr;
+
+    const auto it = sections_.constFind(bytesOf(request.section));
+    if (it != sections_.constEnd()) {
+        section = reader.snapshot()->section(*it);
+    } else {
+        /* not interned: look it up without interning a name the client made up */
+        scratch_.assign(request.section);
+        owned   = obs_data_get_obj(reader.snapshot()->root, scratch_.c_str());
+        section = owned;
+    }
+
+    obs_data_item_t *item = nullptr;
+    if (section) {
+        scratch_.assign(request.key);
+        item = obs_data_item_byname(section, scratch_.c_str());
+    }
+
+    Value v;
+    if (item) {
+        switch (obs_data_item_gettype(item)) {
+        case OBS_DATA_BOOLEAN:
+            v.tag = ValueTag::Bool;
+            v.b   = obs_data_item_get_bool(item);
+            break;
+        case OBS_DATA_NUMBER:
+            if (obs_data_item_numtype(item) == OBS_DATA_NUM_DOUBLE) {
+                v.tag = ValueTag::Double;
+                v.d   = obs_data_item_get_double(item);
+            } else {
+                v.tag = ValueTag::Int;
+                v.i   = obs_data_item_get_int(item);
+            }
+            break;
+        case OBS_DATA_STRING: {
+            const char *s = obs_data_item_get_string(item);
+            v.tag         = ValueTag::String;
+            v.s           = s ? std::string_view(s) : std::string_view();
+            break;
+        }
+        default:
+            v.tag = ValueTag::Other;
+            break;
+        }
+    }
+    w.value(v);   /* before the release: v.s points into the item */
+
+    obs_data_item_release(&item);
+    obs_data_release(owned);
+}
+
+#ifndef _WIN32
+/* ------------------------------------------------------------------------- */
+/*  POSIX: Unix domain socket, one poll() loop                               */
+/* ------------------------------------------------------------------------- */
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;   /* SO_NOSIGPIPE is set per socket instead */
+#endif
+
+bool setNonBlocking(int fd)
+{
+    const int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0 && fcntl(fd, F_SETFD, FD_CLOEXEC) == 0;
+}
+
+void noSigPipe(int fd)
+{
+#ifdef SO_NOSIGPIPE
+    const int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof on);
+#else
+    (void)fd;
+#endif
+}
+
+void closeFd(int &fd)
+{
+    if (fd >= 0)
+        ::close(fd);
+    fd = -1;
+}
+
+/* true if something accepts connections on @p addr: another instance owns it */
+bool socketInUse(const sockaddr_un &addr)
+{
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return false;
+    const bool inUse = ::connect(fd, reinterpret_cast<const sockaddr *>(&addr), sizeof addr) == 0;
+    ::close(fd);
+    return inUse;
+}
+
+} // namespace
+
+QByteArray ConfigIpcServer::defaultPath()
+{
+    const char *dir = std::getenv("XDG_RUNTIME_DIR");
+    if (!dir || !*dir)
+        dir = std::getenv("TMPDIR");
+    if (!dir || !*dir)
+        dir = "/tmp";
+    QByteArray path(dir);
+    if (!path.endsWith('/'))
+        path += "/";
+    return path + "playfame-" + QByteArray::number(static_cast<qint64>(::getpid())) + ".sock";
+}
+
+bool ConfigIpcServer::start()
+{
+    if (thread_.joinable())
+        return true;
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (static_cast<size_t>(options_.path.size()) >= sizeof addr.sun_path) {
+        obs_log(LOG_WARNING, "[ConfigIpc] Socket path too long: %s", options_.path.constData());
+        return false;
+    }
+    std::memcpy(addr.sun_path, options_.path.constData(), static_cast<size_t>(options_.path.size()));
+
+    /* a socket left behind by a crashed instance is removed; anything else is not ours */
+    struct stat st{};
+    if (::lstat(options_.path.constData(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode) || socketInUse(addr)) {
+            obs_log(LOG_WARNING, "[ConfigIpc] %s is in use", options_.path.constData());
+            return false;
+        }
+        ::unlink(options_.path.constData());
+    }
+
+    auto ep = std::make_unique<Endpoint>();
+    ep->listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (ep->listenFd < 0 || !setNonBlocking(ep->listenFd)) {
+        obs_log(LOG_WARNING, "[ConfigIpc] socket() failed: %s", std::strerror(errno));
+        closeFd(ep->listenFd);
+        return false;
+    }
+    if (::bind(ep->listenFd, reinterpret_cast<const sockaddr *>(&addr), sizeof addr) != 0) {
+        obs_log(LOG_WARNING, "[ConfigIpc] Cannot bind %s: %s", options_.path.constData(), std::strerror(errno));
+        closeFd(ep->listenFd);
+        return false;
+    }
+    ep->created = true;
+
+    if (::chmod(options_.path.constData(), 0600) != 0 || ::listen(ep->listenFd, 16) != 0 || ::pipe(ep->wake) != 0 ||
+        !setNonBlocking(ep->wake[0]) || !setNonBlocking(ep->wake[1])) {
+        obs_log(LOG_WARNING, "[ConfigIpc] Cannot listen on %s: %s", options_.path.constData(), std::strerror(errno));
+        closeFd(ep->listenFd);
+        closeFd(ep->wake[0]);
+        closeFd(ep->wake[1]);
+        ::unlink(options_.path.constData());
+        return false;
+    }
+
+    endpoint_ = std::move(ep);
+    stop_.store(false);
+    thread_ = std::thread(&ConfigIpcServer::run, this);
+    obs_log(LOG_INFO, "[ConfigIpc] Listening on %s", options_.path.constData());
+    return true;
+}
+
+void ConfigIpcServer::stop()
+{
+    if (!thread_.joinable())
+        return;
+
+    stop_.store(true);
+    const char byte = 0;
+    while (::write(endpoint_->wake[1], &byte, 1) < 0 && errno == EINTR) {
+    }
+    thread_.join();
+
+    closeFd(endpoint_->listenFd);
+    closeFd(endpoint_->wake[0]);
+    closeFd(endpoint_->wake[1]);
+    if (endpoint_->created)
+        ::unlink(options_.path.constData());
+    endpoint_.reset();
+}
+
+void ConfigIpcServer::run()
+{
+    std::vector<std::unique_ptr<Connection>> conns;
+    std::vector<pollfd>                      fds;
+
+    /* reads until the socket is drained or a few chunks are in; false on a hard error */
+    const auto receive = [this](Connection &c) {
+        for (int round = 0; round < 4; ++round) {
+            const size_t have = c.in.size();
+            c.in.resize(have + kReadChunk);
+            const ssize_t n = ::recv(c.fd, c.in.data() + have, kReadChunk, 0);
+            c.in.resize(have + static_cast<size_t>(std::max<ssize_t>(n, 0)));
+            if (n > 0) {
+                bytesIn_.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+                if (static_cast<size_t>(n) < kReadChunk)
+                    break;
+                continue;
+            }
+            if (n == 0) {
+                c.closing = true;   /* the client is done sending; answer what it sent */
+                break;
+            }
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            return false;
+        }
+        if (!serve(c))
+            c.closing = true;
+        return true;
+    };
+
+    const auto flush = [this](Connection &c) {
+        while (c.pending()) {
+            const ssize_t n = ::send(c.fd, c.out.data() + c.outPos, c.pending(), kSendFlags);
+            if (n > 0) {
+                c.outPos += static_cast<size_t>(n);
+                bytesOut_.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+            } else if (n < 0 && errno == EINTR) {
+                continue;
+            } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                return true;
+            } else {
+                return false;
+            }
+        }
+        c.out.clear();
+        c.outPos = 0;
+        return true;
+    };
+
+    while (!stop_.load()) {
+        fds.clear();
+        fds.push_back({endpoint_->wake[0], POLLIN, 0});
+        fds.push_back({endpoint_->listenFd, POLLIN, 0});
+        for (const auto &c : conns) {
+            short events = 0;
+            if (!c->closing && c->pending() < kOutHighWater)
+                events |= POLLIN;
+            if (c->pending())
+                events |= POLLOUT;
+            fds.push_back({c->fd, events, 0});
+        }
+
+        if (::poll(fds.data(), static_cast<nfds_t>(fds.size()), -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            obs_log(LOG_WARNING, "[ConfigIpc] poll() failed: %s", std::strerror(errno));
+            break;
+        }
+        if (fds[0].revents) {
+            char drain[64];
+            while (::read(endpoint_->wake[0], drain, sizeof drain) > 0) {
+            }
+        }
+        if (stop_.load())
+            break;
+
+        /* serve the connections polled this round; new ones join the next */
+        const size_t polled = conns.size();
+        for (size_t i = 0; i < polled; ++i) {
+            Connection &c  = *conns[i];
+            const short re = fds[2 + i].revents;
+            bool        drop = false;
+            if (re & POLLIN)
+                drop = !receive(c);
+            if (!drop && c.pending())
+                drop = !flush(c);   /* answer right away; POLLOUT picks up the rest */
+            if (!drop && (re & (POLLERR | POLLNVAL)))
+                drop = true;
+            if (!drop && (re & POLLHUP) && !(re & POLLIN))
+                drop = true;
+            if (!drop && c.closing && !c.pending())
+                drop = true;
+            if (drop) {
+                closeFd(c.fd);
+                conns[i].reset();
+            }
+        }
+        conns.erase(std::remove(conns.begin(), conns.end(), nullptr), conns.end());
+
+        if (fds[1].revents & POLLIN) {
+            for (;;) {
+                int fd = ::accept(endpoint_->listenFd, nullptr, nullptr);
+                if (fd < 0) {
+                    if (errno == EINTR)
+                        continue;
+                    break;   /* EAGAIN, or a client that went away */
+                }
+                if (conns.size() >= options_.maxClients || !setNonBlocking(fd)) {
+                    refused_.fetch_add(1, std::memory_order_relaxed);
+                    closeFd(fd);
+                    continue;
+                }
+                noSigPipe(fd);
+                auto c = std::make_unique<Connection>();
+                c->fd  = fd;
+                conns.push_back(std::move(c));
+                connections_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    for (auto &c : conns)
+        closeFd(c->fd);
+}
+
+#else
+/* ------------------------------------------------------------------------- */
+/*  Windows: overlapped named pipe instances                                 */
+/* ------------------------------------------------------------------------- */
+namespace {
+
+HANDLE createInstance(const std::wstring &name, bool first)
+{
+    DWORD openMode = PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED;
+    if (first)
+        openMode |= FILE_FLAG_FIRST_PIPE_INSTANCE;   /* fail if another process owns the name */
+    return CreateNamedPipeW(name.c_str(), openMode, PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_REJECT_REMOTE_CLIENTS,
+                            PIPE_UNLIMITED_INSTANCES, static_cast<DWORD>(kReadChunk),
+                            static_cast<DWORD>(kReadChunk), 0, nullptr);
+}
+
+} // namespace
+
+QByteArray ConfigIpcServer::defaultPath()
+{
+    return QByteArray("\\\\.\\pipe\\playfame-") + QByteArray::number(static_cast<qint64>(GetCurrentProcessId()));
+}
+
+bool ConfigIpcServer::start()
+{
+    if (thread_.joinable())
+        return true;
+
+    auto ep       = std::make_unique<Endpoint>();
+    ep->name      = QString::fromUtf8(options_.path).toStdWString();
+    ep->stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+
+    /* created here so a name that is taken fails start() */
+    ep->first = ep->stopEvent ? createInstance(ep->name, true) : INVALID_HANDLE_VALUE;
+    if (ep->first == INVALID_HANDLE_VALUE) {
+        obs_log(LOG_WARNING, "[ConfigIpc] Cannot create %s (error %lu)", options_.path.constData(),
+                static_cast<unsigned long>(GetLastError()));
+        if (ep->stopEvent)
+            CloseHandle(ep->stopEvent);
+        return false;
+    }
+
+    endpoint_ = std::move(ep);
+    stop_.store(false);
+    thread_ = std::thread(&ConfigIpcServer::run, this);
+    obs_log(LOG_INFO, "[ConfigIpc] Listening on %s", options_.path.constData());
+    return true;
+}
+
+void ConfigIpcServer::stop()
+{
+    if (!thread_.joinable())
+        return;
+
+    stop_.store(true);
+    SetEvent(endpoint_->stopEvent);
+    thread_.join();
+    CloseHandle(endpoint_->stopEvent);
+    endpoint_.reset();
+}
+
+void ConfigIpcServer::run()
+{
+    std::vector<Connection> pipes(options_.maxClients);
+
+    const auto listen = [](Connection &c) {
+        c.in.clear();
+        c.inPos = 0;
+        c.out.clear();
+        c.outPos  = 0;
+        c.closing = false;
+        c.state   = Connection::State::Connecting;
+        c.ov      = OVERLAPPED{};
+        c.ov.hEvent = c.event;
+        c.early     = false;
+        if (ConnectNamedPipe(c.pipe, &c.ov))
+            return;   /* completed: the event is set */
+        const DWORD error = GetLastError();
+        if (error == ERROR_PIPE_CONNECTED) {
+            c.early = true;   /* connected between create and connect */
+            SetEvent(c.event);
+        } else if (error != ERROR_IO_PENDING) {
+            obs_log(LOG_WARNING, "[ConfigIpc] ConnectNamedPipe failed (error %lu)", static_cast<unsigned long>(error));
+        }
+    };
+
+    const auto reset = [&listen](Connection &c) {
+        DisconnectNamedPipe(c.pipe);
+        listen(c);
+    };
+
+    const auto startRead = [&reset](Connection &c) {
+        c.state     = Connection::State::Reading;
+        c.ov        = OVERLAPPED{};
+        c.ov.hEvent = c.event;
+        if (!ReadFile(c.pipe, c.chunk.data(), static_cast<DWORD>(c.chunk.size()), nullptr, &c.ov) &&
+            GetLastError() != ERROR_IO_PENDING)
+            reset(c);
+    };
+
+    const auto startWrite = [&reset](Connection &c) {
+        c.state     = Connection::State::Writing;
+        c.ov        = OVERLAPPED{};
+        c.ov.hEvent = c.event;
+        const DWORD n = static_cast<DWORD>(std::min<size_t>(c.pending(), kOutHighWater));
+        if (!WriteFile(c.pipe, c.out.data() + c.outPos, n, nullptr, &c.ov) && GetLastError() != ERROR_IO_PENDING)
+            reset(c);
+    };
+
+    std::vector<HANDLE> waits{endpoint_->stopEvent};
+    for (Connection &c : pipes) {
+        c.pipe  = waits.size() == 1 ? endpoint_->first : createInstance(endpoint_->name, false);
+        c.event = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        c.chunk.resize(kReadChunk);
+        if (c.pipe == INVALID_HANDLE_VALUE || !c.event) {
+            obs_log(LOG_WARNING, "[ConfigIpc] Cannot create a pipe instance (error %lu)",
+                    static_cast<unsigned long>(GetLastError()));
+            break;
+        }
+        listen(c);
+        waits.push_back(c.event);
+    }
+
+    while (!stop_.load()) {
+        const DWORD r = WaitForMultipleObjects(static_cast<DWORD>(waits.size()), waits.data(), FALSE, INFINITE);
+        if (r == WAIT_OBJECT_0 || r >= WAIT_OBJECT_0 + waits.size())
+            break;
+
+        Connection &c    = pipes[r - WAIT_OBJECT_0 - 1];
+        DWORD       n    = 0;
+        const BOOL  done = c.early || GetOverlappedResult(c.pipe, &c.ov, &n, FALSE);
+        c.early          = false;
+
+        switch (c.state) {
+        case Connection::State::Connecting:
+            if (!done) {
+                reset(c);
+                break;
+            }
+            connections_.fetch_add(1, std::memory_order_relaxed);
+            startRead(c);
+            break;
+
+        case Connection::State::Reading:
+            if (!done || n == 0) {
+                reset(c);   /* the client closed, or the pipe broke */
+                break;
+            }
+            bytesIn_.fetch_add(n, std::memory_order_relaxed);
+            c.in.insert(c.in.end(), c.chunk.begin(), c.chunk.begin() + n);
+            if (!serve(c))
+                c.closing = true;
+            if (c.pending())
+                startWrite(c);
+            else if (c.closing)
+                reset(c);
+            else
+                startRead(c);
+            break;
+
+        case Connection::State::Writing:
+            if (!done) {
+                reset(c);
+                break;
+            }
+            bytesOut_.fetch_add(n, std::memory_order_relaxed);
+            c.outPos += n;
+            if (c.pending()) {
+                startWrite(c);
+                break;
+            }
+            c.out.clear();
+            c.outPos = 0;
+            if (c.closing)
+                reset(c);
+            else
+                startRead(c);
+            break;
+        }
+    }
+
+    for (Connection &c : pipes) {
+        if (c.pipe != INVALID_HANDLE_VALUE) {
+            DWORD n = 0;
+            if (CancelIoEx(c.pipe, &c.ov) || GetLastError() != ERROR_NOT_FOUND)
+                GetOverlappedResult(c.pipe, &c.ov, &n, TRUE);   /* the buffers must outlive the I/O */
+            DisconnectNamedPipe(c.pipe);
+            CloseHandle(c.pipe);
+        }
+        if (c.event)
+            CloseHandle(c.event);
+    }
+}
+#endif
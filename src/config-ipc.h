@@ -0,0 +1,142 @@
+/*!
+ * @file config-ipc.h
+ * @brief Local control endpoint for batched config reads and writes.
+ *
+ * Automation on the same machine reads and changes settings of a running
+ * OBS through a Unix domain socket (a named pipe on Windows), in the framing
+ * of config-ipc-protocol.h. One thread serves every connection: on POSIX a
+ * poll() loop over non-blocking sockets, on Windows overlapped pipe I/O.
+ * It decodes each frame in place and answers every pipelined frame it has
+ * read before it writes, so a client that keeps many requests in flight
+ * costs one read and one write per batch of them.
+ *
+ * The request path never touches the UI thread: gets read a pinned
+ * snapshot, and sets go through one ConfigTransaction per request, which
+ * validates against the schema (config-schema.h) and publishes, journals
+ * and notifies like any other writer. Subscribers with a context object
+ * are notified on their own thread as usual.
+ *
+ * The socket is created with owner-only permissions (the pipe rejects
+ * remote clients); anyone who can connect can change any setting.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include "config-ipc-protocol.h"
+#include "obs-config-helper.h"
+#include "plugin-trace.h"
+
+#include <QByteArray>
+#include <QHash>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+struct ConfigIpcOptions {
+    QByteArray path;                                    ///< Empty: defaultPath().
+    size_t     maxClients    = 8;                       ///< 1..63; further connections are closed at once.
+    uint32_t   maxFrameBytes = ConfigIpc::kMaxFrameBytes;
+};
+
+struct ConfigIpcStats {
+    uint64_t connections = 0;
+    uint64_t refused     = 0;   ///< Connections over maxClients (POSIX; pipe clients see ERROR_PIPE_BUSY).
+    uint64_t requests    = 0;
+    uint64_t gets        = 0;
+    uint64_t sets        = 0;
+    uint64_t commits     = 0;   ///< Transactions applied.
+    uint64_t rejected    = 0;   ///< Requests whose sets failed validation.
+    uint64_t malformed   = 0;   ///< Requests that did not parse, oversized frames included.
+    uint64_t bytesIn     = 0;
+    uint64_t bytesOut    = 0;
+    uint64_t requestP50Us = 0;  ///< Handling time per request, from decode to encoded response.
+    uint64_t requestP99Us = 0;
+};
+
+/**
+ * @class ConfigIpcServer
+ * @brief The endpoint and its serving thread; see the file comment.
+ *
+ * start() and stop() belong to the owner; stats() may be called from any
+ * thread. The helper must outlive the server.
+ */
+class ConfigIpcServer {
+public:
+    ConfigIpcServer(OBSConfigHelper *cfg, ConfigIpcOptions options = ConfigIpcOptions());
+    ~ConfigIpcServer();
+
+    ConfigIpcServer(const ConfigIpcServer &) = delete;
+    ConfigIpcServer &operator=(const ConfigIpcServer &) = delete;
+
+    /// Creates the endpoint and starts serving. False, logged, if it cannot be created.
+    bool start();
+
+    /// Closes every connection and removes the socket; requests in flight are dropped.
+    void stop();
+
+    /// Where clients connect.
+    const QByteArray &path() const { return options_.path; }
+
+    ConfigIpcStats stats() const;
+
+    /// "$XDG_RUNTIME_DIR/playfame-<pid>.sock" (else /tmp), or "\\.\pipe\playfame-<pid>" on Windows.
+    static QByteArray defaultPath();
+
+private:
+    struct Endpoint;
+    struct Connection;
+
+    /// A decoded op; the views point into the request frame.
+    struct Request {
+        ConfigIpc::Op    op;
+        std::string_view section;
+        std::string_view key;
+        ConfigIpc::Value value;
+    };
+
+    void run();
+
+    /// Consumes every complete frame in @p conn's input; false once the connection must close.
+    bool serve(Connection &conn);
+
+    /// Answers one request payload by appending the response frame to @p out.
+    void handle(const uint8_t *payload, size_t size, std::vector<uint8_t> &out);
+    void respond(std::vector<uint8_t> &out, uint32_t id, ConfigIpc::Status status, uint16_t failedOp);
+    bool stage(ConfigTransaction &tx, const Request &request);
+    uint32_t sectionId(std::string_view section);
+    void readValue(const ConfigReader &reader, const Request &request, ConfigIpc::Writer &w);
+
+    OBSConfigHelper          *cfg_;
+    ConfigIpcOptions          options_;
+    std::unique_ptr<Endpoint> endpoint_;
+    std::thread               thread_;
+    std::atomic<bool>         stop_{false};
+
+    /* serving thread only */
+    std::vector<Request>       requests_;    ///< Reused per frame.
+    QHash<QByteArray, uint32_t> sections_;   ///< Interned section ids.
+    std::string                scratch_;     ///< NUL-terminated names for obs_data lookups.
+
+    std::atomic<uint64_t> connections_{0};
+    std::atomic<uint64_t> refused_{0};
+    std::atomic<uint64_t> requestsServed_{0};
+    std::atomic<uint64_t> gets_{0};
+    std::atomic<uint64_t> sets_{0};
+    std::atomic<uint64_t> commits_{0};
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<uint64_t> malformed_{0};
+    std::atomic<uint64_t> bytesIn_{0};
+    std::atomic<uint64_t> bytesOut_{0};
+    TraceHistogram        requestNs_;
+};
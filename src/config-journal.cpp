@@ -0,0 +1,455 @@
+/*!
+ * @file config-journal.cpp
+ * @brief Implements the append-only config journal.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "config-journal.h"
+#include "plugin-support.h"
+#include "plugin-trace.h"
+
+#include <obs-module.h>
+#include <util/platform.h>
+#include <QFile>
+#include <QString>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char     kMagic[4]      = {'P', 'F', 'J', '1'};
+constexpr uint32_t kFormatVersion = 2;
+constexpr uint32_t kLegacyFormat  = 1;      /* held a generation counter instead of the hash */
+constexpr size_t   kHeaderSize    = 16;
+constexpr size_t   kRecordPrefix  = 8;      /* payload length + CRC */
+constexpr uint32_t kMaxPayload    = 16u << 20;
+
+enum ValueTag : uint8_t { TagBool = 1, TagInt = 2, TagDouble = 3, TagString = 4 };
+
+/* CRC-32 (IEEE 802.3, reflected), as used by zlib. */
+uint32_t crc32(const char *data, size_t size)
+{
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i)
+        crc = table[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+template<typename T> void put(QByteArray &out, T value)
+{
+    out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template<typename T> bool take(const char *&cursor, const char *end, T &value)
+{
+    if (static_cast<size_t>(end - cursor) < sizeof(T))
+        return false;
+    std::memcpy(&value, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return true;
+}
+
+bool decode(const char *cursor, const char *end, QByteArray &section, QByteArray &key, ConfigValue &value)
+{
+    uint8_t  tag = 0;
+    uint16_t sectionLen = 0, keyLen = 0;
+    if (!take(cursor, end, tag) || !take(cursor, end, sectionLen) || !take(cursor, end, keyLen))
+        return false;
+    if (static_cast<size_t>(end - cursor) < size_t(sectionLen) + keyLen)
+        return false;
+    section = QByteArray(cursor, sectionLen);
+    cursor += sectionLen;
+    key = QByteArray(cursor, keyLen);
+    cursor += keyLen;
+
+    switch (tag) {
+    case TagBool: {
+        uint8_t b = 0;
+        if (!take(cursor, end, b))
+            return false;
+        value = b != 0;
+        return true;
+    }
+    case TagInt: {
+        int64_t i = 0;
+        if (!take(cursor, end, i))
+            return false;
+        value = static_cast<long long>(i);
+        return true;
+    }
+    case TagDouble: {
+        double d = 0;
+        if (!take(cursor, end, d))
+            return false;
+        value = d;
+        return true;
+    }
+    case TagString: {
+        uint32_t len = 0;
+        if (!take(cursor, end, len) || static_cast<size_t>(end - cursor) < len)
+            return false;
+        value = QByteArray(cursor, static_cast<qsizetype>(len));
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+bool syncFile(std::FILE *f)
+{
+    if (std::fflush(f) != 0)
+        return false;
+#ifdef _WIN32
+    return _commit(_fileno(f)) == 0;
+#else
+    return fsync(fileno(f)) == 0;
+#endif
+}
+
+} // namespace
+
+ConfigJournal::ConfigJournal(QByteArray path, size_t compactThresholdBytes)
+    : path_(std::move(path))
+    , threshold_(compactThresholdBytes)
+{
+}
+
+QByteArray ConfigJournal::header(uint64_t jsonHash) const
+{
+    QByteArray out;
+    out.reserve(kHeaderSize);
+    out.append(kMagic, sizeof(kMagic));
+    put(out, kFormatVersion);
+    put(out, jsonHash);
+    return out;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Recording                                                                */
+/* ------------------------------------------------------------------------- */
+void ConfigJournal::append(uint64_t version, const QByteArray &section, const QByteArray &key,
+                           const ConfigValue &value)
+{
+    if (section.size() > UINT16_MAX || key.size() > UINT16_MAX)
+        return;                     /* not representable; the next compaction still persists it */
+
+    QByteArray payload;
+    payload.reserve(5 + section.size() + key.size() + 8);
+    std::visit([&](const auto &v) {
+        using V = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<V, bool>)
+            put(payload, uint8_t(TagBool));
+        else if constexpr (std::is_same_v<V, long long>)
+            put(payload, uint8_t(TagInt));
+        else if constexpr (std::is_same_v<V, double>)
+            put(payload, uint8_t(TagDouble));
+        else
+            put(payload, uint8_t(TagString));
+    }, value);
+    put(payload, static_cast<uint16_t>(section.size()));
+    put(payload, static_cast<uint16_t>(key.size()));
+    payload.append(section);
+    payload.append(key);
+    std::visit([&](const auto &v) {
+        using V = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<V, bool>)
+            put(payload, uint8_t(v ? 1 : 0));
+        else if constexpr (std::is_same_v<V, long long>)
+            put(payload, static_cast<int64_t>(v));
+        else if constexpr (std::is_same_v<V, double>)
+            put(payload, v);
+        else {
+            put(payload, static_cast<uint32_t>(v.size()));
+            payload.append(v);
+        }
+    }, value);
+
+    Record record;
+    record.version = version;
+    record.bytes.reserve(static_cast<qsizetype>(kRecordPrefix) + payload.size());
+    put(record.bytes, static_cast<uint32_t>(payload.size()));
+    put(record.bytes, crc32(payload.constData(), static_cast<size_t>(payload.size())));
+    record.bytes.append(payload);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    records_.push_back(std::move(record));
+    ++stats_.journalRecords;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Replay                                                                   */
+/* ------------------------------------------------------------------------- */
+namespace {
+
+QByteArray readAll(const QByteArray &path)
+{
+    QFile file(QString::fromUtf8(path));
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+} // namespace
+
+ConfigJournal::Parsed ConfigJournal::parseFile(const QByteArray &data, uint64_t jsonHash, int64_t legacyGeneration,
+                                               const ApplyFn &apply)
+{
+    Parsed      parsed;
+    const char *cursor = data.constData();
+    const char *end    = cursor + data.size();
+
+    char     magic[4] = {};
+    uint32_t format   = 0;
+    uint64_t base     = 0;
+    parsed.accepted = static_cast<size_t>(data.size()) >= kHeaderSize;
+    if (parsed.accepted) {
+        std::memcpy(magic, cursor, sizeof(magic));
+        cursor += sizeof(magic);
+        take(cursor, end, format);
+        take(cursor, end, base);
+        /* format 1 continued the JSON of its own generation or the next one */
+        const int64_t generation = static_cast<int64_t>(base);
+        parsed.legacy   = format == kLegacyFormat && legacyGeneration >= 0 &&
+                          (generation == legacyGeneration || generation + 1 == legacyGeneration);
+        parsed.accepted = !std::memcmp(magic, kMagic, sizeof(kMagic)) &&
+                          ((format == kFormatVersion && base == jsonHash) || parsed.legacy);
+    }
+    if (!parsed.accepted)
+        return parsed;
+
+    QByteArray  section, key;
+    ConfigValue value;
+    for (;;) {
+        const char *record = cursor;
+        uint32_t len = 0, crc = 0;
+        if (!take(cursor, end, len) || !take(cursor, end, crc) || len > kMaxPayload ||
+            static_cast<size_t>(end - cursor) < len || crc32(cursor, len) != crc ||
+            !decode(cursor, cursor + len, section, key, value)) {
+            cursor = record;
+            break;
+        }
+        cursor += len;
+        apply(section, key, value);
+        ++parsed.applied;
+    }
+    parsed.intact = static_cast<size_t>(cursor - data.constData());
+    return parsed;
+}
+
+size_t ConfigJournal::replay(uint64_t jsonHash, const ApplyFn &apply, int64_t legacyGeneration)
+{
+    const QByteArray data   = readAll(path_);
+    Parsed           parsed = parseFile(data, jsonHash, legacyGeneration, apply);
+
+    if (!parsed.accepted && !data.isEmpty())
+        obs_log(LOG_WARNING, "[ConfigJournal] Ignoring journal that does not belong to the config file");
+
+    if (parsed.accepted && parsed.intact != static_cast<size_t>(data.size())) {
+        /* torn tail from a crash mid-append: cut it so new records stay reachable */
+        obs_log(LOG_WARNING, "[ConfigJournal] Dropping %lld bytes of incomplete journal data",
+                static_cast<long long>(static_cast<size_t>(data.size()) - parsed.intact));
+        QFile file(QString::fromUtf8(path_));
+        if (!file.resize(static_cast<qint64>(parsed.intact)))
+            parsed.accepted = false;   /* rewrite the file on the next sync instead */
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    records_.clear();               /* everything so far is now part of the base */
+    synced_    = 0;
+    base_      = jsonHash;
+    fileValid_ = parsed.accepted && !parsed.legacy;
+    if (parsed.legacy)
+        snapshotDue_ = std::max<uint64_t>(snapshotDue_, 1);   /* upgrade: fold it into the JSON */
+    fileBytes_ = parsed.accepted ? static_cast<uint64_t>(parsed.intact) : 0;
+    return parsed.applied;
+}
+
+size_t ConfigJournal::read(uint64_t jsonHash, const ApplyFn &apply, int64_t legacyGeneration) const
+{
+    /* a record the writer is appending right now reads as a torn tail; the copy below has it */
+    const Parsed parsed = parseFile(readAll(path_), jsonHash, legacyGeneration, apply);
+
+    std::vector<QByteArray> records;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        /* the records build on our base; skip them if the JSON on disk is a different one */
+        if (base_ != jsonHash)
+            return parsed.applied;
+        records.reserve(records_.size());
+        for (const Record &r : records_)
+            records.push_back(r.bytes);     /* implicitly shared; decoded outside the lock */
+    }
+
+    size_t      applied = parsed.applied;
+    QByteArray  section, key;
+    ConfigValue value;
+    for (const QByteArray &bytes : records) {
+        const char *payload = bytes.constData() + kRecordPrefix;
+        if (decode(payload, bytes.constData() + bytes.size(), section, key, value)) {
+            apply(section, key, value);
+            ++applied;
+        }
+    }
+    return applied;
+}
+
+bool ConfigJournal::continues(uint64_t jsonHash) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return base_ == jsonHash;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Writer-thread I/O                                                        */
+/* ------------------------------------------------------------------------- */
+bool ConfigJournal::writeFile(const QByteArray &path, const std::vector<QByteArray> &chunks, bool truncate)
+{
+    std::FILE *f = os_fopen(path.constData(), truncate ? "wb" : "ab");
+    if (!f)
+        return false;
+
+    bool ok = true;
+    for (const QByteArray &chunk : chunks) {
+        if (std::fwrite(chunk.constData(), 1, static_cast<size_t>(chunk.size()), f) !=
+            static_cast<size_t>(chunk.size())) {
+            ok = false;
+            break;
+        }
+    }
+    ok = syncFile(f) && ok;
+    std::fclose(f);
+    return ok;
+}
+
+bool ConfigJournal::sync()
+{
+    PF_TRACE_SCOPE("config.journal_sync");
+    std::vector<QByteArray> chunks;
+    size_t   count;
+    bool     rewrite;
+    uint64_t bytes = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        count   = records_.size();
+        rewrite = !fileValid_;
+        if (!rewrite && synced_ == count)
+            return true;
+
+        if (rewrite)
+            chunks.push_back(header(base_));
+        for (size_t i = rewrite ? 0 : synced_; i < count; ++i)
+            chunks.push_back(records_[i].bytes);
+    }
+    for (const QByteArray &chunk : chunks)
+        bytes += static_cast<uint64_t>(chunk.size());
+
+    const bool ok = writeFile(path_, chunks, rewrite);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ok) {
+        synced_    = count;
+        fileValid_ = true;
+        fileBytes_ = rewrite ? bytes : fileBytes_ + bytes;
+        ++stats_.journalSyncs;
+        stats_.journalBytes += bytes;
+        PF_TRACE_COUNTER("config.journal_bytes", fileBytes_);
+    } else if (!rewrite) {
+        /* drop a partial append so later records are not hidden behind it */
+        QFile file(QString::fromUtf8(path_));
+        if (!file.resize(static_cast<qint64>(fileBytes_)))
+            fileValid_ = false;
+    }
+    return ok;
+}
+
+bool ConfigJournal::needsCompaction() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t bytes = fileBytes_;
+    for (size_t i = synced_; i < records_.size(); ++i)
+        bytes += static_cast<uint64_t>(records_[i].bytes.size());
+    return bytes >= threshold_ || snapshotDue_ != 0;
+}
+
+void ConfigJournal::requireSnapshot(uint64_t version)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshotDue_ = std::max(snapshotDue_, version);
+}
+
+bool ConfigJournal::compact(uint64_t snapshotVersion, uint64_t jsonHash)
+{
+    PF_TRACE_SCOPE("config.journal_compact");
+    std::vector<QByteArray> chunks;
+    uint64_t bytes = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t keep = 0;
+        while (keep < records_.size() && records_[keep].version <= snapshotVersion)
+            ++keep;
+        records_.erase(records_.begin(), records_.begin() + static_cast<std::ptrdiff_t>(keep));
+
+        base_ = jsonHash;           /* the old journal no longer matches the JSON either way */
+        chunks.push_back(header(jsonHash));
+        for (const Record &r : records_)
+            chunks.push_back(r.bytes);
+        synced_ = records_.size();
+    }
+    for (const QByteArray &chunk : chunks)
+        bytes += static_cast<uint64_t>(chunk.size());
+
+    /* the old journal stays valid until the new one is complete */
+    const QByteArray tmp = path_ + ".tmp";
+    const bool ok = writeFile(tmp, chunks, true) && os_rename(tmp.constData(), path_.constData()) == 0;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ok) {
+        fileValid_ = true;
+        fileBytes_ = bytes;
+        if (snapshotDue_ <= snapshotVersion)
+            snapshotDue_ = 0;
+        ++stats_.compactions;
+        stats_.journalBytes += bytes;
+    } else {
+        /* the old journal is ignored over the new snapshot, which holds all of it; restart on the next sync */
+        obs_log(LOG_WARNING, "[ConfigJournal] Failed to start a new journal after compaction");
+        synced_    = 0;
+        fileValid_ = false;
+    }
+    return ok;
+}
+
+void ConfigJournal::discard(const QByteArray &path)
+{
+    if (os_file_exists(path.constData()))
+        os_unlink(path.constData());
+}
+
+ConfigIoStats ConfigJournal::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
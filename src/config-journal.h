@@ -0,0 +1,166 @@
+/*!
+ * @file config-journal.h
+ * @brief Append-only write-ahead journal for incremental config persistence.
+ *
+ * In journal mode a save appends the changed keys instead of rewriting the
+ * whole JSON document. The journal is replayed over the JSON snapshot at
+ * load, and folded into a new snapshot once it grows past a threshold.
+ *
+ * File layout (little-endian):
+ *   Header   "PFJ1", u32 format version, u64 hash of the JSON it continues
+ *   Records  u32 payload length, u32 CRC-32 of payload, payload
+ *   Payload  u8 value type, u16 section length, u16 key length,
+ *            section bytes, key bytes, value (i64 | f64 | u8 | u32 length + bytes)
+ *
+ * Records only ever set keys, so replaying a journal over any snapshot that
+ * already contains a prefix of it gives the same result; that is what makes
+ * compaction crash-safe. A torn record at the tail ends the replay.
+ *
+ * A journal is only replayed over the exact JSON bytes it continues from:
+ * its header holds their hash (ConfigBinaryView::checksum()). Any other
+ * JSON, whether written by a tool or by a compaction that crashed before
+ * the journal was swapped, already has or overrides every record, so the
+ * journal is ignored and restarted on the next sync. Records reach the
+ * disk at sync(), i.e. on save(), not on each write.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include <QByteArray>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <variant>
+#include <vector>
+
+/// A config value in storage form (strings as UTF-8).
+using ConfigValue = std::variant<bool, long long, double, QByteArray>;
+
+/**
+ * @brief Bytes and operations spent on persistence, in both modes.
+ */
+struct ConfigIoStats {
+    uint64_t snapshotWrites = 0; ///< Full JSON documents written.
+    uint64_t snapshotBytes  = 0; ///< Bytes of those documents.
+    uint64_t journalSyncs   = 0; ///< Journal appends that reached the disk.
+    uint64_t journalBytes   = 0; ///< Bytes appended to or rewritten in the journal.
+    uint64_t journalRecords = 0; ///< Records appended.
+    uint64_t compactions    = 0; ///< Journals folded into a new snapshot.
+};
+
+/**
+ * @class ConfigJournal
+ * @brief Buffers, persists and replays config write records.
+ *
+ * append() only encodes into memory and may be called from any thread;
+ * sync() and compact() do the I/O and belong in the ConfigWriter sequence.
+ */
+class ConfigJournal {
+public:
+    /// Top-level JSON key that format 1 journals were matched by; erased on load.
+    static constexpr const char *kGenerationKey = "_journal_generation";
+
+    using ApplyFn = std::function<void(const QByteArray &section, const QByteArray &key, const ConfigValue &value)>;
+
+    ConfigJournal(QByteArray path, size_t compactThresholdBytes);
+
+    /**
+     * @brief Records one write.
+     * @param version Snapshot version that the write produced.
+     */
+    void append(uint64_t version, const QByteArray &section, const QByteArray &key, const ConfigValue &value);
+
+    /**
+     * @brief Replays the journal file over freshly loaded data.
+     *
+     * Calls @p apply for every intact record if the file continues the
+     * JSON whose bytes hash to @p jsonHash. Afterwards every write recorded
+     * so far counts as part of the base, and new records continue that JSON.
+     * @param legacyGeneration kGenerationKey of the JSON, or -1. A format 1
+     *        journal matching it is replayed once and a snapshot required.
+     * @return Number of records applied.
+     */
+    size_t replay(uint64_t jsonHash, const ApplyFn &apply, int64_t legacyGeneration = -1);
+
+    /**
+     * @brief Applies the journal like replay(), but only reads.
+     *
+     * For reparsing the JSON while the journal is live: neither the file
+     * nor the recorded state changes, so the writer's sync() and
+     * compact() and concurrent append() are unaffected. After the intact
+     * records of the file, every record appended since the base, synced
+     * or not, is applied as well, so no write of this session is missing.
+     * Nothing is applied over a JSON the journal does not continue.
+     * @return Number of records applied.
+     */
+    size_t read(uint64_t jsonHash, const ApplyFn &apply, int64_t legacyGeneration = -1) const;
+
+    /// True if the journal continues the JSON whose bytes hash to @p jsonHash.
+    bool continues(uint64_t jsonHash) const;
+
+    /// Appends all buffered records to the file and syncs it.
+    bool sync();
+
+    /// True once the journal file has grown past the compaction threshold, or a snapshot is required.
+    bool needsCompaction() const;
+
+    /**
+     * @brief Forces compaction until a snapshot of @p version or newer has been compacted.
+     *
+     * For changes records cannot express, such as removed keys or nested
+     * data: only a full snapshot persists them.
+     */
+    void requireSnapshot(uint64_t version);
+
+    /**
+     * @brief Starts a new journal after a snapshot has been made durable.
+     *
+     * Call only after the JSON of @p snapshotVersion, whose bytes hash to
+     * @p jsonHash, has been written. Records newer than that are carried over.
+     */
+    bool compact(uint64_t snapshotVersion, uint64_t jsonHash);
+
+    /// Deletes a journal file, e.g. after a full save outside journal mode.
+    static void discard(const QByteArray &path);
+
+    /// Journal counters; the snapshot fields are filled in by OBSConfigHelper.
+    ConfigIoStats stats() const;
+
+private:
+    struct Record {
+        uint64_t   version;
+        QByteArray bytes;     ///< Length, CRC and payload, ready to append.
+    };
+
+    QByteArray header(uint64_t jsonHash) const;
+
+    /// What parseFile() found: whether the file belongs to the JSON and where intact data ends.
+    struct Parsed {
+        bool   accepted = false;
+        bool   legacy   = false;    ///< Accepted as a format 1 journal.
+        size_t intact   = 0;
+        size_t applied  = 0;
+    };
+    static Parsed parseFile(const QByteArray &data, uint64_t jsonHash, int64_t legacyGeneration,
+                            const ApplyFn &apply);
+    static bool writeFile(const QByteArray &path, const std::vector<QByteArray> &chunks, bool truncate);
+
+    const QByteArray path_;
+    const size_t     threshold_;
+
+    mutable std::mutex  mutex_;
+    std::vector<Record> records_;      ///< Written since the base snapshot.
+    size_t              synced_    = 0; ///< Prefix of records_ already on disk.
+    uint64_t            fileBytes_ = 0;
+    uint64_t            base_      = 0; ///< Hash of the JSON the records continue.
+    bool                fileValid_ = false; ///< File exists with our header.
+    uint64_t            snapshotDue_ = 0;   ///< requireSnapshot() version not yet compacted, or 0.
+    ConfigIoStats       stats_;
+};
@@ -0,0 +1,501 @@
+/*!
+ * @file config-model.cpp
+ * @brief Implements the lazily fetched config tree, its staged edits and change tracking.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "config-model.h"
+#include "config-transaction.h"
+#include "plugin-trace.h"
+
+#include <QString>
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <variant>
+
+namespace {
+
+/* internal id of a key row is its section row + 1; section rows use 0 */
+constexpr quintptr kSectionId = 0;
+
+const ConfigFieldInfo *findField(const QByteArray &section, const QByteArray &key)
+{
+    return ConfigSchema::findField(std::string_view(section.constData(), static_cast<size_t>(section.size())),
+                                   std::string_view(key.constData(), static_cast<size_t>(key.size())));
+}
+
+ConfigModel::ValueType typeOf(const ConfigValue &value)
+{
+    switch (value.index()) {
+    case 0:  return ConfigModel::Boolean;
+    case 1:  return ConfigModel::Integer;
+    case 2:  return ConfigModel::Real;
+    default: return ConfigModel::Text;
+    }
+}
+
+QVariant toVariant(const ConfigValue &value)
+{
+    return std::visit([](const auto &v) -> QVariant {
+        using V = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<V, QByteArray>)
+            return QString::fromUtf8(v);
+        else if constexpr (std::is_same_v<V, long long>)
+            return QVariant(static_cast<qlonglong>(v));
+        else
+            return QVariant(v);
+    }, value);
+}
+
+} // namespace
+
+ConfigModel::ConfigModel(OBSConfigHelper *cfg, QObject *parent)
+    : QAbstractItemModel(parent)
+    , cfg_(cfg)
+{
+    rebuild(nullptr);
+}
+
+ConfigModel::~ConfigModel()
+{
+    for (const auto &[name, id] : subscriptions_)
+        cfg_->unsubscribe(id);
+    releaseSections();
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Tree structure                                                           */
+/* ------------------------------------------------------------------------- */
+QModelIndex ConfigModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (!hasIndex(row, column, parent))
+        return QModelIndex();
+    if (!parent.isValid())
+        return createIndex(row, column, kSectionId);
+    return createIndex(row, column, static_cast<quintptr>(parent.row()) + 1);
+}
+
+QModelIndex ConfigModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid() || child.internalId() == kSectionId)
+        return QModelIndex();
+    return createIndex(static_cast<int>(child.internalId() - 1), KeyColumn, kSectionId);
+}
+
+int ConfigModel::rowCount(const QModelIndex &parent) const
+{
+    if (!parent.isValid())
+        return static_cast<int>(sections_.size());
+    if (parent.internalId() == kSectionId && parent.column() == KeyColumn)
+        return static_cast<int>(sections_[static_cast<size_t>(parent.row())].keys.size());
+    return 0;
+}
+
+int ConfigModel::columnCount(const QModelIndex &) const
+{
+    return ColumnCount;
+}
+
+bool ConfigModel::hasChildren(const QModelIndex &parent) const
+{
+    if (!parent.isValid())
+        return !sections_.empty() || rootCursor_;
+    if (parent.internalId() != kSectionId || parent.column() != KeyColumn)
+        return false;
+    const Section &section = sections_[static_cast<size_t>(parent.row())];
+    return !section.keys.empty() || sectionCanFetch(section);
+}
+
+bool ConfigModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (!parent.isValid())
+        return rootCursor_ != nullptr;
+    if (parent.internalId() != kSectionId || parent.column() != KeyColumn)
+        return false;
+    return sectionCanFetch(sections_[static_cast<size_t>(parent.row())]);
+}
+
+void ConfigModel::fetchMore(const QModelIndex &parent)
+{
+    PF_TRACE_SCOPE("model.fetch");
+    if (!parent.isValid())
+        fetchSections();
+    else if (parent.internalId() == kSectionId && parent.column() == KeyColumn)
+        fetchKeys(parent.row());
+}
+
+bool ConfigModel::sectionCanFetch(const Section &section) const
+{
+    return section.cursor || section.nextQueued < section.queued.size();
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Values                                                                   */
+/* ------------------------------------------------------------------------- */
+QVariant ConfigModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    if (index.internalId() == kSectionId) {
+        if (index.column() == KeyColumn && role == Qt::DisplayRole)
+            return QString::fromUtf8(sections_[static_cast<size_t>(index.row())].name);
+        return QVariant();
+    }
+
+    const Section    &section = sections_[static_cast<size_t>(index.internalId() - 1)];
+    const QByteArray &key     = section.keys[static_cast<size_t>(index.row())];
+    if (index.column() == KeyColumn)
+        return role == Qt::DisplayRole ? QVariant(QString::fromUtf8(key)) : QVariant();
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+    case ValueTypeRole:
+    case StagedRole:
+        return value(section, key, role);
+    case MinimumRole:
+    case MaximumRole:
+    case MaxBytesRole:
+        return limits(section, key, role);
+    default:
+        return QVariant();
+    }
+}
+
+QVariant ConfigModel::value(const Section &section, const QByteArray &key, int role) const
+{
+    auto staged = staged_.find({section.name, key});
+    if (role == StagedRole)
+        return staged != staged_.end();
+    if (staged != staged_.end())
+        return role == ValueTypeRole ? QVariant(static_cast<int>(typeOf(staged->second))) : toVariant(staged->second);
+
+    /* one lock-free lookup in the current snapshot, only for rows a view asks about */
+    ConfigReader     reader = cfg_->reader();
+    obs_data_item_t *item   = obs_data_item_byname(reader.snapshot()->section(section.handle), key.constData());
+    ValueType        type   = Missing;
+    QVariant         out;
+    if (item) {
+        switch (obs_data_item_gettype(item)) {
+        case OBS_DATA_STRING:
+            type = Text;
+            out  = QString::fromUtf8(obs_data_item_get_string(item));
+            break;
+        case OBS_DATA_NUMBER:
+            if (obs_data_item_numtype(item) == OBS_DATA_NUM_DOUBLE) {
+                type = Real;
+                out  = obs_data_item_get_double(item);
+            } else {
+                type = Integer;
+                out  = static_cast<qlonglong>(obs_data_item_get_int(item));
+            }
+            break;
+        case OBS_DATA_BOOLEAN:
+            type = Boolean;
+            out  = obs_data_item_get_bool(item);
+            break;
+        case OBS_DATA_OBJECT:
+            type = Object;
+            out  = QStringLiteral("{…}");
+            break;
+        case OBS_DATA_ARRAY: {
+            type = Array;
+            obs_data_array_t *array = obs_data_item_get_array(item);
+            out = QStringLiteral("[%1]").arg(static_cast<qlonglong>(obs_data_array_count(array)));
+            obs_data_array_release(array);
+            break;
+        }
+        default:
+            break;
+        }
+        obs_data_item_release(&item);
+    }
+    return role == ValueTypeRole ? QVariant(static_cast<int>(type)) : out;
+}
+
+QVariant ConfigModel::limits(const Section &section, const QByteArray &key, int role) const
+{
+    const ConfigFieldInfo *field = findField(section.name, key);
+    if (!field)
+        return QVariant();
+    if (role == MaxBytesRole)
+        return field->text ? QVariant(static_cast<qlonglong>(field->maxBytes)) : QVariant();
+    if (field->text)
+        return QVariant();
+    return role == MinimumRole ? field->min : field->max;
+}
+
+Qt::ItemFlags ConfigModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid())
+        return Qt::NoItemFlags;
+    Qt::ItemFlags f = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+    if (index.internalId() == kSectionId)
+        return f;
+    f |= Qt::ItemNeverHasChildren;
+    if (index.column() == ValueColumn) {
+        const int type = data(index, ValueTypeRole).toInt();
+        if (type == Text || type == Integer || type == Real || type == Boolean)
+            f |= Qt::ItemIsEditable;
+    }
+    return f;
+}
+
+QVariant ConfigModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QVariant();
+    return section == KeyColumn ? tr("Key") : tr("Value");
+}
+
+bool ConfigModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (role != Qt::EditRole || !index.isValid() || index.internalId() == kSectionId ||
+        index.column() != ValueColumn)
+        return false;
+
+    const Section    &section = sections_[static_cast<size_t>(index.internalId() - 1)];
+    const QByteArray &key     = section.keys[static_cast<size_t>(index.row())];
+    const ConfigFieldInfo *field = findField(section.name, key);
+
+    /* the stored type decides; the schema range or length applies on top */
+    ConfigValue staged;
+    bool        ok = true;
+    switch (data(index, ValueTypeRole).toInt()) {
+    case Text: {
+        QByteArray utf8 = value.toString().toUtf8();
+        ok     = !field || static_cast<size_t>(utf8.size()) <= field->maxBytes;
+        staged = std::move(utf8);
+        break;
+    }
+    case Integer: {
+        const long long v = value.toLongLong(&ok);
+        ok     = ok && (!field || (static_cast<double>(v) >= field->min && static_cast<double>(v) <= field->max));
+        staged = v;
+        break;
+    }
+    case Real: {
+        const double v = value.toDouble(&ok);
+        ok     = ok && (!field || (v >= field->min && v <= field->max));
+        staged = v;
+        break;
+    }
+    case Boolean:
+        staged = value.toBool();
+        break;
+    default:
+        return false;
+    }
+    if (!ok)
+        return false;
+
+    staged_[{section.name, key}] = std::move(staged);
+    emit dataChanged(this->index(index.row(), KeyColumn, index.parent()), index);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Staged edits                                                             */
+/* ------------------------------------------------------------------------- */
+void ConfigModel::stage(ConfigTransaction &tx) const
+{
+    for (const auto &[where, value] : staged_) {
+        const ConfigKey key = cfg_->key(where.first.constData(), where.second.constData());
+        std::visit([&](const auto &v) {
+            using V = std::decay_t<decltype(v)>;
+            if constexpr (std::is_same_v<V, QByteArray>)
+                tx.set(key, QString::fromUtf8(v));
+            else
+                tx.set<V>(key, v);
+        }, value);
+    }
+}
+
+void ConfigModel::discardEdits()
+{
+    auto staged = std::move(staged_);
+    staged_.clear();
+    for (const auto &[where, value] : staged) {
+        for (size_t s = 0; s < sections_.size(); ++s) {
+            if (sections_[s].name != where.first)
+                continue;
+            auto row = sections_[s].rows.constFind(where.second);
+            if (row != sections_[s].rows.constEnd()) {
+                const QModelIndex parent = index(static_cast<int>(s), KeyColumn);
+                emit dataChanged(index(*row, KeyColumn, parent), index(*row, ValueColumn, parent));
+            }
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Filter                                                                   */
+/* ------------------------------------------------------------------------- */
+void ConfigModel::setFilter(const ConfigSearchResult &result)
+{
+    rebuild(&result);
+}
+
+void ConfigModel::clearFilter()
+{
+    if (filtered_)
+        rebuild(nullptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Internals                                                                */
+/* ------------------------------------------------------------------------- */
+void ConfigModel::rebuild(const ConfigSearchResult *filter)
+{
+    beginResetModel();
+    releaseSections();
+    sections_.clear();
+    filtered_ = filter != nullptr;
+
+    if (filter) {
+        /* matched sections are few; their keys are still handed out in batches */
+        sections_.reserve(filter->sections.size());
+        for (const ConfigSearchResult::Section &match : filter->sections)
+            openSection(match.name, nullptr).queued = match.keys;
+    } else {
+        /* only pins the root; sections are read as the view asks for them */
+        ConfigReader reader = cfg_->reader();
+        root_ = reader.snapshot()->root;
+        obs_data_addref(root_);
+        rootCursor_ = obs_data_first(root_);
+    }
+    endResetModel();
+}
+
+void ConfigModel::releaseSections()
+{
+    for (Section &section : sections_) {
+        obs_data_item_release(&section.cursor);
+        obs_data_release(section.source);
+        section.source = nullptr;
+    }
+    obs_data_item_release(&rootCursor_);
+    obs_data_release(root_);
+    root_ = nullptr;
+}
+
+ConfigModel::Section &ConfigModel::openSection(const QByteArray &name, obs_data_t *source)
+{
+    Section section;
+    section.name   = name;
+    section.handle = cfg_->key(name.constData(), "").section;
+    section.source = source;
+    section.cursor = source ? obs_data_first(source) : nullptr;
+
+    if (!subscriptions_.count(name))
+        subscriptions_[name] = cfg_->subscribeSection(QString::fromUtf8(name), this,
+                                                      [this](const std::vector<ConfigChange> &changes) {
+                                                          onChanges(changes);
+                                                      });
+    sections_.push_back(std::move(section));
+    return sections_.back();
+}
+
+void ConfigModel::fetchSections()
+{
+    std::vector<std::pair<QByteArray, obs_data_t *>> batch;
+    while (rootCursor_ && batch.size() < static_cast<size_t>(kFetchBatch)) {
+        if (obs_data_item_gettype(rootCursor_) == OBS_DATA_OBJECT)
+            batch.emplace_back(QByteArray(obs_data_item_get_name(rootCursor_)), obs_data_item_get_obj(rootCursor_));
+        obs_data_item_next(&rootCursor_);
+    }
+    if (batch.empty())
+        return;
+
+    const int first = static_cast<int>(sections_.size());
+    beginInsertRows(QModelIndex(), first, first + static_cast<int>(batch.size()) - 1);
+    for (auto &[name, source] : batch)
+        openSection(name, source);  /* takes the reference */
+    endInsertRows();
+    stats_.sections += batch.size();
+    ++stats_.fetches;
+}
+
+void ConfigModel::fetchKeys(int sectionRow)
+{
+    Section &section = sections_[static_cast<size_t>(sectionRow)];
+    std::vector<QByteArray> batch;
+    batch.reserve(kFetchBatch);
+    while (section.cursor && batch.size() < static_cast<size_t>(kFetchBatch)) {
+        batch.emplace_back(obs_data_item_get_name(section.cursor));
+        obs_data_item_next(&section.cursor);
+    }
+    if (!section.cursor && section.source) {
+        obs_data_release(section.source);   /* walked; later keys arrive through onChanges() */
+        section.source = nullptr;
+    }
+    while (section.nextQueued < section.queued.size() && batch.size() < static_cast<size_t>(kFetchBatch))
+        batch.push_back(section.queued[section.nextQueued++]);
+    if (batch.empty())
+        return;
+
+    const int first = static_cast<int>(section.keys.size());
+    beginInsertRows(index(sectionRow, KeyColumn), first, first + static_cast<int>(batch.size()) - 1);
+    for (QByteArray &key : batch) {
+        section.rows.insert(key, static_cast<int>(section.keys.size()));
+        section.keys.push_back(std::move(key));
+    }
+    endInsertRows();
+    stats_.keys += batch.size();
+    ++stats_.fetches;
+}
+
+void ConfigModel::onChanges(const std::vector<ConfigChange> &changes)
+{
+    for (size_t s = 0; s < sections_.size(); ++s) {
+        Section &section = sections_[s];
+        int      low = -1, high = -1;
+        std::vector<QByteArray> added;
+        for (const ConfigChange &change : changes) {
+            if (change.section != section.handle)
+                continue;
+            auto row = section.rows.constFind(change.key);
+            if (row != section.rows.constEnd()) {
+                low  = low < 0 ? *row : std::min(low, *row);
+                high = std::max(high, *row);
+                continue;
+            }
+            /* a filtered view shows its matches only; keys still under the cursor come anyway */
+            if (filtered_)
+                continue;
+            if (section.source) {
+                obs_data_item_t *item = obs_data_item_byname(section.source, change.key.constData());
+                const bool       known = item != nullptr;
+                obs_data_item_release(&item);
+                if (known)
+                    continue;
+            }
+            if (std::find(section.queued.begin(), section.queued.end(), change.key) == section.queued.end())
+                added.push_back(change.key);
+        }
+
+        const QModelIndex parent = index(static_cast<int>(s), KeyColumn);
+        if (low >= 0)
+            emit dataChanged(index(low, KeyColumn, parent), index(high, ValueColumn, parent));
+        if (added.empty())
+            continue;
+        if (sectionCanFetch(section) || section.keys.empty()) {
+            section.queued.insert(section.queued.end(), added.begin(), added.end());
+            continue;                /* handed out by the next fetchMore() */
+        }
+        const int first = static_cast<int>(section.keys.size());
+        beginInsertRows(parent, first, first + static_cast<int>(added.size()) - 1);
+        for (QByteArray &key : added) {
+            section.rows.insert(key, static_cast<int>(section.keys.size()));
+            section.keys.push_back(std::move(key));
+        }
+        endInsertRows();
+    }
+}
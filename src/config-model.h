@@ -0,0 +1,133 @@
+/*!
+ * @file config-model.h
+ * @brief Virtualized item model over every section and key of an OBSConfigHelper.
+ *
+ * A two-level tree: sections at the top, their keys below, with a Key and
+ * a Value column. Nothing is read up front. The model pins the immutable
+ * root of the current snapshot and hands rows out in batches of kFetchBatch
+ * through canFetchMore()/fetchMore(), which views call only for what they
+ * are about to show, so opening an editor costs the same for ten keys as
+ * for a million. Values are never copied into the model: data() looks them
+ * up in the current snapshot, lock-free, for the rows being painted.
+ *
+ * Edits made through setData() are validated against the stored type and
+ * the schema limits (config-schema.h) and staged; stage() adds them to the
+ * caller's ConfigTransaction so they land with the rest of a dialog's save.
+ * Changes made elsewhere repaint the affected rows and append keys that
+ * did not exist. setFilter() shows only the matches of a ConfigSearch.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include "config-search.h"
+#include "obs-config-helper.h"
+
+#include <QAbstractItemModel>
+#include <QByteArray>
+#include <QHash>
+#include <QVariant>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+class ConfigTransaction;
+
+/**
+ * @class ConfigModel
+ * @brief Lazily materialized tree of config keys; see the file comment.
+ *
+ * Lives on the UI thread like the views using it.
+ */
+class ConfigModel : public QAbstractItemModel {
+    Q_OBJECT
+
+public:
+    enum Column { KeyColumn, ValueColumn, ColumnCount };
+
+    enum Role {
+        ValueTypeRole = Qt::UserRole + 1,   ///< ValueType of the stored (or staged) value.
+        MinimumRole,                        ///< Schema limits of numeric fields, else invalid.
+        MaximumRole,
+        MaxBytesRole,                       ///< Schema limit of text fields, else invalid.
+        StagedRole,                         ///< True while an edit of the row is staged.
+    };
+
+    enum ValueType { Missing, Text, Integer, Real, Boolean, Object, Array };
+
+    /// Rows handed out per fetchMore() call.
+    static constexpr int kFetchBatch = 256;
+
+    struct Stats {
+        size_t   sections = 0;   ///< Section rows handed out.
+        size_t   keys     = 0;   ///< Key rows handed out.
+        uint64_t fetches  = 0;   ///< fetchMore() calls that added rows.
+    };
+
+    explicit ConfigModel(OBSConfigHelper *cfg, QObject *parent = nullptr);
+    ~ConfigModel() override;
+
+    QModelIndex   index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex   parent(const QModelIndex &child) const override;
+    int           rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int           columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    bool          hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    bool          canFetchMore(const QModelIndex &parent) const override;
+    void          fetchMore(const QModelIndex &parent) override;
+    QVariant      data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool          setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    QVariant      headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    /// Shows only @p result's keys, fetched lazily like the full tree.
+    void setFilter(const ConfigSearchResult &result);
+
+    /// Back to every section of the current snapshot.
+    void clearFilter();
+
+    bool isFiltered() const { return filtered_; }
+
+    /// Adds every staged edit to @p tx; they stay staged until discardEdits().
+    void stage(ConfigTransaction &tx) const;
+
+    bool hasStagedEdits() const { return !staged_.empty(); }
+    void discardEdits();
+
+    Stats stats() const { return stats_; }
+
+private:
+    struct Section {
+        QByteArray              name;
+        uint32_t                handle = UINT32_MAX;   ///< Interned index for snapshot lookups.
+        obs_data_t             *source = nullptr;      ///< Pinned object the cursor walks; unfiltered only.
+        obs_data_item_t        *cursor = nullptr;      ///< Next key of source to hand out.
+        std::vector<QByteArray> queued;                ///< Filter matches, then keys added since opening.
+        size_t                  nextQueued = 0;
+        std::vector<QByteArray> keys;                  ///< Rows handed out.
+        QHash<QByteArray, int>  rows;                  ///< Key -> row.
+    };
+
+    void        rebuild(const ConfigSearchResult *filter);
+    void        releaseSections();
+    Section    &openSection(const QByteArray &name, obs_data_t *source);
+    void        fetchSections();
+    void        fetchKeys(int sectionRow);
+    bool        sectionCanFetch(const Section &section) const;
+    void        onChanges(const std::vector<ConfigChange> &changes);
+    QVariant    value(const Section &section, const QByteArray &key, int role) const;
+    QVariant    limits(const Section &section, const QByteArray &key, int role) const;
+
+    OBSConfigHelper *cfg_;
+    obs_data_t      *root_       = nullptr;   ///< Pinned snapshot root; unfiltered only.
+    obs_data_item_t *rootCursor_ = nullptr;   ///< Next section of root_ to hand out.
+    std::vector<Section> sections_;
+    bool                 filtered_ = false;
+    std::map<QByteArray, uint64_t> subscriptions_;   ///< Section name -> id; outlive rebuilds.
+    std::map<std::pair<QByteArray, QByteArray>, ConfigValue> staged_;   ///< (section, key) -> value.
+    Stats stats_;
+};
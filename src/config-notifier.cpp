@@ -0,0 +1,152 @@
+/*!
+ * @file config-notifier.cpp
+ * @brief Implements batched change notification for OBSConfigHelper.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "config-notifier.h"
+
+#include <QMetaObject>
+
+#include <algorithm>
+#include <bit>
+
+ConfigNotifier::ConfigNotifier()
+    : state_(std::make_shared<State>())
+{
+}
+
+bool ConfigNotifier::Subscriber::matches(uint32_t s, const QByteArray &k) const
+{
+    if (s != section)
+        return false;
+    switch (scope) {
+    case Scope::Key:     return k == key;
+    case Scope::Section: return true;
+    case Scope::Prefix:  return k.startsWith(key);
+    }
+    return false;
+}
+
+std::string ConfigNotifier::indexKey(uint32_t section, const QByteArray &key)
+{
+    std::string out;
+    out.reserve(12 + static_cast<size_t>(key.size()));
+    out.append(std::to_string(section));
+    out.push_back('\x1F');
+    out.append(key.constData(), static_cast<size_t>(key.size()));
+    return out;
+}
+
+uint64_t ConfigNotifier::subscribe(Scope scope, uint32_t section, QByteArray key, QObject *context,
+                                   ConfigChangeFn fn)
+{
+    auto sub     = std::make_shared<Subscriber>();
+    sub->scope   = scope;
+    sub->section = section;
+    sub->key     = std::move(key);
+    sub->context = context;
+    sub->queued  = context != nullptr;
+    sub->fn      = std::move(fn);
+
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    sub->id = state_->nextId++;
+    state_->subscribers.push_back(sub);
+    return sub->id;
+}
+
+void ConfigNotifier::unsubscribe(uint64_t id)
+{
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    auto &subs = state_->subscribers;
+    auto it = std::find_if(subs.begin(), subs.end(), [id](const auto &s) { return s->id == id; });
+    if (it == subs.end())
+        return;
+    (*it)->active = false;
+    subs.erase(it);
+}
+
+void ConfigNotifier::record(uint32_t section, const QByteArray &key, uint64_t version)
+{
+    State &st = *state_;
+    std::lock_guard<std::mutex> lock(st.mutex);
+
+    auto [it, inserted] = st.index.try_emplace(indexKey(section, key), static_cast<uint32_t>(st.keys.size()));
+    const uint32_t id = it->second;
+    if (inserted) {
+        st.keys.emplace_back(section, key);
+        st.versions.push_back(0);
+    }
+    st.versions[id] = version;
+
+    for (const auto &sub : st.subscribers) {
+        if (!sub->matches(section, key))
+            continue;
+        if (sub->dirty.size() <= id / 64)
+            sub->dirty.resize(id / 64 + 1, 0);
+        sub->dirty[id / 64] |= uint64_t(1) << (id % 64);
+        if (!sub->scheduled) {
+            sub->scheduled = true;
+            st.ready.push_back(sub);
+        }
+    }
+}
+
+void ConfigNotifier::dispatch()
+{
+    std::vector<std::shared_ptr<Subscriber>> ready;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        ready.swap(state_->ready);
+    }
+
+    for (auto &sub : ready) {
+        if (!sub->queued) {
+            deliver(state_, sub);
+            continue;
+        }
+        QObject *context = sub->context.data();
+        if (!context)
+            continue;               /* receiver is gone */
+
+        /* one queued call per batch; later changes join the dirty bitmap */
+        std::weak_ptr<State> weakState = state_;
+        QMetaObject::invokeMethod(context, [weakState, sub]() {
+            if (auto state = weakState.lock())
+                deliver(state, sub);
+        }, Qt::QueuedConnection);
+    }
+}
+
+void ConfigNotifier::deliver(const std::shared_ptr<State> &state, const std::shared_ptr<Subscriber> &sub)
+{
+    std::vector<ConfigChange> changes;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        sub->scheduled = false;
+        if (!sub->active)
+            return;
+
+        for (size_t w = 0; w < sub->dirty.size(); ++w) {
+            for (uint64_t bits = sub->dirty[w]; bits; bits &= bits - 1) {
+                const size_t id = w * 64 + static_cast<size_t>(std::countr_zero(bits));
+                changes.push_back({state->keys[id].first, state->keys[id].second, state->versions[id]});
+            }
+            sub->dirty[w] = 0;
+        }
+    }
+
+    if (!changes.empty())
+        sub->fn(changes);
+}
+
+uint64_t ConfigNotifier::keyVersion(uint32_t section, const QByteArray &key) const
+{
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    auto it = state_->index.find(indexKey(section, key));
+    return it == state_->index.end() ? 0 : state_->versions[it->second];
+}
@@ -0,0 +1,108 @@
+/*!
+ * @file config-notifier.h
+ * @brief Batched change notification for OBSConfigHelper.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QObject>
+#include <QPointer>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief One changed key, as delivered to a subscriber.
+ */
+struct ConfigChange {
+    uint32_t   section;  ///< Interned section index (see ConfigKey).
+    QByteArray key;      ///< UTF-8 key name.
+    uint64_t   version;  ///< Snapshot version of the most recent change.
+};
+
+/// Receives every key that changed since the previous delivery, once each.
+using ConfigChangeFn = std::function<void(const std::vector<ConfigChange> &changes)>;
+
+/**
+ * @class ConfigNotifier
+ * @brief Tracks per-key versions and delivers changes to subscribers.
+ *
+ * Every key that is written gets a dense index and a "last changed"
+ * version. Each subscriber owns a dirty bitmap over those indices:
+ * record() sets bits, and a delivery drains them into one batch. Repeated
+ * writes to a key before the subscriber runs therefore arrive only once.
+ *
+ * A subscriber with a context object is called on that object's thread
+ * through its event loop (queued), and never after the object is gone.
+ * Without a context it is called directly from dispatch().
+ */
+class ConfigNotifier {
+public:
+    enum class Scope { Key, Section, Prefix };
+
+    ConfigNotifier();
+
+    ConfigNotifier(const ConfigNotifier &) = delete;
+    ConfigNotifier &operator=(const ConfigNotifier &) = delete;
+
+    /**
+     * @brief Registers an observer.
+     * @param key Key name for Scope::Key, key prefix for Scope::Prefix, ignored for Scope::Section.
+     * @return Id for unsubscribe(); never 0.
+     */
+    uint64_t subscribe(Scope scope, uint32_t section, QByteArray key, QObject *context, ConfigChangeFn fn);
+
+    /// Stops deliveries; a batch that is already running completes.
+    void unsubscribe(uint64_t id);
+
+    /// Notes a change. Cheap; safe under the config write lock.
+    void record(uint32_t section, const QByteArray &key, uint64_t version);
+
+    /// Hands out batches marked by record(). Call without holding the config write lock.
+    void dispatch();
+
+    /// Version of the last recorded change to a key, or 0 if none was seen.
+    uint64_t keyVersion(uint32_t section, const QByteArray &key) const;
+
+private:
+    struct Subscriber {
+        uint64_t           id;
+        Scope              scope;
+        uint32_t           section;
+        QByteArray         key;
+        QPointer<QObject>  context;
+        bool               queued;      ///< Deliver through context's event loop.
+        ConfigChangeFn     fn;
+        std::vector<uint64_t> dirty;    ///< Bit per key index.
+        bool               scheduled = false;
+        bool               active    = true;
+
+        bool matches(uint32_t s, const QByteArray &k) const;
+    };
+
+    struct State {
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, uint32_t> index; ///< "section\x1Fkey" -> key index.
+        std::vector<std::pair<uint32_t, QByteArray>> keys;
+        std::vector<uint64_t> versions;
+        std::vector<std::shared_ptr<Subscriber>> subscribers;
+        std::vector<std::shared_ptr<Subscriber>> ready;  ///< Marked, not yet dispatched.
+        uint64_t nextId = 1;
+    };
+
+    static std::string indexKey(uint32_t section, const QByteArray &key);
+    static void deliver(const std::shared_ptr<State> &state, const std::shared_ptr<Subscriber> &sub);
+
+    std::shared_ptr<State> state_;  ///< Shared with queued deliveries.
+};
@@ -0,0 +1,185 @@
+/*!
+ * @file config-reload.cpp
+ * @brief Implements the config file watcher: watch, debounce and off-thread reload.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "config-reload.h"
+#include "plugin-support.h"
+#include "plugin-trace.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/* Filesystem clocks tick coarsely (jiffies, or 2 s on FAT). A file read
+ * within this long of its mtime may be rewritten with the same size and
+ * mtime, so its stamp alone does not prove the file was already read. */
+constexpr int64_t kRacyStampMs = 2000;
+
+double toMs(uint64_t us)
+{
+    return static_cast<double>(us) / 1000.0;
+}
+
+} // namespace
+
+ConfigReloader::ConfigReloader(OBSConfigHelper *cfg, ConfigReloadOptions options)
+    : cfg_(cfg)
+    , options_(options)
+    , lastSeenAtMs_(QDateTime::currentMSecsSinceEpoch())
+    , lastSeen_(ConfigBinaryCache::stampOf(cfg->path().toUtf8().constData()))
+{
+}
+
+ConfigReloader::~ConfigReloader()
+{
+    delete watcher_;                /* no more events from here on */
+    tasks_.cancel();                /* a pending burst is dropped */
+    tasks_.wait();
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Watching                                                                 */
+/* ------------------------------------------------------------------------- */
+void ConfigReloader::watch()
+{
+    if (watcher_)
+        return;
+
+    const QString path = cfg_->path();
+    watcher_ = new QFileSystemWatcher();
+    watcher_->addPath(QFileInfo(path).absolutePath());
+    rearm();
+
+    QObject::connect(watcher_, &QFileSystemWatcher::fileChanged, watcher_, [this](const QString &) {
+        rearm();
+        fileChanged();
+    });
+    /* also sees our own .tmp/.bak/.bin traffic; the stamp check filters that out */
+    QObject::connect(watcher_, &QFileSystemWatcher::directoryChanged, watcher_, [this](const QString &) {
+        rearm();
+        fileChanged();
+    });
+    obs_log(LOG_INFO, "[ConfigReload] Watching %s", path.toUtf8().constData());
+}
+
+/* A rename-replace swaps the inode and drops the file from the watcher. */
+void ConfigReloader::rearm()
+{
+    const QString path = cfg_->path();
+    if (!watcher_->files().contains(path) && QFileInfo::exists(path))
+        watcher_->addPath(path);
+}
+
+void ConfigReloader::fileChanged()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.events;
+    queuedAt_ = Clock::now();
+    pending_  = true;
+    schedule(options_.debounce);
+}
+
+void ConfigReloader::reloadNow()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.events;
+    queuedAt_ = Clock::now() - options_.debounce;
+    pending_  = true;
+    force_    = true;
+    schedule(std::chrono::milliseconds(0));
+}
+
+ConfigReloaderStats ConfigReloader::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Reload task                                                              */
+/* ------------------------------------------------------------------------- */
+/* under mutex_; one runDue() at a time, and none while a reload runs (it
+ * re-checks pending_ when done) */
+void ConfigReloader::schedule(std::chrono::milliseconds delay)
+{
+    if (armed_ || running_)
+        return;
+    armed_ = true;
+    if (!tasks_.postAfter(delay, [this] { runDue(); }))
+        armed_ = false;             /* executor shut down: nothing reloads any more */
+}
+
+void ConfigReloader::runDue()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    armed_ = false;
+    while (pending_) {
+        /* debounce: every event moved queuedAt_; wait for the rest of the quiet time */
+        const Clock::time_point due = queuedAt_ + options_.debounce;
+        const Clock::time_point now = Clock::now();
+        if (now < due) {
+            schedule(std::chrono::ceil<std::chrono::milliseconds>(due - now));
+            return;
+        }
+        const bool force = force_;
+        pending_ = false;
+        force_   = false;
+        running_ = true;
+        lock.unlock();
+        reloadFile(force);
+        lock.lock();
+        running_ = false;
+    }
+}
+
+void ConfigReloader::reloadFile(bool force)
+{
+    const QByteArray pathUtf8 = cfg_->path().toUtf8();
+    const int64_t    nowMs    = QDateTime::currentMSecsSinceEpoch();
+    if (!force) {
+        const ConfigFileStamp stamp = ConfigBinaryCache::stampOf(pathUtf8.constData());
+        const bool ownWrite = stamp.isValid() && stamp == cfg_->lastWrittenStamp();
+        const bool seen = stamp == lastSeen_ && lastSeenAtMs_ - lastSeen_.mtimeMs >= kRacyStampMs;
+        if (ownWrite || seen) {
+            lastSeen_     = stamp;
+            lastSeenAtMs_ = nowMs;
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++(ownWrite ? stats_.ownWrites : stats_.unchanged);
+            return;
+        }
+    }
+
+    PF_TRACE_SCOPE("config.reload_file");
+    const ConfigReloadStats result = cfg_->reload();
+    lastSeen_     = result.stamp;
+    lastSeenAtMs_ = nowMs;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.reloads;
+        stats_.failures   += result.ok ? 0 : 1;
+        stats_.fromBackup += result.fromBackup ? 1 : 0;
+        stats_.last        = result;
+    }
+
+    if (!result.ok) {
+        obs_log(LOG_WARNING, "[ConfigReload] %s changed but neither it nor its .bak parses; keeping live data",
+                pathUtf8.constData());
+        return;
+    }
+    obs_log(LOG_INFO,
+            "[ConfigReload] %zu changed, %zu removed in %zu section(s); parse %.2f ms, diff %.2f ms, "
+            "apply %.2f ms%s%s",
+            result.changed, result.removed, result.sections, toMs(result.parseUs), toMs(result.diffUs),
+            toMs(result.applyUs), result.fromBackup ? " (from .bak)" : "",
+            result.rediffed ? " (re-diffed after a concurrent write)" : "");
+}
@@ -0,0 +1,95 @@
+/*!
+ * @file config-reload.h
+ * @brief Picks up external edits of the config file without a restart.
+ *
+ * Deployment tooling rewrites the JSON behind OBS's back. ConfigReloader
+ * watches the file (and its directory, so an atomic rename-replace does not
+ * lose the watch), waits until writes have been quiet for the debounce
+ * interval, and then calls OBSConfigHelper::reload() on the Background
+ * lane of the plugin executor: the parse, the structural diff against the
+ * live data and the atomic apply of only the changed keys all happen off
+ * the UI thread, and the debounce is a delayed task, not a waiting thread. Events
+ * caused by the helper's own saves, and events that leave the file's size
+ * and mtime unchanged, are recognised by their stamp and skipped (unless
+ * the stamp is too recent to trust, see kRacyStampMs).
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include "obs-config-helper.h"
+#include "plugin-executor.h"
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+class QFileSystemWatcher;
+
+struct ConfigReloadOptions {
+    /// Quiet time after the last change event before the file is read.
+    std::chrono::milliseconds debounce{300};
+};
+
+struct ConfigReloaderStats {
+    uint64_t          events     = 0;   ///< Change events, from the watcher or fileChanged().
+    uint64_t          reloads    = 0;   ///< reload() calls, i.e. bursts after debouncing.
+    uint64_t          ownWrites  = 0;   ///< Skipped: the file is the helper's own last save.
+    uint64_t          unchanged  = 0;   ///< Skipped: same stamp as the last file read.
+    uint64_t          failures   = 0;   ///< Neither the file nor its .bak parsed.
+    uint64_t          fromBackup = 0;   ///< Reloads that had to use the .bak.
+    ConfigReloadStats last;             ///< Timings and counts of the latest reload().
+};
+
+/**
+ * @class ConfigReloader
+ * @brief Debounced, off-thread reload on file change; see the file comment.
+ */
+class ConfigReloader {
+public:
+    /// Create after the first load(): the file as it is now counts as already read.
+    explicit ConfigReloader(OBSConfigHelper *cfg, ConfigReloadOptions options = ConfigReloadOptions());
+
+    /// Stops watching and waits for a running reload. Call on the thread that called watch().
+    ~ConfigReloader();
+
+    ConfigReloader(const ConfigReloader &) = delete;
+    ConfigReloader &operator=(const ConfigReloader &) = delete;
+
+    /// Starts watching the file. UI thread; call once.
+    void watch();
+
+    /// Reports a change; bursts within the debounce interval cost one reload. Any thread.
+    void fileChanged();
+
+    /// Reloads as soon as a running reload is done, without the debounce or the stamp checks.
+    void reloadNow();
+
+    ConfigReloaderStats stats() const;
+
+private:
+    void rearm();
+    void schedule(std::chrono::milliseconds delay);
+    void runDue();
+    void reloadFile(bool force);
+
+    OBSConfigHelper          *cfg_;
+    const ConfigReloadOptions options_;
+    QFileSystemWatcher       *watcher_ = nullptr;   ///< UI thread only.
+
+    mutable std::mutex                    mutex_;
+    std::chrono::steady_clock::time_point queuedAt_;
+    bool                                  pending_ = false;
+    bool                                  force_   = false;
+    bool                                  armed_   = false;   ///< A runDue() is queued.
+    bool                                  running_ = false;   ///< A reload is in progress.
+    ConfigReloaderStats                   stats_;   ///< Guarded by mutex_.
+
+    int64_t         lastSeenAtMs_;   ///< Reload task only: when lastSeen_ was taken, epoch ms.
+    ConfigFileStamp lastSeen_;       ///< Reload task only: stamp of the last file read.
+    TaskGroup       tasks_{TaskLane::Background};
+};
@@ -0,0 +1,229 @@
+/*!
+ * @file config-schema.h
+ * @brief Compile-time schema of every PlayFame setting.
+ *
+ * Each setting is declared once here with its section, key, type, default
+ * and range. OBSConfigHelper, ConfigTransaction and ConfigDialog take these
+ * descriptors directly, so value types are checked by the compiler and range
+ * checks are inlined comparisons instead of QVariant dispatch.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/// Value types a ConfigField can hold.
+template<typename T>
+concept ConfigScalar = std::same_as<T, bool> || std::same_as<T, int> || std::same_as<T, long long> ||
+                       std::same_as<T, double>;
+
+/**
+ * @brief Descriptor of a numeric or boolean setting.
+ *
+ * @tparam T bool, int, long long or double. Booleans use {false, true} as range.
+ */
+template<ConfigScalar T> struct ConfigField {
+    using value_type = T;
+
+    uint32_t    section;      ///< Index into ConfigSchema::kSections.
+    const char *key;
+    T           defaultValue;
+    T           min;
+    T           max;
+
+    constexpr bool contains(T value) const { return !(value < min) && !(max < value); }
+
+    constexpr T clamp(T value) const { return value < min ? min : (max < value ? max : value); }
+
+    /// Used by static_assert below: the default must lie within the range.
+    constexpr bool isWellFormed() const { return key && key[0] && !(max < min) && contains(defaultValue); }
+};
+
+/**
+ * @brief Descriptor of a UTF-8 text setting.
+ */
+struct ConfigTextField {
+    uint32_t    section;      ///< Index into ConfigSchema::kSections.
+    const char *key;
+    const char *defaultValue;
+    size_t      maxBytes;     ///< Longest accepted value, in UTF-8 bytes.
+
+    constexpr bool contains(size_t bytes) const { return bytes <= maxBytes; }
+
+    constexpr bool isWellFormed() const
+    {
+        if (!key || !key[0] || !defaultValue)
+            return false;
+        size_t n = 0;
+        while (defaultValue[n])
+            ++n;
+        return contains(n);
+    }
+};
+
+/// How a field is stored; the order of ConfigValue's alternatives.
+enum class ConfigFieldType : uint8_t { Bool, Integer, Real, Text };
+
+/**
+ * @brief Limits of any field with its type erased, for code that handles every
+ *        field alike (the settings editor, see config-model.h, and the control
+ *        endpoint, see config-ipc.h).
+ */
+struct ConfigFieldInfo {
+    uint32_t        section;
+    const char     *key;
+    bool            text;
+    double          min;        ///< Numeric fields.
+    double          max;
+    size_t          maxBytes;   ///< Text fields.
+    ConfigFieldType type;
+
+    template<ConfigScalar T> static constexpr ConfigFieldInfo of(const ConfigField<T> &field)
+    {
+        constexpr ConfigFieldType type = std::same_as<T, bool>     ? ConfigFieldType::Bool
+                                         : std::same_as<T, double> ? ConfigFieldType::Real
+                                                                   : ConfigFieldType::Integer;
+        return {field.section, field.key, false, static_cast<double>(field.min), static_cast<double>(field.max), 0,
+                type};
+    }
+
+    static constexpr ConfigFieldInfo of(const ConfigTextField &field)
+    {
+        return {field.section, field.key, true, 0, 0, field.maxBytes, ConfigFieldType::Text};
+    }
+};
+
+/* ------------------------------------------------------------------------- */
+/*  PlayFame settings                                                        */
+/* ------------------------------------------------------------------------- */
+namespace ConfigSchema {
+
+/// Sections are interned in this order by every OBSConfigHelper.
+enum Section : uint32_t {
+    Demo,
+    Auth,
+    Meter,
+    Telemetry,
+    Scopes,
+    Perf,
+    Ipc,
+    SectionCount,
+};
+
+inline constexpr const char *kSections[SectionCount] = {
+    "demo",
+    "auth",
+    "meter",
+    "telemetry",
+    "scopes",
+    "perf",
+    "ipc",
+};
+
+inline constexpr ConfigTextField  kDemoText   {Demo, "text",   "hello", 1024};
+inline constexpr ConfigField<int> kDemoNumber {Demo, "number", 0, 0, 9999};
+inline constexpr ConfigField<int> kDemoOption {Demo, "option", 1, 1, 5};
+
+static_assert(kDemoText.isWellFormed());
+static_assert(kDemoNumber.isWellFormed());
+static_assert(kDemoOption.isWellFormed());
+
+/* Firebase project; auth stays off while api_key is empty (see plugin-main.cpp) */
+inline constexpr ConfigTextField  kAuthApiKey        {Auth, "api_key",          "", 256};
+inline constexpr ConfigTextField  kAuthAppId         {Auth, "app_id",           "", 256};
+inline constexpr ConfigTextField  kAuthProjectId     {Auth, "project_id",       "", 256};
+inline constexpr ConfigTextField  kAuthEmulatorHost  {Auth, "emulator_host",    "", 256};
+inline constexpr ConfigField<int> kAuthRefreshMargin {Auth, "refresh_margin_s", 300, 30, 1800};
+
+static_assert(kAuthApiKey.isWellFormed());
+static_assert(kAuthAppId.isWellFormed());
+static_assert(kAuthProjectId.isWellFormed());
+static_assert(kAuthEmulatorHost.isWellFormed());
+static_assert(kAuthRefreshMargin.isWellFormed());
+
+/* Dock audio meter: metered source names, separated by ';' */
+inline constexpr ConfigTextField  kMeterSources {Meter, "sources", "", 1024};
+inline constexpr ConfigField<int> kMeterMaxFps  {Meter, "max_fps", 60, 10, 240};
+
+static_assert(kMeterSources.isWellFormed());
+static_assert(kMeterMaxFps.isWellFormed());
+
+/* Frontend event telemetry; off while endpoint is empty (see plugin-main.cpp) */
+inline constexpr ConfigTextField  kTelemetryEndpoint   {Telemetry, "endpoint",       "", 512};
+inline constexpr ConfigField<int> kTelemetryBatchDelay {Telemetry, "batch_delay_ms", 5000, 500, 60000};
+inline constexpr ConfigField<int> kTelemetrySpoolKb    {Telemetry, "spool_kb",       4096, 256, 65536};
+
+static_assert(kTelemetryEndpoint.isWellFormed());
+static_assert(kTelemetryBatchDelay.isWellFormed());
+static_assert(kTelemetrySpoolKb.isWellFormed());
+
+/* Per-profile / per-scene-collection stores kept in memory (see config-scopes.h) */
+inline constexpr ConfigField<int> kScopesCacheKb   {Scopes, "cache_kb",   8192, 256, 262144};
+inline constexpr ConfigField<int> kScopesMaxStores {Scopes, "max_stores", 16, 2, 256};
+
+static_assert(kScopesCacheKb.isWellFormed());
+static_assert(kScopesMaxStores.isWellFormed());
+
+/* Dock performance monitor (see perf-monitor.h); an alert limit of 0 turns that alert off */
+inline constexpr ConfigField<bool>   kPerfEnabled       {Perf, "enabled",           true, false, true};
+inline constexpr ConfigField<int>    kPerfIntervalMs    {Perf, "interval_ms",       250, 50, 5000};
+inline constexpr ConfigField<double> kPerfAlertRender   {Perf, "alert_render_pct",  90.0, 0.0, 200.0};
+inline constexpr ConfigField<double> kPerfAlertMissed   {Perf, "alert_missed_pct",  1.0, 0.0, 100.0};
+inline constexpr ConfigField<double> kPerfAlertSkipped  {Perf, "alert_skipped_pct", 1.0, 0.0, 100.0};
+inline constexpr ConfigField<double> kPerfAlertDropped  {Perf, "alert_dropped_pct", 2.0, 0.0, 100.0};
+inline constexpr ConfigField<double> kPerfAlertCpu      {Perf, "alert_cpu_pct",     90.0, 0.0, 100.0};
+inline constexpr ConfigField<int>    kPerfAlertHold     {Perf, "alert_hold_s",      3, 0, 60};
+
+static_assert(kPerfEnabled.isWellFormed());
+static_assert(kPerfIntervalMs.isWellFormed());
+static_assert(kPerfAlertRender.isWellFormed());
+static_assert(kPerfAlertMissed.isWellFormed());
+static_assert(kPerfAlertSkipped.isWellFormed());
+static_assert(kPerfAlertDropped.isWellFormed());
+static_assert(kPerfAlertCpu.isWellFormed());
+static_assert(kPerfAlertHold.isWellFormed());
+
+/* Local control endpoint (see config-ipc.h), read at startup; an empty path picks a per-process one */
+inline constexpr ConfigField<bool> kIpcEnabled    {Ipc, "enabled",     false, false, true};
+inline constexpr ConfigTextField   kIpcPath       {Ipc, "path",        "", 256};
+inline constexpr ConfigField<int>  kIpcMaxClients {Ipc, "max_clients", 8, 1, 32};
+
+static_assert(kIpcEnabled.isWellFormed());
+static_assert(kIpcPath.isWellFormed());
+static_assert(kIpcMaxClients.isWellFormed());
+
+/// Every field above; a field missing here is edited without its limits.
+inline constexpr ConfigFieldInfo kFields[] = {
+    ConfigFieldInfo::of(kDemoText),          ConfigFieldInfo::of(kDemoNumber),
+    ConfigFieldInfo::of(kDemoOption),        ConfigFieldInfo::of(kAuthApiKey),
+    ConfigFieldInfo::of(kAuthAppId),         ConfigFieldInfo::of(kAuthProjectId),
+    ConfigFieldInfo::of(kAuthEmulatorHost),  ConfigFieldInfo::of(kAuthRefreshMargin),
+    ConfigFieldInfo::of(kMeterSources),      ConfigFieldInfo::of(kMeterMaxFps),
+    ConfigFieldInfo::of(kTelemetryEndpoint), ConfigFieldInfo::of(kTelemetryBatchDelay),
+    ConfigFieldInfo::of(kTelemetrySpoolKb),  ConfigFieldInfo::of(kScopesCacheKb),
+    ConfigFieldInfo::of(kScopesMaxStores),   ConfigFieldInfo::of(kPerfEnabled),
+    ConfigFieldInfo::of(kPerfIntervalMs),    ConfigFieldInfo::of(kPerfAlertRender),
+    ConfigFieldInfo::of(kPerfAlertMissed),   ConfigFieldInfo::of(kPerfAlertSkipped),
+    ConfigFieldInfo::of(kPerfAlertDropped),  ConfigFieldInfo::of(kPerfAlertCpu),
+    ConfigFieldInfo::of(kPerfAlertHold),     ConfigFieldInfo::of(kIpcEnabled),
+    ConfigFieldInfo::of(kIpcPath),           ConfigFieldInfo::of(kIpcMaxClients),
+};
+
+/// The schema field stored under @p section / @p key, or null.
+constexpr const ConfigFieldInfo *findField(std::string_view section, std::string_view key)
+{
+    for (const ConfigFieldInfo &field : kFields)
+        if (section == kSections[field.section] && key == field.key)
+            return &field;
+    return nullptr;
+}
+
+} // namespace ConfigSchema
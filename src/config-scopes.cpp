@@ -0,0 +1,314 @@
+/*!
+ * @file config-scopes.cpp
+ * @brief Implements the scoped config store cache, its prefetch worker and eviction.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "config-scopes.h"
+#include "plugin-support.h"
+#include "plugin-trace.h"
+
+#include <obs-module.h>
+#include <util/bmem.h>
+#include <util/platform.h>
+
+#include <algorithm>
+
+namespace {
+
+/* parsed obs_data plus snapshot, sections and strings; a rough multiple of the file */
+constexpr size_t kBytesPerFileByte = 4;
+constexpr size_t kStoreOverhead    = 16 * 1024;
+
+int64_t fileSize(const QByteArray &relative)
+{
+    char *path = obs_module_config_path(relative.constData());
+    const int64_t size = path ? os_get_file_size(path) : -1;
+    bfree(path);
+    return std::max<int64_t>(size, 0);
+}
+
+} // namespace
+
+ConfigScopes::ConfigScopes(ConfigScopeOptions options)
+    : options_(options)
+{
+    worker_ = std::thread(&ConfigScopes::runWorker, this);
+}
+
+ConfigScopes::~ConfigScopes()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    loaded_.notify_all();
+    if (worker_.joinable())
+        worker_.join();
+
+    /* the worker is gone; stores flush their writers as they are destroyed */
+    for (Entry &entry : lru_)
+        if (entry.store->reader().version() != entry.loadedVersion)
+            entry.store->save();
+    index_.clear();
+    lru_.clear();
+}
+
+bool ConfigScopes::flush(std::chrono::milliseconds timeout)
+{
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::vector<std::shared_ptr<OBSConfigHelper>> saved;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (Entry &entry : lru_) {
+            const uint64_t version = entry.store->reader().version();
+            if (version == entry.loadedVersion)
+                continue;
+            entry.store->save();
+            entry.loadedVersion = version;
+            saved.push_back(entry.store);
+        }
+    }
+
+    /* outside the lock: activate() may run meanwhile */
+    bool flushed = true;
+    for (const std::shared_ptr<OBSConfigHelper> &store : saved) {
+        const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        flushed = store->flush(std::max(left, std::chrono::milliseconds(0))) && flushed;
+    }
+    return flushed;
+}
+
+QByteArray ConfigScopes::fileName(ConfigScopeKind kind, const QString &name)
+{
+    /* any profile name becomes one safe path component: [A-Za-z0-9_-] as is, the rest %XX */
+    static const char kHex[] = "0123456789ABCDEF";
+    QByteArray file = kind == ConfigScopeKind::Profile ? "scopes/profile/" : "scopes/collection/";
+    const QByteArray utf8 = name.toUtf8();
+    for (qsizetype i = 0; i < utf8.size(); ++i) {
+        const auto c = static_cast<unsigned char>(utf8[i]);
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_') {
+            file.append(static_cast<char>(c));
+        } else {
+            file.append('%');
+            file.append(kHex[c >> 4]);
+            file.append(kHex[c & 0xF]);
+        }
+    }
+    file.append(".json");
+    return file;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Frontend thread                                                          */
+/* ------------------------------------------------------------------------- */
+std::shared_ptr<OBSConfigHelper> ConfigScopes::activate(ConfigScopeKind kind, const QString &name)
+{
+    PF_TRACE_SCOPE("scopes.activate");
+    const QByteArray file = fileName(kind, name);
+    QByteArray      &slot = active_[static_cast<int>(kind)];
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    const QByteArray previous = slot;
+    if (previous == file) {
+        /* repeated event for the active store, cached or still loading */
+        auto same = index_.find(file);
+        return same != index_.end() ? same->second->store : nullptr;
+    } else if (!previous.isEmpty()) {
+        ++transitions_[previous][file];
+    }
+
+    std::shared_ptr<OBSConfigHelper> store;
+    resurrect(file);
+    auto found = index_.find(file);
+    if (found != index_.end()) {
+        Lru::iterator it = found->second;
+        ++stats_.hits;
+        if (it->prefetched) {
+            ++stats_.prefetchHits;
+            it->prefetched = false;
+        }
+        lru_.splice(lru_.begin(), lru_, it);
+        store = it->store;
+    } else {
+        /* parsing is the worker's job; a load already in flight or a burial
+         * of this file finishes first, and current() picks the store up */
+        ++stats_.misses;
+        queueLoad(file, true);
+    }
+
+    slot = file;                    /* before eviction, which spares active stores */
+    const QByteArray next = predictNext(file, previous);
+    if (!next.isEmpty())
+        queueLoad(next, false);     /* may take it back from the graveyard */
+    evictOverBudget();
+    PF_TRACE_COUNTER("scopes.bytes", static_cast<int64_t>(bytes_));
+    return store;
+}
+
+std::shared_ptr<OBSConfigHelper> ConfigScopes::current(ConfigScopeKind kind) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = index_.find(active_[static_cast<int>(kind)]);
+    return found != index_.end() ? found->second->store : nullptr;
+}
+
+std::shared_ptr<OBSConfigHelper> ConfigScopes::waitForCurrent(ConfigScopeKind kind,
+                                                              std::chrono::milliseconds timeout) const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    std::shared_ptr<OBSConfigHelper> store;
+    loaded_.wait_for(lock, timeout, [&] {
+        auto found = index_.find(active_[static_cast<int>(kind)]);
+        if (found != index_.end())
+            store = found->second->store;
+        return store || stopping_;
+    });
+    return store;
+}
+
+void ConfigScopes::prefetch(ConfigScopeKind kind, const QString &name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    queueLoad(fileName(kind, name), false);
+    evictOverBudget();              /* in case it came back from the graveyard */
+}
+
+ConfigScopes::Stats ConfigScopes::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats s  = stats_;
+    s.stores = lru_.size();
+    s.bytes  = bytes_;
+    return s;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Internals                                                                */
+/* ------------------------------------------------------------------------- */
+ConfigScopes::Entry ConfigScopes::load(const QByteArray &file)
+{
+    PF_TRACE_SCOPE("scopes.load");
+    Entry entry;
+    entry.file  = file;
+    entry.store = std::make_shared<OBSConfigHelper>(file.constData());
+    entry.store->setJournalMode(true);
+    entry.store->load();            /* a missing file is an empty store */
+    entry.loadedVersion = entry.store->reader().version();
+    entry.bytes = kStoreOverhead + kBytesPerFileByte * static_cast<size_t>(fileSize(file) +
+                                                                           fileSize(file + ".journal"));
+    return entry;
+}
+
+void ConfigScopes::insert(Entry entry)
+{
+    bytes_ += entry.bytes;
+    lru_.push_front(std::move(entry));
+    index_[lru_.front().file] = lru_.begin();
+}
+
+bool ConfigScopes::resurrect(const QByteArray &file)
+{
+    auto dead = std::find_if(graveyard_.begin(), graveyard_.end(),
+                             [&](const Entry &entry) { return entry.file == file; });
+    if (dead == graveyard_.end())
+        return false;
+    Entry entry = std::move(*dead);
+    graveyard_.erase(dead);
+    insert(std::move(entry));
+    return true;
+}
+
+void ConfigScopes::evictOverBudget()
+{
+    auto it = lru_.end();
+    while ((bytes_ > options_.maxBytes || lru_.size() > options_.maxStores) && it != lru_.begin()) {
+        --it;
+        if (it->file == active_[0] || it->file == active_[1])
+            continue;
+        bytes_ -= it->bytes;
+        index_.erase(it->file);
+        graveyard_.push_back(std::move(*it));
+        it = lru_.erase(it);
+        ++stats_.evictions;
+    }
+    if (!graveyard_.empty())
+        wake_.notify_one();
+}
+
+void ConfigScopes::queueLoad(const QByteArray &file, bool urgent)
+{
+    /* a store being buried is queued: the worker loads only after the burial */
+    if (stopping_ || resurrect(file) || index_.count(file) || loading_.count(file))
+        return;
+    auto queued = std::find(queue_.begin(), queue_.end(), file);
+    if (queued != queue_.end()) {
+        if (!urgent)
+            return;
+        queue_.erase(queued);
+    }
+    if (urgent)
+        queue_.push_front(file);
+    else
+        queue_.push_back(file);
+    wake_.notify_one();
+}
+
+QByteArray ConfigScopes::predictNext(const QByteArray &from, const QByteArray &previous) const
+{
+    auto seen = transitions_.find(from);
+    if (seen != transitions_.end() && !seen->second.empty()) {
+        auto best = std::max_element(seen->second.begin(), seen->second.end(),
+                                     [](const auto &a, const auto &b) { return a.second < b.second; });
+        return best->first;
+    }
+    return previous != from ? previous : QByteArray();
+}
+
+void ConfigScopes::runWorker()
+{
+    for (;;) {
+        std::vector<Entry> dead;
+        QByteArray         file;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this] { return stopping_ || !queue_.empty() || !graveyard_.empty(); });
+            dead.swap(graveyard_);
+            if (!stopping_ && !queue_.empty()) {
+                file = queue_.front();
+                queue_.pop_front();
+                if (index_.count(file) || loading_.count(file))
+                    file.clear();
+                else
+                    loading_.insert(file);
+            }
+            if (stopping_ && dead.empty())
+                return;
+        }
+
+        /* save and free evicted stores off the frontend thread */
+        for (Entry &entry : dead)
+            if (entry.store->reader().version() != entry.loadedVersion)
+                entry.store->save();
+        dead.clear();               /* the stores flush their writers as they are destroyed */
+
+        if (file.isEmpty())
+            continue;
+        Entry entry = load(file);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        loading_.erase(file);
+        entry.prefetched = file != active_[0] && file != active_[1];
+        if (entry.prefetched)
+            ++stats_.prefetches;
+        insert(std::move(entry));
+        evictOverBudget();
+        loaded_.notify_all();
+    }
+}
@@ -0,0 +1,145 @@
+/*!
+ * @file config-scopes.h
+ * @brief Per-profile and per-scene-collection config stores with an LRU cache.
+ *
+ * Each OBS profile and each scene collection gets its own OBSConfigHelper,
+ * stored as "scopes/profile/<name>.json" or "scopes/collection/<name>.json"
+ * in the module config directory. activate() is called for the
+ * PROFILE_CHANGED / SCENE_COLLECTION_CHANGED frontend events; a store that
+ * is already cached is returned without touching the disk, any other is
+ * loaded on the worker thread and published to current() once it is
+ * ready, so the frontend thread never parses a file. Stores stay
+ * cached up to a memory budget (estimated from their file sizes) and a
+ * count, least recently used first out, never the active ones.
+ *
+ * After each switch a worker thread prefetches the likely next store: the
+ * one most often switched to from the new one so far, or else the one just
+ * left, since operators tend to switch back and forth. Evicted stores are
+ * saved if they changed and destroyed on the worker too, so the frontend
+ * thread never waits for a write. A store wanted again before the worker
+ * got to it goes back into the cache; one the worker is already saving is
+ * loaded again only after that save, so no file ever has two stores.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include "obs-config-helper.h"
+
+#include <QByteArray>
+#include <QString>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+enum class ConfigScopeKind { Profile, SceneCollection };
+
+/**
+ * @brief Limits of the ConfigScopes cache.
+ */
+struct ConfigScopeOptions {
+    size_t maxBytes  = 8u << 20;   ///< Estimated memory of all cached stores.
+    size_t maxStores = 16;         ///< Cached stores, including the active ones.
+};
+
+/**
+ * @class ConfigScopes
+ * @brief Cache and loader of the scoped stores; see the file comment.
+ *
+ * activate() and current() are meant for the frontend thread and never
+ * block on the disk; stores are shared_ptrs, so one handed out stays valid
+ * after it is evicted.
+ */
+class ConfigScopes {
+public:
+    struct Stats {
+        uint64_t hits         = 0;   ///< activate() served from the cache.
+        uint64_t misses       = 0;   ///< activate() that queued a load.
+        uint64_t prefetches   = 0;   ///< Stores loaded ahead by the worker.
+        uint64_t prefetchHits = 0;   ///< Hits on a store the worker loaded.
+        uint64_t evictions    = 0;
+        size_t   stores       = 0;
+        size_t   bytes        = 0;   ///< Estimated.
+    };
+
+    explicit ConfigScopes(ConfigScopeOptions options = {});
+
+    /// Stops the worker, then saves changed stores and waits for their writes.
+    ~ConfigScopes();
+
+    /// Saves changed cached stores and waits up to @p timeout for their writes; true if all finished.
+    bool flush(std::chrono::milliseconds timeout);
+
+    ConfigScopes(const ConfigScopes &) = delete;
+    ConfigScopes &operator=(const ConfigScopes &) = delete;
+
+    /**
+     * @brief Makes @p name the active store of @p kind and prefetches the likely next one.
+     *
+     * Returns the cached store. Otherwise returns null and has the worker
+     * load it ahead of any prefetch; current() returns it once loaded.
+     */
+    std::shared_ptr<OBSConfigHelper> activate(ConfigScopeKind kind, const QString &name);
+
+    /// The active store of @p kind, or null before the first activate() or while it loads.
+    std::shared_ptr<OBSConfigHelper> current(ConfigScopeKind kind) const;
+
+    /// current(), waiting up to @p timeout for the worker to load it; not for the frontend thread.
+    std::shared_ptr<OBSConfigHelper> waitForCurrent(ConfigScopeKind kind, std::chrono::milliseconds timeout) const;
+
+    /// Queues a background load of @p name unless it is cached or loading.
+    void prefetch(ConfigScopeKind kind, const QString &name);
+
+    Stats stats() const;
+
+    /// Path below the module config directory, e.g. "scopes/profile/Main.json".
+    static QByteArray fileName(ConfigScopeKind kind, const QString &name);
+
+private:
+    struct Entry {
+        QByteArray                       file;
+        std::shared_ptr<OBSConfigHelper> store;
+        size_t                           bytes         = 0;
+        uint64_t                         loadedVersion = 0;   ///< Saved on eviction if it moved on.
+        bool                             prefetched    = false;
+    };
+    using Lru = std::list<Entry>;   ///< Most recently used first.
+
+    static Entry load(const QByteArray &file);
+    void         insert(Entry entry);                 ///< Under mutex_.
+    bool         resurrect(const QByteArray &file);   ///< Under mutex_; back from graveyard_ if there.
+    void         evictOverBudget();                   ///< Under mutex_.
+    void         queueLoad(const QByteArray &file, bool urgent);   ///< Under mutex_; urgent goes first.
+    QByteArray   predictNext(const QByteArray &from, const QByteArray &previous) const;   ///< Under mutex_.
+    void         runWorker();
+
+    const ConfigScopeOptions options_;
+
+    mutable std::mutex      mutex_;
+    std::condition_variable wake_;     ///< Worker: load queued, graveyard filled, stopping.
+    mutable std::condition_variable loaded_;   ///< waitForCurrent(): the worker cached a store.
+    Lru                                 lru_;
+    std::map<QByteArray, Lru::iterator> index_;
+    std::set<QByteArray>                loading_;
+    std::deque<QByteArray>              queue_;
+    std::vector<Entry>                  graveyard_;   ///< Evicted, for the worker to save and free.
+    std::map<QByteArray, std::map<QByteArray, uint32_t>> transitions_;   ///< from -> to -> count.
+    QByteArray                          active_[2];
+    size_t                              bytes_    = 0;
+    bool                                stopping_ = false;
+    Stats                               stats_;
+    std::thread                         worker_;
+};
@@ -0,0 +1,240 @@
+/*!
+ * @file config-search.cpp
+ * @brief Implements the settings search: debounce, full scan and refinement.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "config-search.h"
+#include "plugin-trace.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/* checked between this many keys, so a superseded scan stops within microseconds */
+constexpr size_t kCancelStride = 1024;
+
+char foldAscii(char c)
+{
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+QByteArray foldAscii(const QByteArray &text)
+{
+    QByteArray folded(text.size(), '\0');
+    for (qsizetype i = 0; i < text.size(); ++i)
+        folded.data()[i] = foldAscii(text[i]);
+    return folded;
+}
+
+/* needle is already folded */
+bool containsFolded(const char *hay, size_t length, const QByteArray &needle)
+{
+    const auto n = static_cast<size_t>(needle.size());
+    if (n == 0)
+        return true;
+    if (!hay || length < n)
+        return false;
+    const char *first = needle.constData();
+    for (size_t i = 0; i + n <= length; ++i) {
+        if (foldAscii(hay[i]) != first[0])
+            continue;
+        size_t j = 1;
+        while (j < n && foldAscii(hay[i + j]) == first[j])
+            ++j;
+        if (j == n)
+            return true;
+    }
+    return false;
+}
+
+bool valueMatches(obs_data_item_t *item, const QByteArray &needle)
+{
+    char text[32];
+    switch (obs_data_item_gettype(item)) {
+    case OBS_DATA_STRING: {
+        const char *value = obs_data_item_get_string(item);
+        return value && containsFolded(value, std::strlen(value), needle);
+    }
+    case OBS_DATA_NUMBER:
+        if (obs_data_item_numtype(item) == OBS_DATA_NUM_DOUBLE)
+            std::snprintf(text, sizeof(text), "%g", obs_data_item_get_double(item));
+        else
+            std::snprintf(text, sizeof(text), "%lld", obs_data_item_get_int(item));
+        return containsFolded(text, std::strlen(text), needle);
+    case OBS_DATA_BOOLEAN:
+        return obs_data_item_get_bool(item) ? containsFolded("true", 4, needle) : containsFolded("false", 5, needle);
+    default:
+        return false;               /* nested objects and arrays are not searched */
+    }
+}
+
+bool itemMatches(obs_data_item_t *item, const QByteArray &needle)
+{
+    const char *name = obs_data_item_get_name(item);
+    return containsFolded(name, std::strlen(name), needle) || valueMatches(item, needle);
+}
+
+/* pins the current root, which is never modified once published, past the reader */
+obs_data_t *pinRoot(const OBSConfigHelper *cfg, uint64_t &version)
+{
+    ConfigReader reader = cfg->reader();
+    obs_data_t  *root   = reader.snapshot()->root;
+    obs_data_addref(root);
+    version = reader.version();
+    return root;
+}
+
+} // namespace
+
+ConfigSearch::ConfigSearch(OBSConfigHelper *cfg, QObject *context, ResultFn fn, std::chrono::milliseconds debounce)
+    : cfg_(cfg)
+    , context_(context)
+    , fn_(std::move(fn))
+    , debounce_(debounce)
+    , latest_(std::make_shared<std::atomic<uint64_t>>(0))
+{
+}
+
+ConfigSearch::~ConfigSearch()
+{
+    latest_->fetch_add(1);          /* stops a scan in flight */
+    tasks_.cancel();
+    tasks_.wait();
+}
+
+uint64_t ConfigSearch::search(const QString &query)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint64_t generation = latest_->fetch_add(1) + 1;
+    /* debounce: the previous query is dropped unless it already started */
+    pending_.cancel();
+    pending_ = CancelToken();
+    if (!query.isEmpty()) {
+        pending_ = CancelToken::create();
+        tasks_.postAfter(debounce_, [this, query, generation] { run(query, generation); }, pending_);
+    }
+    return generation;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Search task                                                              */
+/* ------------------------------------------------------------------------- */
+void ConfigSearch::run(const QString &query, uint64_t generation)
+{
+    /* a superseded scan may still be stopping; it notices within kCancelStride keys */
+    std::lock_guard<std::mutex> lock(scanMutex_);
+    if (cancelled(generation))
+        return;
+
+    PF_TRACE_SCOPE("search.run");
+    const QByteArray needle = foldAscii(query.toUtf8());
+    ConfigSearchResult result;
+    result.query      = query;
+    result.generation = generation;
+    const auto t0 = Clock::now();
+
+    const bool narrower = !previousNeedle_.isEmpty() && needle.size() > previousNeedle_.size() &&
+                          containsFolded(needle.constData(), static_cast<size_t>(needle.size()),
+                                         previousNeedle_);
+    const bool done = narrower ? refine(needle, generation, result) : scan(needle, generation, result);
+    if (!done)
+        return;                     /* superseded; the newer query is already queued */
+    result.durationUs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - t0).count());
+
+    previous_       = result;
+    previousNeedle_ = needle;
+
+    if (!context_) {
+        fn_(result);
+        return;
+    }
+    PluginExecutor::global().postToUi(context_, [fn = fn_, latest = latest_, result = std::move(result)]() {
+        if (latest->load() == result.generation)
+            fn(result);
+    });
+}
+
+bool ConfigSearch::scan(const QByteArray &needle, uint64_t generation, ConfigSearchResult &result)
+{
+    obs_data_t *root = pinRoot(cfg_, result.version);
+    bool        done = true;
+
+    for (obs_data_item_t *s = obs_data_first(root); s; obs_data_item_next(&s)) {
+        if (obs_data_item_gettype(s) != OBS_DATA_OBJECT)
+            continue;
+        const char *sectionName = obs_data_item_get_name(s);
+        const bool  wholeSection = containsFolded(sectionName, std::strlen(sectionName), needle);
+
+        ConfigSearchResult::Section section;
+        section.name = QByteArray(sectionName);
+        obs_data_t *obj = obs_data_item_get_obj(s);
+        for (obs_data_item_t *k = obs_data_first(obj); k; obs_data_item_next(&k)) {
+            if (++result.scanned % kCancelStride == 0 && cancelled(generation)) {
+                obs_data_item_release(&k);
+                done = false;
+                break;
+            }
+            if (wholeSection || itemMatches(k, needle))
+                section.keys.emplace_back(obs_data_item_get_name(k));
+        }
+        obs_data_release(obj);
+
+        if (!done) {
+            obs_data_item_release(&s);
+            break;
+        }
+        if (!section.keys.empty()) {
+            result.matches += section.keys.size();
+            result.sections.push_back(std::move(section));
+        }
+    }
+    obs_data_release(root);
+    return done;
+}
+
+bool ConfigSearch::refine(const QByteArray &needle, uint64_t generation, ConfigSearchResult &result)
+{
+    obs_data_t *root = pinRoot(cfg_, result.version);
+    if (result.version != previous_.version) {
+        obs_data_release(root);     /* keys may have appeared since; only a scan finds them */
+        return scan(needle, generation, result);
+    }
+
+    result.incremental = true;
+    bool done = true;
+    for (const ConfigSearchResult::Section &candidates : previous_.sections) {
+        const bool wholeSection = containsFolded(candidates.name.constData(),
+                                                 static_cast<size_t>(candidates.name.size()), needle);
+        ConfigSearchResult::Section section;
+        section.name = candidates.name;
+        obs_data_t *obj = obs_data_get_obj(root, candidates.name.constData());
+        for (const QByteArray &key : candidates.keys) {
+            if (++result.scanned % kCancelStride == 0 && cancelled(generation)) {
+                done = false;
+                break;
+            }
+            obs_data_item_t *item = obs_data_item_byname(obj, key.constData());
+            if (item && (wholeSection || itemMatches(item, needle)))
+                section.keys.push_back(key);
+            obs_data_item_release(&item);
+        }
+        obs_data_release(obj);
+        if (!done)
+            break;
+        if (!section.keys.empty()) {
+            result.matches += section.keys.size();
+            result.sections.push_back(std::move(section));
+        }
+    }
+    obs_data_release(root);
+    return done;
+}
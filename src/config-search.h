@@ -0,0 +1,100 @@
+/*!
+ * @file config-search.h
+ * @brief Debounced, cancellable search over every key and value of a config.
+ *
+ * The settings editor calls search() for each keystroke. Each call posts a
+ * delayed task on the Interactive lane of the plugin executor and cancels
+ * the previous one, so only a query that stayed stable for the debounce
+ * interval is run: it scans the current snapshot for keys whose name or
+ * value contains the query (ASCII case-insensitive). A newer query also
+ * stops a scan in flight.
+ * When the new query extends the previous one and the config has not
+ * changed since, only the previous matches are checked again, so typing
+ * further gets cheaper instead of rescanning everything.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include "obs-config-helper.h"
+#include "plugin-executor.h"
+
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Matches of one query, grouped by section in config order.
+ */
+struct ConfigSearchResult {
+    struct Section {
+        QByteArray              name;
+        std::vector<QByteArray> keys;
+    };
+
+    QString              query;
+    uint64_t             generation  = 0;   ///< Of the search() call this answers.
+    uint64_t             version     = 0;   ///< Snapshot the scan read.
+    std::vector<Section> sections;
+    size_t               matches     = 0;
+    size_t               scanned     = 0;   ///< Keys examined.
+    bool                 incremental = false;   ///< Refined from the previous matches.
+    uint64_t             durationUs  = 0;   ///< Scan only, without the debounce.
+};
+
+/**
+ * @class ConfigSearch
+ * @brief Answers the latest query off the UI thread; see the file comment.
+ */
+class ConfigSearch {
+public:
+    using ResultFn = std::function<void(const ConfigSearchResult &result)>;
+
+    /**
+     * @param context With an object, @p fn runs on its thread and only for
+     *        the latest query; with nullptr it runs on an executor worker.
+     */
+    ConfigSearch(OBSConfigHelper *cfg, QObject *context, ResultFn fn,
+                 std::chrono::milliseconds debounce = std::chrono::milliseconds(150));
+
+    /// Cancels the pending query and waits for a scan in flight to stop.
+    ~ConfigSearch();
+
+    ConfigSearch(const ConfigSearch &) = delete;
+    ConfigSearch &operator=(const ConfigSearch &) = delete;
+
+    /// Replaces the pending query; an empty one only cancels. Returns its generation.
+    uint64_t search(const QString &query);
+
+private:
+    void run(const QString &query, uint64_t generation);
+    bool scan(const QByteArray &needle, uint64_t generation, ConfigSearchResult &result);
+    bool refine(const QByteArray &needle, uint64_t generation, ConfigSearchResult &result);
+    bool cancelled(uint64_t generation) const { return latest_->load(std::memory_order_relaxed) != generation; }
+
+    OBSConfigHelper                       *cfg_;
+    QObject                               *context_;
+    ResultFn                               fn_;
+    const std::chrono::milliseconds        debounce_;
+    std::shared_ptr<std::atomic<uint64_t>> latest_;   ///< Shared with queued deliveries.
+
+    std::mutex  mutex_;
+    CancelToken pending_;   ///< Of the latest queued query; guarded by mutex_.
+
+    std::mutex         scanMutex_;       ///< One scan at a time; guards the two below.
+    ConfigSearchResult previous_;        ///< Last completed scan.
+    QByteArray         previousNeedle_;
+    TaskGroup          tasks_{TaskLane::Interactive};
+};
@@ -0,0 +1,134 @@
+/*!
+ * @file config-transaction.h
+ * @brief All-or-nothing batch updates for OBSConfigHelper.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include "obs-config-helper.h"
+
+#include <QByteArray>
+#include <QString>
+#include <QVariant>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+/**
+ * @class ConfigTransaction
+ * @brief Stages typed writes and applies them as one atomic change.
+ *
+ * Obtained from OBSConfigHelper::begin(). Nothing is visible to readers
+ * until commit(): every staged write is validated first, each touched
+ * section is copied once, all changes land in a single published snapshot,
+ * and at most one save is queued. If any write is invalid, none is applied.
+ * A transaction that is destroyed without commit() is rolled back.
+ */
+class ConfigTransaction {
+public:
+    /// Staged value, already converted to its storage form.
+    using Value = ConfigValue;
+
+    struct Write {
+        ConfigKey key;
+        Value     value;
+        bool      valid = true; ///< False if the value failed its range/type check.
+    };
+
+    ConfigTransaction(ConfigTransaction &&other) noexcept;
+    ConfigTransaction &operator=(ConfigTransaction &&other) noexcept;
+    ~ConfigTransaction();
+
+    ConfigTransaction(const ConfigTransaction &) = delete;
+    ConfigTransaction &operator=(const ConfigTransaction &) = delete;
+
+    /**
+     * @brief Stages a write through a pre-resolved handle.
+     *
+     * Accepts the same types as OBSConfigHelper::set().
+     */
+    template<typename T> ConfigTransaction &set(const ConfigKey &key, const T &value);
+
+    /**
+     * @brief Stages an arithmetic write that must lie within [min, max].
+     *
+     * An out-of-range value makes commit() fail without applying anything.
+     */
+    template<typename T> ConfigTransaction &set(const ConfigKey &key, T value, T min, T max);
+
+    /**
+     * @brief Stages a write of a schema field, checked against its range.
+     */
+    template<typename T> ConfigTransaction &set(const ConfigField<T> &field, std::type_identity_t<T> value)
+    {
+        set<T>(ConfigKey::fromSchema(field.section, field.key), value);
+        writes_.back().valid = field.contains(value);
+        return *this;
+    }
+
+    ConfigTransaction &set(const ConfigTextField &field, const QString &value)
+    {
+        set(ConfigKey::fromSchema(field.section, field.key), value);
+        const QByteArray &utf8 = std::get<QByteArray>(writes_.back().value);
+        writes_.back().valid = field.contains(static_cast<size_t>(utf8.size()));
+        return *this;
+    }
+
+    /**
+     * @brief Stages a write in the QVariant form of OBSConfigHelper::setValue().
+     *
+     * Validation uses the same rules as setValue().
+     */
+    ConfigTransaction &setValue(const QString &section, const QString &key, const QVariant &value,
+                                QMetaType::Type type, const QVariant &min = QVariant(),
+                                const QVariant &max = QVariant());
+
+    /**
+     * @brief Validates and applies every staged write, then queues one save.
+     * @param saveAfter Queue a save once the change is published.
+     * @return true if all writes were applied, false if none was.
+     */
+    bool commit(bool saveAfter = true);
+
+    /// Discards every staged write.
+    void rollback();
+
+    /// Number of staged writes.
+    size_t size() const { return writes_.size(); }
+
+private:
+    friend class OBSConfigHelper;
+
+    explicit ConfigTransaction(OBSConfigHelper *cfg)
+        : cfg_(cfg)
+    {
+    }
+
+    OBSConfigHelper   *cfg_;
+    std::vector<Write> writes_;
+};
+
+template<typename T> ConfigTransaction &ConfigTransaction::set(const ConfigKey &key, const T &value)
+{
+    Write w;
+    w.key   = key;
+    w.value = config_detail::toValue(value);
+    w.valid = key.isValid();
+    writes_.push_back(std::move(w));
+    return *this;
+}
+
+template<typename T> ConfigTransaction &ConfigTransaction::set(const ConfigKey &key, T value, T min, T max)
+{
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>,
+                  "ConfigTransaction::set: range check needs an arithmetic type");
+    set<T>(key, value);
+    if (value < min || value > max)
+        writes_.back().valid = false;
+    return *this;
+}
@@ -0,0 +1,195 @@
+/*!
+ * @file config-writer.cpp
+ * @brief Implements the coalescing background config writer.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "config-writer.h"
+#include "plugin-support.h"
+#include "plugin-trace.h"
+
+#include <algorithm>
+
+ConfigWriter::ConfigWriter(WriteFn write, std::chrono::milliseconds window)
+    : write_(std::move(write))
+    , window_(window)
+{
+}
+
+ConfigWriter::~ConfigWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        urgent_   = true;
+    }
+    kick(PluginExecutor::global().isWorkerThread());   /* a queued drain could wait for our own slot */
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [this] { return !draining_ && !pending_ && tasks_.empty(); });
+    }
+    group_.cancel();                /* the window timer, if armed */
+    group_.wait();
+
+    obs_data_release(pending_);     /* only set if the last write was skipped */
+}
+
+void ConfigWriter::submit(obs_data_t *snapshot, uint64_t version)
+{
+    if (!snapshot)
+        return;
+
+    obs_data_t *dropped = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.requested;
+        if (pending_) {
+            dropped = pending_;     /* superseded by the newer snapshot */
+            ++stats_.coalesced;
+            PF_TRACE_COUNTER("config.saves_coalesced", stats_.coalesced);
+        } else {
+            firstPending_ = std::chrono::steady_clock::now();
+        }
+        pending_        = snapshot;
+        pendingVersion_ = version;
+    }
+    kick();
+
+    obs_data_release(dropped);      /* outside the lock */
+}
+
+void ConfigWriter::schedule(std::function<void()> task)
+{
+    if (!task)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    kick();
+}
+
+bool ConfigWriter::flush(std::chrono::milliseconds timeout)
+{
+    auto idle = [this] { return !pending_ && !writing_ && tasks_.empty(); };
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (idle())
+            return true;
+        urgent_ = true;
+    }
+    kick();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    return idle_.wait_for(lock, timeout, idle);
+}
+
+void ConfigWriter::setCoalesceWindow(std::chrono::milliseconds window)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        window_ = std::max(window, std::chrono::milliseconds(0));
+    }
+    kick();
+}
+
+ConfigSaveStats ConfigWriter::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Writing                                                                  */
+/* ------------------------------------------------------------------------- */
+void ConfigWriter::kick(bool here)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (draining_)
+            return;                 /* the running drain sees the new state */
+        draining_ = true;
+    }
+    if (here || !group_.post([this] { drain(); }))
+        drain();                    /* or the executor has shut down */
+}
+
+void ConfigWriter::drain()
+{
+    using Clock = std::chrono::steady_clock;
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    for (;;) {
+        if (!pending_ && !tasks_.empty()) {
+            /* background task (e.g. cache refresh); snapshots take priority */
+            std::function<void()> task = std::move(tasks_.front());
+            tasks_.pop_front();
+            writing_ = true;
+            lock.unlock();
+            task();
+            lock.lock();
+            writing_ = false;
+            continue;
+        }
+
+        if (!pending_)
+            break;
+
+        /* coalesce: give newer submissions a chance to replace this one */
+        const Clock::time_point due = firstPending_ + window_;
+        const Clock::time_point now = Clock::now();
+        if (!urgent_ && now < due) {
+            if (due >= armedUntil_)
+                break;              /* a timer fires in time */
+            armedUntil_ = due;
+            lock.unlock();
+            const bool armed = group_.postAfter(
+                std::chrono::ceil<std::chrono::milliseconds>(due - now), [this, due] {
+                    {
+                        std::lock_guard<std::mutex> timerLock(mutex_);
+                        if (armedUntil_ == due)
+                            armedUntil_ = Clock::time_point::max();
+                    }
+                    kick();
+                });
+            lock.lock();
+            if (!armed) {
+                armedUntil_ = Clock::time_point::max();
+                urgent_     = true;  /* no timers any more; write now */
+            }
+            continue;
+        }
+
+        obs_data_t *snapshot = pending_;
+        uint64_t    version  = pendingVersion_;
+        pending_  = nullptr;
+        writing_  = true;
+        urgent_   = stopping_;
+        lock.unlock();
+
+        auto start = Clock::now();
+        bool ok    = write_(snapshot, version);
+        auto us    = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+        obs_data_release(snapshot);
+
+        if (!ok)
+            obs_log(LOG_WARNING, "[ConfigWriter] Failed to write configuration");
+
+        lock.lock();
+        writing_ = false;
+        ok ? ++stats_.written : ++stats_.failed;
+        stats_.lastLatencyUs   = static_cast<uint64_t>(us);
+        stats_.maxLatencyUs    = std::max(stats_.maxLatencyUs, stats_.lastLatencyUs);
+        stats_.totalLatencyUs += stats_.lastLatencyUs;
+
+        if (!pending_ && tasks_.empty())
+            urgent_ = stopping_;    /* a flush during the write is now satisfied */
+    }
+
+    draining_ = false;
+    idle_.notify_all();
+}
@@ -0,0 +1,113 @@
+/*!
+ * @file config-writer.h
+ * @brief Background writer that persists configuration snapshots off the UI thread.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include "plugin-executor.h"
+
+#include <obs-module.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+/**
+ * @brief Counters describing the background save path.
+ */
+struct ConfigSaveStats {
+    uint64_t requested      = 0; ///< Number of submit() calls.
+    uint64_t coalesced      = 0; ///< Submissions replaced by a newer one before being written.
+    uint64_t written        = 0; ///< Snapshots successfully written to disk.
+    uint64_t failed         = 0; ///< Snapshots whose write returned false.
+    uint64_t lastLatencyUs  = 0; ///< Duration of the most recent write.
+    uint64_t maxLatencyUs   = 0; ///< Longest write observed.
+    uint64_t totalLatencyUs = 0; ///< Sum of all write durations (divide by written + failed).
+};
+
+/**
+ * @class ConfigWriter
+ * @brief Serial background writer of immutable config snapshots.
+ *
+ * submit() hands over a snapshot and returns immediately. Snapshots arriving
+ * within the coalesce window replace the pending one, so a burst of saves
+ * results in a single write of the newest state. The writer never touches the
+ * live configuration; it only sees snapshots it owns.
+ *
+ * Writes run on the Background lane of the plugin executor, one at a time;
+ * the coalesce window is a delayed task, not a sleeping thread. Once the
+ * executor has shut down, writes happen on the calling thread.
+ */
+class ConfigWriter {
+public:
+    /// Performs the actual write of one snapshot. Runs on an executor worker.
+    using WriteFn = std::function<bool(obs_data_t *snapshot, uint64_t version)>;
+
+    explicit ConfigWriter(WriteFn write, std::chrono::milliseconds window = std::chrono::milliseconds(300));
+
+    /// Writes whatever is still pending and waits for it, without a time limit: flush() first when that matters.
+    ~ConfigWriter();
+
+    ConfigWriter(const ConfigWriter &) = delete;
+    ConfigWriter &operator=(const ConfigWriter &) = delete;
+
+    /**
+     * @brief Queues a snapshot for writing.
+     * @param snapshot Immutable data; the writer takes over the caller's reference.
+     * @param version  Snapshot version, passed through to the write function.
+     */
+    void submit(obs_data_t *snapshot, uint64_t version = 0);
+
+    /**
+     * @brief Runs a one-off I/O task in the writer's sequence.
+     *
+     * Tasks run in order, after any pending snapshot has been written, and
+     * count as pending work for flush().
+     */
+    void schedule(std::function<void()> task);
+
+    /**
+     * @brief Writes the pending snapshot now and waits for it to finish.
+     * @param timeout Upper bound on the wait.
+     * @return true if nothing is pending or in flight when the call returns.
+     */
+    bool flush(std::chrono::milliseconds timeout);
+
+    /// Sets how long a submission waits for newer ones before it is written.
+    void setCoalesceWindow(std::chrono::milliseconds window);
+
+    /// Returns a copy of the save counters.
+    ConfigSaveStats stats() const;
+
+private:
+    void kick(bool here = false);
+    void drain();
+
+    WriteFn write_;
+
+    mutable std::mutex      mutex_;
+    std::condition_variable idle_;   ///< Signals flush() waiters.
+
+    obs_data_t *pending_  = nullptr;
+    uint64_t    pendingVersion_ = 0;
+    std::deque<std::function<void()>> tasks_;
+    bool        writing_  = false;
+    bool        draining_ = false;   ///< A drain() is queued or running; at most one.
+    bool        urgent_   = false;   ///< Skip the coalesce window (flush/stop).
+    bool        stopping_ = false;
+    std::chrono::milliseconds             window_;
+    std::chrono::steady_clock::time_point firstPending_;
+    std::chrono::steady_clock::time_point armedUntil_ = std::chrono::steady_clock::time_point::max();   ///< Window timer.
+
+    ConfigSaveStats stats_;
+    TaskGroup       group_{TaskLane::Background};
+};
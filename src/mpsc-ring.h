@@ -0,0 +1,93 @@
+/*!
+ * @file mpsc-ring.h
+ * @brief Lock-free multi-producer/single-consumer ring of fixed capacity.
+ *
+ * Bounded queue after Dmitry Vyukov's design: every slot carries a sequence
+ * number that tells producers whether it is free and the consumer whether
+ * it is filled. A producer claims a slot with one compare-exchange on the
+ * head and publishes it with a release store on the slot, so producers never
+ * wait for each other beyond a retried CAS, and never wait for the consumer
+ * at all: a full ring makes push() fail instead.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @class MpscRing
+ * @brief Ring buffer of @p Capacity slots (a power of two).
+ *
+ * Any thread may call push(); exactly one thread may call pop().
+ */
+template<typename T, size_t Capacity> class MpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "slots are copied by value");
+
+public:
+    MpscRing()
+    {
+        for (size_t i = 0; i < Capacity; ++i)
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpscRing(const MpscRing &) = delete;
+    MpscRing &operator=(const MpscRing &) = delete;
+
+    /// Producer: copies @p item in; false (and no change) when the ring is full.
+    bool push(const T &item)
+    {
+        size_t head = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot &slot = slots_[head & (Capacity - 1)];
+            const size_t seq  = slot.sequence.load(std::memory_order_acquire);
+            const auto   diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(head);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(head, head + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;   /* the consumer has not freed this slot yet */
+            } else {
+                head = head_.load(std::memory_order_relaxed);
+            }
+        }
+        Slot &slot = slots_[head & (Capacity - 1)];
+        slot.value = item;
+        slot.sequence.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Consumer: moves the oldest item to @p out; false when the ring is empty.
+    bool pop(T &out)
+    {
+        Slot &slot = slots_[tail_ & (Capacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != tail_ + 1)
+            return false;   /* empty, or the producer that claimed it is still copying */
+        out = slot.value;
+        slot.sequence.store(tail_ + Capacity, std::memory_order_release);
+        ++tail_;
+        return true;
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    static constexpr size_t kLine = 64;
+
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T                   value;
+    };
+
+    alignas(kLine) std::atomic<size_t> head_{0};   ///< Next slot to claim; shared by producers.
+    alignas(kLine) size_t tail_ = 0;                ///< Consumer only.
+    alignas(kLine) Slot slots_[Capacity];
+};
@@ -0,0 +1,279 @@
+/*!
+ * @file notification-center.cpp
+ * @brief Implements the NotificationCenter ring, coalescing, rate limit and overlay toasts.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "notification-center.h"
+#include "plugin-support.h"
+#include "plugin-trace.h"
+
+#include <obs-frontend-api.h>
+#include <obs-module.h>
+
+#include <QLabel>
+
+#include <algorithm>
+#include <cstring>
+
+/* set by CMake when obs-frontend-api declares obs_frontend_push_ui_notification() */
+#ifndef PLAYFAME_HAVE_FRONTEND_NOTIFICATIONS
+#define PLAYFAME_HAVE_FRONTEND_NOTIFICATIONS 0
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kToastMargin  = 16;
+constexpr int kToastSpacing = 8;
+
+/* UTF-16 -> UTF-8 into a fixed buffer, stopping before a code point that does not fit */
+uint16_t encodeUtf8(const QString &text, char *out, size_t capacity)
+{
+    size_t      length = 0;
+    const QChar *p     = text.constData();
+    const qsizetype n  = text.size();
+    for (qsizetype i = 0; i < n; ++i) {
+        char32_t c = p[i].unicode();
+        if (QChar::isHighSurrogate(c) && i + 1 < n && p[i + 1].isLowSurrogate())
+            c = QChar::surrogateToUcs4(p[i], p[i + 1]), ++i;
+        else if (QChar::isSurrogate(c))
+            c = 0xFFFD;
+
+        const size_t bytes = c < 0x80 ? 1 : c < 0x800 ? 2 : c < 0x10000 ? 3 : 4;
+        if (length + bytes > capacity)
+            break;
+        char *o = out + length;
+        switch (bytes) {
+        case 1: o[0] = static_cast<char>(c); break;
+        case 2:
+            o[0] = static_cast<char>(0xC0 | (c >> 6));
+            o[1] = static_cast<char>(0x80 | (c & 0x3F));
+            break;
+        case 3:
+            o[0] = static_cast<char>(0xE0 | (c >> 12));
+            o[1] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            o[2] = static_cast<char>(0x80 | (c & 0x3F));
+            break;
+        default:
+            o[0] = static_cast<char>(0xF0 | (c >> 18));
+            o[1] = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            o[2] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            o[3] = static_cast<char>(0x80 | (c & 0x3F));
+            break;
+        }
+        length += bytes;
+    }
+    return static_cast<uint16_t>(length);
+}
+
+} // namespace
+
+NotificationCenter &NotificationCenter::global()
+{
+    static NotificationCenter center;
+    return center;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Any thread                                                               */
+/* ------------------------------------------------------------------------- */
+bool NotificationCenter::post(NotificationLevel level, const QString &text)
+{
+    Message m;
+    m.level  = level;
+    m.length = encodeUtf8(text, m.text, kTextBytes);
+    if (!ring_.push(m)) {
+        ringFull_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    posted_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+NotificationCenter::Stats NotificationCenter::stats() const
+{
+    Stats s;
+    s.posted    = posted_.load(std::memory_order_relaxed);
+    s.coalesced = coalesced_;
+    s.dropped   = ringFull_.load(std::memory_order_relaxed) + overflow_;
+    s.shown     = shown_;
+    return s;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  UI thread                                                                */
+/* ------------------------------------------------------------------------- */
+void NotificationCenter::install(QWidget *anchor, NotificationOptions options)
+{
+    if (timer_)
+        return;
+    options_    = options;
+    anchor_     = anchor;
+    tokens_     = options_.burst;
+    refilledAt_ = Clock::now();
+
+    auto *timer = new QTimer(anchor);
+    QObject::connect(timer, &QTimer::timeout, timer, [this]() { drain(); });
+    timer->start(static_cast<int>(options_.pollInterval.count()));
+    timer_ = timer;
+    drain();                        /* whatever was posted during startup */
+}
+
+void NotificationCenter::uninstall()
+{
+    delete timer_.data();           /* null if the anchor already took it down */
+    if (anchor_) {
+        for (Entry &entry : recent_)
+            delete entry.toast;
+    }
+    anchor_ = nullptr;
+    pending_.clear();
+    recent_.clear();
+}
+
+void NotificationCenter::drain()
+{
+    Message m;
+    while (ring_.pop(m)) {
+        Entry entry;
+        entry.level = m.level;
+        entry.text  = QString::fromUtf8(m.text, m.length);
+        admit(std::move(entry));
+    }
+
+    const auto now = Clock::now();
+    recent_.erase(std::remove_if(recent_.begin(), recent_.end(),
+                                 [&](const Entry &e) { return !e.toast && now - e.at >= options_.dedupWindow; }),
+                  recent_.end());
+
+    tokens_ = std::min<double>(options_.burst,
+                               tokens_ + std::chrono::duration<double>(now - refilledAt_) /
+                                             std::chrono::duration<double>(options_.refill));
+    refilledAt_ = now;
+
+    while (!pending_.empty() && tokens_ >= 1) {
+#if !PLAYFAME_HAVE_FRONTEND_NOTIFICATIONS
+        const auto visible = std::count_if(recent_.begin(), recent_.end(), [](const Entry &e) { return e.toast; });
+        if (visible >= options_.maxVisible)
+            break;                  /* waits for a toast to go away */
+#endif
+        tokens_ -= 1;
+        Entry entry = std::move(pending_.front());
+        pending_.pop_front();
+        show(std::move(entry));
+    }
+    PF_TRACE_COUNTER("notify.pending", static_cast<int64_t>(pending_.size()));
+}
+
+void NotificationCenter::admit(Entry entry)
+{
+    const auto same = [&](const Entry &e) { return e.level == entry.level && e.text == entry.text; };
+
+    /* already on screen, or shown a moment ago: count it there */
+    auto shown = std::find_if(recent_.rbegin(), recent_.rend(), same);
+    if (shown != recent_.rend()) {
+        ++coalesced_;
+        shown->count += entry.count;
+        shown->at     = Clock::now();
+        if (shown->toast) {
+            shown->toast->setText(label(*shown));
+            if (auto *hide = shown->toast->findChild<QTimer *>())
+                hide->start();      /* stays up as long as it keeps repeating */
+            layoutToasts();
+        }
+        return;
+    }
+
+    auto waiting = std::find_if(pending_.begin(), pending_.end(), same);
+    if (waiting != pending_.end()) {
+        ++coalesced_;
+        waiting->count += entry.count;
+        return;
+    }
+
+    pending_.push_back(std::move(entry));
+    if (pending_.size() > options_.maxPending) {
+        /* warnings outlive information */
+        auto victim = std::find_if(pending_.begin(), pending_.end(),
+                                   [](const Entry &e) { return e.level == NotificationLevel::Info; });
+        pending_.erase(victim != pending_.end() ? victim : pending_.begin());
+        ++overflow_;
+    }
+}
+
+QString NotificationCenter::label(const Entry &entry)
+{
+    return entry.count > 1 ? QStringLiteral("%1 (×%2)").arg(entry.text).arg(entry.count) : entry.text;
+}
+
+void NotificationCenter::show(Entry entry)
+{
+    ++shown_;
+    entry.at = Clock::now();
+    const bool warning = entry.level == NotificationLevel::Warning;
+    obs_log(warning ? LOG_WARNING : LOG_INFO, "[Notify] %s", entry.text.toUtf8().constData());
+
+#if PLAYFAME_HAVE_FRONTEND_NOTIFICATIONS
+    /* OBS shows and stacks these itself */
+    obs_frontend_push_ui_notification(warning ? OBS_FRONTEND_NOTIFICATION_WARNING : OBS_FRONTEND_NOTIFICATION_INFO,
+                                      label(entry).toUtf8().constData());
+#else
+    /* SDK build: an overlay label; never takes focus or mouse input */
+    if (anchor_) {
+        auto *toast = new QLabel(label(entry), anchor_);
+        toast->setWordWrap(true);
+        toast->setAttribute(Qt::WA_TransparentForMouseEvents);
+        toast->setMaximumWidth(std::max(200, anchor_->width() / 3));
+        toast->setStyleSheet(warning ? QStringLiteral("QLabel { background: rgba(120, 60, 0, 230); color: white;"
+                                                      " border-radius: 6px; padding: 8px 12px; }")
+                                     : QStringLiteral("QLabel { background: rgba(30, 30, 30, 230); color: white;"
+                                                      " border-radius: 6px; padding: 8px 12px; }"));
+
+        auto *hide = new QTimer(toast);
+        hide->setSingleShot(true);
+        hide->setInterval(static_cast<int>(options_.showFor.count()));
+        QObject::connect(hide, &QTimer::timeout, toast, [this, toast]() { removeToast(toast); });
+        hide->start();
+
+        entry.toast = toast;
+        toast->show();
+        toast->raise();
+    }
+#endif
+    recent_.push_back(std::move(entry));
+    layoutToasts();
+}
+
+void NotificationCenter::removeToast(QLabel *toast)
+{
+    for (Entry &entry : recent_) {
+        if (entry.toast == toast) {
+            entry.toast = nullptr;  /* stays in recent_ for the rest of dedupWindow */
+            entry.at    = Clock::now();
+        }
+    }
+    toast->deleteLater();
+    layoutToasts();
+}
+
+/* newest at the bottom-right corner, older ones stacked above it */
+void NotificationCenter::layoutToasts()
+{
+    if (!anchor_)
+        return;
+    int bottom = anchor_->height() - kToastMargin;
+    for (auto it = recent_.rbegin(); it != recent_.rend(); ++it) {
+        if (!it->toast)
+            continue;
+        it->toast->adjustSize();
+        bottom -= it->toast->height();
+        it->toast->move(anchor_->width() - kToastMargin - it->toast->width(), bottom);
+        bottom -= kToastSpacing;
+    }
+}
@@ -0,0 +1,132 @@
+/*!
+ * @file notification-center.h
+ * @brief Non-modal, coalescing user notifications that any thread may post.
+ *
+ * post() copies the message into a lock-free ring and returns; it never
+ * blocks, allocates or touches Qt. A timer on the UI thread drains the
+ * ring, folds repeats of a message into one notification, holds back
+ * bursts (token bucket) in a short queue and shows what is left either
+ * through obs_frontend_push_ui_notification() (where CMake finds it in
+ * obs-frontend-api, see PLAYFAME_HAVE_FRONTEND_NOTIFICATIONS) or as
+ * a small overlay in the corner of the OBS main window that goes away on
+ * its own. Nothing ever runs a nested event loop.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include "mpsc-ring.h"
+
+#include <QPointer>
+#include <QString>
+#include <QTimer>
+#include <QWidget>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+class QLabel;
+
+enum class NotificationLevel : uint8_t { Info, Warning };
+
+/**
+ * @brief Coalescing and rate limits of the NotificationCenter.
+ */
+struct NotificationOptions {
+    std::chrono::milliseconds dedupWindow{3000};    ///< Repeats of a shown message within this fold into it.
+    std::chrono::milliseconds refill{1000};         ///< One more notification may be shown per interval...
+    int                       burst      = 3;       ///< ...up to this many at once.
+    size_t                    maxPending = 8;       ///< Held back beyond that; the oldest info is dropped first.
+    int                       maxVisible = 3;       ///< Overlay toasts on screen at the same time.
+    std::chrono::milliseconds showFor{4000};        ///< How long an overlay toast stays up.
+    std::chrono::milliseconds pollInterval{100};    ///< How often the UI thread drains the ring.
+};
+
+/**
+ * @class NotificationCenter
+ * @brief Process-wide notification queue; see the file comment.
+ *
+ * install() and uninstall() run on the UI thread; post() runs anywhere.
+ * Messages posted before install() wait in the ring (up to its capacity).
+ */
+class NotificationCenter {
+public:
+    /// Counters for the log and the trace; read on the UI thread.
+    struct Stats {
+        uint64_t posted    = 0;   ///< Messages accepted by post().
+        uint64_t coalesced = 0;   ///< Folded into an identical pending or shown message.
+        uint64_t dropped   = 0;   ///< Lost to a full ring or a full pending queue.
+        uint64_t shown     = 0;
+    };
+
+    static NotificationCenter &global();
+
+    NotificationCenter(const NotificationCenter &) = delete;
+    NotificationCenter &operator=(const NotificationCenter &) = delete;
+
+    /// Starts draining on the UI thread; overlay toasts appear over @p anchor.
+    void install(QWidget *anchor, NotificationOptions options = {});
+
+    /// Stops draining and removes visible toasts. Pending messages are discarded.
+    void uninstall();
+
+    /// Any thread: queues @p text (truncated to kTextBytes of UTF-8). False if the ring is full.
+    bool post(NotificationLevel level, const QString &text);
+
+    Stats stats() const;
+
+    static constexpr size_t kTextBytes = 250;
+
+private:
+    NotificationCenter() = default;
+
+    /// What travels through the ring; plain bytes so producers never allocate.
+    struct Message {
+        NotificationLevel level = NotificationLevel::Info;
+        uint8_t           unused = 0;
+        uint16_t          length = 0;
+        char              text[kTextBytes];
+    };
+    static_assert(sizeof(Message) <= 256, "keep ring slots small");
+
+    /// A message waiting for the rate limit or on screen, with its repeat count.
+    struct Entry {
+        NotificationLevel                     level = NotificationLevel::Info;
+        QString                               text;
+        int                                   count = 1;
+        std::chrono::steady_clock::time_point at;      ///< When it was last shown or refreshed (recent_ only).
+        QLabel                               *toast = nullptr;
+    };
+
+    void drain();
+    void admit(Entry entry);
+    void show(Entry entry);
+    void layoutToasts();
+    void removeToast(QLabel *toast);
+    static QString label(const Entry &entry);
+
+    static constexpr size_t kRingMessages = 64;
+
+    MpscRing<Message, kRingMessages> ring_;
+    std::atomic<uint64_t>            posted_{0};
+    std::atomic<uint64_t>            ringFull_{0};
+
+    /* UI thread only ------------------------------------------------------- */
+    NotificationOptions                   options_;
+    QPointer<QWidget>                     anchor_;     ///< Owns timer_ and the toasts.
+    QPointer<QTimer>                      timer_;
+    std::deque<Entry>                     pending_;
+    std::vector<Entry>                    recent_;     ///< Shown within dedupWindow, newest last.
+    double                                tokens_ = 0;
+    std::chrono::steady_clock::time_point refilledAt_;
+    uint64_t                              coalesced_ = 0;
+    uint64_t                              overflow_  = 0;
+    uint64_t                              shown_     = 0;
+};
@@ -1,8 +1,14 @@
 // ──────────────────────────────  obs-config-helper.cpp  ───────────────────────────
 #include "obs-config-helper.h"
+#include "config-transaction.h"
+#include "config-binary-cache.h"
+#include "plugin-trace.h"
 #include <QDebug>
 #include <util/platform.h>
+#include <QFile>
 #include <QFileInfo>
+#include <algorithm>
+#include <cstring>
 
 static inline QString typeNameCompat(QMetaType::Type t)
 {
@@ -23,6 +29,352 @@ static inline bool canConvertCompat(const QVariant &v, QMetaType::Type t)
 #endif
 }
 
+/* ------------------------------------------------------------------------- */
+/*  COPY-ON-WRITE HELPERS                                                    */
+/* ------------------------------------------------------------------------- */
+/* Copies one user value into dst. Nested objects and arrays are shared,
+ * not copied: anything reachable from a snapshot is immutable. */
+static void shareItem(obs_data_t *dst, obs_data_item_t *item)
+{
+    const char *name = obs_data_item_get_name(item);
+    switch (obs_data_item_gettype(item)) {
+    case OBS_DATA_STRING:
+        obs_data_set_string(dst, name, obs_data_item_get_string(item));
+        break;
+    case OBS_DATA_NUMBER:
+        if (obs_data_item_numtype(item) == OBS_DATA_NUM_DOUBLE)
+            obs_data_set_double(dst, name, obs_data_item_get_double(item));
+        else
+            obs_data_set_int(dst, name, obs_data_item_get_int(item));
+        break;
+    case OBS_DATA_BOOLEAN:
+        obs_data_set_bool(dst, name, obs_data_item_get_bool(item));
+        break;
+    case OBS_DATA_OBJECT: {
+        obs_data_t *obj = obs_data_item_get_obj(item);
+        obs_data_set_obj(dst, name, obj);
+        obs_data_release(obj);
+        break;
+    }
+    case OBS_DATA_ARRAY: {
+        obs_data_array_t *arr = obs_data_item_get_array(item);
+        obs_data_set_array(dst, name, arr);
+        obs_data_array_release(arr);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+/* Copies every user value of src into dst, sharing nested data. */
+static void shareItems(obs_data_t *dst, obs_data_t *src)
+{
+    if (!src)
+        return;
+
+    for (obs_data_item_t *item = obs_data_first(src); item; obs_data_item_next(&item)) {
+        if (obs_data_item_has_user_value(item))
+            shareItem(dst, item);
+    }
+}
+
+static bool sameData(obs_data_t *a, obs_data_t *b);
+
+/* The item holding a user value under name, or null. */
+static obs_data_item_t *userItem(obs_data_t *obj, const char *name)
+{
+    obs_data_item_t *item = obj ? obs_data_item_byname(obj, name) : nullptr;
+    if (item && !obs_data_item_has_user_value(item))
+        obs_data_item_release(&item);
+    return item;
+}
+
+/* The object stored under name, or null if it is missing or not an object. */
+static obs_data_t *userObject(obs_data_t *obj, const char *name)
+{
+    obs_data_item_t *item = userItem(obj, name);
+    obs_data_t *out = item && obs_data_item_gettype(item) == OBS_DATA_OBJECT ? obs_data_item_get_obj(item) : nullptr;
+    obs_data_item_release(&item);
+    return out;
+}
+
+/* True if two items hold the same value. Nested data is compared by
+ * identity first (snapshots share untouched objects), then item by item:
+ * obs_data_get_json() would rewrite the JSON buffer of an object that other
+ * threads may be reading through a snapshot. */
+static bool sameItem(obs_data_item_t *a, obs_data_item_t *b)
+{
+    if (!a || !b)
+        return a == b;
+    if (obs_data_item_gettype(a) != obs_data_item_gettype(b))
+        return false;
+
+    switch (obs_data_item_gettype(a)) {
+    case OBS_DATA_STRING:
+        return !strcmp(obs_data_item_get_string(a), obs_data_item_get_string(b));
+    case OBS_DATA_NUMBER:
+        if (obs_data_item_numtype(a) != obs_data_item_numtype(b))
+            return false;
+        return obs_data_item_numtype(a) == OBS_DATA_NUM_DOUBLE
+                   ? obs_data_item_get_double(a) == obs_data_item_get_double(b)
+                   : obs_data_item_get_int(a) == obs_data_item_get_int(b);
+    case OBS_DATA_BOOLEAN:
+        return obs_data_item_get_bool(a) == obs_data_item_get_bool(b);
+    case OBS_DATA_OBJECT: {
+        obs_data_t *oa = obs_data_item_get_obj(a);
+        obs_data_t *ob = obs_data_item_get_obj(b);
+        const bool same = sameData(oa, ob);
+        obs_data_release(oa);
+        obs_data_release(ob);
+        return same;
+    }
+    case OBS_DATA_ARRAY: {
+        obs_data_array_t *aa = obs_data_item_get_array(a);
+        obs_data_array_t *ab = obs_data_item_get_array(b);
+        bool same = aa == ab;
+        if (!same && obs_data_array_count(aa) == obs_data_array_count(ab)) {
+            same = true;
+            for (size_t i = 0; same && i < obs_data_array_count(aa); ++i) {
+                obs_data_t *ea = obs_data_array_item(aa, i);
+                obs_data_t *eb = obs_data_array_item(ab, i);
+                same = sameData(ea, eb);
+                obs_data_release(ea);
+                obs_data_release(eb);
+            }
+        }
+        obs_data_array_release(aa);
+        obs_data_array_release(ab);
+        return same;
+    }
+    default:
+        return true;
+    }
+}
+
+/* True if two objects hold the same user values, in any order. */
+static bool sameData(obs_data_t *a, obs_data_t *b)
+{
+    if (a == b)
+        return true;
+    if (!a || !b)
+        return false;
+
+    size_t count = 0;
+    for (obs_data_item_t *item = obs_data_first(a); item; obs_data_item_next(&item)) {
+        if (!obs_data_item_has_user_value(item))
+            continue;
+        ++count;
+        obs_data_item_t *other = userItem(b, obs_data_item_get_name(item));
+        const bool same = other && sameItem(item, other);
+        obs_data_item_release(&other);
+        if (!same) {
+            obs_data_item_release(&item);
+            return false;
+        }
+    }
+    for (obs_data_item_t *item = obs_data_first(b); item; obs_data_item_next(&item)) {
+        if (obs_data_item_has_user_value(item) && count-- == 0) {
+            obs_data_item_release(&item);
+            return false;           /* b has a key a lacks */
+        }
+    }
+    return count == 0;
+}
+
+/* Records every key whose value differs between two versions of a section. */
+static void diffSection(ConfigNotifier &notifier, uint32_t section, obs_data_t *before, obs_data_t *after,
+                        uint64_t version)
+{
+    if (before == after)
+        return;                     /* shared, hence unchanged */
+
+    if (after) {
+        for (obs_data_item_t *item = obs_data_first(after); item; obs_data_item_next(&item)) {
+            if (!obs_data_item_has_user_value(item))
+                continue;
+            const char *name = obs_data_item_get_name(item);
+            obs_data_item_t *old = userItem(before, name);
+            if (!sameItem(old, item))
+                notifier.record(section, QByteArray(name), version);
+            obs_data_item_release(&old);
+        }
+    }
+    if (before) {
+        for (obs_data_item_t *item = obs_data_first(before); item; obs_data_item_next(&item)) {
+            if (!obs_data_item_has_user_value(item))
+                continue;
+            const char *name = obs_data_item_get_name(item);
+            obs_data_item_t *now = userItem(after, name);
+            if (!now)               /* removed */
+                notifier.record(section, QByteArray(name), version);
+            obs_data_item_release(&now);
+        }
+    }
+}
+
+/* What reload() has to do to one section to make the live data match a file. */
+struct SectionDelta {
+    QByteArray              name;
+    obs_data_t             *file    = nullptr;   /* borrowed from the file root; null if the section is gone */
+    bool                    replace = false;     /* no live section: share the parsed one as is */
+    std::vector<QByteArray> changed;
+    std::vector<QByteArray> removed;
+};
+
+/* Keys of after that differ from before, then keys of before that after
+ * lacks. A rewritten file usually keeps the key order, so both sections are
+ * walked in step and only keys out of step are looked up by name. */
+static void diffKeys(obs_data_t *before, obs_data_t *after, SectionDelta &delta)
+{
+    obs_data_item_t *peer   = obs_data_first(before);
+    size_t           inStep = 0;
+
+    for (obs_data_item_t *key = obs_data_first(after); key; obs_data_item_next(&key)) {
+        if (!obs_data_item_has_user_value(key))
+            continue;
+        const char *name = obs_data_item_get_name(key);
+        while (peer && !obs_data_item_has_user_value(peer))
+            obs_data_item_next(&peer);
+
+        if (peer && !strcmp(obs_data_item_get_name(peer), name)) {
+            if (!sameItem(peer, key))
+                delta.changed.emplace_back(name);
+            ++inStep;
+            obs_data_item_next(&peer);
+            continue;
+        }
+        obs_data_item_t *old = userItem(before, name);
+        if (!sameItem(old, key))
+            delta.changed.emplace_back(name);
+        obs_data_item_release(&old);
+    }
+    obs_data_item_release(&peer);
+
+    /* keys are unique, so if every live key was met in step none is gone */
+    size_t liveKeys = 0;
+    for (obs_data_item_t *key = obs_data_first(before); key; obs_data_item_next(&key))
+        liveKeys += obs_data_item_has_user_value(key) ? 1 : 0;
+    if (inStep == liveKeys)
+        return;
+
+    peer = obs_data_first(after);
+    for (obs_data_item_t *key = obs_data_first(before); key; obs_data_item_next(&key)) {
+        if (!obs_data_item_has_user_value(key))
+            continue;
+        const char *name = obs_data_item_get_name(key);
+        while (peer && !obs_data_item_has_user_value(peer))
+            obs_data_item_next(&peer);
+
+        if (peer && !strcmp(obs_data_item_get_name(peer), name)) {
+            obs_data_item_next(&peer);
+            continue;
+        }
+        obs_data_item_t *now = userItem(after, name);
+        if (!now)
+            delta.removed.emplace_back(name);
+        obs_data_item_release(&now);
+    }
+    obs_data_item_release(&peer);
+}
+
+/* Structural diff of two roots, one level deep: sections, then their keys.
+ * Only object items at the top level are sections; anything else in the
+ * file is ignored. Nested values are compared with sameItem(). With
+ * keepMissing, sections the file lacks are left alone instead of dropped. */
+static std::vector<SectionDelta> diffRoots(obs_data_t *live, obs_data_t *file, bool keepMissing)
+{
+    std::vector<SectionDelta> deltas;
+
+    for (obs_data_item_t *item = obs_data_first(file); item; obs_data_item_next(&item)) {
+        if (!obs_data_item_has_user_value(item) || obs_data_item_gettype(item) != OBS_DATA_OBJECT)
+            continue;
+
+        SectionDelta delta;
+        delta.name = QByteArray(obs_data_item_get_name(item));
+        delta.file = obs_data_item_get_obj(item);
+        obs_data_release(delta.file);               /* the file root keeps it alive */
+
+        obs_data_t *before = userObject(live, delta.name.constData());
+        delta.replace = !before;
+        if (before && before != delta.file) {
+            diffKeys(before, delta.file, delta);
+        } else if (!before) {
+            for (obs_data_item_t *key = obs_data_first(delta.file); key; obs_data_item_next(&key)) {
+                if (obs_data_item_has_user_value(key))
+                    delta.changed.emplace_back(obs_data_item_get_name(key));
+            }
+        }
+        obs_data_release(before);
+
+        if (delta.replace || !delta.changed.empty() || !delta.removed.empty())
+            deltas.push_back(std::move(delta));
+    }
+
+    if (keepMissing)
+        return deltas;
+
+    /* sections the file no longer has */
+    for (obs_data_item_t *item = obs_data_first(live); item; obs_data_item_next(&item)) {
+        if (!obs_data_item_has_user_value(item) || obs_data_item_gettype(item) != OBS_DATA_OBJECT)
+            continue;
+        const char *name = obs_data_item_get_name(item);
+        obs_data_t *after = userObject(file, name);
+        if (after) {
+            obs_data_release(after);
+            continue;
+        }
+
+        SectionDelta delta;
+        delta.name = QByteArray(name);
+        obs_data_t *before = obs_data_item_get_obj(item);
+        for (obs_data_item_t *key = obs_data_first(before); key; obs_data_item_next(&key)) {
+            if (obs_data_item_has_user_value(key))
+                delta.removed.emplace_back(obs_data_item_get_name(key));
+        }
+        obs_data_release(before);
+        deltas.push_back(std::move(delta));
+    }
+    return deltas;
+}
+
+static uint64_t elapsedUs(std::chrono::steady_clock::time_point start)
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                     std::chrono::steady_clock::now() - start).count());
+}
+
+/* Parses the JSON at path, or its .bak if that fails. hash receives the hash
+ * of the file's own bytes (0 if it cannot be read), which is what the
+ * journal continues from. */
+static obs_data_t *parseJson(const QByteArray &path, uint64_t &hash, bool &fromBackup)
+{
+    QFile      file(QString::fromUtf8(path));
+    QByteArray bytes;
+    hash = 0;
+    if (file.open(QIODevice::ReadOnly)) {
+        bytes = file.readAll();
+        hash  = ConfigBinaryView::checksum(reinterpret_cast<const uint8_t *>(bytes.constData()),
+                                             static_cast<size_t>(bytes.size()));
+    }
+
+    obs_data_t *root = bytes.isEmpty() ? nullptr : obs_data_create_from_json(bytes.constData());
+    fromBackup = false;
+    if (!root) {
+        const QByteArray backup = path + ".bak";
+        root = obs_data_create_from_json_file(backup.constData());
+        fromBackup = root != nullptr;
+    }
+    return root;
+}
+
+static void destroySnapshot(void *ptr)
+{
+    auto *snapshot = static_cast<ConfigSnapshot *>(ptr);
+    obs_data_release(snapshot->root);
+    delete snapshot;
+}
+
 OBSConfigHelper::OBSConfigHelper(const char *configFile)
 {
     /* 31.x way: resolve per-module config path (must free with bfree) */
@@ -35,13 +387,36 @@ OBSConfigHelper::OBSConfigHelper(const char *configFile)
     os_mkdirs(dirUtf8.constData());                      // util/platform.h
 
     
-    configData = obs_data_create();   // start empty until load() is called
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        publish(obs_data_create());   // start empty until load() is called
+    }
+
+    /* schema sections get fixed indices, so fields need no interning */
+    for (const char *name : ConfigSchema::kSections)
+        internSection(QByteArray(name));
     qDebug() << "[OBSConfigHelper] Using config file:" << configFilePath;
+
+    /* writes happen in the writer, from snapshots only */
+    const QByteArray pathUtf8 = configFilePath.toUtf8();
+    cacheFilePath   = pathUtf8 + ".bin";
+    journalFilePath = pathUtf8 + ".journal";
+    writer = std::make_unique<ConfigWriter>([this](obs_data_t *snapshot, uint64_t version) {
+        /* journal mode: append the delta until the journal is due for compaction */
+        const std::shared_ptr<ConfigJournal> active = currentJournal();
+        if (active && !active->needsCompaction())
+            return active->sync();
+        return writeSnapshot(snapshot, version, active.get());
+    });
 }
 
 OBSConfigHelper::~OBSConfigHelper()
 {
-    obs_data_release(configData);
+    writer.reset();                 /* writes anything still pending */
+
+    /* stray readers may still hold it; let the epoch domain decide */
+    EpochDomain::global().retire(const_cast<ConfigSnapshot *>(current.exchange(nullptr)),
+                                 destroySnapshot);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -49,26 +424,346 @@ OBSConfigHelper::~OBSConfigHelper()
 /* ------------------------------------------------------------------------- */
 bool OBSConfigHelper::load()
 {
-    obs_data_release(configData);  /* drop any previous data */
-    configData = obs_data_create_from_json_file_safe(
-        configFilePath.toUtf8().constData(), ".bak");
+    PF_TRACE_SCOPE("config.load");
+    const QByteArray pathUtf8 = configFilePath.toUtf8();
+    const auto start = std::chrono::steady_clock::now();
+
+    /* parse outside the lock; readers keep using the old snapshot meanwhile */
+    uint64_t    jsonHash = 0;
+    obs_data_t *root = ConfigBinaryCache::load(cacheFilePath.constData(), pathUtf8.constData(), &jsonHash);
+    const bool fromCache = root != nullptr;
+
+    if (!root) {
+        bool fromBackup;
+        root = parseJson(pathUtf8, jsonHash, fromBackup);
+    }
 
-    if (!configData)               /* corrupted or first run */
-        configData = obs_data_create();
+    lastLoad.fromCache  = fromCache;
+    lastLoad.durationUs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                              std::chrono::steady_clock::now() - start).count());
 
-    return configData != nullptr;
+    if (!root)                     /* corrupted or first run */
+        root = obs_data_create();
+    else if (!fromCache && writer) {
+        /* cold start: build the sidecar off-thread for the next start */
+        obs_data_addref(root);
+        writer->schedule([root, pathUtf8, cachePath = cacheFilePath]() {
+            ConfigBinaryCache::store(cachePath.constData(), pathUtf8.constData(), root);
+            obs_data_release(root);
+        });
+    }
+
+    root = replayJournal(root, jsonHash);
+
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+
+        /* notify only what differs from the data readers saw before */
+        const ConfigSnapshot *previous = current.load();
+        for (uint32_t i = 0; i < sectionNames.size(); ++i) {
+            obs_data_t *after = obs_data_get_obj(root, sectionNames[i].constData());
+            diffSection(notifier, i, previous->section(i), after, previous->version + 1);
+            obs_data_release(after);
+        }
+        publish(root);
+        loadedOnce = true;
+    }
+    notifier.dispatch();
+    return true;
+}
+
+/* Applies the journal on top of freshly loaded data whose JSON hashes to
+ * jsonHash. The loaded root may be shared with the sidecar task, so touched
+ * sections are copied, as in set(). readOnly leaves the journal alone, for a
+ * reload while the writer owns it. Takes ownership of root and returns the
+ * root to publish. */
+std::shared_ptr<ConfigJournal> OBSConfigHelper::currentJournal() const
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+    return journal;
+}
+
+obs_data_t *OBSConfigHelper::replayJournal(obs_data_t *root, uint64_t jsonHash, bool readOnly)
+{
+    const std::shared_ptr<ConfigJournal> active = currentJournal();
+    const int64_t legacy = obs_data_get_int(root, ConfigJournal::kGenerationKey);   /* 0 if never compacted */
+    obs_data_t *merged = obs_data_create();
+    shareItems(merged, root);
+    obs_data_erase(merged, ConfigJournal::kGenerationKey);
+
+    std::vector<std::pair<QByteArray, obs_data_t *>> touched;
+    auto apply = [&](const QByteArray &section, const QByteArray &key, const ConfigValue &value) {
+        auto it = std::find_if(touched.begin(), touched.end(),
+                               [&](const auto &entry) { return entry.first == section; });
+        if (it == touched.end()) {
+            obs_data_t *copy = obs_data_create();
+            obs_data_t *src  = obs_data_get_obj(root, section.constData());
+            shareItems(copy, src);
+            obs_data_release(src);
+            it = touched.insert(touched.end(), {section, copy});
+        }
+        config_detail::writeValue(it->second, key.constData(), value);
+    };
+
+    /* outside journal mode a leftover journal is still honoured; the next save folds it in */
+    size_t applied;
+    if (active) {
+        applied = readOnly ? active->read(jsonHash, apply, legacy) : active->replay(jsonHash, apply, legacy);
+    } else {
+        ConfigJournal leftover(journalFilePath, 0);
+        applied = readOnly ? leftover.read(jsonHash, apply, legacy) : leftover.replay(jsonHash, apply, legacy);
+    }
+
+    for (auto &[name, obj] : touched) {
+        obs_data_set_obj(merged, name.constData(), obj);
+        obs_data_release(obj);
+    }
+    obs_data_release(root);
+
+    if (applied)
+        qDebug() << "[OBSConfigHelper] Replayed" << applied << "journal records";
+    return merged;
+}
+
+ConfigReloadStats OBSConfigHelper::reload()
+{
+    PF_TRACE_SCOPE("config.reload");
+    ConfigReloadStats stats;
+    const QByteArray pathUtf8 = configFilePath.toUtf8();
+    const auto start = std::chrono::steady_clock::now();
+
+    /* no lock while parsing; readers and writers carry on */
+    stats.stamp = ConfigBinaryCache::stampOf(pathUtf8.constData());
+    uint64_t    jsonHash = 0;
+    obs_data_t *root = parseJson(pathUtf8, jsonHash, stats.fromBackup);
+    if (!root) {
+        stats.parseUs = elapsedUs(start);
+        qWarning() << "[OBSConfigHelper] Reload: neither" << configFilePath
+                   << "nor its .bak parses; keeping live data";
+        return stats;
+    }
+
+    /* a JSON the journal does not continue was written by someone else; the
+     * journal then no longer describes what is on disk */
+    const std::shared_ptr<ConfigJournal> active = currentJournal();
+    const bool foreign = active && !active->continues(jsonHash);
+    root = replayJournal(root, jsonHash, true);
+    stats.parseUs = elapsedUs(start);
+
+    const uint64_t version = applyFileRoot(root, stats);
+    obs_data_release(root);
+    if (foreign)
+        active->requireSnapshot(std::max<uint64_t>(version, 1));
+    stats.ok = true;
+    return stats;
+}
+
+ConfigReloadStats OBSConfigHelper::applySections(obs_data_t *sections)
+{
+    PF_TRACE_SCOPE("config.apply_sections");
+    ConfigReloadStats stats;
+    if (!sections)
+        return stats;
+    const uint64_t version = applyFileRoot(sections, stats, true);
+    const std::shared_ptr<ConfigJournal> active = currentJournal();
+    if (version && active)
+        active->requireSnapshot(version);   /* the live data no longer matches JSON + journal */
+    stats.ok = true;
+    return stats;
+}
+
+/* Publishes the live data patched to match fileRoot, in one snapshot. The
+ * diff runs against a pinned snapshot outside the lock; if a writer got in
+ * meanwhile it is redone under the lock, so no concurrent write is lost.
+ * Returns the published version, or 0 if nothing differed. */
+uint64_t OBSConfigHelper::applyFileRoot(obs_data_t *fileRoot, ConfigReloadStats &stats, bool keepMissing)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::vector<SectionDelta> deltas;
+    uint64_t diffedVersion = 0;
+    uint64_t published     = 0;
+    {
+        ConfigReader pinned = reader();
+        diffedVersion = pinned.version();
+        deltas = diffRoots(pinned.snapshot()->root, fileRoot, keepMissing);
+    }
+    stats.diffUs = elapsedUs(start);
+
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+
+        const ConfigSnapshot *previous = current.load();
+        if (previous->version != diffedVersion) {
+            start = std::chrono::steady_clock::now();
+            deltas = diffRoots(previous->root, fileRoot, keepMissing);
+            stats.rediffed = true;
+            stats.diffUs += elapsedUs(start);
+        }
+
+        start = std::chrono::steady_clock::now();
+        if (!deltas.empty()) {
+            obs_data_t *root = obs_data_create();
+            shareItems(root, previous->root);
+            const uint64_t version = previous->version + 1;
+
+            for (const SectionDelta &delta : deltas) {
+                const char *name = delta.name.constData();
+                if (!delta.file) {
+                    obs_data_erase(root, name);
+                } else if (delta.replace) {
+                    obs_data_set_obj(root, name, delta.file);
+                } else {
+                    /* untouched keys keep sharing their values with the live section */
+                    obs_data_t *patched = obs_data_create();
+                    obs_data_t *live    = userObject(previous->root, name);
+                    shareItems(patched, live);
+                    obs_data_release(live);
+                    for (const QByteArray &key : delta.changed) {
+                        obs_data_item_t *item = obs_data_item_byname(delta.file, key.constData());
+                        shareItem(patched, item);
+                        obs_data_item_release(&item);
+                    }
+                    for (const QByteArray &key : delta.removed)
+                        obs_data_erase(patched, key.constData());
+                    obs_data_set_obj(root, name, patched);
+                    obs_data_release(patched);
+                }
+
+                stats.changed += delta.changed.size();
+                stats.removed += delta.removed.size();
+
+                /* only interned sections can have subscribers */
+                const auto interned = std::find(sectionNames.begin(), sectionNames.end(), delta.name);
+                if (interned == sectionNames.end())
+                    continue;
+                const auto section = static_cast<uint32_t>(interned - sectionNames.begin());
+                for (const QByteArray &key : delta.changed)
+                    notifier.record(section, key, version);
+                for (const QByteArray &key : delta.removed)
+                    notifier.record(section, key, version);
+            }
+            stats.sections = deltas.size();
+            publish(root);
+            published = version;
+        }
+        stats.applyUs = elapsedUs(start);
+    }
+    notifier.dispatch();
+    return published;
+}
+
+/* Full save of one snapshot. Runs in the writer, on an executor worker. */
+bool OBSConfigHelper::writeSnapshot(obs_data_t *snapshot, uint64_t version, ConfigJournal *active)
+{
+    PF_TRACE_SCOPE("config.write_snapshot");
+    const QByteArray pathUtf8 = configFilePath.toUtf8();
+
+    /* A compaction drops the old journal, so the JSON must hold every record
+     * already synced to it. Those can be newer than a snapshot that waited
+     * behind a sync; the newest published data always holds them. */
+    obs_data_t *out = snapshot;
+    obs_data_addref(out);
+    if (active) {
+        ConfigReader latest = reader();
+        if (latest.version() > version) {
+            obs_data_release(out);
+            out     = latest.snapshot()->root;
+            version = latest.version();
+            obs_data_addref(out);   /* immutable, as in save() */
+        }
+    }
+
+    const bool ok = obs_data_save_json_safe(out, pathUtf8.constData(),
+                                            ".tmp",   /* temp extension */
+                                            ".bak");  /* backup extension */
+    if (ok) {
+        const ConfigFileStamp stamp = ConfigBinaryCache::stampOf(pathUtf8.constData());
+        {
+            std::lock_guard<std::mutex> lock(stampMutex);
+            writtenStamp = stamp;
+        }
+        const int64_t bytes = std::max<int64_t>(0, stamp.size);
+        ++snapshotWrites;
+        snapshotBytes += static_cast<uint64_t>(bytes);
+        PF_TRACE_COUNTER("config.snapshot_bytes", bytes);
+
+        /* the sidecar is only an accelerator; failing to write it is harmless */
+        ConfigBinaryCache::store(cacheFilePath.constData(), pathUtf8.constData(), out);
+
+        /* the new journal continues from exactly these bytes */
+        uint64_t jsonHash = 0;
+        if (active && ConfigBinaryCache::hashOf(pathUtf8.constData(), jsonHash))
+            active->compact(version, jsonHash);
+        else if (active)
+            active->requireSnapshot(version);   /* unreadable right after writing: retry next save */
+        else
+            ConfigJournal::discard(journalFilePath);  /* fully contained in the JSON now */
+    }
+
+    obs_data_release(out);
+    return ok;
+}
+
+ConfigFileStamp OBSConfigHelper::lastWrittenStamp() const
+{
+    std::lock_guard<std::mutex> lock(stampMutex);
+    return writtenStamp;
 }
 
 bool OBSConfigHelper::save()
 {
-    if (!configData)
+    PF_TRACE_SCOPE("config.save");
+    if (!writer)
         return false;
 
-    return obs_data_save_json_safe(
-        configData,
-        configFilePath.toUtf8().constData(),
-        ".tmp",   /* temp extension */
-        ".bak");  /* backup extension */
+    obs_data_t *root = nullptr;
+    uint64_t version = 0;
+    {
+        ConfigReader snapshot = reader();
+        root    = snapshot.snapshot()->root;
+        version = snapshot.version();
+        obs_data_addref(root);     /* immutable: the writer can share it */
+    }
+    writer->submit(root, version);
+    return true;
+}
+
+bool OBSConfigHelper::flush(std::chrono::milliseconds timeout)
+{
+    return writer ? writer->flush(timeout) : true;
+}
+
+void OBSConfigHelper::setSaveCoalesceWindow(std::chrono::milliseconds window)
+{
+    if (writer)
+        writer->setCoalesceWindow(window);
+}
+
+ConfigSaveStats OBSConfigHelper::saveStats() const
+{
+    return writer ? writer->stats() : ConfigSaveStats();
+}
+
+void OBSConfigHelper::setJournalMode(bool enabled, size_t compactThresholdBytes)
+{
+    /* a write in flight keeps its own reference to the old journal */
+    std::shared_ptr<ConfigJournal> created;
+    if (enabled)
+        created = std::make_shared<ConfigJournal>(journalFilePath, compactThresholdBytes);
+
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (created && loadedOnce)
+        created->requireSnapshot(current.load()->version);   /* nothing on disk for it to continue yet */
+    journal = std::move(created);
+}
+
+ConfigIoStats OBSConfigHelper::ioStats() const
+{
+    const std::shared_ptr<ConfigJournal> active = currentJournal();
+    ConfigIoStats stats = active ? active->stats() : ConfigIoStats();
+    stats.snapshotWrites = snapshotWrites.load();
+    stats.snapshotBytes  = snapshotBytes.load();
+    return stats;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -78,55 +773,33 @@ bool OBSConfigHelper::setValue(const QString &section, const QString &key,
                                const QVariant &value, QMetaType::Type type,
                                const QVariant &min, const QVariant &max)
 {
-    if (!configData)
-        return false;
-
     if (!validate(value, type, min, max))
         return false;
 
-    /* grab (or lazily create) the section object --------------------------- */
-    obs_data_t *sectionObj   = obs_data_get_obj(configData, section.toUtf8().constData());
-    bool        newSection   = (sectionObj == nullptr);
+    const ConfigKey handle = this->key(section, key);
 
-    if (newSection)          // create a blank one if the section didn't exist
-        sectionObj = obs_data_create();
-
-    /* --------------------------------------------------------------------- */
-    /*  write the key *before* attaching the section to the parent           */
-    /* --------------------------------------------------------------------- */
     switch (type) {
-    case QMetaType::Int:      obs_data_set_int   (sectionObj, key.toUtf8().constData(), value.toInt());        break;
-    case QMetaType::LongLong: obs_data_set_int   (sectionObj, key.toUtf8().constData(), value.toLongLong());   break;
-    case QMetaType::Double:   obs_data_set_double(sectionObj, key.toUtf8().constData(), value.toDouble());     break;
-    case QMetaType::Bool:     obs_data_set_bool  (sectionObj, key.toUtf8().constData(), value.toBool());       break;
-    case QMetaType::QString:  obs_data_set_string(sectionObj, key.toUtf8().constData(),
-                                                 value.toString().toUtf8().constData());                      break;
+    case QMetaType::Int:      return set(handle, value.toInt());
+    case QMetaType::LongLong: return set(handle, value.toLongLong());
+    case QMetaType::Double:   return set(handle, value.toDouble());
+    case QMetaType::Bool:     return set(handle, value.toBool());
+    case QMetaType::QString:  return set(handle, value.toString());
     case QMetaType::QByteArray:
-        obs_data_set_string(sectionObj, key.toUtf8().constData(),
-                            value.toByteArray().constData());
-        break;
+        return set<const char *>(handle, value.toByteArray().constData());
     default:
         qWarning().nospace() << "[OBSConfigHelper] Unsupported type for "
                              << key << " -> " << typeNameCompat(type);
-        obs_data_release(sectionObj);
         return false;
     }
-
-    /* attach (or re-attach) the fully-populated section ------------------- */
-    obs_data_set_obj(configData, section.toUtf8().constData(), sectionObj);
-    obs_data_release(sectionObj);     // balance our ref
-    return true;
-
 }
 
 QVariant OBSConfigHelper::getValue(const QString &section, const QString &key,
                                    const QVariant &def) const
 {
-    if (!configData)
-        return def;
+    ConfigReader snapshot = reader();
 
     obs_data_t *sectionObj =
-        obs_data_get_obj(configData, section.toUtf8().constData());
+        obs_data_get_obj(snapshot.snapshot()->root, section.toUtf8().constData());
 
     if (!sectionObj)
         return def;
@@ -148,6 +821,124 @@ QVariant OBSConfigHelper::getValue(const QString &section, const QString &key,
     return out.isValid() ? out : def;
 }
 
+/* ------------------------------------------------------------------------- */
+/*  PRE-RESOLVED KEY HANDLES                                                 */
+/* ------------------------------------------------------------------------- */
+ConfigKey OBSConfigHelper::key(const char *section, const char *key)
+{
+    ConfigKey handle;
+    handle.section = internSection(QByteArray(section ? section : ""));
+    handle.name    = QByteArray(key ? key : "");
+    return handle;
+}
+
+ConfigKey OBSConfigHelper::key(const QString &section, const QString &key)
+{
+    ConfigKey handle;
+    handle.section = internSection(section.toUtf8());
+    handle.name    = key.toUtf8();
+    return handle;
+}
+
+uint32_t OBSConfigHelper::internSection(const QByteArray &name)
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+
+    for (size_t i = 0; i < sectionNames.size(); ++i) {
+        if (sectionNames[i] == name)
+            return static_cast<uint32_t>(i);
+    }
+
+    sectionNames.push_back(name);
+
+    /* republish the same data so the new index resolves for readers */
+    obs_data_t *root = current.load()->root;
+    obs_data_addref(root);
+    publish(root);
+    return static_cast<uint32_t>(sectionNames.size() - 1);
+}
+
+/* Private, writable copy of one section. Caller holds writeMutex. */
+obs_data_t *OBSConfigHelper::copySection(uint32_t section) const
+{
+    const ConfigSnapshot *snapshot = current.load();
+    if (section >= sectionNames.size())
+        return nullptr;
+
+    obs_data_t *copy = obs_data_create();
+    shareItems(copy, snapshot->section(section));
+    return copy;
+}
+
+void OBSConfigHelper::publishSection(uint32_t section, obs_data_t *sectionObj)
+{
+    publishSections(&section, &sectionObj, 1);
+}
+
+/* Swaps sections into a new root that shares all other sections, and
+ * publishes it as one snapshot. Takes ownership of sectionObjs. Caller
+ * holds writeMutex. */
+void OBSConfigHelper::publishSections(const uint32_t *sections, obs_data_t *const *sectionObjs, size_t count)
+{
+    obs_data_t *root = obs_data_create();
+    shareItems(root, current.load()->root);
+    for (size_t i = 0; i < count; ++i) {
+        obs_data_set_obj(root, sectionNames[sections[i]].constData(), sectionObjs[i]);
+        obs_data_release(sectionObjs[i]);
+    }
+    publish(root);
+}
+
+/* ------------------------------------------------------------------------- */
+/*  CHANGE NOTIFICATION                                                      */
+/* ------------------------------------------------------------------------- */
+uint64_t OBSConfigHelper::subscribe(const ConfigKey &key, QObject *context, ConfigChangeFn fn)
+{
+    return notifier.subscribe(ConfigNotifier::Scope::Key, key.section, key.name, context, std::move(fn));
+}
+
+uint64_t OBSConfigHelper::subscribeSection(const QString &section, QObject *context, ConfigChangeFn fn)
+{
+    return notifier.subscribe(ConfigNotifier::Scope::Section, internSection(section.toUtf8()), QByteArray(),
+                              context, std::move(fn));
+}
+
+uint64_t OBSConfigHelper::subscribePrefix(const QString &section, const QString &keyPrefix, QObject *context,
+                                          ConfigChangeFn fn)
+{
+    return notifier.subscribe(ConfigNotifier::Scope::Prefix, internSection(section.toUtf8()), keyPrefix.toUtf8(),
+                              context, std::move(fn));
+}
+
+void OBSConfigHelper::unsubscribe(uint64_t id)
+{
+    notifier.unsubscribe(id);
+}
+
+ConfigTransaction OBSConfigHelper::begin()
+{
+    return ConfigTransaction(this);
+}
+
+/* Takes ownership of root. Caller holds writeMutex. */
+void OBSConfigHelper::publish(obs_data_t *root)
+{
+    const ConfigSnapshot *previous = current.load();
+
+    auto *snapshot    = new ConfigSnapshot;
+    snapshot->root    = root;
+    snapshot->version = previous ? previous->version + 1 : 1;
+    snapshot->sections.reserve(sectionNames.size());
+    for (const QByteArray &name : sectionNames) {
+        obs_data_t *obj = obs_data_get_obj(root, name.constData());
+        obs_data_release(obj);     /* borrowed: root keeps it alive */
+        snapshot->sections.push_back(obj);
+    }
+
+    current.store(snapshot, std::memory_order_seq_cst);
+    EpochDomain::global().retire(const_cast<ConfigSnapshot *>(previous), destroySnapshot);
+}
+
 // -------------------------------------------------------------------------
 //  validate()  –  Qt 6-clean
 // -------------------------------------------------------------------------
@@ -1,15 +1,229 @@
 #pragma once
 
 #include <obs-module.h>
+#include "config-binary-cache.h"
+#include "config-epoch.h"
+#include "config-journal.h"
+#include "config-notifier.h"
+#include "config-schema.h"
+#include "config-writer.h"
+#include <QByteArray>
 #include <QString>
 #include <QVariant>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
 // #include <QMap> // QMap is not used in the current implementation, can be removed
 
+class ConfigTransaction;
+
+/**
+ * @brief Pre-resolved handle for a single configuration key.
+ *
+ * Obtained once from OBSConfigHelper::key() and then passed to the typed
+ * get()/set() overloads. The section is interned inside the helper and the
+ * key name is kept as UTF-8, so lookups through a handle do no string
+ * conversion. Reading a bool or number through one allocates nothing;
+ * writes do, see set(). Handles stay valid across load().
+ */
+struct ConfigKey {
+    uint32_t   section = UINT32_MAX; ///< Index of the interned section.
+    QByteArray name;                 ///< UTF-8 encoded key name.
+
+    bool isValid() const { return section != UINT32_MAX; }
+
+    /// Handle for a schema field; schema sections are interned first, in order.
+    static ConfigKey fromSchema(uint32_t section, const char *key)
+    {
+        ConfigKey handle;
+        handle.section = section;
+        handle.name    = QByteArray::fromRawData(key, static_cast<qsizetype>(std::char_traits<char>::length(key)));
+        return handle;
+    }
+};
+
+/**
+ * @brief How the most recent load() obtained its data.
+ */
+struct ConfigLoadStats {
+    bool     fromCache  = false; ///< Rebuilt from the binary sidecar instead of parsing JSON.
+    uint64_t durationUs = 0;     ///< Wall time of the read/parse step.
+};
+
+/**
+ * @brief What the most recent reload() changed and where the time went.
+ */
+struct ConfigReloadStats {
+    bool     ok         = false; ///< A parsed document was applied (possibly with no changes).
+    bool     fromBackup = false; ///< The JSON did not parse; "<config>.bak" was used instead.
+    bool     rediffed   = false; ///< A write raced the diff, so it was redone under the lock.
+    uint64_t parseUs    = 0;     ///< Reading and parsing the file, journal replay included.
+    uint64_t diffUs     = 0;     ///< Structural comparison with the live snapshot.
+    uint64_t applyUs    = 0;     ///< Building and publishing the patched snapshot.
+    size_t   changed    = 0;     ///< Keys added or modified.
+    size_t   removed    = 0;     ///< Keys no longer in the file.
+    size_t   sections   = 0;     ///< Sections touched.
+    ConfigFileStamp stamp;       ///< Size and mtime of the file that was parsed.
+};
+
+/**
+ * @brief Immutable, versioned view of the whole configuration.
+ *
+ * OBSConfigHelper publishes a new snapshot for every change (copy-on-write,
+ * untouched sections are shared) and never modifies one after publishing.
+ * Retired snapshots are freed through EpochDomain once no reader holds them.
+ */
+struct ConfigSnapshot {
+    obs_data_t               *root = nullptr; ///< Owned reference.
+    std::vector<obs_data_t *> sections;       ///< Interned section index -> object in root, or null.
+    uint64_t                  version = 0;
+
+    obs_data_t *section(uint32_t index) const { return index < sections.size() ? sections[index] : nullptr; }
+};
+
+namespace config_detail {
+
+template<typename T> inline constexpr bool kAlwaysFalse = false;
+
+/* Shared by ConfigReader::get() and OBSConfigHelper::set(). */
+template<typename T> T readItem(obs_data_t *sectionObj, const char *name, T defaultValue)
+{
+    if (!sectionObj)
+        return defaultValue;
+
+    obs_data_item_t *item = obs_data_item_byname(sectionObj, name);
+    if (!item)
+        return defaultValue;
+
+    T out;
+    if constexpr (std::is_same_v<T, bool>)
+        out = obs_data_item_get_bool(item);
+    else if constexpr (std::is_integral_v<T>)
+        out = static_cast<T>(obs_data_item_get_int(item));
+    else if constexpr (std::is_floating_point_v<T>)
+        out = static_cast<T>(obs_data_item_get_double(item));
+    else if constexpr (std::is_same_v<T, const char *>)
+        out = obs_data_item_get_string(item);
+    else if constexpr (std::is_same_v<T, QString>)
+        out = QString::fromUtf8(obs_data_item_get_string(item));
+    else
+        static_assert(kAlwaysFalse<T>, "OBSConfigHelper: unsupported value type");
+
+    obs_data_item_release(&item);
+    return out;
+}
+
+template<typename T> void writeItem(obs_data_t *sectionObj, const char *name, const T &value)
+{
+    if constexpr (std::is_same_v<T, bool>)
+        obs_data_set_bool(sectionObj, name, value);
+    else if constexpr (std::is_integral_v<T>)
+        obs_data_set_int(sectionObj, name, static_cast<long long>(value));
+    else if constexpr (std::is_floating_point_v<T>)
+        obs_data_set_double(sectionObj, name, static_cast<double>(value));
+    else if constexpr (std::is_same_v<T, const char *>)
+        obs_data_set_string(sectionObj, name, value ? value : "");
+    else if constexpr (std::is_same_v<T, QString>)
+        obs_data_set_string(sectionObj, name, value.toUtf8().constData());
+    else
+        static_assert(kAlwaysFalse<T>, "OBSConfigHelper: unsupported value type");
+}
+
+/* Storage form used by transactions and the journal. */
+template<typename T> ConfigValue toValue(const T &value)
+{
+    if constexpr (std::is_same_v<T, bool>)
+        return value;
+    else if constexpr (std::is_integral_v<T>)
+        return static_cast<long long>(value);
+    else if constexpr (std::is_floating_point_v<T>)
+        return static_cast<double>(value);
+    else if constexpr (std::is_same_v<T, QString>)
+        return value.toUtf8();
+    else if constexpr (std::is_same_v<T, QByteArray>)
+        return value;
+    else if constexpr (std::is_convertible_v<T, const char *>)
+        return QByteArray(value ? static_cast<const char *>(value) : "");
+    else
+        static_assert(kAlwaysFalse<T>, "OBSConfigHelper: unsupported value type");
+}
+
+inline void writeValue(obs_data_t *sectionObj, const char *name, const ConfigValue &value)
+{
+    std::visit([&](const auto &v) {
+        using V = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<V, QByteArray>)
+            obs_data_set_string(sectionObj, name, v.constData());
+        else
+            writeItem<V>(sectionObj, name, v);
+    }, value);
+}
+
+} // namespace config_detail
+
+/**
+ * @class ConfigReader
+ * @brief Lock-free read access to the current configuration snapshot.
+ *
+ * Creating a reader pins an epoch and performs one atomic load; it never
+ * takes a lock, so it may be used from OBS's render and audio callbacks.
+ * Everything read through it, including const char * values, stays valid
+ * until the reader goes out of scope. Keep readers short-lived and on the
+ * thread that created them.
+ */
+class ConfigReader {
+public:
+    /// Reads a value through a handle; see OBSConfigHelper::get() for types.
+    template<typename T> T get(const ConfigKey &key, T defaultValue = T()) const
+    {
+        return config_detail::readItem<T>(snapshot_->section(key.section), key.name.constData(), defaultValue);
+    }
+
+    /// Reads a schema field: its default when missing, clamped into its range.
+    template<typename T> T get(const ConfigField<T> &field) const
+    {
+        T value = config_detail::readItem<T>(snapshot_->section(field.section), field.key, field.defaultValue);
+        return field.clamp(value);
+    }
+
+    /// Reads a text field; the string stays valid while the reader lives.
+    const char *get(const ConfigTextField &field) const
+    {
+        return config_detail::readItem<const char *>(snapshot_->section(field.section), field.key,
+                                                     field.defaultValue);
+    }
+
+    /// Version of the snapshot this reader sees; increases with every change.
+    uint64_t version() const { return snapshot_->version; }
+
+    const ConfigSnapshot *snapshot() const { return snapshot_; }
+
+private:
+    friend class OBSConfigHelper;
+
+    explicit ConfigReader(const std::atomic<const ConfigSnapshot *> &current)
+        : snapshot_(current.load(std::memory_order_seq_cst))
+    {
+    }
+
+    EpochGuard            guard_;    ///< Declared first: pinned before the load.
+    const ConfigSnapshot *snapshot_;
+};
+
 /**
  * @brief Wrapper for OBS configuration storage.
  *
  * This class provides a secure and stable way to store plugin configurations
  * using OBS's data handling functions, offering type and value validation.
+ *
+ * Reads are lock-free and go through an immutable ConfigSnapshot; writers
+ * serialise on an internal mutex and publish a new snapshot per change.
  */
 class OBSConfigHelper
 {
@@ -24,16 +238,98 @@ public:
 
     /**
      * @brief Loads configuration data from the specified file.
+     *
+     * Uses the binary sidecar (see config-binary-cache.h) when it was built
+     * from the current JSON, and otherwise parses the JSON and refreshes the
+     * sidecar in the background.
      * @return true if loading was successful, false otherwise.
      */
     bool load();
 
     /**
-     * @brief Saves the current configuration data to the specified file.
-     * @return true if saving was successful, false otherwise.
+     * @brief Reports whether the last load() hit the binary cache and how long it took.
+     */
+    ConfigLoadStats loadStats() const { return lastLoad; }
+
+    /**
+     * @brief Re-reads the file and applies only what differs from the live data.
+     *
+     * Unlike load(), nothing is replaced wholesale: the file is parsed
+     * outside the lock, compared section by section and key by key with the
+     * current snapshot, and the changed and removed keys are applied in one
+     * new snapshot that shares every untouched section. Subscribers see only
+     * those keys. A file that does not parse falls back to "<config>.bak";
+     * when neither parses the live data is kept and ok is false.
+     * Readers never wait, and writers only while the patch is published.
+     * Safe to call from any thread; the caller waits for the parse.
+     */
+    ConfigReloadStats reload();
+
+    /**
+     * @brief Applies the section objects of @p sections like reload() applies the file.
+     *
+     * Each section replaces the live one of the same name, publishing and
+     * notifying only keys that differ; live sections @p sections lacks are
+     * kept. Non-object items are ignored. Does not save; in journal mode
+     * the next save writes a full snapshot, as journal records cannot
+     * express removed keys or nested data.
+     */
+    ConfigReloadStats applySections(obs_data_t *sections);
+
+    /// Full path of the JSON file.
+    QString path() const { return configFilePath; }
+
+    /**
+     * @brief Stamp of the JSON as this helper last wrote it, or invalid.
+     *
+     * Lets a file watcher tell its own saves from external edits.
+     */
+    ConfigFileStamp lastWrittenStamp() const;
+
+    /**
+     * @brief Queues the current configuration data for writing.
+     *
+     * Takes a snapshot and returns immediately; a background thread writes it
+     * once the coalesce window has passed. Saves issued within the window are
+     * merged into a single write of the newest state. Use flush() to wait.
+     * @return true if a snapshot was queued, false otherwise.
      */
     bool save();
 
+    /**
+     * @brief Waits for queued saves to reach the disk.
+     * @param timeout Upper bound on the wait.
+     * @return true if everything was written within the timeout.
+     */
+    bool flush(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Sets how long save() waits for further saves before writing.
+     */
+    void setSaveCoalesceWindow(std::chrono::milliseconds window);
+
+    /**
+     * @brief Returns counters for requested, coalesced and written saves.
+     */
+    ConfigSaveStats saveStats() const;
+
+    /**
+     * @brief Switches between full-document saves and the append-only journal.
+     *
+     * In journal mode a save appends only the keys written since the last
+     * one to "<config>.journal"; the JSON is rewritten (and the journal
+     * restarted) once the journal exceeds @p compactThresholdBytes. load()
+     * always replays a journal that belongs to the JSON. Best called before
+     * load(); switching later is safe while saves run, and the next save
+     * then writes a full snapshot for the new journal to continue.
+     */
+    void setJournalMode(bool enabled, size_t compactThresholdBytes = 256 * 1024);
+
+    /**
+     * @brief Returns the bytes written by full saves and by the journal.
+     */
+    ConfigIoStats ioStats() const;
+
     /**
      * @brief Sets a configuration value with optional type and range validation.
      * @param section The section name in the configuration (e.g., "General").
@@ -56,9 +352,156 @@ public:
      */
     QVariant getValue(const QString &section, const QString &key, const QVariant &defaultValue = QVariant()) const;
 
+    /**
+     * @brief Interns a section/key pair and returns a reusable handle.
+     * @param section The section name (e.g., "General").
+     * @param key The key within the section (e.g., "volume").
+     * @return A handle for the typed get()/set() overloads.
+     */
+    ConfigKey key(const char *section, const char *key);
+    ConfigKey key(const QString &section, const QString &key);
+
+    /**
+     * @brief Returns a lock-free reader on the current snapshot.
+     *
+     * Use this to read several keys from one consistent version, or to read
+     * const char * values without copying them.
+     */
+    ConfigReader reader() const { return ConfigReader(current); }
+
+    /**
+     * @brief Reads a value through a pre-resolved handle.
+     *
+     * Lock-free. Supported types are bool, integral and floating-point types
+     * and QString; for const char * use reader() so the string stays alive.
+     * Only the QString overload allocates, for the returned string.
+     * @param key Handle obtained from key().
+     * @param defaultValue Returned when the section or key does not exist.
+     */
+    template<typename T> T get(const ConfigKey &key, T defaultValue = T()) const;
+
+    /**
+     * @brief Writes a value through a pre-resolved handle.
+     *
+     * Copies the affected section, writes the key and publishes a new
+     * snapshot. Supports the types of get() plus const char *.
+     *
+     * Unlike get(), this allocates on every call. The copied section and
+     * the new snapshot are heap objects, and so is the journal record when
+     * journaling is on. That is the price of copy-on-write: readers never
+     * lock, and a snapshot they hold never changes under them. To write
+     * several keys, use begin(): a transaction copies each section it
+     * touches once and publishes a single snapshot.
+     * @return true if the value was written, false for an invalid handle.
+     */
+    template<typename T> bool set(const ConfigKey &key, T value);
+
+    /**
+     * @brief Writes an arithmetic value after checking it against [min, max].
+     * @return true if the value was in range and written, false otherwise.
+     */
+    template<typename T> bool set(const ConfigKey &key, T value, T min, T max);
+
+    /**
+     * @brief Reads a schema field (see config-schema.h). Lock-free, no allocation.
+     * @return The stored value clamped into the field's range, or its default.
+     */
+    template<typename T> T get(const ConfigField<T> &field) const { return reader().get(field); }
+    QString get(const ConfigTextField &field) const { return QString::fromUtf8(reader().get(field)); }
+
+    /**
+     * @brief Writes a schema field after an inlined range check.
+     *
+     * The value type is fixed by the field, so a mismatch fails to compile.
+     * @return true if the value was in range and written, false otherwise.
+     */
+    template<typename T> bool set(const ConfigField<T> &field, std::type_identity_t<T> value)
+    {
+        if (!field.contains(value))
+            return false;
+        return set<T>(ConfigKey::fromSchema(field.section, field.key), value);
+    }
+    bool set(const ConfigTextField &field, const QString &value)
+    {
+        const QByteArray utf8 = value.toUtf8();
+        if (!field.contains(static_cast<size_t>(utf8.size())))
+            return false;
+        return set<const char *>(ConfigKey::fromSchema(field.section, field.key), utf8.constData());
+    }
+
+    /**
+     * @brief Observes changes to one key, a whole section or keys with a prefix.
+     *
+     * Changes are batched: each key appears once per delivery with the
+     * version of its latest change. With a @p context object the callback
+     * runs on that object's thread via its event loop and stops when the
+     * object is destroyed; with nullptr it runs on the writing thread right
+     * after the write. load() reports only keys whose values differ.
+     * @return Id for unsubscribe().
+     */
+    uint64_t subscribe(const ConfigKey &key, QObject *context, ConfigChangeFn fn);
+    uint64_t subscribeSection(const QString &section, QObject *context, ConfigChangeFn fn);
+    uint64_t subscribeSection(ConfigSchema::Section section, QObject *context, ConfigChangeFn fn)
+    {
+        return notifier.subscribe(ConfigNotifier::Scope::Section, section, QByteArray(), context, std::move(fn));
+    }
+    uint64_t subscribePrefix(const QString &section, const QString &keyPrefix, QObject *context, ConfigChangeFn fn);
+    template<typename T> uint64_t subscribe(const ConfigField<T> &field, QObject *context, ConfigChangeFn fn)
+    {
+        return subscribe(ConfigKey::fromSchema(field.section, field.key), context, std::move(fn));
+    }
+    uint64_t subscribe(const ConfigTextField &field, QObject *context, ConfigChangeFn fn)
+    {
+        return subscribe(ConfigKey::fromSchema(field.section, field.key), context, std::move(fn));
+    }
+
+    /// Stops a subscription. Safe to call from inside its own callback.
+    void unsubscribe(uint64_t id);
+
+    /**
+     * @brief Version of the last change to a key since startup, or 0.
+     *
+     * Compare with a remembered value to tell whether a key is dirty.
+     */
+    uint64_t keyVersion(const ConfigKey &key) const { return notifier.keyVersion(key.section, key.name); }
+
+    /**
+     * @brief Starts a batch of writes that is applied all-or-nothing.
+     * @see ConfigTransaction (include config-transaction.h to use it).
+     */
+    ConfigTransaction begin();
+
 private:
-    obs_data_t *configData;
+    friend class ConfigTransaction;
+
     QString configFilePath;
+    QByteArray cacheFilePath;      ///< Binary sidecar next to the JSON.
+    QByteArray journalFilePath;    ///< Write-ahead journal next to the JSON.
+    ConfigLoadStats lastLoad;
+    /// Set in journal mode only; guarded by writeMutex. The writer and readers work on a copy of the pointer.
+    std::shared_ptr<ConfigJournal> journal;
+    bool loadedOnce = false;       ///< load() has published the file; guarded by writeMutex.
+    std::unique_ptr<ConfigWriter> writer;
+    std::atomic<uint64_t> snapshotWrites{0};
+    std::atomic<uint64_t> snapshotBytes{0};
+    mutable std::mutex stampMutex;
+    ConfigFileStamp writtenStamp;  ///< Set by writeSnapshot(), guarded by stampMutex.
+    ConfigNotifier notifier;
+
+    /* Readers only ever load this pointer; everything else is writer-side. */
+    std::atomic<const ConfigSnapshot *> current{nullptr};
+    mutable std::mutex       writeMutex;     ///< Serialises writers, never taken by readers.
+    std::vector<QByteArray>  sectionNames;   ///< Interned sections, guarded by writeMutex.
+
+    uint32_t internSection(const QByteArray &name);
+    obs_data_t *copySection(uint32_t section) const;
+    void publishSection(uint32_t section, obs_data_t *sectionObj);
+    void publishSections(const uint32_t *sections, obs_data_t *const *sectionObjs, size_t count);
+    void publish(obs_data_t *root);
+    std::shared_ptr<ConfigJournal> currentJournal() const;
+    obs_data_t *replayJournal(obs_data_t *root, uint64_t jsonHash, bool readOnly = false);
+    uint64_t applyFileRoot(obs_data_t *fileRoot, ConfigReloadStats &stats, bool keepMissing = false);
+    bool writeSnapshot(obs_data_t *snapshot, uint64_t version, ConfigJournal *active);
 
     /**
      * @brief Validates a QVariant value against an expected type and optional min/max range.
@@ -70,3 +513,43 @@ private:
      */
     bool validate(const QVariant &value, QMetaType::Type type, const QVariant &min, const QVariant &max) const;
 };
+
+/* ------------------------------------------------------------------------- */
+/*  Typed handle access                                                      */
+/* ------------------------------------------------------------------------- */
+template<typename T> T OBSConfigHelper::get(const ConfigKey &key, T defaultValue) const
+{
+    static_assert(!std::is_same_v<T, const char *>,
+                  "OBSConfigHelper::get: read strings through reader() or as QString");
+    return reader().get<T>(key, defaultValue);
+}
+
+template<typename T> bool OBSConfigHelper::set(const ConfigKey &key, T value)
+{
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+
+        obs_data_t *sectionObj = copySection(key.section);
+        if (!sectionObj)
+            return false;
+
+        config_detail::writeItem<T>(sectionObj, key.name.constData(), value);
+        publishSection(key.section, sectionObj);
+
+        const uint64_t version = current.load()->version;
+        if (journal)
+            journal->append(version, sectionNames[key.section], key.name, config_detail::toValue(value));
+        notifier.record(key.section, key.name, version);
+    }
+    notifier.dispatch();            /* outside the lock: callbacks may write */
+    return true;
+}
+
+template<typename T> bool OBSConfigHelper::set(const ConfigKey &key, T value, T min, T max)
+{
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>,
+                  "OBSConfigHelper::set: range check needs an arithmetic type");
+    if (value < min || value > max)
+        return false;
+    return set<T>(key, value);
+}
@@ -0,0 +1,277 @@
+/*!
+ * @file overlay-blend.cpp
+ * @brief Scalar and SIMD premultiplied-alpha blend kernels with runtime dispatch.
+ *
+ * All kernels compute, per channel, s + div255(d * (255 - sa)) with
+ * div255(x) = (x + 128 + ((x + 128) >> 8)) >> 8, which is exact for
+ * x <= 255 * 255, followed by a saturating add. The AVX2 kernel is compiled
+ * with a function-level target attribute so the rest of the plugin keeps
+ * the baseline instruction set.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "overlay-blend.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define PF_BLEND_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define PF_TARGET_AVX2
+#else
+#define PF_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define PF_BLEND_X86 0
+#endif
+
+#if defined(__ARM_NEON) || defined(_M_ARM64)
+#define PF_BLEND_NEON 1
+#include <arm_neon.h>
+#else
+#define PF_BLEND_NEON 0
+#endif
+
+namespace OverlayBlend {
+
+namespace {
+
+/* ------------------------------------------------------------------------- */
+/*  Scalar                                                                   */
+/* ------------------------------------------------------------------------- */
+inline uint8_t div255(uint32_t x)
+{
+    x += 128;
+    return static_cast<uint8_t>((x + (x >> 8)) >> 8);
+}
+
+void blendScalar(uint8_t *dst, const uint8_t *src, size_t pixels)
+{
+    for (size_t i = 0; i < pixels; ++i, dst += 4, src += 4) {
+        const uint32_t a = src[3];
+        if (a == 0)
+            continue;
+        if (a == 255) {
+            std::memcpy(dst, src, 4);
+            continue;
+        }
+        const uint32_t inv = 255 - a;
+        for (int c = 0; c < 4; ++c)
+            dst[c] = static_cast<uint8_t>(std::min<uint32_t>(255, src[c] + div255(dst[c] * inv)));
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/*  SSE2 / AVX2                                                              */
+/* ------------------------------------------------------------------------- */
+#if PF_BLEND_X86
+inline __m128i div255Epu16(__m128i x)
+{
+    x = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+/* one half (two pixels) widened to 16 bits: d * (255 - sa) / 255 */
+inline __m128i attenuateSse2(__m128i s16, __m128i d16)
+{
+    const __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s16, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    return div255Epu16(_mm_mullo_epi16(d16, _mm_sub_epi16(_mm_set1_epi16(255), a)));
+}
+
+void blendSse2(uint8_t *dst, const uint8_t *src, size_t pixels)
+{
+    const __m128i zero  = _mm_setzero_si128();
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+
+    size_t i = 0;
+    for (; i + 4 <= pixels; i += 4) {
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 4));
+        const __m128i sa = _mm_and_si128(s, alpha);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(sa, zero)) == 0xFFFF)
+            continue;                                   /* fully transparent */
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(sa, alpha)) == 0xFFFF) {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4), s);
+            continue;                                   /* fully opaque */
+        }
+
+        const __m128i d  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i * 4));
+        const __m128i lo = attenuateSse2(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero));
+        const __m128i hi = attenuateSse2(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4), _mm_adds_epu8(s, _mm_packus_epi16(lo, hi)));
+    }
+    blendScalar(dst + i * 4, src + i * 4, pixels - i);
+}
+
+PF_TARGET_AVX2 inline __m256i div255Epu16Avx2(__m256i x)
+{
+    x = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+PF_TARGET_AVX2 inline __m256i attenuateAvx2(__m256i s16, __m256i d16)
+{
+    const __m256i a =
+        _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s16, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    return div255Epu16Avx2(_mm256_mullo_epi16(d16, _mm256_sub_epi16(_mm256_set1_epi16(255), a)));
+}
+
+/* unpack and pack both work within 128-bit lanes, so pixel order survives */
+PF_TARGET_AVX2 void blendAvx2(uint8_t *dst, const uint8_t *src, size_t pixels)
+{
+    const __m256i zero  = _mm256_setzero_si256();
+    const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+
+    size_t i = 0;
+    for (; i + 8 <= pixels; i += 8) {
+        const __m256i s  = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i * 4));
+        const __m256i sa = _mm256_and_si256(s, alpha);
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(sa, zero)) == -1)
+            continue;
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(sa, alpha)) == -1) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i * 4), s);
+            continue;
+        }
+
+        const __m256i d  = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i * 4));
+        const __m256i lo = attenuateAvx2(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero));
+        const __m256i hi = attenuateAvx2(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i * 4),
+                            _mm256_adds_epu8(s, _mm256_packus_epi16(lo, hi)));
+    }
+    blendSse2(dst + i * 4, src + i * 4, pixels - i);
+}
+
+bool detectAvx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx     = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+        return false;               /* the OS does not save YMM state */
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+bool cpuHasAvx2()
+{
+    static const bool has = detectAvx2();
+    return has;
+}
+#endif
+
+/* ------------------------------------------------------------------------- */
+/*  NEON                                                                     */
+/* ------------------------------------------------------------------------- */
+#if PF_BLEND_NEON
+void blendNeon(uint8_t *dst, const uint8_t *src, size_t pixels)
+{
+    size_t i = 0;
+    for (; i + 8 <= pixels; i += 8) {
+        const uint8x8x4_t s = vld4_u8(src + i * 4);     /* de-interleaved B, G, R, A */
+        uint8x8x4_t       d = vld4_u8(dst + i * 4);
+        const uint8x8_t inv = vmvn_u8(s.val[3]);
+        for (int c = 0; c < 4; ++c) {
+            const uint16x8_t x = vmull_u8(d.val[c], inv);
+            /* (x + 128 + ((x + 128) >> 8)) >> 8 */
+            d.val[c] = vqadd_u8(s.val[c], vraddhn_u16(x, vrshrq_n_u16(x, 8)));
+        }
+        vst4_u8(dst + i * 4, d);
+    }
+    blendScalar(dst + i * 4, src + i * 4, pixels - i);
+}
+#endif
+
+} // namespace
+
+/* ------------------------------------------------------------------------- */
+/*  Public API                                                               */
+/* ------------------------------------------------------------------------- */
+RowFn rowFunction(Kernel kernel)
+{
+    switch (kernel) {
+    case Kernel::Scalar:
+        return blendScalar;
+#if PF_BLEND_X86
+    case Kernel::SSE2:
+        return blendSse2;
+    case Kernel::AVX2:
+        return cpuHasAvx2() ? blendAvx2 : nullptr;
+#endif
+#if PF_BLEND_NEON
+    case Kernel::NEON:
+        return blendNeon;
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+Kernel bestKernel()
+{
+    static const Kernel best = [] {
+        for (Kernel k : {Kernel::AVX2, Kernel::NEON, Kernel::SSE2})
+            if (rowFunction(k))
+                return k;
+        return Kernel::Scalar;
+    }();
+    return best;
+}
+
+const char *kernelName(Kernel kernel)
+{
+    switch (kernel) {
+    case Kernel::Scalar: return "scalar";
+    case Kernel::SSE2:   return "sse2";
+    case Kernel::AVX2:   return "avx2";
+    case Kernel::NEON:   return "neon";
+    }
+    return "?";
+}
+
+void blendRect(RowFn fn, uint8_t *dst, size_t dstStride, const uint8_t *src, size_t srcStride, uint32_t width,
+               uint32_t height)
+{
+    for (uint32_t y = 0; y < height; ++y, dst += dstStride, src += srcStride)
+        fn(dst, src, width);
+}
+
+void unpremultiplyRow(uint8_t *dst, const uint8_t *src, size_t pixels)
+{
+    /* 16.16 reciprocals of the alpha values */
+    static const auto recip = [] {
+        std::array<uint32_t, 256> r{};
+        for (uint32_t a = 1; a < 256; ++a)
+            r[a] = ((255u << 16) + a / 2) / a;
+        return r;
+    }();
+
+    for (size_t i = 0; i < pixels; ++i, dst += 4, src += 4) {
+        const uint32_t a = src[3];
+        if (a == 255 || a == 0) {
+            std::memcpy(dst, src, 4);
+            continue;
+        }
+        for (int c = 0; c < 3; ++c)
+            dst[c] = static_cast<uint8_t>(std::min<uint32_t>(255, (src[c] * recip[a] + 0x8000) >> 16));
+        dst[3] = static_cast<uint8_t>(a);
+    }
+}
+
+} // namespace OverlayBlend
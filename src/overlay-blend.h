@@ -0,0 +1,46 @@
+/*!
+ * @file overlay-blend.h
+ * @brief Premultiplied-alpha "source over" blend kernels for BGRA rows.
+ *
+ * dst = src + dst * (255 - src.a) / 255, per channel, rounded exactly.
+ * Scalar, SSE2, AVX2 and NEON variants produce identical results; the best
+ * one the CPU supports is picked at runtime. Pixels are 8-bit B, G, R, A in
+ * memory order (QImage::Format_ARGB32_Premultiplied on little-endian).
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace OverlayBlend {
+
+enum class Kernel { Scalar, SSE2, AVX2, NEON };
+
+/// Blends @p pixels premultiplied BGRA pixels of @p src over @p dst.
+using RowFn = void (*)(uint8_t *dst, const uint8_t *src, size_t pixels);
+
+/// The kernel, or nullptr if this build or CPU cannot run it.
+RowFn rowFunction(Kernel kernel);
+
+/// Fastest kernel available; detected once.
+Kernel bestKernel();
+
+const char *kernelName(Kernel kernel);
+
+/**
+ * @brief Blends a @p width x @p height block row by row.
+ * @param dstStride, srcStride Row pitch in bytes.
+ */
+void blendRect(RowFn fn, uint8_t *dst, size_t dstStride, const uint8_t *src, size_t srcStride, uint32_t width,
+               uint32_t height);
+
+/// Converts premultiplied BGRA to straight alpha (for consumers that expect it).
+void unpremultiplyRow(uint8_t *dst, const uint8_t *src, size_t pixels);
+
+} // namespace OverlayBlend
@@ -0,0 +1,410 @@
+/*!
+ * @file overlay-source.cpp
+ * @brief Implements the overlay source: change-driven rasterization, dirty
+ *        rectangle compositing and asynchronous frame output.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "overlay-source.h"
+#include "overlay-blend.h"
+#include "obs-config-helper.h"
+#include "plugin-support.h"
+#include "plugin-trace.h"
+
+#include <obs-module.h>
+#include <util/platform.h>
+
+#include <QColor>
+#include <QFont>
+#include <QFontMetrics>
+#include <QImage>
+#include <QPainter>
+#include <QRegion>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr const char *kSourceId = "playfame_overlay";
+constexpr int         kMargin   = 16;   ///< Text inset from the panel edge, in pixels.
+
+OBSConfigHelper *g_config = nullptr;
+
+struct OverlaySettings {
+    int width    = 1280;
+    int height   = 180;
+    int fontSize = 48;
+
+    bool operator==(const OverlaySettings &) const = default;
+};
+
+OverlaySettings readSettings(obs_data_t *settings)
+{
+    OverlaySettings s;
+    s.width    = static_cast<int>(obs_data_get_int(settings, "width"));
+    s.height   = static_cast<int>(obs_data_get_int(settings, "height"));
+    s.fontSize = static_cast<int>(obs_data_get_int(settings, "font_size"));
+    return s;
+}
+
+/**
+ * @brief Hand-off between OBS/config threads and the render thread.
+ *
+ * Shared with the config subscription, which can still be running for a
+ * moment after the source is destroyed.
+ */
+struct OverlaySignal {
+    std::mutex              mutex;
+    std::condition_variable wake;
+    OverlaySettings         settings;
+    bool                    settingsDirty = true;
+    bool                    configDirty   = true;
+    bool                    reoutput      = false;
+    bool                    stopping      = false;
+};
+
+/**
+ * @class OverlaySource
+ * @brief One overlay instance; renders on its own thread, only on change.
+ */
+class OverlaySource {
+public:
+    OverlaySource(obs_source_t *source, obs_data_t *settings);
+    ~OverlaySource();
+
+    OverlaySource(const OverlaySource &) = delete;
+    OverlaySource &operator=(const OverlaySource &) = delete;
+
+    void update(obs_data_t *settings);
+
+    /// Sends the cached frame again; nothing is re-rendered.
+    void reoutput();
+
+private:
+    /// A premultiplied BGRA element placed at @c rect in the frame.
+    struct Layer {
+        QImage  image;
+        QRect   rect;
+        QString text;
+    };
+    enum LayerId { Panel, Title, Stats, LayerCount };   ///< Bottom to top.
+
+    void run();
+    void resize(const OverlaySettings &s);
+    void rasterizeText(Layer &layer, const QString &text, const QFont &font, int top, bool force, QRegion &dirty);
+    void composite(const QRegion &dirty);
+    void output();
+
+    obs_source_t                  *source_;
+    std::shared_ptr<OverlaySignal> signal_;
+    uint64_t                       subscription_ = 0;
+    const OverlayBlend::RowFn      blend_;
+
+    /* render thread only */
+    OverlaySettings      settings_;
+    bool                 sized_ = false;
+    Layer                layers_[LayerCount];
+    std::vector<uint8_t> frame_;    ///< Premultiplied composite.
+    std::vector<uint8_t> output_;   ///< Straight alpha, as OBS draws async frames.
+
+    std::thread thread_;            ///< Declared last: started after everything else.
+};
+
+OverlaySource::OverlaySource(obs_source_t *source, obs_data_t *settings)
+    : source_(source)
+    , signal_(std::make_shared<OverlaySignal>())
+    , blend_(OverlayBlend::rowFunction(OverlayBlend::bestKernel()))
+{
+    signal_->settings = readSettings(settings);
+
+    /* called directly on the writing thread; only flags the change */
+    subscription_ = g_config->subscribeSection(ConfigSchema::Demo, nullptr,
+                                               [signal = signal_](const std::vector<ConfigChange> &) {
+        {
+            std::lock_guard<std::mutex> lock(signal->mutex);
+            signal->configDirty = true;
+        }
+        signal->wake.notify_one();
+    });
+
+    obs_source_set_async_unbuffered(source_, true);     /* show each frame as soon as it arrives */
+    thread_ = std::thread(&OverlaySource::run, this);
+}
+
+OverlaySource::~OverlaySource()
+{
+    g_config->unsubscribe(subscription_);
+    {
+        std::lock_guard<std::mutex> lock(signal_->mutex);
+        signal_->stopping = true;
+    }
+    signal_->wake.notify_one();
+    if (thread_.joinable())
+        thread_.join();
+}
+
+void OverlaySource::update(obs_data_t *settings)
+{
+    {
+        std::lock_guard<std::mutex> lock(signal_->mutex);
+        signal_->settings      = readSettings(settings);
+        signal_->settingsDirty = true;
+    }
+    signal_->wake.notify_one();
+}
+
+void OverlaySource::reoutput()
+{
+    {
+        std::lock_guard<std::mutex> lock(signal_->mutex);
+        signal_->reoutput = true;
+    }
+    signal_->wake.notify_one();
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Render thread                                                            */
+/* ------------------------------------------------------------------------- */
+void OverlaySource::run()
+{
+    for (;;) {
+        OverlaySettings settings;
+        bool settingsDirty, configDirty, reoutput;
+        {
+            std::unique_lock<std::mutex> lock(signal_->mutex);
+            signal_->wake.wait(lock, [this] {
+                return signal_->stopping || signal_->settingsDirty || signal_->configDirty || signal_->reoutput;
+            });
+            if (signal_->stopping)
+                return;
+            settings      = signal_->settings;
+            settingsDirty = signal_->settingsDirty;
+            configDirty   = signal_->configDirty;
+            reoutput      = signal_->reoutput;
+            signal_->settingsDirty = signal_->configDirty = signal_->reoutput = false;
+        }
+
+        QRegion dirty;
+        const bool resized = settingsDirty && (!sized_ || !(settings == settings_));
+        if (resized) {
+            resize(settings);
+            dirty = QRect(0, 0, settings_.width, settings_.height);
+        }
+
+        if (resized || configDirty) {
+            PF_TRACE_SCOPE("overlay.rasterize");
+            QString title, stats;
+            {
+                ConfigReader reader = g_config->reader();
+                title = reader.get(ConfigSchema::kDemoText);
+                stats = QStringLiteral("Number %1   Option %2")
+                            .arg(reader.get(ConfigSchema::kDemoNumber))
+                            .arg(reader.get(ConfigSchema::kDemoOption));
+            }
+
+            QFont titleFont;
+            titleFont.setPixelSize(settings_.fontSize);
+            titleFont.setBold(true);
+            QFont statsFont;
+            statsFont.setPixelSize(std::max(1, settings_.fontSize * 3 / 5));
+
+            const int statsTop = kMargin + QFontMetrics(titleFont).height() + kMargin / 4;
+            rasterizeText(layers_[Title], title, titleFont, kMargin, resized, dirty);
+            rasterizeText(layers_[Stats], stats, statsFont, statsTop, resized, dirty);
+        }
+
+        if (!dirty.isEmpty())
+            composite(dirty);
+        if (!dirty.isEmpty() || reoutput)
+            output();
+    }
+}
+
+/* New size or font: reallocate the frame and redraw the background panel. */
+void OverlaySource::resize(const OverlaySettings &s)
+{
+    PF_TRACE_SCOPE("overlay.resize");
+    settings_ = s;
+    sized_    = true;
+
+    const size_t bytes = static_cast<size_t>(s.width) * static_cast<size_t>(s.height) * 4;
+    frame_.assign(bytes, 0);
+    output_.assign(bytes, 0);
+
+    QImage panel(s.width, s.height, QImage::Format_ARGB32_Premultiplied);
+    panel.fill(Qt::transparent);
+    {
+        QPainter p(&panel);
+        p.setRenderHint(QPainter::Antialiasing);
+        p.setPen(Qt::NoPen);
+        p.setBrush(QColor(16, 18, 28, 200));
+        p.drawRoundedRect(QRectF(0.5, 0.5, s.width - 1.0, s.height - 1.0), 12.0, 12.0);
+    }
+    layers_[Panel] = {panel, QRect(0, 0, s.width, s.height), QString()};
+    layers_[Title] = Layer();
+    layers_[Stats] = Layer();
+}
+
+/* Redraws a text layer if its text changed; marks its old and new area dirty. */
+void OverlaySource::rasterizeText(Layer &layer, const QString &text, const QFont &font, int top, bool force,
+                                  QRegion &dirty)
+{
+    if (!force && text == layer.text)
+        return;
+
+    const QFontMetrics fm(font);
+    const int     maxWidth = std::max(0, settings_.width - 2 * kMargin);
+    const QString shown    = fm.elidedText(text, Qt::ElideRight, maxWidth);
+    const QRect   rect     = QRect(kMargin, top, std::min(fm.horizontalAdvance(shown) + 2, maxWidth), fm.height()) &
+                             QRect(0, 0, settings_.width, settings_.height);
+
+    QImage image;
+    if (!rect.isEmpty()) {
+        image = QImage(rect.size(), QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+        QPainter p(&image);
+        p.setRenderHint(QPainter::TextAntialiasing);
+        p.setFont(font);
+        p.setPen(Qt::white);
+        p.drawText(QRect(QPoint(0, 0), rect.size()), Qt::AlignLeft | Qt::AlignVCenter, shown);
+    }
+
+    dirty += layer.rect;
+    dirty += rect;
+    layer = {image, rect, text};
+}
+
+/* Rebuilds the dirty rectangles from the layers, bottom to top. */
+void OverlaySource::composite(const QRegion &dirty)
+{
+    PF_TRACE_SCOPE("overlay.composite");
+    const QRect  bounds(0, 0, settings_.width, settings_.height);
+    const size_t stride = static_cast<size_t>(settings_.width) * 4;
+    uint64_t     pixels = 0;
+
+    for (const QRect &d : dirty) {
+        const QRect r = d & bounds;
+        if (r.isEmpty())
+            continue;
+
+        uint8_t *origin = frame_.data() + static_cast<size_t>(r.y()) * stride + static_cast<size_t>(r.x()) * 4;
+        for (int y = 0; y < r.height(); ++y)
+            std::memset(origin + static_cast<size_t>(y) * stride, 0, static_cast<size_t>(r.width()) * 4);
+
+        for (const Layer &layer : layers_) {
+            const QRect c = r & layer.rect;
+            if (c.isEmpty() || layer.image.isNull())
+                continue;
+            const size_t srcStride = static_cast<size_t>(layer.image.bytesPerLine());
+            const uint8_t *src = layer.image.constBits() +
+                                 static_cast<size_t>(c.y() - layer.rect.y()) * srcStride +
+                                 static_cast<size_t>(c.x() - layer.rect.x()) * 4;
+            uint8_t *dst = frame_.data() + static_cast<size_t>(c.y()) * stride + static_cast<size_t>(c.x()) * 4;
+            OverlayBlend::blendRect(blend_, dst, stride, src, srcStride, static_cast<uint32_t>(c.width()),
+                                    static_cast<uint32_t>(c.height()));
+        }
+
+        for (int y = r.y(); y <= r.bottom(); ++y) {
+            const size_t offset = static_cast<size_t>(y) * stride + static_cast<size_t>(r.x()) * 4;
+            OverlayBlend::unpremultiplyRow(output_.data() + offset, frame_.data() + offset,
+                                           static_cast<size_t>(r.width()));
+        }
+        pixels += static_cast<uint64_t>(r.width()) * static_cast<uint64_t>(r.height());
+    }
+    PF_TRACE_COUNTER("overlay.dirty_pixels", pixels);
+}
+
+void OverlaySource::output()
+{
+    if (output_.empty())
+        return;
+
+    obs_source_frame frame = {};
+    frame.data[0]     = output_.data();
+    frame.linesize[0] = static_cast<uint32_t>(settings_.width) * 4;
+    frame.width       = static_cast<uint32_t>(settings_.width);
+    frame.height      = static_cast<uint32_t>(settings_.height);
+    frame.format      = VIDEO_FORMAT_BGRA;
+    frame.timestamp   = os_gettime_ns();
+    obs_source_output_video(source_, &frame);     /* OBS copies the frame */
+}
+
+/* ------------------------------------------------------------------------- */
+/*  obs_source_info callbacks                                                */
+/* ------------------------------------------------------------------------- */
+const char *overlay_get_name(void *)
+{
+    return obs_module_text("PlayFame.Overlay");
+}
+
+void *overlay_create(obs_data_t *settings, obs_source_t *source)
+{
+    return new OverlaySource(source, settings);
+}
+
+void overlay_destroy(void *data)
+{
+    delete static_cast<OverlaySource *>(data);
+}
+
+void overlay_update(void *data, obs_data_t *settings)
+{
+    static_cast<OverlaySource *>(data)->update(settings);
+}
+
+void overlay_show(void *data)
+{
+    static_cast<OverlaySource *>(data)->reoutput();
+}
+
+void overlay_get_defaults(obs_data_t *settings)
+{
+    const OverlaySettings d;
+    obs_data_set_default_int(settings, "width", d.width);
+    obs_data_set_default_int(settings, "height", d.height);
+    obs_data_set_default_int(settings, "font_size", d.fontSize);
+}
+
+obs_properties_t *overlay_get_properties(void *)
+{
+    obs_properties_t *props = obs_properties_create();
+    obs_properties_add_int(props, "width", obs_module_text("PlayFame.Overlay.Width"), 64, 7680, 1);
+    obs_properties_add_int(props, "height", obs_module_text("PlayFame.Overlay.Height"), 32, 4320, 1);
+    obs_properties_add_int(props, "font_size", obs_module_text("PlayFame.Overlay.FontSize"), 8, 400, 1);
+    return props;
+}
+
+} // namespace
+
+void overlay_source_register(OBSConfigHelper *cfg)
+{
+    g_config = cfg;
+
+    obs_source_info info = {};
+    info.id             = kSourceId;
+    info.type           = OBS_SOURCE_TYPE_INPUT;
+    info.output_flags   = OBS_SOURCE_ASYNC_VIDEO;
+    info.icon_type      = OBS_ICON_TYPE_TEXT;
+    info.get_name       = overlay_get_name;
+    info.create         = overlay_create;
+    info.destroy        = overlay_destroy;
+    info.update         = overlay_update;
+    info.show           = overlay_show;
+    info.activate       = overlay_show;
+    info.get_defaults   = overlay_get_defaults;
+    info.get_properties = overlay_get_properties;
+    obs_register_source(&info);
+
+    obs_log(LOG_INFO, "[Overlay] Source registered; blend kernel: %s",
+            OverlayBlend::kernelName(OverlayBlend::bestKernel()));
+}
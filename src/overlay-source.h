@@ -0,0 +1,28 @@
+/*!
+ * @file overlay-source.h
+ * @brief "PlayFame Overlay" source: the demo text and stats as a CPU-rendered
+ *        asynchronous video source.
+ *
+ * The overlay is drawn only when one of its inputs changes (a setting in the
+ * "demo" config section or the source's own size and font settings). Each
+ * element is a premultiplied BGRA layer; a change re-rasterizes that layer
+ * alone, and only the rectangles it covered before and after are composited
+ * again into the cached frame with the SIMD blend kernels (overlay-blend.h).
+ * The frame reaches OBS through obs_source_output_video(), which keeps
+ * showing it until the next change, so no GPU work is needed.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+class OBSConfigHelper;
+
+/**
+ * @brief Registers the overlay source with OBS; call from obs_module_load().
+ * @param cfg Config the overlay reads; must outlive every overlay instance.
+ */
+void overlay_source_register(OBSConfigHelper *cfg);
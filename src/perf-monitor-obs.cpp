@@ -0,0 +1,66 @@
+/*!
+ * @file perf-monitor-obs.cpp
+ * @brief Implements ObsPerfProbe.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "perf-monitor-obs.h"
+
+#include <obs-frontend-api.h>
+
+ObsPerfProbe::ObsPerfProbe()
+    : cpu_(os_cpu_usage_info_start())
+{
+}
+
+ObsPerfProbe::~ObsPerfProbe()
+{
+    obs_weak_output_release(stream_);
+    os_cpu_usage_info_destroy(cpu_);
+}
+
+void ObsPerfProbe::refreshOutputs()
+{
+    obs_output_t      *output = obs_frontend_get_streaming_output();
+    obs_weak_output_t *weak   = output ? obs_output_get_weak_output(output) : nullptr;
+    obs_output_release(output);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    obs_weak_output_release(stream_);
+    stream_ = weak;
+}
+
+bool ObsPerfProbe::read(PerfCounters &c)
+{
+    video_t *video = obs_get_video();
+    if (!video)
+        return false;
+
+    c.renderedFrames  = obs_get_total_frames();
+    c.laggedFrames    = obs_get_lagged_frames();
+    c.encodedFrames   = video_output_get_total_frames(video);
+    c.skippedFrames   = video_output_get_skipped_frames(video);
+    c.renderTimeNs    = obs_get_average_frame_time_ns();
+    c.frameIntervalNs = obs_get_frame_interval_ns();
+    c.fps             = obs_get_active_fps();
+    c.cpuPercent      = cpu_ ? os_cpu_usage_info_query(cpu_) : 0.0;
+
+    obs_output_t *stream = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stream = stream_ ? obs_weak_output_get_output(stream_) : nullptr;
+    }
+    if (stream) {
+        if (obs_output_active(stream)) {
+            c.streaming     = true;
+            c.outputFrames  = static_cast<uint64_t>(obs_output_get_total_frames(stream));
+            c.droppedFrames = static_cast<uint64_t>(obs_output_get_frames_dropped(stream));
+        }
+        obs_output_release(stream);
+    }
+    return true;
+}
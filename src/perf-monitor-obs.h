@@ -0,0 +1,49 @@
+/*!
+ * @file perf-monitor-obs.h
+ * @brief Reads PerfCounters from libobs for the PerfMonitor sampler.
+ *
+ * Every read is a handful of libobs getters (the render thread's averages,
+ * the video output's frame counters and the CPU usage info); none of them
+ * takes a lock the render or encoder threads hold for long. The streaming
+ * output comes from the frontend, which may only be asked on the UI thread,
+ * so the plugin calls refreshOutputs() on the streaming events and the
+ * sampler holds a weak reference in between.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include "perf-monitor.h"
+
+#include <obs.h>
+#include <util/platform.h>
+
+#include <mutex>
+
+/**
+ * @class ObsPerfProbe
+ * @brief PerfMonitor::ProbeFn over libobs; see the file comment.
+ */
+class ObsPerfProbe {
+public:
+    ObsPerfProbe();
+    ~ObsPerfProbe();
+
+    ObsPerfProbe(const ObsPerfProbe &) = delete;
+    ObsPerfProbe &operator=(const ObsPerfProbe &) = delete;
+
+    /// UI thread: picks up the frontend's current streaming output.
+    void refreshOutputs();
+
+    /// Sampler thread. False while OBS has no video output.
+    bool read(PerfCounters &counters);
+
+private:
+    std::mutex           mutex_;              ///< stream_.
+    obs_weak_output_t   *stream_ = nullptr;
+    os_cpu_usage_info_t *cpu_    = nullptr;   ///< Sampler thread only after construction.
+};
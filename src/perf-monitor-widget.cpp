@@ -0,0 +1,249 @@
+/*!
+ * @file perf-monitor-widget.cpp
+ * @brief Implements PerfMonitorWidget: display timer and sparkline painting.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "perf-monitor-widget.h"
+#include "plugin-trace.h"
+
+#include <QFontMetrics>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPainter>
+#include <QPen>
+#include <QTimer>
+#include <QVBoxLayout>
+
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+constexpr int kSparkHeight    = 18;
+constexpr int kRowGap         = 6;
+constexpr int kMinRefreshMs   = 100;   /* faster than this is not readable */
+constexpr int kFooterTicks    = 8;     /* sampler cost changes slowly */
+
+/**
+ * @brief Plain paint surface; the owner does the drawing.
+ */
+class SparkLines : public QWidget {
+public:
+    using PaintFn = std::function<void(QPainter &, const QRect &)>;
+
+    SparkLines(PaintFn paint, QWidget *parent) : QWidget(parent), paint_(std::move(paint)) {}
+
+protected:
+    void paintEvent(QPaintEvent *) override
+    {
+        QPainter p(this);
+        paint_(p, rect());
+    }
+
+private:
+    PaintFn paint_;
+};
+
+QString formatValue(PerfMetric metric, const PerfSample &s)
+{
+    switch (metric) {
+    case PerfMetric::RenderLoad:
+        return QStringLiteral("%1 ms (%2%)").arg(s.renderMs, 0, 'f', 2).arg(s[metric], 0, 'f', 0);
+    case PerfMetric::Missed:
+        return QStringLiteral("%1 (%2%)").arg(s.missed).arg(s[metric], 0, 'f', 1);
+    case PerfMetric::Skipped:
+        return QStringLiteral("%1 (%2%)").arg(s.skipped).arg(s[metric], 0, 'f', 1);
+    case PerfMetric::Dropped:
+        return s.streaming ? QStringLiteral("%1 (%2%)").arg(s.dropped).arg(s[metric], 0, 'f', 1)
+                           : PerfMonitorWidget::tr("not streaming");
+    default:
+        return QStringLiteral("%1%").arg(s[metric], 0, 'f', 1);
+    }
+}
+
+} // namespace
+
+/* ------------------------------------------------------------------------- */
+/*  Construction                                                             */
+/* ------------------------------------------------------------------------- */
+PerfMonitorWidget::PerfMonitorWidget(PerfMonitor *monitor, QWidget *parent)
+    : QWidget(parent)
+    , monitor_(monitor)
+    , samples_(PerfMonitor::kHistory)
+{
+    line_.reserve(static_cast<int>(PerfMonitor::kHistory));
+
+    auto *layout = new QVBoxLayout;
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    auto *header = new QHBoxLayout;
+    header->addWidget(new QLabel(tr("Performance"), this));
+    header->addStretch();
+    status_ = new QLabel(this);
+    header->addWidget(status_);
+    layout->addLayout(header);
+
+    lines_ = new SparkLines([this](QPainter &p, const QRect &area) { paintLines(p, area); }, this);
+    lines_->setMinimumHeight(linesHeight());
+    layout->addWidget(lines_);
+
+    footer_ = new QLabel(this);
+    footer_->setEnabled(false);
+    layout->addWidget(footer_);
+
+    setLayout(layout);
+
+    timer_ = new QTimer(this);
+    connect(timer_, &QTimer::timeout, this, &PerfMonitorWidget::tick);
+
+    if (!monitor_)
+        status_->setText(tr("off"));
+}
+
+QString PerfMonitorWidget::metricName(PerfMetric metric)
+{
+    switch (metric) {
+    case PerfMetric::RenderLoad:
+        return tr("Render time");
+    case PerfMetric::Missed:
+        return tr("Missed frames");
+    case PerfMetric::Skipped:
+        return tr("Skipped frames");
+    case PerfMetric::Dropped:
+        return tr("Dropped frames");
+    case PerfMetric::Cpu:
+        return tr("CPU usage");
+    default:
+        return QString();
+    }
+}
+
+QString PerfMonitorWidget::alertText(const PerfAlert &alert)
+{
+    if (alert.raised)
+        return tr("%1 at %2% (limit %3%)")
+            .arg(metricName(alert.metric))
+            .arg(alert.value, 0, 'f', 1)
+            .arg(alert.limit, 0, 'g', 3);
+    return tr("%1 back below %2%").arg(metricName(alert.metric)).arg(alert.limit, 0, 'g', 3);
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Display                                                                  */
+/* ------------------------------------------------------------------------- */
+void PerfMonitorWidget::showEvent(QShowEvent *event)
+{
+    if (monitor_) {
+        timer_->start(kMinRefreshMs);   /* tick() adopts the sampling interval */
+        shown_ = 0;                     /* whatever arrived while hidden */
+        tick();
+        updateFooter();
+    }
+    QWidget::showEvent(event);
+}
+
+void PerfMonitorWidget::hideEvent(QHideEvent *event)
+{
+    timer_->stop();
+    QWidget::hideEvent(event);
+}
+
+void PerfMonitorWidget::tick()
+{
+    options_            = monitor_->options();
+    const int refreshMs = std::max(kMinRefreshMs, static_cast<int>(options_.interval.count()));
+    if (timer_->interval() != refreshMs)
+        timer_->setInterval(refreshMs);
+
+    if (++ticks_ >= kFooterTicks) {
+        ticks_ = 0;
+        updateFooter();
+    }
+    if (!options_.enabled)
+        status_->setText(tr("paused"));
+
+    /* nothing new: no copy, no repaint */
+    const uint64_t written = monitor_->written();
+    const uint32_t alerts  = monitor_->activeAlerts();
+    if (written == shown_ && alerts == alerts_)
+        return;
+
+    PF_TRACE_SCOPE("perf.paint");
+    count_  = monitor_->history(samples_.data(), samples_.size());
+    shown_  = written;
+    alerts_ = alerts;
+    if (options_.enabled && count_)
+        status_->setText(tr("%1 fps").arg(samples_[count_ - 1].fps, 0, 'f', 1));
+    lines_->update();
+}
+
+void PerfMonitorWidget::updateFooter()
+{
+    const PerfMonitorStats stats = monitor_->stats();
+    footer_->setText(tr("Sampler: %1 us/tick p99, %2% of a core (budget %3%)")
+                         .arg(stats.tickP99Us)
+                         .arg(stats.cpuPercent, 0, 'f', 3)
+                         .arg(options_.budgetPercent, 0, 'g', 2));
+}
+
+int PerfMonitorWidget::linesHeight() const
+{
+    return static_cast<int>(kPerfMetricCount) * (QFontMetrics(font()).height() + kSparkHeight + kRowGap);
+}
+
+void PerfMonitorWidget::paintLines(QPainter &p, const QRect &area) const
+{
+    const QFontMetrics fm(font());
+    const int          line  = fm.height();
+    const QColor       text  = palette().color(QPalette::Text);
+    const QColor       alarm(214, 60, 50);
+    int                y     = area.top();
+
+    /* newest sample at the right edge, one slot per history entry */
+    const double step = static_cast<double>(area.width()) / static_cast<double>(PerfMonitor::kHistory - 1);
+    const double x0   = area.right() - step * static_cast<double>(count_ ? count_ - 1 : 0);
+
+    for (size_t m = 0; m < kPerfMetricCount; ++m) {
+        const PerfMetric metric = static_cast<PerfMetric>(m);
+        const bool       raised = alerts_ & (1u << m);
+        const float      limit  = options_.limit[m];
+
+        p.setPen(raised ? alarm : text);
+        const QRect textRow(area.left(), y, area.width(), line);
+        p.drawText(textRow, Qt::AlignLeft | Qt::AlignVCenter, metricName(metric));
+        if (count_)
+            p.drawText(textRow, Qt::AlignRight | Qt::AlignVCenter, formatValue(metric, samples_[count_ - 1]));
+        y += line;
+
+        const QRect track(area.left(), y, area.width(), kSparkHeight);
+        p.fillRect(track, QColor(40, 40, 40));
+
+        /* the scale keeps the limit in view and never clips the history */
+        float peak = limit > 0.0f ? limit * 1.25f : 1.0f;
+        for (size_t i = 0; i < count_; ++i)
+            peak = std::max(peak, samples_[i].value[m]);
+        const double scale = (kSparkHeight - 2) / static_cast<double>(peak);
+        const double base  = track.bottom();
+
+        if (limit > 0.0f) {
+            p.setPen(QPen(QColor(120, 120, 120), 1, Qt::DashLine));
+            const int ly = static_cast<int>(base - limit * scale);
+            p.drawLine(track.left(), ly, track.right(), ly);
+        }
+
+        if (count_ > 1) {
+            line_.resize(static_cast<int>(count_));
+            for (size_t i = 0; i < count_; ++i)
+                line_[static_cast<int>(i)] = QPointF(x0 + step * static_cast<double>(i),
+                                                     base - samples_[i].value[m] * scale);
+            p.setPen(raised ? alarm : QColor(70, 190, 90));
+            p.drawPolyline(line_);
+        }
+        y += kSparkHeight + kRowGap;
+    }
+}
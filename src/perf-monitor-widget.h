@@ -0,0 +1,72 @@
+/*!
+ * @file perf-monitor-widget.h
+ * @brief Dock widget drawing the PerfMonitor history as sparklines.
+ *
+ * One row per PerfMetric: its current value and a sparkline of the history
+ * with the alert limit as a dashed line, red while the alert is raised. The
+ * widget only reads the monitor, on a timer that runs while it is visible,
+ * and repaints only when a new sample arrived. A footer shows what the
+ * sampler itself costs against its budget.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include "perf-monitor.h"
+
+#include <QPolygonF>
+#include <QString>
+#include <QWidget>
+
+#include <vector>
+
+class QHideEvent;
+class QLabel;
+class QPainter;
+class QRect;
+class QShowEvent;
+class QTimer;
+
+/**
+ * @class PerfMonitorWidget
+ * @brief Sparkline rows over a PerfMonitor owned elsewhere.
+ */
+class PerfMonitorWidget : public QWidget {
+    Q_OBJECT
+
+public:
+    /// @p monitor must outlive the widget; null shows the monitor as off.
+    explicit PerfMonitorWidget(PerfMonitor *monitor, QWidget *parent = nullptr);
+
+    static QString metricName(PerfMetric metric);
+
+    /// Notification text for a raised or cleared alert.
+    static QString alertText(const PerfAlert &alert);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    void tick();
+    void updateFooter();
+    int  linesHeight() const;
+    void paintLines(QPainter &p, const QRect &area) const;
+
+    PerfMonitor            *monitor_;
+    std::vector<PerfSample> samples_;          ///< kHistory slots, reused.
+    size_t                  count_       = 0;
+    uint64_t                shown_       = 0;  ///< written() at the last copy.
+    uint32_t                alerts_      = 0;
+    PerfMonitorOptions      options_;
+    mutable QPolygonF       line_;             ///< Reused by paintLines().
+    QWidget                *lines_       = nullptr;
+    QLabel                 *status_      = nullptr;
+    QLabel                 *footer_      = nullptr;
+    QTimer                 *timer_       = nullptr;
+    int                     ticks_       = 0;
+};
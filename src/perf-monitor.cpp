@@ -0,0 +1,280 @@
+/*!
+ * @file perf-monitor.cpp
+ * @brief Implements PerfMonitor: the sampler loop, rates, history and alerts.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "perf-monitor.h"
+
+#include <algorithm>
+#include <ctime>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+static_assert((PerfMonitor::kHistory & (PerfMonitor::kHistory - 1)) == 0, "kHistory must be a power of two");
+
+namespace {
+
+/* an output that restarts starts its counters over */
+uint64_t delta(uint64_t now, uint64_t before)
+{
+    return now >= before ? now - before : now;
+}
+
+float percentOf(uint64_t part, uint64_t whole)
+{
+    return whole ? static_cast<float>(static_cast<double>(part) * 100.0 / static_cast<double>(whole)) : 0.0f;
+}
+
+uint64_t nowNs()
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+}
+
+uint64_t budgetUs(const PerfMonitorOptions &options)
+{
+    const double intervalUs = std::chrono::duration<double, std::micro>(options.interval).count();
+    return static_cast<uint64_t>(intervalUs * options.budgetPercent / 100.0);
+}
+
+} // namespace
+
+/* ------------------------------------------------------------------------- */
+/*  Lifetime                                                                 */
+/* ------------------------------------------------------------------------- */
+PerfMonitor::PerfMonitor(ProbeFn probe, AlertFn alert)
+    : probe_(std::move(probe))
+    , alert_(std::move(alert))
+{
+}
+
+PerfMonitor::~PerfMonitor()
+{
+    stop();
+}
+
+void PerfMonitor::start(const PerfMonitorOptions &options)
+{
+    if (thread_.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        options_ = options;
+        stop_    = false;
+    }
+    thread_ = std::thread(&PerfMonitor::run, this);
+}
+
+void PerfMonitor::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    if (thread_.joinable())
+        thread_.join();
+}
+
+void PerfMonitor::setOptions(const PerfMonitorOptions &options)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        options_ = options;
+    }
+    wake_.notify_all();             /* a paused sampler resumes */
+}
+
+PerfMonitorOptions PerfMonitor::options() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return options_;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Sampler thread                                                           */
+/* ------------------------------------------------------------------------- */
+void PerfMonitor::run()
+{
+    const uint64_t startCpuUs = threadCpuUs();
+    const auto     started    = Clock::now();
+    auto           next       = started;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+        if (!options_.enabled) {
+            /* rates across a pause would average over it; alerts would be stale */
+            haveLast_ = false;
+            alerts_   = {};
+            activeAlerts_.store(0, std::memory_order_relaxed);
+            wake_.wait(lock, [this] { return stop_ || options_.enabled; });
+            next = Clock::now();
+            continue;
+        }
+        if (wake_.wait_until(lock, next, [this] { return stop_; }))
+            break;
+
+        const PerfMonitorOptions options = options_;
+        lock.unlock();
+
+        tick(options);
+
+        /* the whole thread, wake-ups included, not just the ticks */
+        cpuUs_.store(threadCpuUs() - startCpuUs, std::memory_order_relaxed);
+        const auto now = Clock::now();
+        sampledUs_.store(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - started).count()),
+                         std::memory_order_relaxed);
+
+        /* a tick that fell behind is skipped, not caught up in a burst */
+        next += options.interval;
+        if (next <= now) {
+            lateTicks_.fetch_add(static_cast<uint64_t>((now - next) / options.interval) + 1, std::memory_order_relaxed);
+            next = now + options.interval;
+        }
+        lock.lock();
+    }
+}
+
+void PerfMonitor::tick(const PerfMonitorOptions &options)
+{
+    const uint64_t cpu0 = threadCpuUs();
+    const uint64_t t0   = nowNs();
+
+    PerfCounters c;
+    if (!probe_ || !probe_(c)) {
+        probeFailures_.fetch_add(1, std::memory_order_relaxed);
+        haveLast_ = false;
+        return;
+    }
+
+    PerfSample s;
+    s.timeNs        = t0;
+    s.renderMs      = static_cast<float>(static_cast<double>(c.renderTimeNs) / 1e6);
+    s.fps           = static_cast<float>(c.fps);
+    s.streaming     = c.streaming;
+    s.value[static_cast<size_t>(PerfMetric::RenderLoad)] = percentOf(c.renderTimeNs, c.frameIntervalNs);
+    s.value[static_cast<size_t>(PerfMetric::Cpu)]        = static_cast<float>(c.cpuPercent);
+
+    if (haveLast_) {
+        const uint64_t rendered = delta(c.renderedFrames, last_.renderedFrames);
+        const uint64_t encoded  = delta(c.encodedFrames, last_.encodedFrames);
+        const uint64_t output   = delta(c.outputFrames, last_.outputFrames);
+        s.missed  = static_cast<uint32_t>(delta(c.laggedFrames, last_.laggedFrames));
+        s.skipped = static_cast<uint32_t>(delta(c.skippedFrames, last_.skippedFrames));
+        s.dropped = static_cast<uint32_t>(delta(c.droppedFrames, last_.droppedFrames));
+        s.value[static_cast<size_t>(PerfMetric::Missed)]  = percentOf(s.missed, rendered);
+        s.value[static_cast<size_t>(PerfMetric::Skipped)] = percentOf(s.skipped, encoded);
+        s.value[static_cast<size_t>(PerfMetric::Dropped)] = percentOf(s.dropped, output);
+    }
+    last_     = c;
+    haveLast_ = true;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const uint64_t n = written_.load(std::memory_order_relaxed);
+        ring_[n & (kHistory - 1)] = s;
+        written_.store(n + 1, std::memory_order_release);
+    }
+
+    checkAlerts(s, options);
+
+    tickNs_.record(nowNs() - t0);
+    if (threadCpuUs() - cpu0 > budgetUs(options))
+        overBudget_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PerfMonitor::checkAlerts(const PerfSample &sample, const PerfMonitorOptions &options)
+{
+    const uint64_t holdNs =
+        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(options.hold).count());
+
+    for (size_t i = 0; i < kPerfMetricCount; ++i) {
+        AlertState &a     = alerts_[i];
+        const float limit = options.limit[i];
+        const float value = sample.value[i];
+
+        /* a disabled limit clears its alert at once */
+        const bool over = limit > 0.0f && value >= limit;
+        if (over == a.active) {
+            a.since = 0;
+            continue;
+        }
+        if (limit > 0.0f) {
+            if (!a.since)
+                a.since = sample.timeNs;
+            if (sample.timeNs - a.since < holdNs)
+                continue;
+        }
+
+        a.active = over;
+        a.since  = 0;
+        const uint32_t bit = 1u << i;
+        if (over) {
+            activeAlerts_.fetch_or(bit, std::memory_order_relaxed);
+            alertsRaised_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            activeAlerts_.fetch_and(~bit, std::memory_order_relaxed);
+        }
+        if (alert_)
+            alert_(PerfAlert{static_cast<PerfMetric>(i), over, value, limit});
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Readers                                                                  */
+/* ------------------------------------------------------------------------- */
+size_t PerfMonitor::history(PerfSample *out, size_t max) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint64_t n     = written_.load(std::memory_order_relaxed);
+    const size_t   count = static_cast<size_t>(std::min<uint64_t>({n, kHistory, max}));
+    for (size_t i = 0; i < count; ++i)
+        out[i] = ring_[(n - count + i) & (kHistory - 1)];
+    return count;
+}
+
+PerfMonitorStats PerfMonitor::stats() const
+{
+    PerfMonitorStats s;
+    s.samples       = written_.load(std::memory_order_relaxed);
+    s.probeFailures = probeFailures_.load(std::memory_order_relaxed);
+    s.lateTicks     = lateTicks_.load(std::memory_order_relaxed);
+    s.overBudget    = overBudget_.load(std::memory_order_relaxed);
+    s.budgetUs      = budgetUs(options());
+    s.tickP50Us     = tickNs_.percentile(0.50) / 1000;
+    s.tickP99Us     = tickNs_.percentile(0.99) / 1000;
+    s.tickMaxUs     = tickNs_.max() / 1000;
+    s.cpuUs         = cpuUs_.load(std::memory_order_relaxed);
+    s.alertsRaised  = alertsRaised_.load(std::memory_order_relaxed);
+
+    const uint64_t sampledUs = sampledUs_.load(std::memory_order_relaxed);
+    s.cpuPercent = sampledUs ? static_cast<double>(s.cpuUs) * 100.0 / static_cast<double>(sampledUs) : 0.0;
+    return s;
+}
+
+uint64_t PerfMonitor::threadCpuUs()
+{
+#ifdef _WIN32
+    FILETIME created, exited, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &created, &exited, &kernel, &user))
+        return 0;
+    const auto ticks = [](const FILETIME &t) {
+        return (static_cast<uint64_t>(t.dwHighDateTime) << 32) | t.dwLowDateTime;
+    };
+    return (ticks(kernel) + ticks(user)) / 10;   /* 100 ns units */
+#else
+    timespec ts{};
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+        return 0;
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000u + static_cast<uint64_t>(ts.tv_nsec) / 1000u;
+#endif
+}
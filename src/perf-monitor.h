@@ -0,0 +1,200 @@
+/*!
+ * @file perf-monitor.h
+ * @brief Samples OBS frame timing and output counters on a thread of its own.
+ *
+ * A probe reads OBS's cumulative counters (render time, lagged, skipped and
+ * dropped frames, CPU usage) at a fixed interval. Each tick turns them into
+ * one PerfSample of per-interval rates, appends it to a fixed ring of the
+ * last kHistory samples and checks the alert limits. A limit has to be
+ * exceeded for the hold time before its alert is raised, and the value has
+ * to stay below it as long before the alert clears, so a single slow frame
+ * does not flap the alert.
+ *
+ * The sampler measures itself: the wall and thread CPU time of every tick
+ * go into a histogram, and ticks over the budget (by default 0.1% of one
+ * core, i.e. 250 us of CPU per 250 ms tick) are counted. The UI copies the
+ * history out only when written() has moved, so a hidden dock costs nothing.
+ *
+ * No OBS or Qt dependency: the OBS probe lives in perf-monitor-obs.cpp.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include "plugin-trace.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+/// What a sample measures and an alert watches, in percent.
+enum class PerfMetric : uint8_t {
+    RenderLoad,   ///< Average render time as a share of the frame interval.
+    Missed,       ///< Frames missed due to rendering lag.
+    Skipped,      ///< Frames skipped due to encoding lag.
+    Dropped,      ///< Frames dropped by the streaming output (network).
+    Cpu,          ///< OBS process CPU usage.
+    Count,
+};
+
+inline constexpr size_t kPerfMetricCount = static_cast<size_t>(PerfMetric::Count);
+
+/**
+ * @brief Cumulative counters as OBS reports them; filled by the probe.
+ */
+struct PerfCounters {
+    uint64_t renderedFrames  = 0;   ///< obs_get_total_frames().
+    uint64_t laggedFrames    = 0;   ///< obs_get_lagged_frames().
+    uint64_t encodedFrames   = 0;   ///< video_output_get_total_frames().
+    uint64_t skippedFrames   = 0;   ///< video_output_get_skipped_frames().
+    uint64_t outputFrames    = 0;   ///< obs_output_get_total_frames() of the stream.
+    uint64_t droppedFrames   = 0;   ///< obs_output_get_frames_dropped() of the stream.
+    uint64_t renderTimeNs    = 0;   ///< Average, not cumulative.
+    uint64_t frameIntervalNs = 0;
+    double   cpuPercent      = 0.0;
+    double   fps             = 0.0;
+    bool     streaming       = false;
+};
+
+/**
+ * @brief One tick's rates; what the history holds.
+ */
+struct PerfSample {
+    uint64_t timeNs = 0;                      ///< steady_clock, since its epoch.
+    float    value[kPerfMetricCount] = {};    ///< Indexed by PerfMetric.
+    float    renderMs = 0.0f;
+    float    fps      = 0.0f;
+    uint32_t missed   = 0;                    ///< Frames in this interval.
+    uint32_t skipped  = 0;
+    uint32_t dropped  = 0;
+    bool     streaming = false;
+
+    float operator[](PerfMetric m) const { return value[static_cast<size_t>(m)]; }
+};
+
+static_assert(std::is_trivially_copyable_v<PerfSample>);
+
+/**
+ * @brief A raised or cleared alert; handed to the alert callback.
+ */
+struct PerfAlert {
+    PerfMetric metric = PerfMetric::RenderLoad;
+    bool       raised = false;   ///< false: cleared.
+    float      value  = 0.0f;
+    float      limit  = 0.0f;
+};
+
+struct PerfMonitorOptions {
+    bool                      enabled  = true;
+    std::chrono::milliseconds interval {250};
+    std::chrono::milliseconds hold     {3000};   ///< How long a limit must be crossed, either way.
+    float                     limit[kPerfMetricCount] = {};   ///< 0 disables the alert.
+    double                    budgetPercent = 0.1;  ///< Sampler CPU time allowed, in % of one core.
+};
+
+struct PerfMonitorStats {
+    uint64_t samples       = 0;
+    uint64_t probeFailures = 0;
+    uint64_t lateTicks     = 0;   ///< Ticks skipped because the sampler fell behind.
+    uint64_t overBudget    = 0;   ///< Ticks whose CPU time exceeded the per-tick budget.
+    uint64_t budgetUs      = 0;   ///< Per-tick budget at the current interval.
+    uint64_t tickP50Us     = 0;   ///< Wall time per tick.
+    uint64_t tickP99Us     = 0;
+    uint64_t tickMaxUs     = 0;
+    uint64_t cpuUs         = 0;   ///< Sampler thread CPU time, all ticks.
+    double   cpuPercent    = 0.0; ///< cpuUs over the time sampled, in % of one core.
+    uint64_t alertsRaised  = 0;
+};
+
+/**
+ * @class PerfMonitor
+ * @brief The sampler thread, its history ring and the alert state.
+ *
+ * start() and stop() belong to the owner; everything else may be called
+ * from any thread. The probe and the alert callback run on the sampler
+ * thread and must not block.
+ */
+class PerfMonitor {
+public:
+    static constexpr size_t kHistory = 256;   ///< Power of two; about a minute at 250 ms.
+
+    using ProbeFn = std::function<bool(PerfCounters &counters)>;
+    using AlertFn = std::function<void(const PerfAlert &alert)>;
+
+    explicit PerfMonitor(ProbeFn probe, AlertFn alert = {});
+    ~PerfMonitor();
+
+    PerfMonitor(const PerfMonitor &) = delete;
+    PerfMonitor &operator=(const PerfMonitor &) = delete;
+
+    void start(const PerfMonitorOptions &options);
+    void stop();
+    bool running() const { return thread_.joinable(); }
+
+    /// Takes effect at the next tick; disabling pauses the sampler.
+    void setOptions(const PerfMonitorOptions &options);
+    PerfMonitorOptions options() const;
+
+    /// Samples taken so far; the history changed when this did.
+    uint64_t written() const { return written_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Copies the newest samples, oldest first, into @p out.
+     * @return How many were copied, at most min(@p max, kHistory).
+     */
+    size_t history(PerfSample *out, size_t max) const;
+
+    /// Bit i set while the alert of metric i is raised.
+    uint32_t activeAlerts() const { return activeAlerts_.load(std::memory_order_relaxed); }
+
+    PerfMonitorStats stats() const;
+
+    /// CPU time of the calling thread, in microseconds.
+    static uint64_t threadCpuUs();
+
+private:
+    struct AlertState {
+        bool     active = false;
+        uint64_t since  = 0;   ///< When the value last crossed the limit towards the other state; 0: not crossing.
+    };
+
+    void run();
+    void tick(const PerfMonitorOptions &options);
+    void checkAlerts(const PerfSample &sample, const PerfMonitorOptions &options);
+
+    ProbeFn probe_;
+    AlertFn alert_;
+
+    mutable std::mutex      mutex_;        ///< options_, stop_ and the ring.
+    std::condition_variable wake_;
+    PerfMonitorOptions      options_;
+    bool                    stop_ = false;
+    std::array<PerfSample, kHistory> ring_{};
+    std::atomic<uint64_t>   written_{0};
+    std::thread             thread_;
+
+    /* sampler thread only */
+    PerfCounters                       last_;
+    bool                               haveLast_ = false;
+    std::array<AlertState, kPerfMetricCount> alerts_{};
+
+    std::atomic<uint32_t> activeAlerts_{0};
+    std::atomic<uint64_t> probeFailures_{0};
+    std::atomic<uint64_t> lateTicks_{0};
+    std::atomic<uint64_t> overBudget_{0};
+    std::atomic<uint64_t> cpuUs_{0};
+    std::atomic<uint64_t> sampledUs_{0};
+    std::atomic<uint64_t> alertsRaised_{0};
+    TraceHistogram        tickNs_;
+};
@@ -9,23 +9,87 @@
  */
 
 #include "plugin-dock.h"
+#include "audio-meter-widget.h"
+#include "perf-monitor-widget.h"
 #include <QVBoxLayout>
 #include <QLabel>
 #include "config-dialog.h"
+#include "plugin-startup.h"
+#include "plugin-trace.h"
+#include "toast-helper.h"
+
+#include <obs-module.h>
+#include <util/bmem.h>
+#include <util/platform.h>
+
+#include <QDateTime>
+#include <QHBoxLayout>
+#include <QShowEvent>
+#include <QTimer>
+
+#include <memory>
 
 
 /**
  * @brief Constructs the PlayFameDock.
  *
- * Sets up the dock's UI, including layout and widgets, parented to the given OBS main window.
+ * Creates only the dock shell, parented to the given OBS main window; the
+ * widgets follow in buildUi() on first show.
  *
+ * @param perf   The plugin's performance monitor, drawn by the dock.
  * @param parent The OBS main window widget to attach this dock to.
  */
-PlayFameDock::PlayFameDock(OBSConfigHelper *cfg, QWidget *parent)
+PlayFameDock::PlayFameDock(OBSConfigHelper *cfg, PerfMonitor *perf, QWidget *parent)
     : QWidget(parent)
     , cfg_(cfg)
+    , perf_(perf)
 {
     setWindowTitle(kDockName);
+    startDumpPoll();
+}
+
+/**
+ * @brief Polls for SIGUSR1 dump requests, once the trigger is installed.
+ *
+ * The trigger exists only while tracing was requested, so an idle dock
+ * runs no timer.
+ */
+void PlayFameDock::startDumpPoll()
+{
+    if (dumpPoll_ || !Trace::signalTriggerInstalled())
+        return;
+
+    /* SIGUSR1 only sets a flag; the dump itself happens here on the UI thread */
+    dumpPoll_ = new QTimer(this);
+    connect(dumpPoll_, &QTimer::timeout, this, [this]() {
+        if (Trace::takeDumpRequest())
+            dumpTrace();
+    });
+    dumpPoll_->start(500);
+}
+
+/**
+ * @brief Builds the widgets the first time the dock becomes visible.
+ */
+void PlayFameDock::showEvent(QShowEvent *event)
+{
+    if (!built_) {
+        built_ = true;
+        StartupSequence::global().measure(StartupPhase::FirstShow, "dock.build", std::chrono::milliseconds(16),
+                                          [this] {
+            PF_TRACE_SCOPE("dock.build");
+            buildUi();
+            return true;
+        });
+    }
+    QWidget::showEvent(event);
+}
+
+/**
+ * @brief Sets up the dock's layout and widgets.
+ */
+void PlayFameDock::buildUi()
+{
     auto *layout = new QVBoxLayout;
     layout->setAlignment(Qt::AlignTop | Qt::AlignHCenter);
 
@@ -40,11 +104,46 @@ PlayFameDock::PlayFameDock(OBSConfigHelper *cfg, QWidget *parent)
         "QPushButton:hover { background:#368af0; }");
     layout->addWidget(cfgBtn);
 
+    /* kept current by a subscription instead of polling the config */
+    status_ = new QLabel(cfg_->get(ConfigSchema::kDemoText), this);
+    status_->setAlignment(Qt::AlignHCenter);
+    layout->addWidget(status_);
+    subscription_ = cfg_->subscribe(ConfigSchema::kDemoText, this, [this](const std::vector<ConfigChange> &) {
+        status_->setText(cfg_->get(ConfigSchema::kDemoText));
+    });
+
     connect(cfgBtn, &QPushButton::clicked, this, [this]() {
-        ConfigDialog dlg(cfg_, this);
-        dlg.exec();
+        std::unique_ptr<ConfigDialog> dlg;
+        {
+            PF_TRACE_SCOPE("dialog.open");
+            dlg = std::make_unique<ConfigDialog>(cfg_, this);
+        }
+        dlg->exec();
     });
 
+    /* tracing controls; PLAYFAME_TRACE=1 in the environment starts enabled */
+    auto *traceRow = new QHBoxLayout;
+    auto *traceBtn = new QPushButton("Trace", this);
+    traceBtn->setCheckable(true);
+    traceBtn->setChecked(Trace::enabled());
+    auto *dumpBtn = new QPushButton("Dump trace", this);
+    traceRow->addWidget(traceBtn);
+    traceRow->addWidget(dumpBtn);
+    layout->addLayout(traceRow);
+
+    connect(traceBtn, &QPushButton::toggled, this, [this](bool on) {
+        Trace::setEnabled(on);
+        if (on && Trace::installSignalTrigger())
+            startDumpPoll();
+    });
+    connect(dumpBtn, &QPushButton::clicked, this, &PlayFameDock::dumpTrace);
+
+    /* meters the sources in the "meter" section; idles while the dock is hidden */
+    layout->addWidget(new AudioMeterWidget(cfg_, this));
+
+    /* sparklines of the sampler's history; reads nothing while the dock is hidden */
+    layout->addWidget(new PerfMonitorWidget(perf_, this));
+
     setLayout(layout);
 }
 
@@ -55,9 +154,34 @@ PlayFameDock::PlayFameDock(OBSConfigHelper *cfg, QWidget *parent)
  */
 PlayFameDock::~PlayFameDock()
 {
+    if (subscription_)
+        cfg_->unsubscribe(subscription_);
     // Do NOT unregister here; obs_module_unload() handles that.
 }
 
+/**
+ * @brief Writes the Chrome trace to <config>/traces/playfame-trace-<timestamp>.json.
+ */
+void PlayFameDock::dumpTrace()
+{
+    const QString name = QStringLiteral("traces/playfame-trace-%1.json")
+                             .arg(QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss"));
+
+    char *dir  = obs_module_config_path("traces");
+    char *path = obs_module_config_path(name.toUtf8().constData());
+    if (dir)
+        os_mkdirs(dir);
+
+    const bool ok = path && Trace::writeChromeTrace(path);
+    if (ok)
+        showToast(this, tr("Trace written to %1").arg(QString::fromUtf8(path)));
+    else
+        showToast(this, tr("Could not write trace file"), true);
+
+    bfree(dir);
+    bfree(path);
+}
+
 /**
  * @brief Registers this dock with the OBS frontend.
  *
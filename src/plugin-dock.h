@@ -14,17 +14,25 @@
 #include "obs-config-helper.h"
 #include <QWidget>
 
+class PerfMonitor;
+class QLabel;
+class QTimer;
+class QShowEvent;
+
 /**
  * @class PlayFameDock
  * @brief Dockable widget for the PlayFame plugin within OBS.
  *
  * Inherits from QWidget and provides UI integration with the OBS main window.
+ * Construction only creates the empty shell OBS docks; the widgets are built
+ * when the dock is first shown, so a hidden dock costs nothing at startup.
  */
 class PlayFameDock : public QWidget {
     Q_OBJECT
 
 public:
-    explicit PlayFameDock(OBSConfigHelper *cfg, QWidget *parent = nullptr);
+    /// @p perf is the plugin's performance monitor; it outlives the dock.
+    PlayFameDock(OBSConfigHelper *cfg, PerfMonitor *perf, QWidget *parent = nullptr);
     ~PlayFameDock() override;
 
     /// Register the dock with OBS. Returns true on success.
@@ -33,9 +41,26 @@ public:
     /// Unregister the dock from OBS.
     void unregisterDock();
 
+    /// Writes the current trace to the plugin config dir and reports the path.
+    void dumpTrace();
+
+protected:
+    void showEvent(QShowEvent *event) override;
+
 private:
+    /// Creates the widgets; called on first show.
+    void buildUi();
+
+    /// Starts polling for SIGUSR1 dump requests once the trigger is installed.
+    void startDumpPoll();
+
     static constexpr const char *kDockId   = "playfame_dock";
     static constexpr const char *kDockName = "PlayFame";
     OBSConfigHelper *cfg_;   
+    PerfMonitor     *perf_;
+    QLabel          *status_       = nullptr; ///< Shows the configured text.
+    uint64_t         subscription_ = 0;
+    bool             built_        = false;
+    QTimer          *dumpPoll_     = nullptr;
 
 };
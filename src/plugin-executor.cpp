@@ -0,0 +1,565 @@
+/*!
+ * @file plugin-executor.cpp
+ * @brief Implements the plugin-wide work-stealing executor.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "plugin-executor.h"
+#include "plugin-support.h"
+
+#include <obs-module.h>
+
+#include <algorithm>
+
+namespace {
+
+/* the worker the current thread is, if any */
+thread_local const PluginExecutor *t_executor = nullptr;
+thread_local size_t                t_worker   = 0;
+
+constexpr size_t kLanes = 2;
+
+size_t laneIndex(TaskLane lane)
+{
+    return static_cast<size_t>(lane);
+}
+
+size_t defaultWorkers()
+{
+    const size_t cores = std::thread::hardware_concurrency();
+    return std::clamp<size_t>(cores > 1 ? cores - 1 : 2, 2, 16);
+}
+
+void raiseMax(std::atomic<size_t> &max, size_t value)
+{
+    size_t seen = max.load(std::memory_order_relaxed);
+    while (seen < value && !max.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
+/* ------------------------------------------------------------------------- */
+/*  TaskGroup                                                                */
+/* ------------------------------------------------------------------------- */
+void executor_detail::GroupState::add()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    ++outstanding;
+}
+
+void executor_detail::GroupState::done()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--outstanding == 0)
+        idle.notify_all();
+}
+
+TaskGroup::TaskGroup(TaskLane lane, PluginExecutor &executor)
+    : executor_(executor)
+    , lane_(lane)
+    , state_(std::make_shared<executor_detail::GroupState>())
+{
+}
+
+TaskGroup::~TaskGroup()
+{
+    cancel();
+    wait();
+}
+
+bool TaskGroup::post(PluginExecutor::TaskFn fn, CancelToken token)
+{
+    return postAfter(std::chrono::milliseconds(0), std::move(fn), std::move(token));
+}
+
+bool TaskGroup::postAfter(std::chrono::milliseconds delay, PluginExecutor::TaskFn fn, CancelToken token)
+{
+    state_->add();
+    PluginExecutor::Task task;
+    task.fn    = std::move(fn);
+    task.token = std::move(token);
+    task.group = state_;
+    task.lane  = lane_;
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(delay).count();
+    return executor_.enqueue(std::move(task), ns > 0 ? static_cast<uint64_t>(ns) : 0);
+}
+
+void TaskGroup::cancel()
+{
+    state_->token.cancel();
+    executor_.purge(state_);
+}
+
+bool TaskGroup::wait(std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    auto idle = [this] { return state_->outstanding == 0; };
+    if (timeout == std::chrono::milliseconds::max()) {
+        state_->idle.wait(lock, idle);
+        return true;
+    }
+    return state_->idle.wait_for(lock, timeout, idle);
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Lifecycle                                                                */
+/* ------------------------------------------------------------------------- */
+PluginExecutor &PluginExecutor::global()
+{
+    static PluginExecutor executor;
+    return executor;
+}
+
+PluginExecutor::~PluginExecutor()
+{
+    shutdown();
+}
+
+void PluginExecutor::start(ExecutorOptions options)
+{
+    std::lock_guard<std::mutex> lock(startMutex_);
+    if (started_.load(std::memory_order_acquire))
+        return;
+    {
+        std::lock_guard<std::mutex> injectLock(injectMutex_);
+        if (closed_)
+            return;
+    }
+
+    options_ = options;
+    if (options_.workers == 0)
+        options_.workers = defaultWorkers();
+    if (options_.maxBackground == 0 || options_.maxBackground >= options_.workers)
+        options_.maxBackground = std::max<size_t>(1, options_.workers - 1);
+
+    /* the vector is complete before any worker looks at it */
+    for (size_t i = 0; i < options_.workers; ++i)
+        workers_.push_back(std::make_unique<Worker>());
+    {
+        std::lock_guard<std::mutex> exitLock(exitMutex_);
+        liveWorkers_ = workers_.size();
+    }
+    started_.store(true, std::memory_order_release);
+    for (size_t i = 0; i < workers_.size(); ++i)
+        workers_[i]->thread = std::thread(&PluginExecutor::runWorker, this, i);
+
+    obs_log(LOG_INFO, "[Executor] Started %zu workers (%zu may run background work)", options_.workers,
+            options_.maxBackground);
+}
+
+bool PluginExecutor::shutdown(std::chrono::milliseconds timeout)
+{
+    std::lock_guard<std::mutex> startLock(startMutex_);
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        if (stopping_)
+            return true;
+        stopping_ = true;
+        nextDueNs_.store(nextDue());   /* delayed tasks are due now */
+    }
+    wake_.notify_all();
+
+    bool finished = true;
+    {
+        std::unique_lock<std::mutex> lock(exitMutex_);
+        auto gone = [this] { return liveWorkers_ == 0; };
+        if (timeout == std::chrono::milliseconds::max())
+            exited_.wait(lock, gone);
+        else
+            finished = exited_.wait_for(lock, timeout, gone);
+    }
+    for (auto &worker : workers_) {
+        if (!worker->thread.joinable())
+            continue;
+        if (finished)
+            worker->thread.join();
+        else
+            worker->thread.detach();
+    }
+
+    std::deque<Task> left[kLanes];
+    {
+        std::lock_guard<std::mutex> lock(injectMutex_);
+        closed_ = true;
+        if (finished) {
+            for (size_t l = 0; l < kLanes; ++l)
+                left[l].swap(inject_[l]);
+        }
+    }
+    if (!finished) {
+        obs_log(LOG_WARNING, "[Executor] Workers still busy after %lld ms; detached",
+                static_cast<long long>(timeout.count()));
+        return false;
+    }
+
+    /* posted by other threads after the last worker looked, or before start() */
+    for (size_t l = 0; l < kLanes; ++l)
+        lanes_[l].depth.fetch_sub(left[l].size());
+    std::vector<Delayed> delayed;
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        delayed.swap(delayed_);
+    }
+    for (Delayed &d : delayed)
+        left[laneIndex(d.task.lane)].push_back(std::move(d.task));
+    for (size_t l = 0; l < kLanes; ++l) {
+        for (Task &task : left[l])
+            execute(task);
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Posting                                                                  */
+/* ------------------------------------------------------------------------- */
+bool PluginExecutor::post(TaskLane lane, TaskFn fn, CancelToken token)
+{
+    return postAfter(std::chrono::milliseconds(0), lane, std::move(fn), std::move(token));
+}
+
+bool PluginExecutor::postAfter(std::chrono::milliseconds delay, TaskLane lane, TaskFn fn, CancelToken token)
+{
+    Task task;
+    task.fn    = std::move(fn);
+    task.token = std::move(token);
+    task.lane  = lane;
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(delay).count();
+    return enqueue(std::move(task), ns > 0 ? static_cast<uint64_t>(ns) : 0);
+}
+
+bool PluginExecutor::enqueue(Task task, uint64_t delayNs)
+{
+    if (!started_.load(std::memory_order_acquire) && this == &global())
+        start();
+
+    LaneCounters &counters = lanes_[laneIndex(task.lane)];
+    counters.submitted.fetch_add(1, std::memory_order_relaxed);
+
+    if (delayNs > 0) {
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        if (!stopping_) {
+            const uint64_t due = Trace::nowNs() + delayNs;
+            delayed_.push_back(Delayed{due, sequence_++, std::move(task)});
+            std::push_heap(delayed_.begin(), delayed_.end(), [](const Delayed &a, const Delayed &b) {
+                return a.dueNs != b.dueNs ? a.dueNs > b.dueNs : a.sequence > b.sequence;
+            });
+            const bool earlier = due < nextDueNs_.load();
+            if (earlier)
+                nextDueNs_.store(due);
+            lock.unlock();
+            if (earlier)
+                wake_.notify_one();   /* a sleeper recomputes its deadline */
+            return true;
+        }
+    }
+
+    if (pushReady(task))
+        return true;
+    counters.submitted.fetch_sub(1, std::memory_order_relaxed);
+    task.fn = nullptr;
+    if (task.group)
+        task.group->done();
+    return false;
+}
+
+bool PluginExecutor::pushReady(Task &task)
+{
+    const size_t l = laneIndex(task.lane);
+    task.readyNs   = Trace::nowNs();
+
+    if (t_executor == this) {
+        Worker &self = *workers_[t_worker];
+        std::lock_guard<std::mutex> lock(self.mutex);
+        self.lanes[l].push_back(std::move(task));
+    } else {
+        std::lock_guard<std::mutex> lock(injectMutex_);
+        if (closed_)
+            return false;
+        inject_[l].push_back(std::move(task));
+    }
+
+    /* seq_cst, paired with sleepers_ in runWorker(): either the sleeper sees
+     * the depth or we see the sleeper */
+    const size_t depth = lanes_[l].depth.fetch_add(1) + 1;
+    raiseMax(lanes_[l].maxDepth, depth);
+    wakeOne();
+    return true;
+}
+
+void PluginExecutor::wakeOne()
+{
+    if (sleepers_.load() == 0)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);   /* the sleeper is inside wait() */
+    }
+    wake_.notify_one();
+}
+
+void PluginExecutor::postToUi(QObject *context, TaskFn fn)
+{
+    uiPosted_.fetch_add(1, std::memory_order_relaxed);
+    uiDepth_.fetch_add(1, std::memory_order_relaxed);
+    /* the depth drops when the functor goes, even if Qt never runs it */
+    std::shared_ptr<void> queued(nullptr, [this](void *) { uiDepth_.fetch_sub(1, std::memory_order_relaxed); });
+    const uint64_t postedNs = Trace::nowNs();
+    QMetaObject::invokeMethod(
+        context,
+        [this, fn = std::move(fn), queued = std::move(queued), postedNs]() {
+            uiUs_.record((Trace::nowNs() - postedNs) / 1000);
+            fn();
+        },
+        Qt::QueuedConnection);
+}
+
+bool PluginExecutor::isWorkerThread() const
+{
+    return t_executor == this;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Workers                                                                  */
+/* ------------------------------------------------------------------------- */
+void PluginExecutor::runWorker(size_t self)
+{
+    t_executor = this;
+    t_worker   = self;
+
+    for (;;) {
+        const uint64_t now = Trace::nowNs();
+        if (nextDueNs_.load() <= now)
+            promoteDue(now);
+
+        Task task;
+        if (findTask(self, task)) {
+            execute(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        sleepers_.fetch_add(1);
+        bool exit = false;
+        for (;;) {
+            const uint64_t t = Trace::nowNs();
+            if (ready(t))
+                break;
+            if (stopping_ && delayed_.empty()) {
+                exit = true;
+                break;
+            }
+            const uint64_t due = nextDueNs_.load();
+            if (due <= t)
+                continue;
+            if (due == UINT64_MAX)
+                wake_.wait(lock);
+            else
+                wake_.wait_for(lock, std::chrono::nanoseconds(due - t));
+        }
+        sleepers_.fetch_sub(1);
+        if (exit)
+            break;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(exitMutex_);
+        --liveWorkers_;
+    }
+    exited_.notify_all();
+    wake_.notify_all();               /* another sleeper may be the last one out */
+}
+
+bool PluginExecutor::ready(uint64_t nowNs) const
+{
+    if (lanes_[laneIndex(TaskLane::Interactive)].depth.load() > 0)
+        return true;
+    if (lanes_[laneIndex(TaskLane::Background)].depth.load() > 0 &&
+        runningBackground_.load() < options_.maxBackground)
+        return true;
+    return !delayed_.empty() && nextDueNs_.load() <= nowNs;
+}
+
+bool PluginExecutor::findTask(size_t self, Task &out)
+{
+    if (popLane(self, TaskLane::Interactive, out))
+        return true;
+
+    if (lanes_[laneIndex(TaskLane::Background)].depth.load() == 0 || !reserveBackground())
+        return false;
+    if (popLane(self, TaskLane::Background, out))
+        return true;              /* the slot is released in finish() */
+    runningBackground_.fetch_sub(1);
+    return false;
+}
+
+bool PluginExecutor::reserveBackground()
+{
+    size_t running = runningBackground_.load();
+    while (running < options_.maxBackground) {
+        if (runningBackground_.compare_exchange_weak(running, running + 1))
+            return true;
+    }
+    return false;
+}
+
+bool PluginExecutor::popLane(size_t self, TaskLane lane, Task &out)
+{
+    const size_t l = laneIndex(lane);
+    LaneCounters &counters = lanes_[l];
+    if (counters.depth.load() == 0)
+        return false;
+
+    auto take = [&](std::deque<Task> &queue, bool newest) {
+        if (queue.empty())
+            return false;
+        if (newest) {
+            out = std::move(queue.back());
+            queue.pop_back();
+        } else {
+            out = std::move(queue.front());
+            queue.pop_front();
+        }
+        counters.depth.fetch_sub(1);
+        return true;
+    };
+
+    {
+        Worker &own = *workers_[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (take(own.lanes[l], true))
+            return true;
+    }
+    {
+        std::lock_guard<std::mutex> lock(injectMutex_);
+        if (take(inject_[l], false))
+            return true;
+    }
+    for (size_t i = 1; i < workers_.size(); ++i) {
+        Worker &victim = *workers_[(self + i) % workers_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (take(victim.lanes[l], false)) {
+            counters.stolen.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void PluginExecutor::promoteDue(uint64_t nowNs)
+{
+    std::vector<Task> due;
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        auto later = [](const Delayed &a, const Delayed &b) {
+            return a.dueNs != b.dueNs ? a.dueNs > b.dueNs : a.sequence > b.sequence;
+        };
+        while (!delayed_.empty() && (stopping_ || delayed_.front().dueNs <= nowNs)) {
+            std::pop_heap(delayed_.begin(), delayed_.end(), later);
+            due.push_back(std::move(delayed_.back().task));
+            delayed_.pop_back();
+        }
+        nextDueNs_.store(nextDue());
+    }
+    for (Task &task : due) {
+        if (!pushReady(task))
+            finish(task, false);
+    }
+}
+
+/* under sleepMutex_; while stopping every delayed task is due */
+uint64_t PluginExecutor::nextDue() const
+{
+    if (delayed_.empty())
+        return UINT64_MAX;
+    return stopping_ ? 0 : delayed_.front().dueNs;
+}
+
+void PluginExecutor::execute(Task &task)
+{
+    LaneCounters &counters = lanes_[laneIndex(task.lane)];
+    if (task.token.cancelled() || (task.group && task.group->token.cancelled())) {
+        finish(task, false);
+    } else {
+        const uint64_t startNs = Trace::nowNs();
+        counters.waitUs.record((startNs - task.readyNs) / 1000);
+        task.fn();
+        counters.runUs.record((Trace::nowNs() - startNs) / 1000);
+        finish(task, true);
+    }
+
+    /* release the slot findTask() reserved */
+    if (task.lane == TaskLane::Background && t_executor == this) {
+        runningBackground_.fetch_sub(1);
+        if (lanes_[laneIndex(TaskLane::Background)].depth.load() > 0)
+            wakeOne();                /* a sleeper may have been held back by the cap */
+    }
+}
+
+void PluginExecutor::finish(Task &task, bool ran)
+{
+    LaneCounters &counters = lanes_[laneIndex(task.lane)];
+    (ran ? counters.completed : counters.cancelled).fetch_add(1, std::memory_order_relaxed);
+
+    /* captures go before the group is told, so its owner may be destroyed */
+    task.fn = nullptr;
+    if (task.group)
+        task.group->done();
+}
+
+void PluginExecutor::purge(const std::shared_ptr<executor_detail::GroupState> &group)
+{
+    std::vector<Task> dropped;
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        auto keep = std::partition(delayed_.begin(), delayed_.end(),
+                                   [&group](const Delayed &d) { return d.task.group != group; });
+        for (auto it = keep; it != delayed_.end(); ++it)
+            dropped.push_back(std::move(it->task));
+        delayed_.erase(keep, delayed_.end());
+        std::make_heap(delayed_.begin(), delayed_.end(), [](const Delayed &a, const Delayed &b) {
+            return a.dueNs != b.dueNs ? a.dueNs > b.dueNs : a.sequence > b.sequence;
+        });
+        nextDueNs_.store(nextDue());
+    }
+    /* ready tasks of the group are dropped when a worker pops them */
+    for (Task &task : dropped)
+        finish(task, false);
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Metrics                                                                  */
+/* ------------------------------------------------------------------------- */
+ExecutorStats PluginExecutor::stats() const
+{
+    ExecutorStats s;
+    s.workers = started_.load(std::memory_order_acquire) ? options_.workers : 0;
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        s.delayed = delayed_.size();
+    }
+    for (size_t l = 0; l < kLanes; ++l) {
+        const LaneCounters &c = lanes_[l];
+        ExecutorLaneStats &out = s.lanes[l];
+        out.submitted = c.submitted.load(std::memory_order_relaxed);
+        out.completed = c.completed.load(std::memory_order_relaxed);
+        out.cancelled = c.cancelled.load(std::memory_order_relaxed);
+        out.stolen    = c.stolen.load(std::memory_order_relaxed);
+        out.depth     = c.depth.load(std::memory_order_relaxed);
+        out.maxDepth  = c.maxDepth.load(std::memory_order_relaxed);
+        out.waitP50Us = c.waitUs.percentile(0.50);
+        out.waitP99Us = c.waitUs.percentile(0.99);
+        out.waitMaxUs = c.waitUs.max();
+        out.runP50Us  = c.runUs.percentile(0.50);
+        out.runP99Us  = c.runUs.percentile(0.99);
+        out.runMaxUs  = c.runUs.max();
+    }
+    s.uiPosted = uiPosted_.load(std::memory_order_relaxed);
+    s.uiDepth  = uiDepth_.load(std::memory_order_relaxed);
+    s.uiP99Us  = uiUs_.percentile(0.99);
+    s.uiMaxUs  = uiUs_.max();
+    return s;
+}
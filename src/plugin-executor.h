@@ -0,0 +1,325 @@
+/*!
+ * @file plugin-executor.h
+ * @brief Plugin-wide task executor: work-stealing pool, priority lanes, UI continuations.
+ *
+ * One pool of worker threads, sized to the cores, runs the plugin's short
+ * jobs (config saves and reloads, searches, later network and encoding
+ * work) so features no longer start a thread each.
+ *
+ * - Every worker owns a deque per lane. Tasks posted from a worker go to
+ *   its own deque and are popped newest first (they touch data that is
+ *   still in its cache); idle workers steal the oldest task of another
+ *   worker. Tasks posted from other threads enter shared injection queues.
+ * - Two lanes: Interactive work (the user is waiting) always goes first,
+ *   and Background work (disk, network) may occupy all workers but one, so
+ *   a slow write never delays a search.
+ * - postAfter() runs a task once a delay has passed (debouncing, retries).
+ * - A CancelToken drops tasks that have not started and tells running ones
+ *   to stop early. A TaskGroup ties tasks to an owner: its destructor
+ *   cancels what is pending and waits for what is running, so tasks never
+ *   outlive the object they use.
+ * - post() with a QObject context runs the work on the pool and its
+ *   continuation on the context's thread, typically the UI thread.
+ * - stats() reports queue depths and wait/run latency percentiles per lane.
+ *
+ * Tasks posted before start() wait for it; global() starts itself with the
+ * default options on first use. After shutdown() posting fails and callers
+ * fall back to doing the work inline.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include "plugin-trace.h"
+
+#include <QMetaObject>
+#include <QObject>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+enum class TaskLane { Interactive, Background };
+
+/**
+ * @brief Shared stop flag for tasks.
+ *
+ * Copies share one flag. A default-constructed token can never be
+ * cancelled and costs nothing to check.
+ */
+class CancelToken {
+public:
+    CancelToken() = default;
+
+    static CancelToken create() { return CancelToken(std::make_shared<std::atomic<bool>>(false)); }
+
+    void cancel() const
+    {
+        if (flag_)
+            flag_->store(true, std::memory_order_relaxed);
+    }
+
+    bool cancelled() const { return flag_ && flag_->load(std::memory_order_relaxed); }
+
+private:
+    explicit CancelToken(std::shared_ptr<std::atomic<bool>> flag) : flag_(std::move(flag)) {}
+
+    std::shared_ptr<std::atomic<bool>> flag_;
+};
+
+struct ExecutorOptions {
+    size_t workers       = 0;   ///< 0: one per core, leaving one to OBS, at least 2.
+    size_t maxBackground = 0;   ///< Workers that may run Background tasks at once; 0: all but one.
+};
+
+/**
+ * @brief Counters and latencies of one lane since start().
+ */
+struct ExecutorLaneStats {
+    uint64_t submitted = 0;
+    uint64_t completed = 0;
+    uint64_t cancelled = 0;   ///< Dropped before they started.
+    uint64_t stolen    = 0;   ///< Taken from another worker's deque.
+    size_t   depth     = 0;   ///< Queued and ready now, delayed tasks excluded.
+    size_t   maxDepth  = 0;
+    uint64_t waitP50Us = 0, waitP99Us = 0, waitMaxUs = 0;   ///< Ready to started.
+    uint64_t runP50Us  = 0, runP99Us  = 0, runMaxUs  = 0;
+};
+
+struct ExecutorStats {
+    size_t            workers = 0;
+    size_t            delayed = 0;   ///< postAfter() tasks not yet due.
+    ExecutorLaneStats lanes[2];      ///< Indexed by TaskLane.
+    uint64_t          uiPosted  = 0; ///< Continuations queued to a context thread.
+    size_t            uiDepth   = 0; ///< Queued there and not yet run.
+    uint64_t          uiP99Us   = 0; ///< Queued to run on the context thread.
+    uint64_t          uiMaxUs   = 0;
+};
+
+namespace executor_detail {
+
+/* Outstanding-task count of a TaskGroup; shared with queued tasks. */
+struct GroupState {
+    CancelToken             token = CancelToken::create();
+    std::mutex              mutex;
+    std::condition_variable idle;
+    size_t                  outstanding = 0;
+
+    void add();
+    void done();
+};
+
+} // namespace executor_detail
+
+/**
+ * @class PluginExecutor
+ * @brief The shared pool; see the file comment.
+ */
+class PluginExecutor {
+public:
+    using TaskFn = std::function<void()>;
+
+    static PluginExecutor &global();
+
+    PluginExecutor() = default;
+    ~PluginExecutor();   ///< shutdown() without a deadline.
+
+    PluginExecutor(const PluginExecutor &) = delete;
+    PluginExecutor &operator=(const PluginExecutor &) = delete;
+
+    /// Starts the workers; later calls do nothing. Tasks posted earlier run now.
+    void start(ExecutorOptions options = ExecutorOptions());
+
+    /**
+     * @brief Runs what is queued (delayed tasks at once), then joins the workers.
+     *
+     * Posting fails from here on. @return false if the workers did not
+     * finish within @p timeout; they are detached and finish on their own.
+     */
+    bool shutdown(std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /// Queues @p fn; false (and @p fn dropped) after shutdown().
+    bool post(TaskLane lane, TaskFn fn, CancelToken token = CancelToken());
+
+    /// Queues @p fn to become ready after @p delay.
+    bool postAfter(std::chrono::milliseconds delay, TaskLane lane, TaskFn fn, CancelToken token = CancelToken());
+
+    /**
+     * @brief Runs @p work on the pool and @p done with its result on @p context's thread.
+     *
+     * With a nullptr context @p done runs right after @p work on the
+     * worker. @p done is skipped if @p token was cancelled meanwhile; Qt
+     * drops it if @p context is destroyed first. @p context must be alive
+     * when @p work finishes: cancel and wait for the task (TaskGroup)
+     * before destroying it.
+     */
+    template<typename Work, typename Done>
+    bool post(TaskLane lane, Work work, QObject *context, Done done, CancelToken token = CancelToken());
+
+    /// Runs @p fn on @p context's thread through its event loop, with latency metrics.
+    void postToUi(QObject *context, TaskFn fn);
+
+    /// True on one of this executor's workers.
+    bool isWorkerThread() const;
+
+    size_t workerCount() const { return workers_.size(); }
+
+    ExecutorStats stats() const;
+
+private:
+    friend class TaskGroup;
+
+    struct Task {
+        TaskFn                                      fn;
+        CancelToken                                 token;
+        std::shared_ptr<executor_detail::GroupState> group;
+        TaskLane                                    lane = TaskLane::Background;
+        uint64_t                                    readyNs = 0;
+    };
+
+    struct Delayed {
+        uint64_t dueNs;
+        uint64_t sequence;   ///< FIFO among equal deadlines.
+        Task     task;
+    };
+
+    struct alignas(64) Worker {
+        std::mutex       mutex;
+        std::deque<Task> lanes[2];
+        std::thread      thread;
+    };
+
+    struct LaneCounters {
+        std::atomic<uint64_t> submitted{0};
+        std::atomic<uint64_t> completed{0};
+        std::atomic<uint64_t> cancelled{0};
+        std::atomic<uint64_t> stolen{0};
+        std::atomic<size_t>   depth{0};
+        std::atomic<size_t>   maxDepth{0};
+        TraceHistogram        waitUs;
+        TraceHistogram        runUs;
+    };
+
+    bool enqueue(Task task, uint64_t delayNs);
+    bool pushReady(Task &task);
+    void wakeOne();
+    void runWorker(size_t self);
+    void execute(Task &task);
+    bool findTask(size_t self, Task &out);
+    bool popLane(size_t self, TaskLane lane, Task &out);
+    bool reserveBackground();
+    void promoteDue(uint64_t nowNs);
+    uint64_t nextDue() const;
+    void finish(Task &task, bool ran);
+    void purge(const std::shared_ptr<executor_detail::GroupState> &group);
+    bool ready(uint64_t nowNs) const;
+
+    ExecutorOptions                      options_;
+    std::mutex                           startMutex_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<bool>                    started_{false};
+    bool                                 closed_ = false;   ///< Guarded by injectMutex_; posting fails.
+
+    std::mutex              exitMutex_;
+    std::condition_variable exited_;
+    size_t                  liveWorkers_ = 0;   ///< Guarded by exitMutex_.
+
+    mutable std::mutex    injectMutex_;
+    std::deque<Task>      inject_[2];       ///< From threads that are not workers.
+    LaneCounters          lanes_[2];
+    std::atomic<size_t>   runningBackground_{0};
+
+    mutable std::mutex      sleepMutex_;    ///< Also guards delayed_ and stopping_.
+    std::condition_variable wake_;
+    std::vector<Delayed>    delayed_;       ///< Min-heap on dueNs.
+    uint64_t                sequence_ = 0;
+    std::atomic<uint64_t>   nextDueNs_{UINT64_MAX};
+    std::atomic<size_t>     sleepers_{0};
+    bool                    stopping_ = false;
+
+    std::atomic<uint64_t> uiPosted_{0};
+    std::atomic<size_t>   uiDepth_{0};
+    TraceHistogram        uiUs_;
+};
+
+/**
+ * @class TaskGroup
+ * @brief Tasks owned by one object; destroying the group cancels and waits for them.
+ *
+ * Declare it after everything its tasks touch, or call cancel() and wait()
+ * first thing in the owner's destructor. Do not wait from one of the
+ * group's own tasks.
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(TaskLane lane, PluginExecutor &executor = PluginExecutor::global());
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+
+    /// Queues @p fn; it is also dropped if @p token is cancelled. False after shutdown().
+    bool post(PluginExecutor::TaskFn fn, CancelToken token = CancelToken());
+    bool postAfter(std::chrono::milliseconds delay, PluginExecutor::TaskFn fn, CancelToken token = CancelToken());
+
+    /// Drops every task that has not started; running ones see token().cancelled().
+    void cancel();
+
+    /// Waits until every posted task has run or been dropped.
+    bool wait(std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    /// Cancelled by cancel(); check it in long-running tasks.
+    const CancelToken &token() const { return state_->token; }
+
+private:
+    PluginExecutor                              &executor_;
+    const TaskLane                               lane_;
+    std::shared_ptr<executor_detail::GroupState> state_;
+};
+
+/* ------------------------------------------------------------------------- */
+/*  Continuations                                                            */
+/* ------------------------------------------------------------------------- */
+template<typename Work, typename Done>
+bool PluginExecutor::post(TaskLane lane, Work work, QObject *context, Done done, CancelToken token)
+{
+    return post(lane, [this, work = std::move(work), context, done = std::move(done), token]() mutable {
+        if constexpr (std::is_void_v<std::invoke_result_t<Work &>>) {
+            work();
+            if (token.cancelled())
+                return;
+            if (!context)
+                done();
+            else
+                postToUi(context, [done = std::move(done), token]() mutable {
+                    if (!token.cancelled())
+                        done();
+                });
+        } else {
+            auto result = work();
+            if (token.cancelled())
+                return;
+            if (!context)
+                done(std::move(result));
+            else
+                postToUi(context, [done = std::move(done), token, result = std::move(result)]() mutable {
+                    if (!token.cancelled())
+                        done(std::move(result));
+                });
+        }
+    }, token);
+}
@@ -0,0 +1,748 @@
+/*!
+ * @file plugin-log.cpp
+ * @brief Implements the asynchronous logging backend.
+ *
+ * Records carry the format pointer and the arguments in the order printf
+ * would consume them (integers widened to 64 bits, strings copied inline).
+ * The drain thread walks the same format string again to decode them, so no
+ * per-argument type tags are needed.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "plugin-log.h"
+#include "plugin-support.h"
+
+#include <obs-module.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+
+namespace {
+
+constexpr size_t   kRecordSize   = 512;
+constexpr size_t   kRingSlots    = 256;    /* power of two; 128 KiB per logging thread */
+constexpr size_t   kMaxRings     = 64;
+constexpr size_t   kSiteSlots    = 1024;   /* power of two */
+constexpr size_t   kSiteProbes   = 8;
+constexpr uint32_t kSiteBurst    = 20;     /* messages per call site and window */
+constexpr int64_t  kSiteWindowMs = 1000;
+constexpr size_t   kLineSize     = 2048;
+
+struct LogRecord {
+    const char   *format;
+    int32_t       level;
+    uint32_t      suppressed;   ///< Messages from this site held back before this one.
+    uint16_t      argBytes;
+    uint8_t       truncated;
+    uint8_t       pad[5];
+    unsigned char args[kRecordSize - 24];
+};
+static_assert(sizeof(LogRecord) == kRecordSize, "LogRecord must fill its slot exactly");
+
+/* Single producer (the owning thread), single consumer (the drain thread). */
+struct LogRing {
+    alignas(64) std::atomic<uint32_t> head{0};
+    alignas(64) std::atomic<uint32_t> tail{0};
+    std::atomic<bool> abandoned{false};   ///< Owning thread has exited.
+    LogRecord slots[kRingSlots];
+};
+
+struct LogSite {
+    std::atomic<const char *> format{nullptr};
+    std::atomic<int64_t>      windowStart{0};
+    std::atomic<uint32_t>     count{0};
+    std::atomic<uint32_t>     suppressed{0};
+};
+
+std::atomic<LogRing *> g_rings[kMaxRings];
+LogSite                g_sites[kSiteSlots];
+
+std::atomic<bool> g_running{false};
+std::mutex        g_control;       ///< Serialises start/stop.
+std::thread       g_drain;
+
+/* the drain parks while every ring is empty; the first record after that wakes it */
+std::atomic<bool>       g_parked{false};
+std::mutex              g_parkMutex;
+std::condition_variable g_wake;
+
+struct Counters {
+    std::atomic<uint64_t> queued{0}, written{0}, dropped{0}, suppressed{0}, truncated{0}, synchronous{0};
+} g_stats;
+
+struct ThreadRing {
+    LogRing *ring   = nullptr;
+    bool     failed = false;
+
+    ~ThreadRing()
+    {
+        if (ring)
+            ring->abandoned.store(true, std::memory_order_release);
+    }
+};
+thread_local ThreadRing t_ring;
+
+/* ------------------------------------------------------------------------- */
+/*  printf conversion parsing                                                */
+/* ------------------------------------------------------------------------- */
+enum class ArgKind { Literal, Int, UInt, Double, Char, String, Pointer, Skip, Invalid };
+
+struct Spec {
+    const char *begin;         ///< The '%'.
+    const char *end;           ///< One past the conversion character.
+    const char *flags;
+    size_t      flagCount;
+    int         width;         ///< -1 none, -2 '*'.
+    int         precision;     ///< -1 none, -2 '*'.
+    char        length[3];     ///< As written, e.g. "ll".
+    char        conv;
+    ArgKind     kind;
+};
+
+int readNumber(const char *&p)
+{
+    int n = 0;
+    while (*p >= '0' && *p <= '9')
+        n = n * 10 + (*p++ - '0');
+    return n;
+}
+
+/* Finds the next conversion at or after p. Returns false at the end of the string. */
+bool nextSpec(const char *p, Spec &spec)
+{
+    p = std::strchr(p, '%');
+    if (!p)
+        return false;
+
+    spec = Spec{};
+    spec.begin = p++;
+    if (*p == '%') {
+        spec.end  = p + 1;
+        spec.kind = ArgKind::Literal;
+        return true;
+    }
+
+    spec.flags = p;
+    while (*p && std::strchr("-+ #0'", *p))
+        ++p;
+    spec.flagCount = static_cast<size_t>(p - spec.flags);
+
+    spec.width = -1;
+    if (*p == '*') {
+        spec.width = -2;
+        ++p;
+    } else if (*p >= '0' && *p <= '9') {
+        spec.width = readNumber(p);
+    }
+
+    spec.precision = -1;
+    if (*p == '.') {
+        ++p;
+        if (*p == '*') {
+            spec.precision = -2;
+            ++p;
+        } else {
+            spec.precision = readNumber(p);
+        }
+    }
+
+    size_t len = 0;
+    while (*p && std::strchr("hlLqjzt", *p) && len < 2)
+        spec.length[len++] = *p++;
+
+    spec.conv = *p;
+    spec.end  = *p ? p + 1 : p;
+
+    const bool wide = spec.length[0] == 'l' && spec.length[1] == '\0';
+    switch (spec.conv) {
+    case 'd': case 'i':
+        spec.kind = ArgKind::Int;
+        break;
+    case 'u': case 'o': case 'x': case 'X':
+        spec.kind = ArgKind::UInt;
+        break;
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+        spec.kind = ArgKind::Double;
+        break;
+    case 'c':
+        spec.kind = wide ? ArgKind::Invalid : ArgKind::Char;
+        break;
+    case 's':
+        spec.kind = wide ? ArgKind::Invalid : ArgKind::String;
+        break;
+    case 'p':
+        spec.kind = ArgKind::Pointer;
+        break;
+    case 'n':
+        spec.kind = ArgKind::Skip;
+        break;
+    default:
+        spec.kind = ArgKind::Invalid;
+        break;
+    }
+    return true;
+}
+
+bool lengthIs(const Spec &spec, const char *mod)
+{
+    return !std::strcmp(spec.length, mod);
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Encoding (calling thread)                                                */
+/* ------------------------------------------------------------------------- */
+class ArgWriter {
+public:
+    explicit ArgWriter(LogRecord &record)
+        : rec_(record)
+    {
+    }
+
+    template<typename T> bool put(T value)
+    {
+        if (used_ + sizeof(T) > sizeof(rec_.args))
+            return false;
+        std::memcpy(rec_.args + used_, &value, sizeof(T));
+        used_ += sizeof(T);
+        return true;
+    }
+
+    bool putString(const char *s)
+    {
+        if (!s)
+            s = "(null)";
+        if (used_ + sizeof(uint16_t) > sizeof(rec_.args))
+            return false;
+        const size_t room = sizeof(rec_.args) - used_ - sizeof(uint16_t);
+        size_t len = strnlen(s, room + 1);
+        const bool fits = len <= room;
+        if (!fits)
+            len = room;
+        put(static_cast<uint16_t>(len));
+        std::memcpy(rec_.args + used_, s, len);
+        used_ += len;
+        return fits;
+    }
+
+    size_t used() const { return used_; }
+
+private:
+    LogRecord &rec_;
+    size_t     used_ = 0;
+};
+
+/* Reads one integer argument as printf would; hh and h narrow the promoted value. */
+int64_t readSigned(const Spec &spec, va_list &args)
+{
+    if (lengthIs(spec, "l"))
+        return va_arg(args, long);
+    if (lengthIs(spec, "ll") || lengthIs(spec, "q"))
+        return va_arg(args, long long);
+    if (lengthIs(spec, "z"))
+        return va_arg(args, std::make_signed_t<size_t>);
+    if (lengthIs(spec, "j"))
+        return va_arg(args, intmax_t);
+    if (lengthIs(spec, "t"))
+        return va_arg(args, ptrdiff_t);
+
+    const int v = va_arg(args, int);
+    if (lengthIs(spec, "hh"))
+        return static_cast<signed char>(v);
+    if (lengthIs(spec, "h"))
+        return static_cast<short>(v);
+    return v;
+}
+
+uint64_t readUnsigned(const Spec &spec, va_list &args)
+{
+    if (lengthIs(spec, "l"))
+        return va_arg(args, unsigned long);
+    if (lengthIs(spec, "ll") || lengthIs(spec, "q"))
+        return va_arg(args, unsigned long long);
+    if (lengthIs(spec, "z"))
+        return va_arg(args, size_t);
+    if (lengthIs(spec, "j"))
+        return va_arg(args, uintmax_t);
+    if (lengthIs(spec, "t"))
+        return static_cast<uint64_t>(va_arg(args, ptrdiff_t));
+
+    const unsigned v = va_arg(args, unsigned);
+    if (lengthIs(spec, "hh"))
+        return static_cast<unsigned char>(v);
+    if (lengthIs(spec, "h"))
+        return static_cast<unsigned short>(v);
+    return v;
+}
+
+/* Copies the arguments of one call into rec. Returns false if some were cut. */
+bool encodeArgs(LogRecord &rec, const char *format, va_list args)
+{
+    va_list ap;
+    va_copy(ap, args);
+
+    ArgWriter out(rec);
+    bool complete = true;
+    Spec spec;
+    for (const char *p = format; complete && nextSpec(p, spec); p = spec.end) {
+        if (spec.kind == ArgKind::Literal)
+            continue;
+        if (spec.kind == ArgKind::Invalid) {
+            complete = false;       /* unknown argument type: cannot stay in step with va_list */
+            break;
+        }
+        if (spec.width == -2)
+            complete = out.put(static_cast<int32_t>(va_arg(ap, int)));
+        if (complete && spec.precision == -2)
+            complete = out.put(static_cast<int32_t>(va_arg(ap, int)));
+        if (!complete)
+            break;
+
+        switch (spec.kind) {
+        case ArgKind::Int:
+            complete = out.put(readSigned(spec, ap));
+            break;
+        case ArgKind::UInt:
+            complete = out.put(readUnsigned(spec, ap));
+            break;
+        case ArgKind::Double:
+            complete = out.put(lengthIs(spec, "L") ? static_cast<double>(va_arg(ap, long double))
+                                                   : va_arg(ap, double));
+            break;
+        case ArgKind::Char:
+            complete = out.put(static_cast<int32_t>(va_arg(ap, int)));
+            break;
+        case ArgKind::String:
+            complete = out.putString(va_arg(ap, const char *));
+            break;
+        case ArgKind::Pointer:
+            complete = out.put(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(va_arg(ap, void *))));
+            break;
+        case ArgKind::Skip:
+            (void)va_arg(ap, void *);
+            break;
+        default:
+            break;
+        }
+    }
+
+    va_end(ap);
+    rec.argBytes  = static_cast<uint16_t>(out.used());
+    rec.truncated = complete ? 0 : 1;
+    return complete;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Decoding (drain thread)                                                  */
+/* ------------------------------------------------------------------------- */
+class LineWriter {
+public:
+    void append(const char *s, size_t n)
+    {
+        n = std::min(n, sizeof(line_) - 1 - len_);
+        std::memcpy(line_ + len_, s, n);
+        len_ += n;
+        line_[len_] = '\0';
+    }
+
+    template<typename T> void format(const char *spec, T value)
+    {
+        const size_t room = sizeof(line_) - len_;
+        const int n = std::snprintf(line_ + len_, room, spec, value);
+        if (n > 0)
+            len_ += std::min(static_cast<size_t>(n), room - 1);
+    }
+
+    const char *c_str() const { return line_; }
+
+private:
+    char   line_[kLineSize] = {};
+    size_t len_             = 0;
+};
+
+class ArgReader {
+public:
+    explicit ArgReader(const LogRecord &rec)
+        : rec_(rec)
+    {
+    }
+
+    template<typename T> bool take(T &value)
+    {
+        if (pos_ + sizeof(T) > rec_.argBytes)
+            return false;
+        std::memcpy(&value, rec_.args + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return true;
+    }
+
+    bool takeString(const char *&s, size_t &len)
+    {
+        uint16_t n = 0;
+        if (!take(n) || pos_ + n > rec_.argBytes)
+            return false;
+        s   = reinterpret_cast<const char *>(rec_.args + pos_);
+        len = n;
+        pos_ += n;
+        return true;
+    }
+
+private:
+    const LogRecord &rec_;
+    size_t           pos_ = 0;
+};
+
+/* Rebuilds one conversion with star values resolved and a fixed length modifier. */
+void buildSpec(char *out, size_t size, const Spec &spec, int width, int precision, const char *length)
+{
+    int n = std::snprintf(out, size, "%%%.*s", static_cast<int>(spec.flagCount), spec.flags);
+    if (width != -1 && n > 0)
+        n += std::snprintf(out + n, size - static_cast<size_t>(n), "%d", width);
+    if (precision >= 0 && n > 0)
+        n += std::snprintf(out + n, size - static_cast<size_t>(n), ".%d", precision);
+    if (n > 0)
+        std::snprintf(out + n, size - static_cast<size_t>(n), "%s%c", length, spec.conv);
+}
+
+void formatRecord(const LogRecord &rec, LineWriter &line)
+{
+    ArgReader in(rec);
+    const char *p = rec.format;
+    bool ok = true;
+
+    Spec spec;
+    while (ok && nextSpec(p, spec)) {
+        line.append(p, static_cast<size_t>(spec.begin - p));
+        p = spec.end;
+        if (spec.kind == ArgKind::Literal) {
+            line.append("%", 1);
+            continue;
+        }
+
+        int32_t width = spec.width, precision = spec.precision;
+        if (spec.width == -2)
+            ok = in.take(width);
+        if (ok && spec.precision == -2) {
+            ok = in.take(precision);
+            if (precision < 0)
+                precision = -1;
+        }
+        if (!ok || spec.kind == ArgKind::Invalid) {
+            ok = false;
+            break;
+        }
+
+        char fmt[48];
+        switch (spec.kind) {
+        case ArgKind::Int:
+        case ArgKind::UInt: {
+            uint64_t v = 0;         /* same bits for both kinds */
+            if ((ok = in.take(v))) {
+                buildSpec(fmt, sizeof(fmt), spec, width, precision, "ll");
+                if (spec.kind == ArgKind::Int)
+                    line.format(fmt, static_cast<long long>(v));
+                else
+                    line.format(fmt, static_cast<unsigned long long>(v));
+            }
+            break;
+        }
+        case ArgKind::Double: {
+            double v = 0;
+            if ((ok = in.take(v))) {
+                buildSpec(fmt, sizeof(fmt), spec, width, precision, "");
+                line.format(fmt, v);
+            }
+            break;
+        }
+        case ArgKind::Char: {
+            int32_t v = 0;
+            if ((ok = in.take(v))) {
+                buildSpec(fmt, sizeof(fmt), spec, width, precision, "");
+                line.format(fmt, static_cast<int>(v));
+            }
+            break;
+        }
+        case ArgKind::String: {
+            const char *s = nullptr;
+            size_t len = 0;
+            if ((ok = in.takeString(s, len))) {
+                char copy[kRecordSize];
+                std::memcpy(copy, s, len);
+                copy[len] = '\0';
+                buildSpec(fmt, sizeof(fmt), spec, width, precision, "");
+                line.format(fmt, static_cast<const char *>(copy));
+            }
+            break;
+        }
+        case ArgKind::Pointer: {
+            uint64_t v = 0;
+            if ((ok = in.take(v))) {
+                buildSpec(fmt, sizeof(fmt), spec, width, precision, "");
+                line.format(fmt, reinterpret_cast<void *>(static_cast<uintptr_t>(v)));
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    if (ok)
+        line.append(p, std::strlen(p));
+    if (rec.truncated || !ok)
+        line.append(" [truncated]", 12);
+    if (rec.suppressed) {
+        char note[64];
+        const int n = std::snprintf(note, sizeof(note), " (%u similar messages suppressed)", rec.suppressed);
+        if (n > 0)
+            line.append(note, static_cast<size_t>(n));
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Rate limiting                                                            */
+/* ------------------------------------------------------------------------- */
+int64_t nowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/* Returns false if this call site is over its budget for the current window. */
+bool admit(const char *format, uint32_t &suppressedBefore)
+{
+    const size_t hash = static_cast<size_t>((static_cast<uint64_t>(reinterpret_cast<uintptr_t>(format)) >> 3) *
+                                            0x9E3779B97F4A7C15ull >> 54);
+    LogSite *site = nullptr;
+    for (size_t probe = 0; probe < kSiteProbes && !site; ++probe) {
+        LogSite &candidate = g_sites[(hash + probe) & (kSiteSlots - 1)];
+        const char *expected = candidate.format.load(std::memory_order_acquire);
+        if (expected == format ||
+            (!expected && (candidate.format.compare_exchange_strong(expected, format) || expected == format)))
+            site = &candidate;
+    }
+    if (!site)
+        return true;                /* table crowded: do not limit */
+
+    const int64_t now = nowMs();
+    int64_t start = site->windowStart.load(std::memory_order_relaxed);
+    if (now - start >= kSiteWindowMs && site->windowStart.compare_exchange_strong(start, now)) {
+        site->count.store(0, std::memory_order_relaxed);
+        suppressedBefore = site->suppressed.exchange(0, std::memory_order_relaxed);
+    }
+
+    if (site->count.fetch_add(1, std::memory_order_relaxed) < kSiteBurst)
+        return true;
+    site->suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Rings and drain                                                          */
+/* ------------------------------------------------------------------------- */
+LogRing *threadRing()
+{
+    if (t_ring.ring || t_ring.failed)
+        return t_ring.ring;
+
+    auto *ring = new (std::nothrow) LogRing; /* once per thread, not per message */
+    for (size_t i = 0; ring && i < kMaxRings; ++i) {
+        LogRing *expected = nullptr;
+        if (g_rings[i].compare_exchange_strong(expected, ring)) {
+            t_ring.ring = ring;
+            return ring;
+        }
+    }
+    delete ring;
+    t_ring.failed = true;
+    return nullptr;
+}
+
+void writeSync(int level, const char *format, va_list args)
+{
+    char line[kLineSize];
+    std::vsnprintf(line, sizeof(line), format, args);
+    blog(level, "[%s] %s", PLUGIN_NAME, line);
+    g_stats.synchronous.fetch_add(1, std::memory_order_relaxed);
+}
+
+size_t drainRing(LogRing &ring)
+{
+    uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+    const uint32_t head = ring.head.load(std::memory_order_acquire);
+    size_t count = 0;
+
+    for (; tail != head; ++tail, ++count) {
+        const LogRecord &rec = ring.slots[tail & (kRingSlots - 1)];
+        LineWriter line;
+        formatRecord(rec, line);
+        blog(rec.level, "[%s] %s", PLUGIN_NAME, line.c_str());
+        ring.tail.store(tail + 1, std::memory_order_release);
+    }
+    g_stats.written.fetch_add(count, std::memory_order_relaxed);
+    return count;
+}
+
+size_t drainAll(bool reclaim)
+{
+    size_t count = 0;
+    for (auto &slot : g_rings) {
+        LogRing *ring = slot.load(std::memory_order_acquire);
+        if (!ring)
+            continue;
+        const bool gone = ring->abandoned.load(std::memory_order_acquire);
+        count += drainRing(*ring);
+        if (gone && reclaim) {
+            slot.store(nullptr, std::memory_order_release);
+            delete ring;
+        }
+    }
+    return count;
+}
+
+void reportDrops(uint64_t &reported)
+{
+    const uint64_t dropped = g_stats.dropped.load(std::memory_order_relaxed);
+    if (dropped == reported)
+        return;
+    blog(LOG_WARNING, "[%s] Logger dropped %llu messages (ring full)", PLUGIN_NAME,
+         static_cast<unsigned long long>(dropped - reported));
+    reported = dropped;
+}
+
+bool anyQueued()
+{
+    for (auto &slot : g_rings) {
+        LogRing *ring = slot.load(std::memory_order_acquire);
+        if (ring && ring->head.load(std::memory_order_acquire) != ring->tail.load(std::memory_order_relaxed))
+            return true;
+    }
+    return false;
+}
+
+void wakeDrain()
+{
+    /* seq_cst, paired with park(): either the drain sees our record or we see it parked */
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!g_parked.load(std::memory_order_relaxed))
+        return;
+    {
+        std::lock_guard<std::mutex> lock(g_parkMutex);   /* the drain is inside wait() */
+    }
+    g_wake.notify_one();
+}
+
+void park()
+{
+    std::unique_lock<std::mutex> lock(g_parkMutex);
+    g_parked.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    g_wake.wait(lock, [] { return anyQueued() || !g_running.load(std::memory_order_acquire); });
+    g_parked.store(false, std::memory_order_relaxed);
+}
+
+void drainLoop()
+{
+    uint64_t reported = 0;
+    while (g_running.load(std::memory_order_acquire)) {
+        if (!drainAll(true))
+            park();
+        reportDrops(reported);
+    }
+    drainAll(true);
+    reportDrops(reported);
+}
+
+} // namespace
+
+/* ------------------------------------------------------------------------- */
+/*  C API                                                                    */
+/* ------------------------------------------------------------------------- */
+extern "C" void plugin_log_va(int log_level, const char *format, va_list args)
+{
+    if (!format)
+        return;
+    if (!g_running.load(std::memory_order_acquire)) {
+        writeSync(log_level, format, args);
+        return;
+    }
+
+    uint32_t suppressedBefore = 0;
+    if (!admit(format, suppressedBefore)) {
+        g_stats.suppressed.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    LogRing *ring = threadRing();
+    if (!ring) {
+        writeSync(log_level, format, args);
+        return;
+    }
+
+    const uint32_t head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) >= kRingSlots) {
+        g_stats.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    LogRecord &rec = ring->slots[head & (kRingSlots - 1)];
+    rec.format     = format;
+    rec.level      = log_level;
+    rec.suppressed = suppressedBefore;
+    if (!encodeArgs(rec, format, args))
+        g_stats.truncated.fetch_add(1, std::memory_order_relaxed);
+
+    ring->head.store(head + 1, std::memory_order_release);
+    g_stats.queued.fetch_add(1, std::memory_order_relaxed);
+    wakeDrain();
+}
+
+extern "C" void plugin_log_start(void)
+{
+    std::lock_guard<std::mutex> lock(g_control);
+    if (g_running.load())
+        return;
+    g_running.store(true, std::memory_order_release);
+    g_drain = std::thread(drainLoop);
+}
+
+extern "C" void plugin_log_stop(void)
+{
+    std::lock_guard<std::mutex> lock(g_control);
+    if (!g_running.load())
+        return;
+    g_running.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(g_parkMutex);
+    }
+    g_wake.notify_one();
+    if (g_drain.joinable())
+        g_drain.join();
+
+    /* records queued by threads that saw the drain running just before it stopped */
+    drainAll(true);
+}
+
+extern "C" void plugin_log_get_stats(struct plugin_log_stats *stats)
+{
+    if (!stats)
+        return;
+    stats->queued      = g_stats.queued.load(std::memory_order_relaxed);
+    stats->written     = g_stats.written.load(std::memory_order_relaxed);
+    stats->dropped     = g_stats.dropped.load(std::memory_order_relaxed);
+    stats->suppressed  = g_stats.suppressed.load(std::memory_order_relaxed);
+    stats->truncated   = g_stats.truncated.load(std::memory_order_relaxed);
+    stats->synchronous = g_stats.synchronous.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,59 @@
+/*!
+ * @file plugin-log.h
+ * @brief Asynchronous logging backend behind obs_log().
+ *
+ * obs_log() stays the logging call for plugin code. Instead of formatting on
+ * the calling thread it copies the format pointer and the raw arguments into
+ * a fixed-size record in a per-thread ring, without locking or allocating.
+ * A background thread formats the records and forwards them to blog().
+ *
+ * - Levels above PLAYFAME_LOG_LEVEL (plugin-support.h) are compiled out.
+ * - Each call site (identified by its format string) may log a burst of
+ *   messages per second; the rest are counted and reported with the next
+ *   message that gets through.
+ * - A full ring drops the message and counts it; the drain thread reports
+ *   drops as a warning.
+ *
+ * Format strings must be string literals (or otherwise outlive the drain),
+ * which every obs_log() call in the plugin already satisfies. Before
+ * plugin_log_start() and after plugin_log_stop() messages are written
+ * synchronously.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include <stdarg.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct plugin_log_stats {
+	uint64_t queued;      /* records handed to a ring */
+	uint64_t written;     /* records formatted and passed to blog() */
+	uint64_t dropped;     /* lost because the thread's ring was full */
+	uint64_t suppressed;  /* held back by the per-call-site rate limit */
+	uint64_t truncated;   /* arguments that did not fit a record */
+	uint64_t synchronous; /* written on the calling thread (no drain running or no ring free) */
+};
+
+/** Queues one message; used by obs_log(). Never blocks on the drain thread. */
+void plugin_log_va(int log_level, const char *format, va_list args);
+
+/** Starts the drain thread. Called from obs_module_load(). */
+void plugin_log_start(void);
+
+/** Writes everything still queued and stops the drain thread. Called last in obs_module_unload(). */
+void plugin_log_stop(void);
+
+void plugin_log_get_stats(struct plugin_log_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -4,14 +4,35 @@
  */
 
 #include "plugin-main.h"
+#include "auth-firebase.h"
+#include "auth-service.h"
+#include "config-ipc.h"
+#include "config-reload.h"
+#include "config-scopes.h"
+#include "notification-center.h"
+#include "overlay-source.h"
+#include "perf-monitor.h"
+#include "perf-monitor-obs.h"
+#include "perf-monitor-widget.h"
 #include "plugin-dock.h"
+#include "plugin-executor.h"
 #include "plugin-support.h"
+#include "plugin-log.h"
+#include "plugin-shutdown.h"
+#include "plugin-startup.h"
+#include "plugin-trace.h"
 #include "obs-config-helper.h"
+#include "telemetry.h"
+#include "telemetry-http.h"
 
 #include <obs-frontend-api.h>
 #include <obs-module.h>
 
-#include <QMetaObject>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+
 #include <QThread>
 #include <QWidget>
 
@@ -21,62 +42,592 @@ OBS_MODULE_USE_DEFAULT_LOCALE("playfame", "en-US")
 /* ------------------------------------------------------------------------- */
 /*  Globals                                                                  */
 /* ------------------------------------------------------------------------- */
-static PlayFameDock    *g_main_dock     = nullptr;
-static OBSConfigHelper *g_plugin_config = nullptr;
+static PlayFameDock      *g_main_dock     = nullptr;
+static OBSConfigHelper   *g_plugin_config = nullptr;
+static AuthService       *g_auth          = nullptr;
+static TelemetryPipeline *g_telemetry     = nullptr;
+static ConfigScopes      *g_scopes        = nullptr;
+static ConfigReloader    *g_config_reloader = nullptr;
+static ObsPerfProbe      *g_perf_probe    = nullptr;
+static PerfMonitor       *g_perf          = nullptr;
+static uint64_t           g_perf_subscription = 0;
+static ConfigIpcServer   *g_ipc           = nullptr;
+
+ConfigScopes *playfame_config_scopes(void)
+{
+    return g_scopes;
+}
+
+/**
+ * @brief Starts Firebase sign-in in the background, if a project is configured.
+ *
+ * Returns immediately; the auth worker restores the cached session or signs
+ * in. FIREBASE_AUTH_EMULATOR_HOST (host:port) points it at a local emulator.
+ */
+static void start_auth()
+{
+    FirebaseAuthOptions options;
+    {
+        ConfigReader reader  = g_plugin_config->reader();
+        options.apiKey       = reader.get(ConfigSchema::kAuthApiKey);
+        options.appId        = reader.get(ConfigSchema::kAuthAppId);
+        options.projectId    = reader.get(ConfigSchema::kAuthProjectId);
+        options.emulatorHost = reader.get(ConfigSchema::kAuthEmulatorHost);
+    }
+    const char *emulatorEnv = std::getenv("FIREBASE_AUTH_EMULATOR_HOST");
+    if (emulatorEnv && *emulatorEnv)
+        options.emulatorHost = emulatorEnv;
+
+    if (!options.emulatorHost.isEmpty()) {
+        /* the emulator accepts any key; "demo-" projects never reach production */
+        if (options.apiKey.isEmpty())
+            options.apiKey = "emulator";
+        if (options.projectId.isEmpty())
+            options.projectId = "demo-playfame";
+    } else if (options.apiKey.isEmpty()) {
+        obs_log(LOG_INFO, "[playfame] Firebase auth not configured");
+        return;
+    }
+
+    char *cachePath = obs_module_config_path("auth-session.json");
+    g_auth = new AuthService(std::make_unique<FirebaseAuthBackend>(std::move(options)),
+                             QByteArray(cachePath ? cachePath : ""));
+    bfree(cachePath);
+
+    g_auth->setRefreshMargin(std::chrono::seconds(g_plugin_config->get(ConfigSchema::kAuthRefreshMargin)));
+    g_auth->start();
+}
+
+/**
+ * @brief Starts the frontend event telemetry, if an endpoint is configured.
+ *
+ * PLAYFAME_TELEMETRY_ENDPOINT overrides the configured endpoint, e.g. to
+ * point the uploader at a local HTTP stand-in. Batches that cannot be sent
+ * are spooled to <config>/telemetry.
+ */
+static void start_telemetry()
+{
+    TelemetryHttpOptions http;
+    TelemetryOptions     options;
+    {
+        ConfigReader reader   = g_plugin_config->reader();
+        http.endpoint         = reader.get(ConfigSchema::kTelemetryEndpoint);
+        options.maxBatchDelay = std::chrono::milliseconds(reader.get(ConfigSchema::kTelemetryBatchDelay));
+        options.maxSpoolBytes = static_cast<size_t>(reader.get(ConfigSchema::kTelemetrySpoolKb)) * 1024;
+    }
+    const char *endpointEnv = std::getenv("PLAYFAME_TELEMETRY_ENDPOINT");
+    if (endpointEnv && *endpointEnv)
+        http.endpoint = endpointEnv;
+    if (http.endpoint.isEmpty()) {
+        obs_log(LOG_INFO, "[playfame] Telemetry not configured");
+        return;
+    }
+
+    /* g_auth is set before this stage and deleted only after the pipeline */
+    http.idToken = []() {
+        const std::optional<AuthToken> token = g_auth ? g_auth->currentToken() : std::nullopt;
+        return token ? token->idToken : QByteArray();
+    };
+
+    char *spoolDir   = obs_module_config_path("telemetry");
+    options.spoolDir = spoolDir ? spoolDir : "";
+    bfree(spoolDir);
+
+    g_telemetry = new TelemetryPipeline(std::make_unique<TelemetryHttpUploader>(std::move(http)), std::move(options));
+    g_telemetry->start();
+}
+
+/**
+ * @brief Sampler options from the "perf" section; the budget stays the default.
+ */
+static PerfMonitorOptions perf_options()
+{
+    PerfMonitorOptions options;
+    ConfigReader reader = g_plugin_config->reader();
+    options.enabled     = reader.get(ConfigSchema::kPerfEnabled);
+    options.interval    = std::chrono::milliseconds(reader.get(ConfigSchema::kPerfIntervalMs));
+    options.hold        = std::chrono::seconds(reader.get(ConfigSchema::kPerfAlertHold));
+    const auto limit    = [&](PerfMetric metric, const ConfigField<double> &field) {
+        options.limit[static_cast<size_t>(metric)] = static_cast<float>(reader.get(field));
+    };
+    limit(PerfMetric::RenderLoad, ConfigSchema::kPerfAlertRender);
+    limit(PerfMetric::Missed, ConfigSchema::kPerfAlertMissed);
+    limit(PerfMetric::Skipped, ConfigSchema::kPerfAlertSkipped);
+    limit(PerfMetric::Dropped, ConfigSchema::kPerfAlertDropped);
+    limit(PerfMetric::Cpu, ConfigSchema::kPerfAlertCpu);
+    return options;
+}
 
 /**
- * @brief Destroy the dock safely on the UI thread.
+ * @brief Raised and cleared performance alerts; runs on the sampler thread.
+ */
+static void report_perf_alert(const PerfAlert &alert)
+{
+    const QString text = PerfMonitorWidget::alertText(alert);
+    obs_log(alert.raised ? LOG_WARNING : LOG_INFO, "[Perf] %s", text.toUtf8().constData());
+    NotificationCenter::global().post(alert.raised ? NotificationLevel::Warning : NotificationLevel::Info, text);
+}
+
+/**
+ * @brief Switches the scoped config store for a profile or scene collection change.
  *
- * If we are already on Qt's GUI thread, delete directly. Otherwise marshal a
- * blocking call to ensure the object goes away *before* this function returns.
+ * Cached stores are switched to without reading the disk; any other is
+ * loaded on the scopes worker and shows up in current() once ready. The
+ * likely next one is prefetched in the background (see config-scopes.h).
+ */
+static void activate_config_scope(ConfigScopeKind kind)
+{
+    if (!g_scopes)
+        return;
+    char *name = kind == ConfigScopeKind::Profile ? obs_frontend_get_current_profile()
+                                                  : obs_frontend_get_current_scene_collection();
+    if (name)
+        g_scopes->activate(kind, QString::fromUtf8(name));
+    bfree(name);
+}
+
+/**
+ * @brief Hands a frontend event to telemetry; only a copy into the event ring.
+ *
+ * Scene, profile and scene collection changes carry the new name.
+ */
+static void report_frontend_event(enum obs_frontend_event e)
+{
+    if (!g_telemetry)
+        return;
+
+    switch (e) {
+    case OBS_FRONTEND_EVENT_SCENE_CHANGED:
+        if (obs_source_t *scene = obs_frontend_get_current_scene()) {
+            g_telemetry->enqueue(TelemetryEvent::make(e, 0, obs_source_get_name(scene)));
+            obs_source_release(scene);
+            return;
+        }
+        break;
+    case OBS_FRONTEND_EVENT_PROFILE_CHANGED:
+    case OBS_FRONTEND_EVENT_SCENE_COLLECTION_CHANGED: {
+        char *name = e == OBS_FRONTEND_EVENT_PROFILE_CHANGED ? obs_frontend_get_current_profile()
+                                                            : obs_frontend_get_current_scene_collection();
+        g_telemetry->enqueue(TelemetryEvent::make(e, 0, name));
+        bfree(name);
+        return;
+    }
+    default:
+        break;
+    }
+    g_telemetry->enqueue(TelemetryEvent::make(e));
+}
+
+/**
+ * @brief Destroy the dock without waiting on the UI thread.
+ *
+ * On Qt's GUI thread the dock is deleted directly. From any other thread it
+ * is handed to the UI event loop with deleteLater() instead of a blocking
+ * call, which could deadlock OBS exit while the UI thread is busy.
  */
 static void destroy_dock_safe()
 {
     if (!g_main_dock)
         return;
 
+    PF_TRACE_SCOPE("dock.destroy");
+
     QObject *obj = g_main_dock;                 /* keep valid pointer        */
     g_main_dock  = nullptr;                     /* mark as gone immediately  */
 
-    if (QThread::currentThread() == obj->thread()) {
+    if (QThread::currentThread() == obj->thread())
         delete obj;
-    } else {
-        QMetaObject::invokeMethod(
-            obj,                                /* context = dock itself     */
-            [obj]() { delete obj; },
-            Qt::BlockingQueuedConnection);
-    }
+    else
+        obj->deleteLater();                     /* thread-safe, never waits  */
 }
 
 /**
  * @brief OBS-frontend event callback.
  *
- * Removes the dock during the *UI shutdown* phase, while frontend callbacks
- * are still valid.  This avoids using frontend API from obs_module_unload().
+ * Reports every event to telemetry, runs the deferred startup stages once
+ * OBS has finished loading, and removes the dock during the *UI shutdown*
+ * phase, while frontend callbacks are still valid.  This avoids using
+ * frontend API from obs_module_unload().
  */
 static void on_frontend_event(enum obs_frontend_event e, void *)
 {
-    if (e == OBS_FRONTEND_EVENT_EXIT) {
+    report_frontend_event(e);
+
+    if (e == OBS_FRONTEND_EVENT_FINISHED_LOADING) {
+        StartupSequence::global().onFinishedLoading();
+    } else if (e == OBS_FRONTEND_EVENT_PROFILE_CHANGED) {
+        activate_config_scope(ConfigScopeKind::Profile);
+    } else if (e == OBS_FRONTEND_EVENT_SCENE_COLLECTION_CHANGED) {
+        activate_config_scope(ConfigScopeKind::SceneCollection);
+    } else if (e == OBS_FRONTEND_EVENT_STREAMING_STARTED || e == OBS_FRONTEND_EVENT_STREAMING_STOPPED) {
+        if (g_perf_probe)
+            g_perf_probe->refreshOutputs();
+    } else if (e == OBS_FRONTEND_EVENT_EXIT) {
+        if (g_perf)
+            g_perf->stop();         /* no more libobs reads while OBS shuts down */
         destroy_dock_safe();
+        NotificationCenter::global().uninstall();
     }
 }
 
+/**
+ * @brief Registers the startup stages; see plugin-startup.h for the phases.
+ *
+ * Only what OBS needs before its window appears stays in obs_module_load():
+ * the config object (no file I/O yet) and an empty dock shell, so that OBS
+ * can restore the dock's saved placement. Parsing the config runs on the
+ * startup worker; subscribers such as the dock see the loaded values as
+ * change notifications. Sign-in waits until OBS has finished loading, and
+ * the dock builds its widgets when it is first shown.
+ */
+static void register_startup_stages(QWidget *mainWindow)
+{
+    using std::chrono::milliseconds;
+    StartupSequence &startup = StartupSequence::global();
+
+    /* the shared pool for saves, reloads and searches; threads only, no work yet */
+    startup.add(StartupPhase::Load, "executor.start", milliseconds(1), [] {
+        PluginExecutor::global().start();
+        return true;
+    });
+
+    startup.add(StartupPhase::Load, "config.create", milliseconds(2), [] {
+        g_plugin_config = new OBSConfigHelper("playfame_config.json");
+        g_plugin_config->setJournalMode(true);
+        return true;
+    });
+
+    /* OBS only accepts source types during module load */
+    startup.add(StartupPhase::Load, "source.register", milliseconds(1), [] {
+        overlay_source_register(g_plugin_config);
+        return true;
+    });
+
+    /* no thread yet; the dock draws its history once perf.start has run */
+    startup.add(StartupPhase::Load, "perf.create", milliseconds(1), [] {
+        g_perf_probe = new ObsPerfProbe();
+        g_perf       = new PerfMonitor([](PerfCounters &counters) { return g_perf_probe->read(counters); },
+                                       report_perf_alert);
+        return true;
+    });
+
+    /* the dock is created from the event loop, as before, but timed */
+    startup.add(StartupPhase::Load, "dock.queue", milliseconds(1), [mainWindow] {
+        PluginExecutor::global().postToUi(mainWindow, [mainWindow]() {
+            /* toasts posted so far waited in the ring; from here the UI thread drains it */
+            NotificationCenter::global().install(mainWindow);
+            StartupSequence::global().measure(StartupPhase::Load, "dock.register", milliseconds(2), [mainWindow] {
+                PF_TRACE_SCOPE("dock.create");
+                auto *dock = new PlayFameDock(g_plugin_config, g_perf, mainWindow);
+                if (!dock->registerDock()) {
+                    obs_log(LOG_ERROR, "[playfame] Failed to register dock");
+                    dock->deleteLater();
+                    return false;
+                }
+                g_main_dock = dock;
+                return true;
+            });
+        });
+        return true;
+    });
+
+    startup.add(StartupPhase::Background, "config.load", milliseconds(50), [] {
+        g_plugin_config->load();
+        return true;
+    });
+
+    /* sign in off-thread; never waits for the network */
+    startup.add(StartupPhase::FinishedLoading, "auth.start", milliseconds(5), [] {
+        start_auth();
+        return true;
+    });
+
+    /* loads the current profile's and collection's stores; later ones on their events */
+    startup.add(StartupPhase::FinishedLoading, "scopes.start", milliseconds(5), [] {
+        ConfigScopeOptions options;
+        {
+            ConfigReader reader = g_plugin_config->reader();
+            options.maxBytes    = static_cast<size_t>(reader.get(ConfigSchema::kScopesCacheKb)) * 1024;
+            options.maxStores   = static_cast<size_t>(reader.get(ConfigSchema::kScopesMaxStores));
+        }
+        g_scopes = new ConfigScopes(options);
+        activate_config_scope(ConfigScopeKind::Profile);
+        activate_config_scope(ConfigScopeKind::SceneCollection);
+        return true;
+    });
+
+    /* picks up external rewrites of the config, e.g. by deployment tooling */
+    startup.add(StartupPhase::FinishedLoading, "config.watch", milliseconds(5), [] {
+        g_config_reloader = new ConfigReloader(g_plugin_config);
+        g_config_reloader->watch();
+        return true;
+    });
+
+    /* samples frame timing on its own thread; the "perf" section retunes it live */
+    startup.add(StartupPhase::FinishedLoading, "perf.start", milliseconds(2), [] {
+        g_perf_probe->refreshOutputs();
+        g_perf->start(perf_options());
+        g_perf_subscription = g_plugin_config->subscribeSection(ConfigSchema::Perf, nullptr,
+                                                                [](const std::vector<ConfigChange> &) {
+                                                                    g_perf->setOptions(perf_options());
+                                                                });
+        return true;
+    });
+
+    /* local control endpoint for automation; opt-in, PLAYFAME_IPC_PATH also picks the path */
+    startup.add(StartupPhase::FinishedLoading, "ipc.start", milliseconds(5), [] {
+        const char        *pathEnv = std::getenv("PLAYFAME_IPC_PATH");
+        const bool         fromEnv = pathEnv && *pathEnv;
+        const ConfigReader reader  = g_plugin_config->reader();
+        if (!fromEnv && !reader.get(ConfigSchema::kIpcEnabled))
+            return true;
+
+        ConfigIpcOptions options;
+        options.path       = QByteArray(fromEnv ? pathEnv : reader.get(ConfigSchema::kIpcPath));
+        options.maxClients = static_cast<size_t>(reader.get(ConfigSchema::kIpcMaxClients));
+        g_ipc = new ConfigIpcServer(g_plugin_config, options);
+        if (!g_ipc->start()) {
+            delete g_ipc;
+            g_ipc = nullptr;
+            return false;
+        }
+        return true;
+    });
+
+    /* after auth, whose token the uploader attaches */
+    startup.add(StartupPhase::FinishedLoading, "telemetry.start", milliseconds(2), [] {
+        start_telemetry();
+        return true;
+    });
+}
+
+/* A worker stage past its deadline leaks its component rather than freeing
+ * it after the unload has moved on. */
+static bool may_free(const char *what)
+{
+    if (ShutdownSequence::mayFree())
+        return true;
+    obs_log(LOG_WARNING, "[playfame] %s finished after its shutdown deadline; left allocated", what);
+    return false;
+}
+
+/**
+ * @brief Registers the shutdown stages; see plugin-shutdown.h for the order.
+ *
+ * UI objects go first, on the unloading thread. Telemetry and the config
+ * then flush side by side, each within its deadline; auth goes last, as the
+ * uploader attaches its token. A stage that overruns is abandoned: it leaks
+ * its own object, and the stages depending on it leave that object alone.
+ */
+static void register_shutdown_stages()
+{
+    using std::chrono::milliseconds;
+    ShutdownSequence &shutdown = ShutdownSequence::global();
+
+    /* waits for config.load if it is still running */
+    shutdown.add(ShutdownPriority::Ui, "startup.join", milliseconds(1000), [] {
+        StartupSequence::global().shutdown();
+        return true;
+    });
+
+    /* normally already done on EXIT; defensive */
+    shutdown.add(ShutdownPriority::Ui, "dock.destroy", milliseconds(50), [] {
+        destroy_dock_safe();
+        return true;
+    }, ShutdownAffinity::Caller);
+
+    shutdown.add(ShutdownPriority::Ui, "notify.uninstall", milliseconds(10), [] {
+        NotificationCenter::global().uninstall();
+        const NotificationCenter::Stats stats = NotificationCenter::global().stats();
+        obs_log(LOG_INFO, "[playfame] Notifications: %llu posted, %llu shown, %llu coalesced, %llu dropped",
+                static_cast<unsigned long long>(stats.posted), static_cast<unsigned long long>(stats.shown),
+                static_cast<unsigned long long>(stats.coalesced), static_cast<unsigned long long>(stats.dropped));
+        return true;
+    }, ShutdownAffinity::Caller);
+
+    /* normally already stopped on EXIT; the dock may still hold the monitor until Release */
+    shutdown.add(ShutdownPriority::Ui, "perf.stop", milliseconds(500), [] {
+        if (!g_perf)
+            return true;
+        if (g_perf_subscription)
+            g_plugin_config->unsubscribe(g_perf_subscription);
+        g_perf_subscription = 0;
+        g_perf->stop();
+        const PerfMonitorStats stats = g_perf->stats();
+        obs_log(LOG_INFO,
+                "[playfame] Perf monitor: %llu samples, tick p99 %llu us, max %llu us, %.3f%% of a core, "
+                "%llu over the %llu us budget, %llu late, %llu alerts",
+                static_cast<unsigned long long>(stats.samples), static_cast<unsigned long long>(stats.tickP99Us),
+                static_cast<unsigned long long>(stats.tickMaxUs), stats.cpuPercent,
+                static_cast<unsigned long long>(stats.overBudget), static_cast<unsigned long long>(stats.budgetUs),
+                static_cast<unsigned long long>(stats.lateTicks), static_cast<unsigned long long>(stats.alertsRaised));
+        return true;
+    });
+
+    /* no more writes from clients once the final save starts */
+    shutdown.add(ShutdownPriority::Ui, "ipc.stop", milliseconds(200), [] {
+        if (!g_ipc)
+            return true;
+        g_ipc->stop();
+        const ConfigIpcStats stats = g_ipc->stats();
+        obs_log(LOG_INFO,
+                "[playfame] Config IPC: %llu connections, %llu requests (%llu gets, %llu sets, %llu commits), "
+                "%llu rejected, %llu malformed, request p99 %llu us",
+                static_cast<unsigned long long>(stats.connections), static_cast<unsigned long long>(stats.requests),
+                static_cast<unsigned long long>(stats.gets), static_cast<unsigned long long>(stats.sets),
+                static_cast<unsigned long long>(stats.commits), static_cast<unsigned long long>(stats.rejected),
+                static_cast<unsigned long long>(stats.malformed),
+                static_cast<unsigned long long>(stats.requestP99Us));
+        if (!may_free("Config IPC"))
+            return false;
+        delete g_ipc;
+        g_ipc = nullptr;
+        return true;
+    });
+
+    /* the watcher lives on the UI thread; stop reloads before the final save */
+    shutdown.add(ShutdownPriority::Ui, "config.unwatch", milliseconds(200), [] {
+        if (!g_config_reloader)
+            return true;
+        const ConfigReloaderStats stats = g_config_reloader->stats();
+        obs_log(LOG_INFO, "[playfame] Config reloads: %llu events, %llu reloads, %llu own writes, %llu failed",
+                static_cast<unsigned long long>(stats.events), static_cast<unsigned long long>(stats.reloads),
+                static_cast<unsigned long long>(stats.ownWrites), static_cast<unsigned long long>(stats.failures));
+        delete g_config_reloader;
+        g_config_reloader = nullptr;
+        return true;
+    }, ShutdownAffinity::Caller);
+
+    /* spools unsent batches; never waits for the network */
+    shutdown.add(ShutdownPriority::Flush, "telemetry.stop", milliseconds(1500), [] {
+        if (!g_telemetry)
+            return true;
+        g_telemetry->stop();
+        const TelemetryStats stats = g_telemetry->stats();
+        obs_log(LOG_INFO, "[playfame] Telemetry: %llu events, %llu uploaded, %llu dropped, %llu bytes spooled",
+                static_cast<unsigned long long>(stats.enqueued), static_cast<unsigned long long>(stats.uploadedEvents),
+                static_cast<unsigned long long>(stats.droppedQueueFull + stats.droppedSpool + stats.rejected),
+                static_cast<unsigned long long>(stats.spoolBytes));
+        if (!may_free("Telemetry"))
+            return false;
+        delete g_telemetry;
+        g_telemetry = nullptr;
+        return true;
+    });
+
+    /* saves changed scoped stores and waits for their writes */
+    shutdown.add(ShutdownPriority::Flush, "scopes.flush", milliseconds(2000), [] {
+        if (!g_scopes)
+            return true;
+        const ConfigScopes::Stats stats = g_scopes->stats();
+        obs_log(LOG_INFO, "[playfame] Config scopes: %llu hits, %llu loads, %llu prefetched, %llu evicted",
+                static_cast<unsigned long long>(stats.hits), static_cast<unsigned long long>(stats.misses),
+                static_cast<unsigned long long>(stats.prefetches), static_cast<unsigned long long>(stats.evictions));
+        if (!g_scopes->flush(milliseconds(1500))) {
+            obs_log(LOG_WARNING, "[playfame] Config scopes flush timed out; left allocated");
+            return false;
+        }
+        if (!may_free("Config scopes"))
+            return false;
+        delete g_scopes;
+        g_scopes = nullptr;
+        return true;
+    });
+
+    shutdown.add(ShutdownPriority::Flush, "config.flush", milliseconds(2000), [] {
+        if (!g_plugin_config)
+            return true;
+        if (ShutdownSequence::global().abandoned("startup.join")) {
+            obs_log(LOG_WARNING, "[playfame] Config still loading; not saved");
+            return false;           /* the loader still uses it */
+        }
+        g_plugin_config->save();
+        const bool flushed = g_plugin_config->flush(milliseconds(1500));
+        if (!flushed) {
+            /* ~ConfigWriter would wait for the stuck write without a limit */
+            obs_log(LOG_WARNING, "[playfame] Config flush timed out; config left allocated");
+            return false;
+        }
+        if (ShutdownSequence::global().abandoned("ipc.stop")) {
+            obs_log(LOG_WARNING, "[playfame] Config IPC still stopping; config left allocated");
+            return true;            /* its thread may still commit */
+        }
+        if (!may_free("Config"))
+            return false;
+        delete g_plugin_config;
+        g_plugin_config = nullptr;
+        return true;
+    });
+
+    /* the telemetry uploader reads the token until it has stopped */
+    shutdown.add(ShutdownPriority::Release, "auth.release", milliseconds(500), [] {
+        if (ShutdownSequence::global().abandoned("telemetry.stop")) {
+            obs_log(LOG_WARNING, "[playfame] Telemetry still stopping; auth left running");
+            return false;
+        }
+        if (g_auth && !may_free("Auth"))
+            return false;
+        delete g_auth;              /* cancels a fetch in progress */
+        g_auth = nullptr;
+        return true;
+    });
+
+    /* after the dock, whichever way it went, and every stage that could read the monitor */
+    shutdown.add(ShutdownPriority::Release, "perf.release", milliseconds(50), [] {
+        if (ShutdownSequence::global().abandoned("perf.stop")) {
+            obs_log(LOG_WARNING, "[playfame] Perf sampler still stopping; left running");
+            return false;
+        }
+        if ((g_perf || g_perf_probe) && !may_free("Perf monitor"))
+            return false;
+        delete g_perf;
+        g_perf = nullptr;
+        delete g_perf_probe;
+        g_perf_probe = nullptr;
+        return true;
+    });
+
+    /* after every store is flushed; runs what is still queued, then joins */
+    shutdown.add(ShutdownPriority::Release, "executor.stop", milliseconds(1000), [] {
+        PluginExecutor &executor = PluginExecutor::global();
+        const bool joined = executor.shutdown(milliseconds(800));
+        const ExecutorStats stats = executor.stats();
+        const ExecutorLaneStats &ui = stats.lanes[static_cast<size_t>(TaskLane::Interactive)];
+        const ExecutorLaneStats &bg = stats.lanes[static_cast<size_t>(TaskLane::Background)];
+        obs_log(LOG_INFO,
+                "[playfame] Executor: %zu workers; interactive %llu run, %llu cancelled, wait p99 %llu us; "
+                "background %llu run, max depth %zu, wait p99 %llu us; %llu stolen",
+                stats.workers, static_cast<unsigned long long>(ui.completed),
+                static_cast<unsigned long long>(ui.cancelled), static_cast<unsigned long long>(ui.waitP99Us),
+                static_cast<unsigned long long>(bg.completed), bg.maxDepth,
+                static_cast<unsigned long long>(bg.waitP99Us),
+                static_cast<unsigned long long>(ui.stolen + bg.stolen));
+        return joined;
+    });
+}
+
 /**
  * @brief Called by OBS when the plugin is loaded.
  *
- * Creates / loads the configuration helper and registers the dock.
+ * Runs only the Load startup stages; everything else is deferred.
  *
  * @return `true` if initialisation succeeded.
  */
 bool obs_module_load(void)
 {
-    obs_log(LOG_INFO, "[playfame] Loading plugin…");
+    plugin_log_start();            /* obs_log() no longer formats on the caller */
 
-    /* 1 Initialise configuration --------------------------------------- */
-    g_plugin_config = new OBSConfigHelper("playfame_config.json");
-    g_plugin_config->load();
+    /* tracing is opt-in: PLAYFAME_TRACE=1 or the dock's Trace toggle; only
+       then does SIGUSR1 become a dump trigger */
+    const char *traceEnv = std::getenv("PLAYFAME_TRACE");
+    if (traceEnv && *traceEnv && *traceEnv != '0') {
+        Trace::setEnabled(true);
+        Trace::installSignalTrigger();
+    }
+
+    PF_TRACE_SCOPE("module.load");
+    obs_log(LOG_INFO, "[playfame] Loading plugin…");
 
-    /* 2 Create dock in the UI thread ----------------------------------- */
     QWidget *mainWindow =
         static_cast<QWidget *>(obs_frontend_get_main_window());
     if (!mainWindow) {
@@ -84,20 +635,13 @@ bool obs_module_load(void)
         return false;
     }
 
-    QMetaObject::invokeMethod(
-        mainWindow,
-        [mainWindow]() {
-            auto *dock = new PlayFameDock(g_plugin_config, mainWindow);
-            if (!dock->registerDock()) {
-                obs_log(LOG_ERROR, "[playfame] Failed to register dock");
-                dock->deleteLater();
-            } else {
-                g_main_dock = dock;
-            }
-        },
-        Qt::QueuedConnection);
+    /* 1 Run the cheap stages; the rest is deferred ---------------------- */
+    register_startup_stages(mainWindow);
+    register_shutdown_stages();
+    if (!StartupSequence::global().runLoad(mainWindow))
+        return false;
 
-    /* 3 Listen for EXIT so we can tear the dock down while callbacks stay valid */
+    /* 2 FINISHED_LOADING runs the deferred stages; EXIT tears the dock down */
     obs_frontend_add_event_callback(on_frontend_event, nullptr);
 
     obs_log(LOG_INFO, "[playfame] Plugin loaded successfully");
@@ -113,17 +657,13 @@ bool obs_module_load(void)
  */
 void obs_module_unload(void)
 {
+    PF_TRACE_SCOPE("module.unload");
     obs_log(LOG_INFO, "[playfame] Unloading plugin…");
 
-    /* Ensure no dangling dock survives (defensive) */
-    destroy_dock_safe();
-
-    /* Persist & free configuration ------------------------------------ */
-    if (g_plugin_config) {
-        g_plugin_config->save();
-        delete g_plugin_config;
-        g_plugin_config = nullptr;
-    }
+    /* Ordered, each stage within its deadline; see register_shutdown_stages() */
+    ShutdownSequence::global().run();
+    Trace::removeSignalTrigger();  /* the dock that polled for it is gone */
 
     obs_log(LOG_INFO, "[playfame] Plugin unloaded");
+    plugin_log_stop();             /* writes whatever is still queued */
 }
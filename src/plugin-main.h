@@ -14,8 +14,13 @@
 
 #include <obs-module.h>
 
+class ConfigScopes;
+
 /// Called by OBS when the module is loaded.
 bool obs_module_load(void);
 
 /// Called by OBS when the module is unloaded.
 void obs_module_unload(void);
+
+/// Per-profile and per-scene-collection config stores; null until OBS has finished loading.
+ConfigScopes *playfame_config_scopes(void);
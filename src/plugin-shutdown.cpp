@@ -0,0 +1,225 @@
+/*!
+ * @file plugin-shutdown.cpp
+ * @brief Implements the ordered shutdown runner, its deadlines and per-stage timing.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "plugin-shutdown.h"
+#include "plugin-support.h"
+#include "plugin-trace.h"
+
+#include <obs-module.h>
+
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double toMs(uint64_t us)
+{
+    return static_cast<double>(us) / 1000.0;
+}
+
+uint64_t elapsedUs(Clock::time_point since)
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - since).count());
+}
+
+/* shared with the stage's thread, which outlives run() if it is abandoned */
+struct Completion {
+    std::mutex              mutex;
+    std::condition_variable done;
+    bool                    finished  = false;
+    bool                    ok        = false;
+    bool                    abandoned = false;   ///< Set by the runner at the deadline.
+    bool                    freeing   = false;   ///< Set by mayFree(); the runner then waits.
+    uint64_t                us        = 0;
+};
+
+/* the Completion of the worker stage running on this thread */
+thread_local Completion *t_stage = nullptr;
+
+} // namespace
+
+ShutdownSequence &ShutdownSequence::global()
+{
+    static ShutdownSequence sequence;
+    return sequence;
+}
+
+const char *ShutdownSequence::priorityName(ShutdownPriority priority)
+{
+    switch (priority) {
+    case ShutdownPriority::Ui:      return "ui";
+    case ShutdownPriority::Flush:   return "flush";
+    case ShutdownPriority::Release: return "release";
+    }
+    return "?";
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Registration and run                                                     */
+/* ------------------------------------------------------------------------- */
+void ShutdownSequence::add(ShutdownPriority priority, const char *name, std::chrono::milliseconds deadline,
+                           StageFn fn, ShutdownAffinity affinity)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    stages_.push_back({priority, name, deadline, std::move(fn), affinity});
+}
+
+void ShutdownSequence::run()
+{
+    std::vector<Stage> stages;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (ran_)
+            return;
+        ran_ = true;
+        stages.swap(stages_);       /* also drops the captures once done */
+    }
+
+    PF_TRACE_SCOPE("shutdown");
+    const auto start = Clock::now();
+    for (ShutdownPriority priority : {ShutdownPriority::Ui, ShutdownPriority::Flush, ShutdownPriority::Release}) {
+        std::vector<Stage> group;
+        for (const Stage &s : stages)
+            if (s.priority == priority)
+                group.push_back(s);
+        if (!group.empty())
+            runPriority(group);
+    }
+
+    size_t abandonedCount = 0;
+    for (const ShutdownStageReport &r : report())
+        abandonedCount += r.outcome == ShutdownStageReport::Abandoned ? 1 : 0;
+    obs_log(abandonedCount ? LOG_WARNING : LOG_INFO, "[Shutdown] Done in %.2f ms, %zu stage(s) abandoned",
+            toMs(elapsedUs(start)), abandonedCount);
+}
+
+bool ShutdownSequence::abandoned(const char *name) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const ShutdownStageReport &r : reports_)
+        if (!std::strcmp(r.name, name))
+            return r.outcome == ShutdownStageReport::Abandoned;
+    return false;
+}
+
+bool ShutdownSequence::mayFree()
+{
+    Completion *stage = t_stage;
+    if (!stage)
+        return true;
+    std::lock_guard<std::mutex> lock(stage->mutex);
+    if (stage->abandoned)
+        return false;
+    stage->freeing = true;
+    return true;
+}
+
+std::vector<ShutdownStageReport> ShutdownSequence::report() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return reports_;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Internals                                                                */
+/* ------------------------------------------------------------------------- */
+void ShutdownSequence::runPriority(const std::vector<Stage> &stages)
+{
+    PF_TRACE_SCOPE("shutdown.priority");
+    const auto start = Clock::now();
+
+    /* workers first, so they flush while the caller stages run */
+    struct Running {
+        const Stage                *stage;
+        std::shared_ptr<Completion> completion;
+        std::thread                 thread;
+    };
+    std::vector<Running> running;
+    for (const Stage &s : stages) {
+        if (s.affinity != ShutdownAffinity::Worker)
+            continue;
+        auto completion = std::make_shared<Completion>();
+        std::thread thread([completion, fn = s.fn] {
+            PF_TRACE_SCOPE("shutdown.stage");
+            t_stage = completion.get();
+            const auto t0 = Clock::now();
+            const bool ok = fn ? fn() : true;
+            std::lock_guard<std::mutex> lock(completion->mutex);
+            completion->finished = true;
+            completion->ok       = ok;
+            completion->us       = elapsedUs(t0);
+            completion->done.notify_all();
+        });
+        running.push_back({&s, std::move(completion), std::move(thread)});
+    }
+
+    for (const Stage &s : stages) {
+        if (s.affinity != ShutdownAffinity::Caller)
+            continue;
+        const auto t0 = Clock::now();
+        const bool ok = s.fn ? s.fn() : true;
+        record(s, elapsedUs(t0), ok ? ShutdownStageReport::Done : ShutdownStageReport::Failed);
+    }
+
+    /* deadlines count from the start of the priority, as the stages ran side by side */
+    for (Running &r : running) {
+        bool finished = false, ok = false;
+        uint64_t us = 0;
+        {
+            std::unique_lock<std::mutex> lock(r.completion->mutex);
+            auto done = [&] { return r.completion->finished; };
+            finished = r.completion->done.wait_until(lock, start + r.stage->deadline, done);
+            if (!finished && r.completion->freeing) {
+                r.completion->done.wait(lock, done);   /* past its slow part; only the delete is left */
+                finished = true;
+            }
+            r.completion->abandoned = !finished;
+            ok = r.completion->ok;
+            us = r.completion->us;
+        }
+        if (finished) {
+            r.thread.join();
+            record(*r.stage, us, ok ? ShutdownStageReport::Done : ShutdownStageReport::Failed);
+        } else {
+            r.thread.detach();      /* keeps its Completion and captures alive */
+            record(*r.stage, static_cast<uint64_t>(
+                                 std::chrono::duration_cast<std::chrono::microseconds>(r.stage->deadline).count()),
+                   ShutdownStageReport::Abandoned);
+        }
+    }
+}
+
+void ShutdownSequence::record(const Stage &stage, uint64_t us, ShutdownStageReport::Outcome outcome)
+{
+    const auto deadlineUs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(stage.deadline).count());
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reports_.push_back({stage.name, stage.priority, us, deadlineUs, outcome});
+    }
+
+    const char *priority = priorityName(stage.priority);
+    if (outcome == ShutdownStageReport::Abandoned)
+        obs_log(LOG_WARNING, "[Shutdown] %s/%s abandoned after its %.2f ms deadline", priority, stage.name,
+                toMs(deadlineUs));
+    else if (outcome == ShutdownStageReport::Failed)
+        obs_log(LOG_WARNING, "[Shutdown] %s/%s failed after %.2f ms", priority, stage.name, toMs(us));
+    else if (us > deadlineUs)
+        obs_log(LOG_WARNING, "[Shutdown] %s/%s took %.2f ms, over its %.2f ms deadline", priority, stage.name,
+                toMs(us), toMs(deadlineUs));
+    else
+        obs_log(LOG_INFO, "[Shutdown] %s/%s took %.2f ms (deadline %.2f ms)", priority, stage.name, toMs(us),
+                toMs(deadlineUs));
+}
@@ -0,0 +1,110 @@
+/*!
+ * @file plugin-shutdown.h
+ * @brief Ordered plugin shutdown with a deadline per stage.
+ *
+ * Components register a stage with a priority and a deadline; run() goes
+ * through the priorities in order:
+ * - Ui:      UI objects (dock, toasts); runs on the calling thread.
+ * - Flush:   components write out pending work (telemetry spool, config).
+ * - Release: objects other stages used while flushing (auth).
+ *
+ * Stages of one priority run in parallel, each on its own thread, and the
+ * next priority starts once all of them have finished or passed their
+ * deadline. A stage past its deadline is abandoned: its thread is detached
+ * and keeps running after obs_module_unload() has returned, so abandoned
+ * work must never touch a global another stage or the unload may have
+ * freed, and must not free one either. A worker stage therefore calls
+ * mayFree() right before deleting its component and leaks it on false;
+ * later stages that depend on it check abandoned() instead of freeing
+ * shared state under it. Every stage is timed and logged.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+enum class ShutdownPriority { Ui, Flush, Release };
+
+/// Where a stage runs.
+enum class ShutdownAffinity {
+    Worker,   ///< Own thread, in parallel with the other stages of its priority; may be abandoned.
+    Caller,   ///< The thread calling run() (the UI thread for obs_module_unload()); never abandoned.
+};
+
+/**
+ * @brief Timing of one stage that has run (or was abandoned).
+ */
+struct ShutdownStageReport {
+    enum Outcome { Done, Failed, Abandoned };
+
+    const char      *name;
+    ShutdownPriority priority;
+    uint64_t         durationUs;   ///< Up to the deadline for abandoned stages.
+    uint64_t         deadlineUs;
+    Outcome          outcome;
+};
+
+/**
+ * @class ShutdownSequence
+ * @brief Registry and runner of shutdown stages; see the file comment.
+ */
+class ShutdownSequence {
+public:
+    /// A stage returns false on failure; the sequence goes on regardless.
+    using StageFn = std::function<bool()>;
+
+    static ShutdownSequence &global();
+
+    /// Registers a stage. Caller stages of one priority run in registration order.
+    void add(ShutdownPriority priority, const char *name, std::chrono::milliseconds deadline, StageFn fn,
+             ShutdownAffinity affinity = ShutdownAffinity::Worker);
+
+    /// Runs every registered stage once; later calls do nothing. Bounded by the sum of the deadlines.
+    void run();
+
+    /// True if the named stage was abandoned; valid once its priority has run.
+    bool abandoned(const char *name) const;
+
+    /**
+     * @brief Asks, from inside a stage, whether it may still free its component.
+     *
+     * False once the stage has been abandoned: it must then leak whatever it
+     * was about to delete. After true the stage is no longer abandoned, and
+     * its priority waits for it past the deadline, so call this after the
+     * slow part (stop, flush), right before the delete. Always true outside
+     * a worker stage.
+     */
+    static bool mayFree();
+
+    std::vector<ShutdownStageReport> report() const;
+
+    static const char *priorityName(ShutdownPriority priority);
+
+private:
+    ShutdownSequence() = default;
+
+    struct Stage {
+        ShutdownPriority          priority;
+        const char               *name;
+        std::chrono::milliseconds deadline;
+        StageFn                   fn;
+        ShutdownAffinity          affinity;
+    };
+
+    void runPriority(const std::vector<Stage> &stages);
+    void record(const Stage &stage, uint64_t us, ShutdownStageReport::Outcome outcome);
+
+    mutable std::mutex               mutex_;
+    std::vector<Stage>               stages_;
+    std::vector<ShutdownStageReport> reports_;
+    bool                             ran_ = false;
+};
@@ -0,0 +1,210 @@
+/*!
+ * @file plugin-startup.cpp
+ * @brief Implements the staged startup runner and its per-stage timing.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "plugin-startup.h"
+#include "plugin-support.h"
+#include "plugin-trace.h"
+
+#include <obs-module.h>
+
+#include <QMetaObject>
+
+namespace {
+
+double toMs(uint64_t us)
+{
+    return static_cast<double>(us) / 1000.0;
+}
+
+} // namespace
+
+StartupSequence &StartupSequence::global()
+{
+    static StartupSequence sequence;
+    return sequence;
+}
+
+StartupSequence::~StartupSequence()
+{
+    shutdown();
+}
+
+const char *StartupSequence::phaseName(StartupPhase phase)
+{
+    switch (phase) {
+    case StartupPhase::Load:            return "load";
+    case StartupPhase::Background:      return "background";
+    case StartupPhase::FinishedLoading: return "finished-loading";
+    case StartupPhase::FirstShow:       return "first-show";
+    }
+    return "?";
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Registration and phases                                                  */
+/* ------------------------------------------------------------------------- */
+void StartupSequence::add(StartupPhase phase, const char *name, std::chrono::microseconds budget, StageFn fn)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    stages_.push_back({phase, name, budget, std::move(fn)});
+}
+
+bool StartupSequence::runLoad(QObject *uiContext)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uiContext_       = uiContext;
+        backgroundDone_  = false;
+        finishedLoading_ = false;
+        finishedRun_     = false;
+        stopping_        = false;
+    }
+
+    {
+        PF_TRACE_SCOPE("startup.load");
+        std::vector<Stage> load;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const Stage &s : stages_)
+                if (s.phase == StartupPhase::Load)
+                    load.push_back(s);
+        }
+        for (const Stage &s : load)
+            if (!measure(s.phase, s.name, s.budget, s.fn))
+                return false;
+    }
+
+    worker_ = std::thread([this] {
+        {
+            PF_TRACE_SCOPE("startup.background");
+            runPhase(StartupPhase::Background);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            backgroundDone_ = true;
+        }
+        runFinishedLoadingIfReady(false);
+    });
+    return true;
+}
+
+void StartupSequence::onFinishedLoading()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        finishedLoading_ = true;
+    }
+    runFinishedLoadingIfReady(true);
+}
+
+bool StartupSequence::measure(StartupPhase phase, const char *name, std::chrono::microseconds budget,
+                              const StageFn &fn)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const bool ok    = fn ? fn() : true;
+    const auto us    = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                              std::chrono::steady_clock::now() - start).count());
+    const auto budgetUs = static_cast<uint64_t>(budget.count());
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reports_.push_back({name, phase, us, budgetUs, ok});
+    }
+
+    if (!ok)
+        obs_log(LOG_WARNING, "[Startup] %s/%s failed after %.2f ms", phaseName(phase), name, toMs(us));
+    else if (us > budgetUs)
+        obs_log(LOG_WARNING, "[Startup] %s/%s took %.2f ms, over its %.2f ms budget", phaseName(phase), name,
+                toMs(us), toMs(budgetUs));
+    else
+        obs_log(LOG_INFO, "[Startup] %s/%s took %.2f ms (budget %.2f ms)", phaseName(phase), name, toMs(us),
+                toMs(budgetUs));
+    return ok;
+}
+
+void StartupSequence::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    if (worker_.joinable())
+        worker_.join();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stages_.clear();                /* also drops what the stage functions captured */
+}
+
+std::vector<StartupStageReport> StartupSequence::report() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return reports_;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Internals                                                                */
+/* ------------------------------------------------------------------------- */
+void StartupSequence::runPhase(StartupPhase phase)
+{
+    for (size_t i = 0;; ++i) {
+        Stage stage{};
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            while (i < stages_.size() && stages_[i].phase != phase)
+                ++i;
+            if (stopping_ || i >= stages_.size())
+                return;
+            stage = stages_[i];     /* copied: add() may grow the list meanwhile */
+        }
+        measure(stage.phase, stage.name, stage.budget, stage.fn);
+    }
+}
+
+/* FinishedLoading needs both the frontend event and the Background stages;
+ * whichever comes last triggers it, and the worker hands it to the UI thread. */
+void StartupSequence::runFinishedLoadingIfReady(bool onUiThread)
+{
+    QObject *context = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_ || finishedRun_ || !backgroundDone_ || !finishedLoading_)
+            return;
+        if (!onUiThread) {
+            context = uiContext_.data();
+            if (!context)
+                return;
+        }
+        finishedRun_ = true;
+    }
+
+    auto run = [this] {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_)
+                return;             /* unloaded before the queued call ran */
+        }
+        {
+            PF_TRACE_SCOPE("startup.finished_loading");
+            runPhase(StartupPhase::FinishedLoading);
+        }
+
+        uint64_t totals[3] = {};
+        for (const StartupStageReport &r : report())
+            if (r.phase != StartupPhase::FirstShow)
+                totals[static_cast<int>(r.phase)] += r.durationUs;
+        obs_log(LOG_INFO, "[Startup] Done: load %.2f ms, background %.2f ms, finished-loading %.2f ms",
+                toMs(totals[0]), toMs(totals[1]), toMs(totals[2]));
+    };
+
+    if (onUiThread)
+        run();
+    else
+        QMetaObject::invokeMethod(context, run, Qt::QueuedConnection);
+}
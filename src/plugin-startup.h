@@ -0,0 +1,101 @@
+/*!
+ * @file plugin-startup.h
+ * @brief Staged plugin startup with a time budget per stage.
+ *
+ * obs_module_load() only registers stages; each runs in one of these phases:
+ * - Load:            synchronously in obs_module_load(); registration only.
+ * - Background:      in order on a worker thread started at the end of Load.
+ * - FinishedLoading: on the UI thread after OBS_FRONTEND_EVENT_FINISHED_LOADING
+ *                    and after every Background stage has finished.
+ * - FirstShow:       ad hoc through measure(), e.g. when the dock is first shown.
+ *
+ * Every stage is timed and logged; stages over their budget log a warning.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+enum class StartupPhase { Load, Background, FinishedLoading, FirstShow };
+
+/**
+ * @brief Timing of one stage that has run.
+ */
+struct StartupStageReport {
+    const char  *name;
+    StartupPhase phase;
+    uint64_t     durationUs;
+    uint64_t     budgetUs;
+    bool         ok;
+};
+
+/**
+ * @class StartupSequence
+ * @brief Registry and runner of startup stages; see the file comment.
+ */
+class StartupSequence {
+public:
+    /// A stage returns false on failure; a failed Load stage fails the module load.
+    using StageFn = std::function<bool()>;
+
+    static StartupSequence &global();
+
+    ~StartupSequence();
+
+    /// Registers a stage. Stages of one phase run in registration order.
+    void add(StartupPhase phase, const char *name, std::chrono::microseconds budget, StageFn fn);
+
+    /**
+     * @brief Runs the Load stages, then starts the Background worker.
+     * @param uiContext Object on the UI thread; FinishedLoading stages are queued to it.
+     * @return false if a Load stage failed (nothing is started then).
+     */
+    bool runLoad(QObject *uiContext);
+
+    /// Called for OBS_FRONTEND_EVENT_FINISHED_LOADING, on the UI thread.
+    void onFinishedLoading();
+
+    /// Times @p fn as a stage right now, on the calling thread.
+    bool measure(StartupPhase phase, const char *name, std::chrono::microseconds budget, const StageFn &fn);
+
+    /// Waits for the Background worker and drops stages that have not run yet.
+    void shutdown();
+
+    std::vector<StartupStageReport> report() const;
+
+    static const char *phaseName(StartupPhase phase);
+
+private:
+    struct Stage {
+        StartupPhase              phase;
+        const char               *name;
+        std::chrono::microseconds budget;
+        StageFn                   fn;
+    };
+
+    void runPhase(StartupPhase phase);
+    void runFinishedLoadingIfReady(bool onUiThread);
+
+    mutable std::mutex              mutex_;
+    std::vector<Stage>              stages_;
+    std::vector<StartupStageReport> reports_;
+    QPointer<QObject>               uiContext_;
+    std::thread                     worker_;
+    bool                            backgroundDone_  = false;
+    bool                            finishedLoading_ = false;
+    bool                            finishedRun_     = false;
+    bool                            stopping_        = false;
+};
@@ -33,6 +33,18 @@ extern const char *PLUGIN_VERSION;
 void obs_log(int log_level, const char *format, ...);
 extern void blogva(int log_level, const char *format, va_list args);
 
+/* Calls above this level (LOG_ERROR 100, LOG_WARNING 200, LOG_INFO 300,
+ * LOG_DEBUG 400) are removed at compile time. Set through CMake. */
+#ifndef PLAYFAME_LOG_LEVEL
+#define PLAYFAME_LOG_LEVEL 400
+#endif
+
+#define obs_log(log_level, ...)                                   \
+	do {                                                      \
+		if ((log_level) <= PLAYFAME_LOG_LEVEL)            \
+			(obs_log)((log_level), __VA_ARGS__);      \
+	} while (0)
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,323 @@
+/*!
+ * @file plugin-trace.cpp
+ * @brief Implements tracing buffers, histograms and the Chrome trace writer.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "plugin-trace.h"
+#include "plugin-support.h"
+
+#include <obs-module.h>
+#include <util/platform.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+constexpr size_t kEventsPerThread = 16384;  /* power of two; 512 KiB per traced thread */
+constexpr size_t kMaxThreads      = 64;
+
+enum EventType : uint64_t { EventComplete = 1, EventCounter = 2 };
+
+/* Fields are relaxed atomics so the dump may read while the owner writes. */
+struct TraceEvent {
+    std::atomic<uint64_t> name{0};   ///< const char *
+    std::atomic<uint64_t> start{0};
+    std::atomic<uint64_t> value{0};  ///< Duration (ns) or counter value.
+    std::atomic<uint64_t> type{0};
+};
+
+struct ThreadBuffer {
+    uint32_t              tid = 0;
+    std::atomic<uint64_t> written{0};
+    TraceEvent            events[kEventsPerThread];
+};
+
+std::mutex                                 g_registry;  ///< Guards g_buffers and g_sites.
+std::vector<std::shared_ptr<ThreadBuffer>> g_buffers;   ///< Kept after their thread exits.
+TraceSite                                 *g_sites = nullptr;
+std::atomic<uint64_t>                      g_epochNs{0};
+std::atomic<bool>                          g_dumpRequested{false};
+std::mutex                                 g_trigger;   ///< Guards the two below.
+bool                                       g_triggerInstalled = false;
+#ifndef _WIN32
+struct sigaction                           g_previousAction;
+#endif
+std::atomic<uint64_t>                      g_droppedThreads{0};
+
+thread_local std::shared_ptr<ThreadBuffer> t_buffer;
+thread_local bool                          t_bufferFailed = false;
+
+ThreadBuffer *threadBuffer()
+{
+    if (t_buffer || t_bufferFailed)
+        return t_buffer.get();
+
+    std::lock_guard<std::mutex> lock(g_registry);
+    if (g_buffers.size() >= kMaxThreads) {
+        t_bufferFailed = true;
+        g_droppedThreads.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    t_buffer      = std::make_shared<ThreadBuffer>();
+    t_buffer->tid = static_cast<uint32_t>(g_buffers.size() + 1);
+    g_buffers.push_back(t_buffer);
+    return t_buffer.get();
+}
+
+void append(uint64_t type, const char *name, uint64_t start, uint64_t value)
+{
+    ThreadBuffer *buf = threadBuffer();
+    if (!buf)
+        return;
+
+    const uint64_t index = buf->written.load(std::memory_order_relaxed);
+    TraceEvent &e = buf->events[index & (kEventsPerThread - 1)];
+    e.name.store(reinterpret_cast<uintptr_t>(name), std::memory_order_relaxed);
+    e.start.store(start, std::memory_order_relaxed);
+    e.value.store(value, std::memory_order_relaxed);
+    e.type.store(type, std::memory_order_relaxed);
+    buf->written.store(index + 1, std::memory_order_release);
+}
+
+void writeEscaped(std::FILE *f, const char *s)
+{
+    std::fputc('"', f);
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\')
+            std::fputc('\\', f);
+        if (static_cast<unsigned char>(*s) >= 0x20)
+            std::fputc(*s, f);
+    }
+    std::fputc('"', f);
+}
+
+extern "C" void onDumpSignal(int)
+{
+    Trace::requestDump();
+}
+
+} // namespace
+
+/* ------------------------------------------------------------------------- */
+/*  Histogram                                                                */
+/* ------------------------------------------------------------------------- */
+size_t TraceHistogram::bucketOf(uint64_t value)
+{
+    if (value < 64)
+        return static_cast<size_t>(value);
+    const int shift = (63 - std::countl_zero(value)) - 5;  /* keeps 6 significant bits */
+    return static_cast<size_t>(shift) * 32 + static_cast<size_t>(value >> shift);
+}
+
+uint64_t TraceHistogram::lowerBound(size_t bucket)
+{
+    if (bucket < 64)
+        return bucket;
+    const size_t shift = bucket / 32 - 1;
+    return static_cast<uint64_t>(bucket % 32 + 32) << shift;
+}
+
+void TraceHistogram::record(uint64_t value)
+{
+    buckets_[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t seen = max_.load(std::memory_order_relaxed);
+    while (value > seen && !max_.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t TraceHistogram::percentile(double q) const
+{
+    const uint64_t total = count();
+    if (!total)
+        return 0;
+
+    const uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(q * static_cast<double>(total) + 0.5));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= target)
+            return std::min(i + 1 < kBuckets ? lowerBound(i + 1) - 1 : max(), max());
+    }
+    return max();
+}
+
+TraceSite::TraceSite(const char *siteName)
+    : name(siteName)
+{
+    std::lock_guard<std::mutex> lock(g_registry);
+    next    = g_sites;
+    g_sites = this;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Recording                                                                */
+/* ------------------------------------------------------------------------- */
+namespace Trace {
+
+void setEnabled(bool on)
+{
+    uint64_t expected = 0;
+    g_epochNs.compare_exchange_strong(expected, nowNs());
+    gEnabled.store(on, std::memory_order_relaxed);
+}
+
+uint64_t nowNs()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void complete(TraceSite &site, uint64_t startNs, uint64_t endNs)
+{
+    const uint64_t duration = endNs - startNs;
+    site.histogram.record(duration);
+    append(EventComplete, site.name, startNs, duration);
+}
+
+void counter(const char *name, int64_t value)
+{
+    append(EventCounter, name, nowNs(), static_cast<uint64_t>(value));
+}
+
+void requestDump()
+{
+    g_dumpRequested.store(true, std::memory_order_relaxed);
+}
+
+bool takeDumpRequest()
+{
+    return g_dumpRequested.exchange(false, std::memory_order_relaxed);
+}
+
+bool installSignalTrigger()
+{
+#ifndef _WIN32
+    std::lock_guard<std::mutex> lock(g_trigger);
+    if (g_triggerInstalled)
+        return true;
+    struct sigaction action {};
+    action.sa_handler = onDumpSignal;
+    action.sa_flags   = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    g_triggerInstalled = sigaction(SIGUSR1, &action, &g_previousAction) == 0;
+    return g_triggerInstalled;
+#else
+    return false;
+#endif
+}
+
+void removeSignalTrigger()
+{
+#ifndef _WIN32
+    std::lock_guard<std::mutex> lock(g_trigger);
+    if (!g_triggerInstalled)
+        return;
+    sigaction(SIGUSR1, &g_previousAction, nullptr);
+    g_triggerInstalled = false;
+#endif
+}
+
+bool signalTriggerInstalled()
+{
+    std::lock_guard<std::mutex> lock(g_trigger);
+    return g_triggerInstalled;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Chrome trace export                                                      */
+/* ------------------------------------------------------------------------- */
+bool writeChromeTrace(const char *path)
+{
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::vector<TraceSite *> sites;
+    {
+        std::lock_guard<std::mutex> lock(g_registry);
+        buffers = g_buffers;
+        for (TraceSite *s = g_sites; s; s = s->next)
+            sites.push_back(s);
+    }
+
+    std::FILE *f = os_fopen(path, "wb");
+    if (!f)
+        return false;
+
+    const uint64_t epoch = g_epochNs.load();
+    const auto us = [epoch](uint64_t ns) { return static_cast<double>(ns - std::min(ns, epoch)) / 1000.0; };
+
+    std::fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    std::fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"%s\"}}", PLUGIN_NAME);
+
+    for (const auto &buf : buffers) {
+        std::fprintf(f, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}",
+                     buf->tid, buf->tid);
+
+        /* copy the window, then drop whatever the owner overwrote meanwhile */
+        const uint64_t end   = buf->written.load(std::memory_order_acquire);
+        const uint64_t begin = end > kEventsPerThread ? end - kEventsPerThread : 0;
+        std::vector<std::pair<uint64_t, std::array<uint64_t, 4>>> copy;
+        copy.reserve(static_cast<size_t>(end - begin));
+        for (uint64_t i = begin; i < end; ++i) {
+            const TraceEvent &e = buf->events[i & (kEventsPerThread - 1)];
+            copy.push_back({i, {e.name.load(std::memory_order_relaxed), e.start.load(std::memory_order_relaxed),
+                                e.value.load(std::memory_order_relaxed), e.type.load(std::memory_order_relaxed)}});
+        }
+        const uint64_t now   = buf->written.load(std::memory_order_acquire);
+        const uint64_t valid = now > kEventsPerThread ? now - kEventsPerThread : 0;
+
+        for (const auto &[index, e] : copy) {
+            if (index < valid || !e[0])
+                continue;
+            const char *name = reinterpret_cast<const char *>(static_cast<uintptr_t>(e[0]));
+            std::fprintf(f, ",\n{\"name\":");
+            writeEscaped(f, name);
+            if (e[3] == EventComplete)
+                std::fprintf(f, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", buf->tid,
+                             us(e[1]), static_cast<double>(e[2]) / 1000.0);
+            else
+                std::fprintf(f, ",\"ph\":\"C\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"value\":%lld}}",
+                             buf->tid, us(e[1]), static_cast<long long>(e[2]));
+        }
+    }
+
+    /* latency summaries; viewers ignore unknown top-level keys */
+    std::fprintf(f, "\n],\"playfameHistograms\":[");
+    bool first = true;
+    for (TraceSite *site : sites) {
+        const TraceHistogram &h = site->histogram;
+        if (!h.count())
+            continue;
+        std::fprintf(f, "%s\n{\"name\":", first ? "" : ",");
+        writeEscaped(f, site->name);
+        std::fprintf(f,
+                     ",\"count\":%llu,\"mean_us\":%.3f,\"p50_us\":%.3f,\"p90_us\":%.3f,\"p99_us\":%.3f,"
+                     "\"p999_us\":%.3f,\"max_us\":%.3f}",
+                     static_cast<unsigned long long>(h.count()),
+                     static_cast<double>(h.sum()) / static_cast<double>(h.count()) / 1000.0,
+                     h.percentile(0.50) / 1000.0, h.percentile(0.90) / 1000.0, h.percentile(0.99) / 1000.0,
+                     h.percentile(0.999) / 1000.0, h.max() / 1000.0);
+        first = false;
+    }
+    std::fprintf(f, "\n],\"playfameUntracedThreads\":%llu}\n",
+                 static_cast<unsigned long long>(g_droppedThreads.load()));
+
+    const bool ok = !std::ferror(f);
+    return std::fclose(f) == 0 && ok;
+}
+
+} // namespace Trace
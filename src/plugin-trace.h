@@ -0,0 +1,171 @@
+/*!
+ * @file plugin-trace.h
+ * @brief Lightweight hot-path tracing: scoped timers, counters, latency
+ *        histograms and Chrome/Perfetto trace export.
+ *
+ * Usage:
+ * @code
+ * void OBSConfigHelper::load()
+ * {
+ *     PF_TRACE_SCOPE("config.load");
+ *     ...
+ *     PF_TRACE_COUNTER("config.keys", count);
+ * }
+ * @endcode
+ *
+ * Every PF_TRACE_SCOPE site owns a histogram of its durations. While
+ * tracing is enabled, each scope records into that histogram and appends a
+ * complete event to a per-thread ring (the newest events win), which
+ * writeChromeTrace() dumps as JSON for chrome://tracing or ui.perfetto.dev.
+ * While disabled, a scope costs one relaxed atomic load. Building with
+ * PLAYFAME_TRACE=0 removes the macros entirely.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#ifndef PLAYFAME_TRACE
+#define PLAYFAME_TRACE 1
+#endif
+
+/**
+ * @class TraceHistogram
+ * @brief Log-linear latency histogram in the spirit of HdrHistogram.
+ *
+ * Values below 64 are exact; above that every power of two is split into
+ * 32 buckets, so any value is reported within ~3%. Recording is one
+ * relaxed atomic increment and is safe from any thread.
+ */
+class TraceHistogram {
+public:
+    static constexpr size_t kBuckets = 59 * 32 + 32;
+
+    void record(uint64_t value);
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+    uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+
+    /// Smallest bucket bound covering the fraction @p q (0..1) of samples.
+    uint64_t percentile(double q) const;
+
+    static size_t bucketOf(uint64_t value);
+    static uint64_t lowerBound(size_t bucket);
+
+private:
+    std::atomic<uint64_t> buckets_[kBuckets] = {};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> max_{0};
+    std::atomic<uint64_t> sum_{0};
+};
+
+/**
+ * @brief A named instrumentation point; created once per PF_TRACE_SCOPE.
+ */
+struct TraceSite {
+    explicit TraceSite(const char *siteName);
+
+    const char    *name;
+    TraceHistogram histogram;   ///< Durations in nanoseconds.
+    TraceSite     *next = nullptr;
+};
+
+namespace Trace {
+
+inline std::atomic<bool> gEnabled{false};
+
+inline bool enabled()
+{
+    return gEnabled.load(std::memory_order_relaxed);
+}
+
+/// Turns event recording on or off. Histograms keep their samples.
+void setEnabled(bool on);
+
+/// Monotonic clock in nanoseconds.
+uint64_t nowNs();
+
+/// Records a finished scope into the site histogram and the thread's ring.
+void complete(TraceSite &site, uint64_t startNs, uint64_t endNs);
+
+/// Records a counter sample (shown as a track in the trace viewer).
+void counter(const char *name, int64_t value);
+
+/**
+ * @brief Writes all buffered events and histogram summaries as Chrome trace JSON.
+ * @return false if the file could not be written.
+ */
+bool writeChromeTrace(const char *path);
+
+/// Asks for a dump; async-signal-safe. Picked up by takeDumpRequest().
+void requestDump();
+
+/// Returns true once per requestDump().
+bool takeDumpRequest();
+
+/**
+ * @brief Maps SIGUSR1 to requestDump() on POSIX systems; no-op elsewhere.
+ *
+ * Keeps the handler it replaces for removeSignalTrigger(). Later calls do
+ * nothing. @return true if the trigger is installed.
+ */
+bool installSignalTrigger();
+
+/// Puts back the SIGUSR1 handler that installSignalTrigger() replaced.
+void removeSignalTrigger();
+
+/// True between installSignalTrigger() and removeSignalTrigger().
+bool signalTriggerInstalled();
+
+} // namespace Trace
+
+/**
+ * @class TraceScope
+ * @brief Times the enclosing scope; see PF_TRACE_SCOPE.
+ */
+class TraceScope {
+public:
+    explicit TraceScope(TraceSite &site)
+        : site_(site)
+        , start_(Trace::enabled() ? Trace::nowNs() : 0)
+    {
+    }
+
+    ~TraceScope()
+    {
+        if (start_)
+            Trace::complete(site_, start_, Trace::nowNs());
+    }
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    TraceSite &site_;
+    uint64_t   start_;
+};
+
+#define PF_TRACE_CONCAT_(a, b) a##b
+#define PF_TRACE_CONCAT(a, b)  PF_TRACE_CONCAT_(a, b)
+
+#if PLAYFAME_TRACE
+#define PF_TRACE_SCOPE(name)                                                  \
+    static TraceSite PF_TRACE_CONCAT(pfTraceSite_, __LINE__)(name);           \
+    TraceScope PF_TRACE_CONCAT(pfTraceScope_, __LINE__)(PF_TRACE_CONCAT(pfTraceSite_, __LINE__))
+#define PF_TRACE_COUNTER(name, value)                                         \
+    do {                                                                      \
+        if (Trace::enabled())                                                 \
+            Trace::counter((name), static_cast<int64_t>(value));              \
+    } while (0)
+#else
+#define PF_TRACE_SCOPE(name)          do { } while (0)
+#define PF_TRACE_COUNTER(name, value) do { } while (0)
+#endif
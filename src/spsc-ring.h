@@ -0,0 +1,72 @@
+/*!
+ * @file spsc-ring.h
+ * @brief Wait-free single-producer/single-consumer ring of fixed capacity.
+ *
+ * push() and pop() each take a bounded number of steps and never block or
+ * allocate, so the producer can be a real-time thread (OBS's audio thread).
+ * Head and tail live on separate cache lines, and each side keeps a cached
+ * copy of the other's index so the shared line is read only when the
+ * cached value says the ring looks full (or empty).
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+/**
+ * @class SpscRing
+ * @brief Ring buffer of @p Capacity slots (a power of two).
+ *
+ * Exactly one thread may call push() and exactly one thread may call pop().
+ */
+template<typename T, size_t Capacity> class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "slots are copied by value");
+
+public:
+    /// Producer: copies @p item in; false (and no change) when the ring is full.
+    bool push(const T &item)
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - cachedTail_ == Capacity) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head - cachedTail_ == Capacity)
+                return false;
+        }
+        slots_[head & (Capacity - 1)] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Consumer: moves the oldest item to @p out; false when the ring is empty.
+    bool pop(T &out)
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == cachedHead_) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail == cachedHead_)
+                return false;
+        }
+        out = slots_[tail & (Capacity - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    static constexpr size_t kLine = 64;
+
+    alignas(kLine) std::atomic<size_t> head_{0};   ///< Written by the producer.
+    size_t cachedTail_ = 0;                         ///< Producer's view of tail_.
+    alignas(kLine) std::atomic<size_t> tail_{0};   ///< Written by the consumer.
+    size_t cachedHead_ = 0;                         ///< Consumer's view of head_.
+    alignas(kLine) T slots_[Capacity];
+};
@@ -0,0 +1,76 @@
+/*!
+ * @file telemetry-http.cpp
+ * @brief Implements TelemetryHttpUploader on QNetworkAccessManager.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "telemetry-http.h"
+
+#include <QEventLoop>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QTimer>
+#include <QUrl>
+
+#include <memory>
+
+namespace {
+
+constexpr int kCancelPollMs = 50;
+
+} // namespace
+
+TelemetryHttpUploader::TelemetryHttpUploader(TelemetryHttpOptions options)
+    : options_(std::move(options))
+{
+}
+
+TelemetryUploadResult TelemetryHttpUploader::upload(const QByteArray &batch, uint32_t events,
+                                                    const std::atomic<bool> &cancel)
+{
+    TelemetryUploadResult result;
+
+    /* created per call: the manager must live and die on the uploader thread,
+     * and batches are seconds apart, so connection reuse buys little */
+    QNetworkAccessManager manager;
+    manager.setTransferTimeout(static_cast<int>(options_.timeout.count()));
+
+    QNetworkRequest request(QUrl(QString::fromUtf8(options_.endpoint)));
+    request.setHeader(QNetworkRequest::ContentTypeHeader, QByteArray("application/x-playfame-telemetry"));
+    request.setRawHeader("X-PlayFame-Events", QByteArray::number(events));
+    if (options_.idToken) {
+        const QByteArray token = options_.idToken();
+        if (!token.isEmpty())
+            request.setRawHeader("Authorization", "Bearer " + token);
+    }
+
+    std::unique_ptr<QNetworkReply> reply(manager.post(request, batch));
+
+    QEventLoop loop;
+    QTimer     poll;
+    QObject::connect(reply.get(), &QNetworkReply::finished, &loop, &QEventLoop::quit);
+    QObject::connect(&poll, &QTimer::timeout, &loop, [&]() {
+        if (cancel.load(std::memory_order_relaxed))
+            reply->abort();
+    });
+    poll.start(kCancelPollMs);
+    if (!reply->isFinished())
+        loop.exec();
+
+    const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status >= 200 && status < 300) {
+        result.status = TelemetryUploadResult::Sent;
+    } else if (status == 0 || status == 408 || status == 429 || status >= 500) {
+        result.status = TelemetryUploadResult::Retry;
+        result.error  = status ? QStringLiteral("HTTP %1").arg(status) : reply->errorString();
+    } else {
+        result.status = TelemetryUploadResult::Rejected;
+        result.error  = QStringLiteral("HTTP %1").arg(status);
+    }
+    return result;
+}
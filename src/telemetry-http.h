@@ -0,0 +1,45 @@
+/*!
+ * @file telemetry-http.h
+ * @brief TelemetryUploader that POSTs batches to an HTTP(S) endpoint.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include "telemetry.h"
+
+#include <QByteArray>
+
+#include <chrono>
+#include <functional>
+
+/**
+ * @brief Where and how TelemetryHttpUploader sends batches.
+ */
+struct TelemetryHttpOptions {
+    QByteArray                  endpoint;    ///< e.g. "https://…/v1/events", or "http://127.0.0.1:8787/events" for a local stand-in.
+    std::function<QByteArray()> idToken;     ///< Bearer token for the request; may return empty. Called on the uploader thread.
+    std::chrono::milliseconds   timeout{15000};
+};
+
+/**
+ * @class TelemetryHttpUploader
+ * @brief One POST per batch, body = the encoded batch.
+ *
+ * 2xx counts as sent; connection errors, timeouts, 408, 429 and 5xx are
+ * retried; any other status rejects the batch. Runs its own event loop on
+ * the uploader thread while a request is in flight.
+ */
+class TelemetryHttpUploader : public TelemetryUploader {
+public:
+    explicit TelemetryHttpUploader(TelemetryHttpOptions options);
+
+    TelemetryUploadResult upload(const QByteArray &batch, uint32_t events, const std::atomic<bool> &cancel) override;
+
+private:
+    TelemetryHttpOptions options_;
+};
@@ -0,0 +1,531 @@
+/*!
+ * @file telemetry.cpp
+ * @brief Implements the telemetry codec, batcher, uploader loop and spool.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#include "telemetry.h"
+#include "plugin-support.h"
+#include "plugin-trace.h"
+
+#include <obs-module.h>
+#include <util/platform.h>
+
+#include <QFile>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr char   kMagic[4]    = {'P', 'F', 'T', '1'};
+constexpr size_t kHeaderBound = sizeof(kMagic) + 8 + 10 + 5 + 10;
+constexpr char   kSpoolSuffix[] = ".pft";
+
+void putVarint(QByteArray &out, uint64_t v)
+{
+    while (v >= 0x80) {
+        out.append(static_cast<char>(v | 0x80));
+        v >>= 7;
+    }
+    out.append(static_cast<char>(v));
+}
+
+bool takeVarint(const char *&p, const char *end, uint64_t &out)
+{
+    out = 0;
+    for (unsigned shift = 0; shift < 64 && p < end; shift += 7) {
+        const auto b = static_cast<uint8_t>(*p++);
+        out |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if (!(b & 0x80))
+            return true;
+    }
+    return false;
+}
+
+uint64_t zigzag(int64_t v)
+{
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+int64_t unzigzag(uint64_t v)
+{
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+int64_t wallClockMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+TelemetryEvent TelemetryEvent::make(uint32_t type, int32_t value, const char *detail)
+{
+    TelemetryEvent e;
+    e.timestampMs = wallClockMs();
+    e.type        = type;
+    e.value       = value;
+    if (detail) {
+        size_t len = strnlen(detail, kDetailBytes + 1);
+        if (len > kDetailBytes) {
+            len = kDetailBytes;
+            while (len && (static_cast<uint8_t>(detail[len]) & 0xC0) == 0x80)
+                --len;   /* don't split a UTF-8 sequence */
+        }
+        std::memcpy(e.detail, detail, len);
+        e.detailLength = static_cast<uint8_t>(len);
+    }
+    return e;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Codec                                                                    */
+/* ------------------------------------------------------------------------- */
+size_t TelemetryCodec::maxEncodedSize(const TelemetryEvent &event)
+{
+    return 5 + 10 + 5 + 1 + event.detailLength;
+}
+
+QByteArray TelemetryCodec::encode(uint64_t sessionId, uint64_t sequence, const TelemetryEvent *events, size_t count)
+{
+    size_t bound = kHeaderBound;
+    for (size_t i = 0; i < count; ++i)
+        bound += maxEncodedSize(events[i]);
+
+    QByteArray out;
+    out.reserve(static_cast<qsizetype>(bound));
+    out.append(kMagic, sizeof(kMagic));
+    for (int i = 0; i < 8; ++i)
+        out.append(static_cast<char>(sessionId >> (8 * i)));
+    putVarint(out, sequence);
+    putVarint(out, count);
+    putVarint(out, count ? static_cast<uint64_t>(events[0].timestampMs) : 0);
+
+    int64_t previous = count ? events[0].timestampMs : 0;
+    for (size_t i = 0; i < count; ++i) {
+        const TelemetryEvent &e = events[i];
+        putVarint(out, e.type);
+        putVarint(out, zigzag(e.timestampMs - previous));
+        putVarint(out, zigzag(e.value));
+        putVarint(out, e.detailLength);
+        out.append(e.detail, e.detailLength);
+        previous = e.timestampMs;
+    }
+    return out;
+}
+
+bool TelemetryCodec::decode(const QByteArray &batch, std::vector<TelemetryEvent> &events, uint64_t *sessionId,
+                            uint64_t *sequence)
+{
+    const char *p   = batch.constData();
+    const char *end = p + batch.size();
+    if (batch.size() < static_cast<qsizetype>(sizeof(kMagic) + 8) || std::memcmp(p, kMagic, sizeof(kMagic)))
+        return false;
+    p += sizeof(kMagic);
+
+    uint64_t session = 0;
+    for (int i = 0; i < 8; ++i)
+        session |= static_cast<uint64_t>(static_cast<uint8_t>(*p++)) << (8 * i);
+
+    uint64_t seq = 0, count = 0, first = 0;
+    if (!takeVarint(p, end, seq) || !takeVarint(p, end, count) || !takeVarint(p, end, first))
+        return false;
+    if (count > static_cast<uint64_t>(end - p) / 4)   /* every event takes at least 4 bytes */
+        return false;
+
+    events.clear();
+    events.reserve(count);
+    int64_t timestamp = static_cast<int64_t>(first);
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t type = 0, delta = 0, value = 0, length = 0;
+        if (!takeVarint(p, end, type) || !takeVarint(p, end, delta) || !takeVarint(p, end, value) ||
+            !takeVarint(p, end, length) || length > TelemetryEvent::kDetailBytes ||
+            static_cast<uint64_t>(end - p) < length)
+            return false;
+
+        TelemetryEvent e;
+        timestamp        += unzigzag(delta);
+        e.timestampMs     = timestamp;
+        e.type            = static_cast<uint32_t>(type);
+        e.value           = static_cast<int32_t>(unzigzag(value));
+        e.detailLength    = static_cast<uint8_t>(length);
+        std::memcpy(e.detail, p, length);
+        p += length;
+        events.push_back(e);
+    }
+    if (p != end)
+        return false;
+
+    if (sessionId)
+        *sessionId = session;
+    if (sequence)
+        *sequence = seq;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Pipeline                                                                 */
+/* ------------------------------------------------------------------------- */
+TelemetryPipeline::TelemetryPipeline(std::unique_ptr<TelemetryUploader> uploader, TelemetryOptions options)
+    : uploader_(std::move(uploader))
+    , options_(std::move(options))
+    , sessionId_(static_cast<uint64_t>(wallClockMs()))   /* sorts spool files of later sessions last */
+{
+}
+
+TelemetryPipeline::~TelemetryPipeline()
+{
+    stop();
+}
+
+void TelemetryPipeline::start()
+{
+    if (batcher_.joinable())
+        return;
+    batcher_        = std::thread(&TelemetryPipeline::runBatcher, this);
+    uploaderThread_ = std::thread(&TelemetryPipeline::runUploader, this);
+}
+
+void TelemetryPipeline::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_)
+            return;
+        stopping_ = true;
+    }
+    cancel_.store(true);            /* an upload in progress gives up */
+    wake_.notify_all();
+
+    if (batcher_.joinable())
+        batcher_.join();            /* seals whatever is still in the ring */
+    if (uploaderThread_.joinable())
+        uploaderThread_.join();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!spoolScanned_)
+        recoverSpool();             /* so the spool limit also covers older files */
+    size_t spooled = 0;
+    for (const Batch &batch : memory_) {
+        if (spoolBatch(batch))
+            ++spooled;
+        else
+            stats_.droppedSpool += batch.events;
+    }
+    memory_.clear();
+    if (spooled)
+        obs_log(LOG_INFO, "[Telemetry] Spooled %zu unsent batches for the next session", spooled);
+}
+
+bool TelemetryPipeline::enqueue(const TelemetryEvent &event)
+{
+    if (!ring_.push(event)) {
+        droppedQueueFull_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    enqueued_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+TelemetryStats TelemetryPipeline::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    TelemetryStats s   = stats_;
+    s.enqueued         = enqueued_.load(std::memory_order_relaxed);
+    s.droppedQueueFull = droppedQueueFull_.load(std::memory_order_relaxed);
+    return s;
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Batcher thread                                                           */
+/* ------------------------------------------------------------------------- */
+void TelemetryPipeline::runBatcher()
+{
+    std::vector<TelemetryEvent> pending;
+    pending.reserve(options_.maxBatchEvents);
+    size_t            pendingBytes = 0;
+    Clock::time_point firstAt;
+
+    auto add = [&](const TelemetryEvent &e) {
+        if (pending.empty())
+            firstAt = Clock::now();
+        pending.push_back(e);
+        pendingBytes += TelemetryCodec::maxEncodedSize(e);
+        if (pending.size() >= options_.maxBatchEvents || pendingBytes >= options_.maxBatchBytes)
+            seal(pending, pendingBytes);
+    };
+
+    for (;;) {
+        bool stopping;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait_for(lock, options_.pollInterval, [this] { return stopping_; });
+            stopping = stopping_;
+        }
+
+        TelemetryEvent e;
+        while (ring_.pop(e))
+            add(e);
+
+        /* tell the backend about losses in-band, once per poll at most */
+        const uint64_t dropped = droppedQueueFull_.load(std::memory_order_relaxed);
+        if (dropped != droppedReported_) {
+            add(TelemetryEvent::make(kTelemetryDropped, static_cast<int32_t>(
+                                         std::min<uint64_t>(dropped - droppedReported_, INT32_MAX))));
+            droppedReported_ = dropped;
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++stats_.generated;
+        }
+
+        if (!pending.empty() && (stopping || Clock::now() - firstAt >= options_.maxBatchDelay))
+            seal(pending, pendingBytes);
+        if (stopping)
+            return;
+    }
+}
+
+void TelemetryPipeline::seal(std::vector<TelemetryEvent> &pending, size_t &pendingBytes)
+{
+    PF_TRACE_SCOPE("telemetry.seal");
+    Batch batch;
+    batch.sequence = sequence_++;
+    batch.events   = static_cast<uint32_t>(pending.size());
+    batch.bytes    = TelemetryCodec::encode(sessionId_, batch.sequence, pending.data(), pending.size());
+    pending.clear();
+    pendingBytes = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.batches;
+        stats_.encodedBytes += static_cast<uint64_t>(batch.bytes.size());
+        memory_.push_back(std::move(batch));
+
+        /* backpressure: the uploader is behind, so the oldest waiting batches go to disk */
+        while (memory_.size() > options_.maxMemoryBatches) {
+            if (!spoolBatch(memory_.front()))
+                stats_.droppedSpool += memory_.front().events;
+            memory_.pop_front();
+        }
+    }
+    wake_.notify_all();
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Uploader thread                                                          */
+/* ------------------------------------------------------------------------- */
+void TelemetryPipeline::runUploader()
+{
+    size_t recovered = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!spoolScanned_)
+            recoverSpool();
+        recovered = spool_.size();
+    }
+    enqueue(TelemetryEvent::make(kTelemetrySessionStart, static_cast<int32_t>(recovered)));
+
+    auto              retryDelay  = options_.retryMin;
+    Clock::time_point nextAttempt = Clock::now();
+
+    for (;;) {
+        Batch    batch;
+        uint64_t session = sessionId_;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            for (;;) {
+                if (stopping_)
+                    return;
+                if (memory_.empty() && spool_.empty())
+                    wake_.wait(lock);
+                else if (Clock::now() < nextAttempt)
+                    wake_.wait_until(lock, nextAttempt);
+                else
+                    break;
+            }
+
+            /* spooled batches are older than anything still in memory */
+            if (!spool_.empty()) {
+                const auto entry = spool_.begin();
+                session          = entry->session;
+                batch.sequence   = entry->sequence;
+                batch.events     = entry->events;
+                QFile file(QString::fromUtf8(spoolPath(entry->name)));
+                if (file.open(QIODevice::ReadOnly))
+                    batch.bytes = file.readAll();
+                if (!batch.bytes.startsWith(QByteArray(kMagic, sizeof(kMagic)))) {
+                    obs_log(LOG_WARNING, "[Telemetry] Dropping unreadable spool file %s", entry->name.constData());
+                    stats_.droppedSpool += entry->events;
+                    removeSpooled(entry);
+                    continue;
+                }
+            } else {
+                batch = memory_.front();
+            }
+        }
+
+        TelemetryUploadResult result;
+        {
+            PF_TRACE_SCOPE("telemetry.upload");
+            result = uploader_->upload(batch.bytes, batch.events, cancel_);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            finish(session, batch.sequence, result, batch.events);
+        }
+
+        if (result.status == TelemetryUploadResult::Retry) {
+            if (!cancel_.load(std::memory_order_relaxed))
+                obs_log(LOG_WARNING, "[Telemetry] Upload failed (%s); retrying in %lld ms",
+                        result.error.toUtf8().constData(), static_cast<long long>(retryDelay.count()));
+            nextAttempt = Clock::now() + retryDelay;
+            retryDelay  = std::min(retryDelay * 2, options_.retryMax);
+        } else {
+            if (result.status == TelemetryUploadResult::Rejected)
+                obs_log(LOG_WARNING, "[Telemetry] Batch of %u events rejected: %s", batch.events,
+                        result.error.toUtf8().constData());
+            retryDelay  = options_.retryMin;
+            nextAttempt = Clock::now();
+        }
+    }
+}
+
+void TelemetryPipeline::finish(uint64_t session, uint64_t sequence, const TelemetryUploadResult &result,
+                               uint32_t events)
+{
+    /* the batcher may have moved the batch to the spool while it was in flight */
+    const auto inMemory = std::find_if(memory_.begin(), memory_.end(), [&](const Batch &b) {
+        return session == sessionId_ && b.sequence == sequence;
+    });
+    const auto inSpool = std::find_if(spool_.begin(), spool_.end(), [&](const SpoolEntry &s) {
+        return s.session == session && s.sequence == sequence;
+    });
+
+    switch (result.status) {
+    case TelemetryUploadResult::Sent:
+        ++stats_.uploadedBatches;
+        stats_.uploadedEvents += events;
+        break;
+    case TelemetryUploadResult::Rejected:
+        stats_.rejected += events;
+        break;
+    case TelemetryUploadResult::Retry:
+        ++stats_.uploadFailures;
+        /* keep it on disk while offline; it survives a crash there */
+        if (inMemory != memory_.end() && spoolBatch(*inMemory))
+            memory_.erase(inMemory);
+        return;
+    }
+
+    if (inMemory != memory_.end())
+        memory_.erase(inMemory);
+    if (inSpool != spool_.end())
+        removeSpooled(inSpool);
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Spool                                                                    */
+/* ------------------------------------------------------------------------- */
+QByteArray TelemetryPipeline::spoolPath(const QByteArray &name) const
+{
+    return options_.spoolDir + "/" + name;
+}
+
+void TelemetryPipeline::recoverSpool()
+{
+    spoolScanned_ = true;
+    if (options_.spoolDir.isEmpty())
+        return;
+    os_mkdirs(options_.spoolDir.constData());
+
+    os_dir_t *dir = os_opendir(options_.spoolDir.constData());
+    if (!dir)
+        return;
+    while (struct os_dirent *ent = os_readdir(dir)) {
+        if (ent->directory)
+            continue;
+        if (std::strstr(ent->d_name, ".tmp")) {
+            os_unlink(spoolPath(QByteArray(ent->d_name)).constData());   /* torn write */
+            continue;
+        }
+
+        unsigned long long session = 0, sequence = 0;
+        unsigned           events  = 0;
+        char               suffix[8] = {};
+        if (std::sscanf(ent->d_name, "%16llx-%8llx-%u%7s", &session, &sequence, &events, suffix) != 4 ||
+            std::strcmp(suffix, kSpoolSuffix))
+            continue;
+
+        const QByteArray name(ent->d_name);
+        const int64_t    size = os_get_file_size(spoolPath(name).constData());
+        if (size < 0)
+            continue;
+        spool_.push_back({name, session, sequence, events, static_cast<uint64_t>(size)});
+        stats_.spoolBytes += static_cast<uint64_t>(size);
+    }
+    os_closedir(dir);
+
+    std::sort(spool_.begin(), spool_.end(), [](const SpoolEntry &a, const SpoolEntry &b) {
+        return a.session != b.session ? a.session < b.session : a.sequence < b.sequence;
+    });
+    stats_.recoveredBatches = spool_.size();
+    evictSpool(0);
+    if (!spool_.empty())
+        obs_log(LOG_INFO, "[Telemetry] %zu spooled batches (%llu bytes) waiting to upload", spool_.size(),
+                static_cast<unsigned long long>(stats_.spoolBytes));
+}
+
+bool TelemetryPipeline::spoolBatch(const Batch &batch)
+{
+    const auto size = static_cast<uint64_t>(batch.bytes.size());
+    if (options_.spoolDir.isEmpty() || size > options_.maxSpoolBytes)
+        return false;
+    evictSpool(size);
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "%016llx-%08llx-%u%s", static_cast<unsigned long long>(sessionId_),
+                  static_cast<unsigned long long>(batch.sequence), batch.events, kSpoolSuffix);
+    const QByteArray path = spoolPath(QByteArray(name));
+    const QByteArray tmp  = path + ".tmp";
+
+    /* write-then-rename: the uploader never sees a partial file under the final name */
+    std::FILE *f  = os_fopen(tmp.constData(), "wb");
+    bool       ok = f && std::fwrite(batch.bytes.constData(), 1, size, f) == size;
+    if (f)
+        ok = std::fclose(f) == 0 && ok;
+    ok = ok && os_rename(tmp.constData(), path.constData()) == 0;
+    if (!ok) {
+        os_unlink(tmp.constData());
+        obs_log(LOG_WARNING, "[Telemetry] Could not write spool file %s", path.constData());
+        return false;
+    }
+
+    spool_.push_back({QByteArray(name), sessionId_, batch.sequence, batch.events, size});
+    stats_.spoolBytes += size;
+    ++stats_.spooledBatches;
+    return true;
+}
+
+void TelemetryPipeline::evictSpool(uint64_t incomingBytes)
+{
+    while (!spool_.empty() && stats_.spoolBytes + incomingBytes > options_.maxSpoolBytes) {
+        stats_.droppedSpool += spool_.front().events;
+        removeSpooled(spool_.begin());
+    }
+}
+
+void TelemetryPipeline::removeSpooled(std::deque<SpoolEntry>::iterator entry)
+{
+    os_unlink(spoolPath(entry->name).constData());
+    stats_.spoolBytes -= entry->bytes;
+    spool_.erase(entry);
+}
@@ -0,0 +1,238 @@
+/*!
+ * @file telemetry.h
+ * @brief Batched telemetry for frontend events, spooled to disk while offline.
+ *
+ * The pipeline has four stages, each on the thread that suits it:
+ * - enqueue() copies a fixed-size event into a lock-free MPSC ring. It is
+ *   called from OBS frontend callbacks, never blocks or allocates, and a
+ *   full ring drops the event and counts it.
+ * - The batcher thread drains the ring and seals a batch once it holds
+ *   maxBatchEvents events or maxBatchBytes bytes, or its oldest event is
+ *   maxBatchDelay old. Batches are encoded right away (TelemetryCodec).
+ * - The uploader thread sends sealed batches, oldest first, through a
+ *   TelemetryUploader. Failed uploads back off exponentially.
+ * - Batches that cannot be sent yet are written to a bounded spool
+ *   directory: when more than maxMemoryBatches are waiting, when an upload
+ *   asks to be retried, and at shutdown. The next session uploads them.
+ *   When the spool is over maxSpoolBytes the oldest batches are evicted and
+ *   their events counted as dropped.
+ *
+ * @author <Developer> <Email Address>
+ * @copyright Copyright (C) <Year> <Developer>
+ * @license GNU General Public License v2 or later
+ * @see https://www.gnu.org/licenses/
+ */
+
+#pragma once
+
+#include "mpsc-ring.h"
+
+#include <QByteArray>
+#include <QString>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief One event as it crosses the ring; trivially copyable, no allocation.
+ */
+struct TelemetryEvent {
+    static constexpr size_t kDetailBytes = 46;
+
+    int64_t  timestampMs  = 0;     ///< Wall clock, ms since the Unix epoch.
+    uint32_t type         = 0;     ///< obs_frontend_event value, or a TelemetryEventType.
+    int32_t  value        = 0;     ///< Type-specific number.
+    uint8_t  detailLength = 0;
+    char     detail[kDetailBytes] = {};   ///< Type-specific UTF-8 text, e.g. a scene name; not terminated.
+
+    /// Event stamped with the current time; @p detail is cut at kDetailBytes.
+    static TelemetryEvent make(uint32_t type, int32_t value = 0, const char *detail = nullptr);
+};
+
+/// Plugin-defined event types; well above the obs_frontend_event range.
+enum TelemetryEventType : uint32_t {
+    kTelemetrySessionStart = 0x10000,   ///< value: spooled batches found at start.
+    kTelemetryDropped      = 0x10001,   ///< value: events dropped since the last report.
+};
+
+/**
+ * @brief Compact binary batch format.
+ *
+ * Layout: "PFT1", u64 session id (LE), varint batch sequence, varint event
+ * count, varint timestamp of the first event; then per event varint type,
+ * zigzag varint timestamp delta to the previous event, zigzag varint value,
+ * varint detail length and the detail bytes. Typical events take 4-6 bytes
+ * plus their detail text.
+ */
+namespace TelemetryCodec {
+
+/// Upper bound of the bytes @p event adds to a batch.
+size_t maxEncodedSize(const TelemetryEvent &event);
+
+QByteArray encode(uint64_t sessionId, uint64_t sequence, const TelemetryEvent *events, size_t count);
+
+/// False if @p batch is truncated or malformed.
+bool decode(const QByteArray &batch, std::vector<TelemetryEvent> &events, uint64_t *sessionId = nullptr,
+            uint64_t *sequence = nullptr);
+
+} // namespace TelemetryCodec
+
+/**
+ * @brief Outcome of one upload attempt.
+ */
+struct TelemetryUploadResult {
+    enum Status {
+        Sent,       ///< Accepted; the batch is done.
+        Retry,      ///< Offline, timed out or a server error; keep the batch.
+        Rejected,   ///< The server refused this batch for good; drop it.
+    };
+
+    Status  status = Retry;
+    QString error;
+};
+
+/**
+ * @class TelemetryUploader
+ * @brief Transport behind TelemetryPipeline.
+ *
+ * upload() is called on the uploader thread only and may block. Long waits
+ * should poll @p cancel and give up once it is set.
+ */
+class TelemetryUploader {
+public:
+    virtual ~TelemetryUploader() = default;
+
+    virtual TelemetryUploadResult upload(const QByteArray &batch, uint32_t events, const std::atomic<bool> &cancel) = 0;
+};
+
+/**
+ * @brief Batching, spool and retry limits.
+ */
+struct TelemetryOptions {
+    QByteArray                spoolDir;                       ///< UTF-8; empty keeps batches in memory only.
+    size_t                    maxBatchEvents   = 256;
+    size_t                    maxBatchBytes    = 16 * 1024;
+    std::chrono::milliseconds maxBatchDelay{5000};
+    size_t                    maxMemoryBatches = 8;           ///< Waiting batches kept in memory before spooling.
+    size_t                    maxSpoolBytes    = 4 * 1024 * 1024;
+    std::chrono::milliseconds retryMin{1000};
+    std::chrono::milliseconds retryMax{std::chrono::minutes(5)};
+    std::chrono::milliseconds pollInterval{20};               ///< How often the batcher drains the ring.
+};
+
+/**
+ * @brief Counters describing the pipeline.
+ *
+ * After stop(): enqueued + generated == uploadedEvents + rejected +
+ * droppedSpool + events still waiting in the spool.
+ */
+struct TelemetryStats {
+    uint64_t enqueued         = 0;   ///< Events accepted by enqueue().
+    uint64_t generated        = 0;   ///< Drop reports added by the batcher itself.
+    uint64_t droppedQueueFull = 0;   ///< Events refused because the ring was full.
+    uint64_t droppedSpool     = 0;   ///< Events in batches evicted from a full spool (or with no spool).
+    uint64_t rejected         = 0;   ///< Events in batches the server refused.
+    uint64_t batches          = 0;   ///< Batches sealed.
+    uint64_t encodedBytes     = 0;   ///< Bytes of those batches.
+    uint64_t uploadedBatches  = 0;
+    uint64_t uploadedEvents   = 0;
+    uint64_t uploadFailures   = 0;   ///< Attempts answered with Retry.
+    uint64_t spooledBatches   = 0;   ///< Batches written to the spool.
+    uint64_t recoveredBatches = 0;   ///< Batches found in the spool at start.
+    uint64_t spoolBytes       = 0;   ///< Current spool size.
+};
+
+/**
+ * @class TelemetryPipeline
+ * @brief Owns the event ring, the batcher and uploader threads and the spool.
+ */
+class TelemetryPipeline {
+public:
+    TelemetryPipeline(std::unique_ptr<TelemetryUploader> uploader, TelemetryOptions options);
+
+    /// Same as stop().
+    ~TelemetryPipeline();
+
+    TelemetryPipeline(const TelemetryPipeline &) = delete;
+    TelemetryPipeline &operator=(const TelemetryPipeline &) = delete;
+
+    /// Starts both threads; the spool is scanned on the uploader thread.
+    void start();
+
+    /**
+     * @brief Stops both threads without waiting for the network.
+     *
+     * Cancels an upload in progress, seals what is still queued and writes
+     * every unsent batch to the spool for the next session.
+     */
+    void stop();
+
+    /// Any thread: lock-free; false if the ring is full (the event is counted as dropped).
+    bool enqueue(const TelemetryEvent &event);
+
+    TelemetryStats stats() const;
+
+    /// Session id stamped on this run's batches and spool files.
+    uint64_t sessionId() const { return sessionId_; }
+
+private:
+    static constexpr size_t kRingEvents = 4096;
+
+    struct Batch {
+        QByteArray bytes;
+        uint32_t   events   = 0;
+        uint64_t   sequence = 0;
+    };
+
+    struct SpoolEntry {
+        QByteArray name;           ///< File name inside spoolDir.
+        uint64_t   session  = 0;
+        uint64_t   sequence = 0;
+        uint32_t   events   = 0;
+        uint64_t   bytes    = 0;
+    };
+
+    void runBatcher();
+    void runUploader();
+    void seal(std::vector<TelemetryEvent> &pending, size_t &pendingBytes);
+    void finish(uint64_t session, uint64_t sequence, const TelemetryUploadResult &result, uint32_t events);
+
+    /* spool; all called with mutex_ held */
+    void recoverSpool();
+    bool spoolBatch(const Batch &batch);
+    void evictSpool(uint64_t incomingBytes);
+    void removeSpooled(std::deque<SpoolEntry>::iterator entry);
+    QByteArray spoolPath(const QByteArray &name) const;
+
+    std::unique_ptr<TelemetryUploader> uploader_;
+    const TelemetryOptions             options_;
+    const uint64_t                     sessionId_;
+
+    MpscRing<TelemetryEvent, kRingEvents> ring_;
+    std::atomic<uint64_t>                 enqueued_{0};
+    std::atomic<uint64_t>                 droppedQueueFull_{0};
+
+    mutable std::mutex       mutex_;
+    std::condition_variable  wake_;
+    bool                     stopping_     = false;
+    bool                     spoolScanned_ = false;
+    std::deque<Batch>        memory_;          ///< Sealed, not spooled, oldest first.
+    std::deque<SpoolEntry>   spool_;           ///< Spool files, oldest first.
+    TelemetryStats           stats_;
+
+    /* batcher only */
+    uint64_t                 sequence_       = 0;
+    uint64_t                 droppedReported_ = 0;
+
+    std::atomic<bool>        cancel_{false};
+    std::thread              batcher_;
+    std::thread              uploaderThread_;
+};
@@ -1,27 +1,18 @@
 #pragma once
-#include <obs-frontend-api.h>
-#include <QMessageBox>
+#include "notification-center.h"
 #include <QString>
-#include <QWidget>
+
+class QWidget;
 
 /* -------------------------------------------------------------------------
- *  showToast(QWidget*, QString) – call OBS' UI toast if the enum exists,
- *  otherwise fall back to a simple information box.
+ *  showToast(QWidget*, QString) – queue a non-modal notification; safe from
+ *  any thread and never blocks. NotificationCenter coalesces repeats and
+ *  rate-limits; it uses OBS' UI notifications when obs-frontend-api has them, an
+ *  overlay on the main window otherwise. @p parent is no longer needed.
  * ------------------------------------------------------------------------- */
-inline void showToast(QWidget *parent, const QString &msg,
+inline void showToast(QWidget * /*parent*/, const QString &msg,
                       bool warning = false)
 {
-#if defined(OBS_FRONTEND_NOTIFICATION_INFO)
-    /* OBS 29+ full-tree build – enum & function are visible */
-    obs_frontend_push_ui_notification(
-        warning ? OBS_FRONTEND_NOTIFICATION_WARNING
-                : OBS_FRONTEND_NOTIFICATION_INFO,
-        msg.toUtf8().constData());
-#else
-    /* SDK build: use a regular Qt popup instead */
-    QMessageBox::information(parent,
-                             warning ? QObject::tr("Warning")
-                                     : QObject::tr("Information"),
-                             msg);
-#endif
+    NotificationCenter::global().post(
+        warning ? NotificationLevel::Warning : NotificationLevel::Info, msg);
 }